@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HCF_OBJECT_POOL_H
+#define HCF_OBJECT_POOL_H
+
+#include <stdbool.h>
+#include "object_base.h"
+#include "result.h"
+
+/* objects kept by each thread, further released objects go to the shared overflow */
+#define HCF_POOL_THREAD_SIZE 16
+#define HCF_POOL_SHARED_SIZE 64
+
+/* How the pool creates, wipes and identifies the objects of one framework type. */
+typedef struct {
+    HcfResult (*create)(const char *algoName, HcfObjectBase **obj);
+    /* drop keys and message state so that obj is as created, false if obj can not be reused */
+    bool (*clear)(HcfObjectBase *obj);
+    const char *(*getAlgoName)(HcfObjectBase *obj);
+} HcfObjectPoolType;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Take a pooled object of type and algoName, the pool of the calling thread first, or create one. */
+HcfResult HcfObjectPoolAcquire(const HcfObjectPoolType *type, const char *algoName, HcfObjectBase **obj);
+
+/* Clear obj and keep it for a later acquire, obj is destroyed if it can not be cleared or the pools are full. */
+void HcfObjectPoolRelease(const HcfObjectPoolType *type, HcfObjectBase *obj);
+
+/* Destroy the objects pooled by the calling thread and the shared overflow. */
+void HcfObjectPoolClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HCF_PARALLEL_H
+#define HCF_PARALLEL_H
+
+#include <stdint.h>
+#include "result.h"
+
+#define HCF_MAX_PARALLEL_THREAD_NUM 16
+
+/* Process the items in [begin, end) of the task. */
+typedef HcfResult (*HcfParallelTaskFunc)(void *task, uint32_t begin, uint32_t end);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Split [0, count) into threadNum contiguous ranges and run func on each of them, the first range
+ * runs on the calling thread. threadNum 0 or 1 runs everything on the calling thread.
+ * Returns the first failure of func, HCF_SUCCESS if all ranges succeed.
+ */
+HcfResult HcfParallelRun(uint32_t count, uint32_t threadNum, HcfParallelTaskFunc func, void *task);
+
+/* The number of online cpus, at most HCF_MAX_PARALLEL_THREAD_NUM. */
+uint32_t HcfGetDefaultThreadNum(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
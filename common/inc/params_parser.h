@@ -27,6 +27,7 @@ typedef enum {
     HCF_ALG_PRIMES,
     HCF_ALG_DIGEST,
     HCF_ALG_MGF1_DIGEST,
+    HCF_ALG_MAC_DIGEST,
 } HCF_ALG_PARA_TYPE;
 
 typedef enum {
@@ -34,6 +35,7 @@ typedef enum {
     HCF_ALG_DES,
     HCF_ALG_RSA,
     HCF_ALG_ECC,
+    HCF_ALG_CHACHA20,
 } HCF_ALG_VALUE;
 
 typedef enum {
@@ -46,6 +48,7 @@ typedef enum {
     HCF_ALG_AES_192,
     HCF_ALG_AES_256,
     HCF_ALG_3DES_192,
+    HCF_ALG_CHACHA20_256,
 
     HCF_ALG_MODE_NONE,
     HCF_ALG_MODE_ECB,
@@ -59,6 +62,9 @@ typedef enum {
     HCF_ALG_MODE_CFB128,
     HCF_ALG_MODE_CCM,
     HCF_ALG_MODE_GCM,
+    HCF_ALG_MODE_POLY1305,
+    HCF_ALG_MODE_GCM_SIV,
+    HCF_ALG_MODE_XTS,
 
     HCF_ALG_NOPADDING,
     HCF_ALG_PADDING_PKCS5,
@@ -107,6 +113,8 @@ typedef struct {
     HCF_ALG_PARA_VALUE paddingMode;
     HCF_ALG_PARA_VALUE md;
     HCF_ALG_PARA_VALUE mgf1md;
+    /* the hmac digest of an encrypt-then-mac cipher such as "AES256|CBC|PKCS7|HMAC-SHA256", 0 if none */
+    HCF_ALG_PARA_VALUE macMd;
 } CipherAttr;
 
 typedef struct {
@@ -136,6 +144,13 @@ extern "C" {
 
 HcfResult ParseAndSetParameter(const char* paramsStr, void *params, SetParameterFunc setFunc);
 
+/*
+ * Same as ParseAndSetParameter for params that start zeroed. The parsed params are kept in a process-wide
+ * cache keyed by paramsStr and setFunc, so repeated strings skip the parse.
+ */
+HcfResult ParseAndSetParameterCached(const char* paramsStr, void *params, uint32_t paramsSize,
+    SetParameterFunc setFunc);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@ extern "C" {
 
 bool IsStrValid(const char *str, uint32_t maxLen);
 bool IsBlobValid(const HcfBlob *blob);
+bool IsBlobArrayValid(const HcfBlob *blobs, uint32_t count);
 bool IsClassMatch(const HcfObjectBase *obj, const char *className);
 
 #ifdef __cplusplus
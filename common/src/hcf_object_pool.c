@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hcf_object_pool.h"
+
+#include <pthread.h>
+#include <string.h>
+#include "log.h"
+#include "memory.h"
+
+typedef struct {
+    const HcfObjectPoolType *type;
+    HcfObjectBase *obj;
+} PoolItem;
+
+typedef struct {
+    uint32_t count;
+    PoolItem items[HCF_POOL_THREAD_SIZE];
+} ThreadPool;
+
+static PoolItem gSharedItems[HCF_POOL_SHARED_SIZE];
+static uint32_t gSharedCount = 0;
+static pthread_mutex_t gSharedLock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_key_t gThreadPoolKey;
+static pthread_once_t gThreadPoolOnce = PTHREAD_ONCE_INIT;
+static bool gThreadPoolKeyValid = false;
+
+/* the most recently released match is taken first, it is the most likely to still be in cache */
+static HcfObjectBase *TakeItem(PoolItem *items, uint32_t *count, const HcfObjectPoolType *type,
+    const char *algoName)
+{
+    for (uint32_t i = *count; i > 0; i--) {
+        PoolItem *item = &items[i - 1];
+        if ((item->type == type) && (strcmp(type->getAlgoName(item->obj), algoName) == 0)) {
+            HcfObjectBase *obj = item->obj;
+            *item = items[*count - 1];
+            (*count)--;
+            return obj;
+        }
+    }
+    return NULL;
+}
+
+static bool PutItem(PoolItem *items, uint32_t *count, uint32_t capacity, const HcfObjectPoolType *type,
+    HcfObjectBase *obj)
+{
+    if (*count >= capacity) {
+        return false;
+    }
+    items[*count].type = type;
+    items[*count].obj = obj;
+    (*count)++;
+    return true;
+}
+
+static bool PutSharedItem(const HcfObjectPoolType *type, HcfObjectBase *obj)
+{
+    (void)pthread_mutex_lock(&gSharedLock);
+    bool ret = PutItem(gSharedItems, &gSharedCount, HCF_POOL_SHARED_SIZE, type, obj);
+    (void)pthread_mutex_unlock(&gSharedLock);
+    return ret;
+}
+
+/* at thread exit the pooled objects move to the shared overflow while it has room */
+static void ReleaseThreadPool(void *arg)
+{
+    ThreadPool *pool = (ThreadPool *)arg;
+    for (uint32_t i = 0; i < pool->count; i++) {
+        if (!PutSharedItem(pool->items[i].type, pool->items[i].obj)) {
+            OH_HCF_OBJ_DESTROY(pool->items[i].obj);
+        }
+    }
+    HcfFree(pool);
+}
+
+static void CreateThreadPoolKey(void)
+{
+    gThreadPoolKeyValid = (pthread_key_create(&gThreadPoolKey, ReleaseThreadPool) == 0);
+}
+
+static ThreadPool *GetThreadPool(bool create)
+{
+    (void)pthread_once(&gThreadPoolOnce, CreateThreadPoolKey);
+    if (!gThreadPoolKeyValid) {
+        return NULL;
+    }
+    ThreadPool *pool = (ThreadPool *)pthread_getspecific(gThreadPoolKey);
+    if ((pool != NULL) || !create) {
+        return pool;
+    }
+    pool = (ThreadPool *)HcfMalloc(sizeof(ThreadPool), 0);
+    if (pool == NULL) {
+        return NULL;
+    }
+    if (pthread_setspecific(gThreadPoolKey, pool) != 0) {
+        HcfFree(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+HcfResult HcfObjectPoolAcquire(const HcfObjectPoolType *type, const char *algoName, HcfObjectBase **obj)
+{
+    if ((type == NULL) || (algoName == NULL) || (obj == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    ThreadPool *pool = GetThreadPool(false);
+    *obj = (pool != NULL) ? TakeItem(pool->items, &(pool->count), type, algoName) : NULL;
+    if (*obj != NULL) {
+        return HCF_SUCCESS;
+    }
+    (void)pthread_mutex_lock(&gSharedLock);
+    *obj = TakeItem(gSharedItems, &gSharedCount, type, algoName);
+    (void)pthread_mutex_unlock(&gSharedLock);
+    if (*obj != NULL) {
+        return HCF_SUCCESS;
+    }
+    return type->create(algoName, obj);
+}
+
+void HcfObjectPoolRelease(const HcfObjectPoolType *type, HcfObjectBase *obj)
+{
+    if ((type == NULL) || (obj == NULL)) {
+        return;
+    }
+    if (!type->clear(obj)) {
+        OH_HCF_OBJ_DESTROY(obj);
+        return;
+    }
+    ThreadPool *pool = GetThreadPool(true);
+    if ((pool != NULL) && PutItem(pool->items, &(pool->count), HCF_POOL_THREAD_SIZE, type, obj)) {
+        return;
+    }
+    if (!PutSharedItem(type, obj)) {
+        OH_HCF_OBJ_DESTROY(obj);
+    }
+}
+
+void HcfObjectPoolClear(void)
+{
+    ThreadPool *pool = GetThreadPool(false);
+    if (pool != NULL) {
+        for (uint32_t i = 0; i < pool->count; i++) {
+            OH_HCF_OBJ_DESTROY(pool->items[i].obj);
+        }
+        pool->count = 0;
+    }
+    (void)pthread_mutex_lock(&gSharedLock);
+    for (uint32_t i = 0; i < gSharedCount; i++) {
+        OH_HCF_OBJ_DESTROY(gSharedItems[i].obj);
+    }
+    gSharedCount = 0;
+    (void)pthread_mutex_unlock(&gSharedLock);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hcf_parallel.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "log.h"
+
+typedef struct {
+    HcfParallelTaskFunc func;
+    void *task;
+    uint32_t begin;
+    uint32_t end;
+    HcfResult result;
+} HcfParallelRange;
+
+static void *RunRange(void *arg)
+{
+    HcfParallelRange *range = (HcfParallelRange *)arg;
+    range->result = range->func(range->task, range->begin, range->end);
+    return NULL;
+}
+
+static uint32_t gDefaultThreadNum = 1;
+static pthread_once_t gDefaultThreadNumOnce = PTHREAD_ONCE_INIT;
+
+static void InitDefaultThreadNum(void)
+{
+    long cpuNum = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpuNum > 1) {
+        gDefaultThreadNum = (cpuNum > HCF_MAX_PARALLEL_THREAD_NUM) ? HCF_MAX_PARALLEL_THREAD_NUM : (uint32_t)cpuNum;
+    }
+}
+
+/* sysconf reads sysfs on every call, which costs more than creating the cipher that asks for it */
+uint32_t HcfGetDefaultThreadNum(void)
+{
+    (void)pthread_once(&gDefaultThreadNumOnce, InitDefaultThreadNum);
+    return gDefaultThreadNum;
+}
+
+HcfResult HcfParallelRun(uint32_t count, uint32_t threadNum, HcfParallelTaskFunc func, void *task)
+{
+    if (func == NULL) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (threadNum > HCF_MAX_PARALLEL_THREAD_NUM) {
+        threadNum = HCF_MAX_PARALLEL_THREAD_NUM;
+    }
+    if (threadNum > count) {
+        threadNum = count;
+    }
+    if (threadNum <= 1) {
+        return func(task, 0, count);
+    }
+
+    HcfParallelRange ranges[HCF_MAX_PARALLEL_THREAD_NUM];
+    pthread_t threads[HCF_MAX_PARALLEL_THREAD_NUM];
+    bool started[HCF_MAX_PARALLEL_THREAD_NUM] = { false };
+    uint32_t step = count / threadNum;
+    uint32_t remain = count % threadNum;
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < threadNum; i++) {
+        uint32_t len = step + ((i < remain) ? 1 : 0);
+        ranges[i].func = func;
+        ranges[i].task = task;
+        ranges[i].begin = begin;
+        ranges[i].end = begin + len;
+        ranges[i].result = HCF_SUCCESS;
+        begin += len;
+    }
+    for (uint32_t i = 1; i < threadNum; i++) {
+        started[i] = (pthread_create(&threads[i], NULL, RunRange, &ranges[i]) == 0);
+        if (!started[i]) {
+            LOGD("pthread_create failed, run the range on the calling thread.");
+        }
+    }
+    (void)RunRange(&ranges[0]);
+    HcfResult ret = ranges[0].result;
+    for (uint32_t i = 1; i < threadNum; i++) {
+        if (started[i]) {
+            (void)pthread_join(threads[i], NULL);
+        } else {
+            (void)RunRange(&ranges[i]);
+        }
+        if (ret == HCF_SUCCESS) {
+            ret = ranges[i].result;
+        }
+    }
+    return ret;
+}
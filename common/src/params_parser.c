@@ -15,10 +15,27 @@
 
 #include "params_parser.h"
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include "hcf_string.h"
+#include <string.h>
 #include "log.h"
+#include "memory.h"
+#include "securec.h"
+
+#define PARA_CONFIG_HASH_SIZE 256
+#define PARSE_CACHE_SIZE 256
+#define PARSE_CACHE_MAX_COUNT (PARSE_CACHE_SIZE / 2)
+#define PARSE_CACHE_PARAMS_MAX_SIZE 64
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+typedef struct {
+    SetParameterFunc setFunc;
+    char *paramsStr;
+    uint32_t paramsSize;
+    uint8_t params[PARSE_CACHE_PARAMS_MAX_SIZE];
+} ParseCacheEntry;
 
 const HcfParaConfig gConfig[] = {
     {"ECC224",       HCF_ALG_KEY_TYPE,       HCF_ALG_ECC_224},
@@ -30,6 +47,7 @@ const HcfParaConfig gConfig[] = {
     {"AES192",       HCF_ALG_KEY_TYPE,       HCF_ALG_AES_192},
     {"AES256",       HCF_ALG_KEY_TYPE,       HCF_ALG_AES_256},
     {"3DES192",      HCF_ALG_KEY_TYPE,       HCF_ALG_3DES_192},
+    {"ChaCha20",     HCF_ALG_KEY_TYPE,       HCF_ALG_CHACHA20_256},
 
     {"ECB",          HCF_ALG_MODE,           HCF_ALG_MODE_ECB},
     {"CBC",          HCF_ALG_MODE,           HCF_ALG_MODE_CBC},
@@ -42,6 +60,9 @@ const HcfParaConfig gConfig[] = {
     {"CFB128",       HCF_ALG_MODE,           HCF_ALG_MODE_CFB128},
     {"CCM",          HCF_ALG_MODE,           HCF_ALG_MODE_CCM},
     {"GCM",          HCF_ALG_MODE,           HCF_ALG_MODE_GCM},
+    {"Poly1305",     HCF_ALG_MODE,           HCF_ALG_MODE_POLY1305},
+    {"GCMSIV",       HCF_ALG_MODE,           HCF_ALG_MODE_GCM_SIV},
+    {"XTS",          HCF_ALG_MODE,           HCF_ALG_MODE_XTS},
 
     {"NoPadding",    HCF_ALG_PADDING_TYPE,   HCF_ALG_NOPADDING},
     {"PKCS5",        HCF_ALG_PADDING_TYPE,   HCF_ALG_PADDING_PKCS5},
@@ -73,6 +94,11 @@ const HcfParaConfig gConfig[] = {
     {"MGF1_SHA384",       HCF_ALG_MGF1_DIGEST,         HCF_OPENSSL_DIGEST_SHA384},
     {"MGF1_SHA512",       HCF_ALG_MGF1_DIGEST,         HCF_OPENSSL_DIGEST_SHA512},
 
+    {"HMAC-SHA1",         HCF_ALG_MAC_DIGEST,          HCF_OPENSSL_DIGEST_SHA1},
+    {"HMAC-SHA256",       HCF_ALG_MAC_DIGEST,          HCF_OPENSSL_DIGEST_SHA256},
+    {"HMAC-SHA384",       HCF_ALG_MAC_DIGEST,          HCF_OPENSSL_DIGEST_SHA384},
+    {"HMAC-SHA512",       HCF_ALG_MAC_DIGEST,          HCF_OPENSSL_DIGEST_SHA512},
+
     {"PRIMES_2",          HCF_ALG_PRIMES,              HCF_OPENSSL_PRIMES_2},
     {"PRIMES_3",          HCF_ALG_PRIMES,              HCF_OPENSSL_PRIMES_3},
     {"PRIMES_4",          HCF_ALG_PRIMES,              HCF_OPENSSL_PRIMES_4},
@@ -80,16 +106,44 @@ const HcfParaConfig gConfig[] = {
 
 };
 
-const HcfParaConfig* findConfig(const HcString* tag)
+/* index + 1 into gConfig, 0 marks an empty slot */
+static uint16_t gConfigHash[PARA_CONFIG_HASH_SIZE];
+static pthread_once_t gConfigHashOnce = PTHREAD_ONCE_INIT;
+
+static ParseCacheEntry *gParseCache[PARSE_CACHE_SIZE];
+static uint32_t gParseCacheCount = 0;
+static pthread_rwlock_t gParseCacheLock = PTHREAD_RWLOCK_INITIALIZER;
+
+static uint32_t HashString(const char *str, uint32_t len)
 {
-    if (tag == NULL) {
-        return NULL;
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)str[i]) * FNV_PRIME;
     }
+    return hash;
+}
 
+static void BuildConfigHash(void)
+{
     for (uint32_t i = 0; i < sizeof(gConfig) / sizeof(HcfParaConfig); ++i) {
-        if (StringCompare(tag, gConfig[i].tag) == 0) {
-            return &gConfig[i];
+        uint32_t slot = HashString(gConfig[i].tag, strlen(gConfig[i].tag)) & (PARA_CONFIG_HASH_SIZE - 1);
+        while (gConfigHash[slot] != 0) {
+            slot = (slot + 1) & (PARA_CONFIG_HASH_SIZE - 1);
+        }
+        gConfigHash[slot] = (uint16_t)(i + 1);
+    }
+}
+
+static const HcfParaConfig *FindConfig(const char *tag, uint32_t len)
+{
+    (void)pthread_once(&gConfigHashOnce, BuildConfigHash);
+    uint32_t slot = HashString(tag, len) & (PARA_CONFIG_HASH_SIZE - 1);
+    while (gConfigHash[slot] != 0) {
+        const HcfParaConfig *config = &gConfig[gConfigHash[slot] - 1];
+        if ((strncmp(config->tag, tag, len) == 0) && (config->tag[len] == '\0')) {
+            return config;
         }
+        slot = (slot + 1) & (PARA_CONFIG_HASH_SIZE - 1);
     }
     return NULL;
 }
@@ -99,42 +153,99 @@ HcfResult ParseAndSetParameter(const char* paramsStr, void *params, SetParameter
     if (paramsStr == NULL || setFunc == NULL) {
         return HCF_INVALID_PARAMS;
     }
-    HcString str = CreateString();
-    HcString subStr = CreateString();
-    if (!StringSetPointer(&str, paramsStr)) {
-        DeleteString(&subStr);
-        DeleteString(&str);
-        return HCF_INVALID_PARAMS;
+    const char *token = paramsStr;
+    while (true) {
+        const char *end = strchr(token, '|');
+        uint32_t len = (end == NULL) ? strlen(token) : (uint32_t)(end - token);
+        HcfResult ret = (*setFunc)(FindConfig(token, len), params);
+        if ((ret != HCF_SUCCESS) || (end == NULL)) {
+            return ret;
+        }
+        token = end + 1;
     }
-    HcfResult ret = HCF_INVALID_PARAMS;
-    uint32_t pos = 0;
-    do {
-        int findPos = StringFind(&str, '|', pos);
-        if (findPos >= 0) {
-            if (!StringSubString(&str, pos, findPos - pos, &subStr)) {
-                LOGE("StringSubString failed!");
-                break;
-            }
-            ret = (*setFunc)(findConfig(&subStr), params);
-            if (ret != HCF_SUCCESS) {
-                break;
-            }
-            pos = findPos + 1;
-        } else {
-            uint32_t strLen = StringLength(&str);
-            if (strLen < pos) {
-                break;
-            }
-            if (!StringSubString(&str, pos, strLen - pos, &subStr)) {
-                LOGE("get last string failed!");
-                break;
-            }
-            ret = (*setFunc)(findConfig(&subStr), params);
+}
+
+static uint32_t ParseCacheSlot(const char *paramsStr, SetParameterFunc setFunc)
+{
+    uint32_t hash = HashString(paramsStr, strlen(paramsStr)) ^ (uint32_t)(uintptr_t)setFunc;
+    return hash & (PARSE_CACHE_SIZE - 1);
+}
+
+static bool IsCacheEntryMatch(const ParseCacheEntry *entry, const char *paramsStr, SetParameterFunc setFunc,
+    uint32_t paramsSize)
+{
+    return (entry->setFunc == setFunc) && (entry->paramsSize == paramsSize) &&
+        (strcmp(entry->paramsStr, paramsStr) == 0);
+}
+
+static bool GetCachedParameter(const char *paramsStr, void *params, uint32_t paramsSize, SetParameterFunc setFunc)
+{
+    bool found = false;
+    (void)pthread_rwlock_rdlock(&gParseCacheLock);
+    for (uint32_t slot = ParseCacheSlot(paramsStr, setFunc); gParseCache[slot] != NULL;
+        slot = (slot + 1) & (PARSE_CACHE_SIZE - 1)) {
+        if (IsCacheEntryMatch(gParseCache[slot], paramsStr, setFunc, paramsSize)) {
+            (void)memcpy_s(params, paramsSize, gParseCache[slot]->params, paramsSize);
+            found = true;
             break;
         }
-    } while (true);
+    }
+    (void)pthread_rwlock_unlock(&gParseCacheLock);
+    return found;
+}
 
-    DeleteString(&subStr);
-    DeleteString(&str);
+static ParseCacheEntry *NewCacheEntry(const char *paramsStr, const void *params, uint32_t paramsSize,
+    SetParameterFunc setFunc)
+{
+    ParseCacheEntry *entry = (ParseCacheEntry *)HcfMalloc(sizeof(ParseCacheEntry), 0);
+    if (entry == NULL) {
+        return NULL;
+    }
+    size_t strSize = strlen(paramsStr) + 1;
+    entry->paramsStr = (char *)HcfMalloc(strSize, 0);
+    if (entry->paramsStr == NULL) {
+        HcfFree(entry);
+        return NULL;
+    }
+    (void)memcpy_s(entry->paramsStr, strSize, paramsStr, strSize);
+    (void)memcpy_s(entry->params, PARSE_CACHE_PARAMS_MAX_SIZE, params, paramsSize);
+    entry->paramsSize = paramsSize;
+    entry->setFunc = setFunc;
+    return entry;
+}
+
+/* entries live as long as the process, a full cache keeps serving the strings it has */
+static void AddCachedParameter(const char *paramsStr, const void *params, uint32_t paramsSize,
+    SetParameterFunc setFunc)
+{
+    (void)pthread_rwlock_wrlock(&gParseCacheLock);
+    uint32_t slot = ParseCacheSlot(paramsStr, setFunc);
+    while ((gParseCache[slot] != NULL) &&
+        !IsCacheEntryMatch(gParseCache[slot], paramsStr, setFunc, paramsSize)) {
+        slot = (slot + 1) & (PARSE_CACHE_SIZE - 1);
+    }
+    if ((gParseCache[slot] == NULL) && (gParseCacheCount < PARSE_CACHE_MAX_COUNT)) {
+        gParseCache[slot] = NewCacheEntry(paramsStr, params, paramsSize, setFunc);
+        gParseCacheCount += (gParseCache[slot] != NULL) ? 1 : 0;
+    }
+    (void)pthread_rwlock_unlock(&gParseCacheLock);
+}
+
+HcfResult ParseAndSetParameterCached(const char* paramsStr, void *params, uint32_t paramsSize,
+    SetParameterFunc setFunc)
+{
+    if ((paramsStr == NULL) || (params == NULL) || (setFunc == NULL)) {
+        return HCF_INVALID_PARAMS;
+    }
+    if (paramsSize > PARSE_CACHE_PARAMS_MAX_SIZE) {
+        return ParseAndSetParameter(paramsStr, params, setFunc);
+    }
+    if (GetCachedParameter(paramsStr, params, paramsSize, setFunc)) {
+        return HCF_SUCCESS;
+    }
+    HcfResult ret = ParseAndSetParameter(paramsStr, params, setFunc);
+    if (ret == HCF_SUCCESS) {
+        AddCachedParameter(paramsStr, params, paramsSize, setFunc);
+    }
     return ret;
 }
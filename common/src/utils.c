@@ -37,6 +37,20 @@ bool IsBlobValid(const HcfBlob *blob)
     return ((blob != NULL) && (blob->data != NULL) && (blob->len > 0));
 }
 
+/* empty segments are allowed, a segment with data must have a buffer */
+bool IsBlobArrayValid(const HcfBlob *blobs, uint32_t count)
+{
+    if ((blobs == NULL) || (count == 0)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if ((blobs[i].len > 0) && (blobs[i].data == NULL)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool IsClassMatch(const HcfObjectBase *obj, const char *className)
 {
     if ((obj == NULL) || (obj->getClass() == NULL) || (className == NULL)) {
@@ -23,6 +23,8 @@
 #include "log.h"
 #include "memory.h"
 #include "cipher_rsa_openssl.h"
+#include "hcf_object_pool.h"
+#include "hcf_parallel.h"
 #include "utils.h"
 
 typedef HcfResult (*HcfCipherGeneratorSpiCreateFunc)(CipherAttr *, OH_HCF_CipherGeneratorSpi **);
@@ -45,7 +47,8 @@ typedef struct {
 static const HcfCipherGenAbility CIPHER_ABILITY_SET[] = {
     { HCF_ALG_RSA, { HcfCipherRsaCipherSpiCreate } },
     { HCF_ALG_AES, { HcfCipherAesGeneratorSpiCreate } },
-    { HCF_ALG_DES, { HcfCipherDesGeneratorSpiCreate } }
+    { HCF_ALG_DES, { HcfCipherDesGeneratorSpiCreate } },
+    { HCF_ALG_CHACHA20, { HcfCipherChaCha20GeneratorSpiCreate } }
 };
 
 static void SetKeyLength(HCF_ALG_PARA_VALUE value, void *cipher)
@@ -63,6 +66,9 @@ static void SetKeyLength(HCF_ALG_PARA_VALUE value, void *cipher)
         case HCF_ALG_3DES_192:
             cipherAttr->algo = HCF_ALG_DES;
             break;
+        case HCF_ALG_CHACHA20_256:
+            cipherAttr->algo = HCF_ALG_CHACHA20;
+            break;
         case HCF_OPENSSL_RSA_512:
         case HCF_OPENSSL_RSA_768:
         case HCF_OPENSSL_RSA_1024:
@@ -100,6 +106,11 @@ static void SetMgf1Digest(HCF_ALG_PARA_VALUE value, CipherAttr *cipher)
     cipher->mgf1md = value;
 }
 
+static void SetMacDigest(HCF_ALG_PARA_VALUE value, CipherAttr *cipher)
+{
+    cipher->macMd = value;
+}
+
 static HcfResult OnSetParameter(const HcfParaConfig *config, void *cipher)
 {
     if ((config == NULL) || (cipher == NULL)) {
@@ -124,6 +135,9 @@ static HcfResult OnSetParameter(const HcfParaConfig *config, void *cipher)
         case HCF_ALG_MGF1_DIGEST:
             SetMgf1Digest(config->paraValue, cipher);
             break;
+        case HCF_ALG_MAC_DIGEST:
+            SetMacDigest(config->paraValue, cipher);
+            break;
         default:
             ret = HCF_INVALID_PARAMS;
             break;
@@ -206,12 +220,126 @@ static HcfResult CipherFinal(HcfCipher *self, HcfBlob *input, HcfBlob *output)
     return impl->spiObj->doFinal(impl->spiObj, input, output);
 }
 
+static HcfResult CipherGetOutputSize(HcfCipher *self, uint32_t inputLen, bool isFinal, uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)self;
+    if (impl->spiObj->getOutputSize == NULL) {
+        LOGE("Algo not support getOutputSize!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->getOutputSize(impl->spiObj, inputLen, isFinal, outputLen);
+}
+
+static HcfResult CipherUpdateToBuffer(HcfCipher *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL) || (output->data == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)self;
+    if (impl->spiObj->updateToBuffer == NULL) {
+        LOGE("Algo not support updateToBuffer!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->updateToBuffer(impl->spiObj, input, output);
+}
+
+static HcfResult CipherFinalToBuffer(HcfCipher *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL) || (output->data == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)self;
+    if (impl->spiObj->doFinalToBuffer == NULL) {
+        LOGE("Algo not support doFinalToBuffer!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->doFinalToBuffer(impl->spiObj, input, output);
+}
+
+static HcfResult CipherReset(HcfCipher *self, HcfParamsSpec *params)
+{
+    if (self == NULL) { /* params maybe is NULL */
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)self;
+    if (impl->spiObj->reset == NULL) {
+        LOGE("Algo not support reset!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->reset(impl->spiObj, params);
+}
+
+static HcfResult CipherSetSpecUint(HcfCipher *self, CipherSpecItem item, uint32_t value)
+{
+    if (self == NULL) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)self;
+    if (impl->spiObj->setCipherSpecUint == NULL) {
+        LOGE("Algo not support setCipherSpecUint!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->setCipherSpecUint(impl->spiObj, item, value);
+}
+
+static HcfResult CipherUpdateAad(HcfCipher *self, HcfBlob *aad)
+{
+    if ((self == NULL) || (aad == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)self;
+    if (impl->spiObj->updateAad == NULL) {
+        LOGE("Algo not support updateAad!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->updateAad(impl->spiObj, aad);
+}
+
 static void InitCipher(OH_HCF_CipherGeneratorSpi *spiObj, CipherGenImpl *cipher)
 {
     cipher->super.init = CipherInit;
     cipher->super.update = CipherUpdate;
     cipher->super.doFinal = CipherFinal;
     cipher->super.getAlgorithm = GetAlogrithm;
+    cipher->super.getOutputSize = CipherGetOutputSize;
+    cipher->super.updateToBuffer = CipherUpdateToBuffer;
+    cipher->super.doFinalToBuffer = CipherFinalToBuffer;
+    cipher->super.reset = CipherReset;
+    cipher->super.setCipherSpecUint = CipherSetSpecUint;
+    cipher->super.updateAad = CipherUpdateAad;
     cipher->super.base.destroy = CipherDestroy;
     cipher->super.base.getClass = GetCipherGeneratorClass;
 }
@@ -237,11 +365,15 @@ HcfResult HcfCipherCreate(const char *transformation, HcfCipher **cipher)
         LOGE("Invalid input params while creating cipher!");
         return HCF_INVALID_PARAMS;
     }
-    if (ParseAndSetParameter(transformation, (void *)&attr, OnSetParameter) != HCF_SUCCESS) {
+    if (ParseAndSetParameterCached(transformation, (void *)&attr, sizeof(attr), OnSetParameter) != HCF_SUCCESS) {
         LOGE("ParseAndSetParameter failed!");
         return HCF_NOT_SUPPORT;
     }
 
+    if ((attr.macMd != 0) && (attr.algo != HCF_ALG_AES)) {
+        LOGE("only aes supports encrypt-then-mac!");
+        return HCF_NOT_SUPPORT;
+    }
     const HcfCipherGenFuncSet *funcSet = FindAbility(&attr);
     if (funcSet == NULL) {
         LOGE("FindAbility failed!");
@@ -270,3 +402,569 @@ HcfResult HcfCipherCreate(const char *transformation, HcfCipher **cipher)
     *cipher = (HcfCipher *)returnGenerator;
     return res;
 }
+
+static HcfResult CipherAeadBatch(HcfCipher *cipher, enum HcfCryptoMode opMode, HcfKey *key,
+    const HcfCipherBatchParams *params, HcfCipherBatchItem *items, uint32_t count)
+{
+    if ((cipher == NULL) || (key == NULL) || (params == NULL) || (items == NULL) || (count == 0)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)cipher;
+    if (impl->spiObj->aeadBatch == NULL) {
+        LOGE("Algo not support batch aead!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->aeadBatch(impl->spiObj, opMode, key, params, items, count);
+}
+
+HcfResult HcfCipherSealBatch(HcfCipher *cipher, HcfKey *key, const HcfCipherBatchParams *params,
+    HcfCipherBatchItem *items, uint32_t count)
+{
+    return CipherAeadBatch(cipher, ENCRYPT_MODE, key, params, items, count);
+}
+
+HcfResult HcfCipherOpenBatch(HcfCipher *cipher, HcfKey *key, const HcfCipherBatchParams *params,
+    HcfCipherBatchItem *items, uint32_t count)
+{
+    return CipherAeadBatch(cipher, DECRYPT_MODE, key, params, items, count);
+}
+
+HcfResult HcfCipherCryptSectors(HcfCipher *cipher, const HcfCipherSectorParams *params, HcfBlob *input,
+    HcfBlob *output)
+{
+    if ((cipher == NULL) || (params == NULL) || !IsBlobValid(input) || (output == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)cipher;
+    if (impl->spiObj->cryptSectors == NULL) {
+        LOGE("Algo not support sector crypt!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->cryptSectors(impl->spiObj, params, input, output);
+}
+
+/*
+ * An EVP update costs more than copying a packet sized input, so segments are gathered into one update up to
+ * this length and outputs up to this length are scattered from a bounce buffer. Longer data is not copied.
+ */
+#define CIPHER_VEC_STAGE_LEN 2048
+
+typedef struct {
+    HcfBlob *outputs;
+    uint32_t count;
+    uint32_t index;
+    uint32_t used;
+} CipherVecWriter;
+
+/* room left in the current segment, full and empty segments are skipped */
+static uint32_t GetWriterRoom(CipherVecWriter *writer)
+{
+    while ((writer->index < writer->count) && (writer->used == writer->outputs[writer->index].len)) {
+        writer->index++;
+        writer->used = 0;
+    }
+    return (writer->index < writer->count) ? (writer->outputs[writer->index].len - writer->used) : 0;
+}
+
+static HcfResult ScatterOutput(CipherVecWriter *writer, const uint8_t *data, uint32_t len)
+{
+    while (len > 0) {
+        uint32_t room = GetWriterRoom(writer);
+        if (room == 0) {
+            LOGE("output segments are too small!");
+            return HCF_INVALID_PARAMS;
+        }
+        uint32_t copyLen = (len < room) ? len : room;
+        HcfBlob *segment = &(writer->outputs[writer->index]);
+        (void)memcpy_s(segment->data + writer->used, room, data, copyLen);
+        writer->used += copyLen;
+        data += copyLen;
+        len -= copyLen;
+    }
+    return HCF_SUCCESS;
+}
+
+/*
+ * Shrink *len until the spi output of the piece fits room. The spi asks for a fixed overhead on top of the
+ * input for the data a block mode keeps back, so one retry is enough.
+ */
+static bool FitPiece(OH_HCF_CipherGeneratorSpi *spi, uint32_t room, uint32_t *len)
+{
+    uint32_t need = 0;
+    if (spi->getOutputSize(spi, *len, false, &need) != HCF_SUCCESS) {
+        return false;
+    }
+    if (need <= room) {
+        return true;
+    }
+    uint32_t overhead = (need > *len) ? (need - *len) : 0;
+    if (room <= overhead) {
+        return false;
+    }
+    *len = room - overhead;
+    return ((spi->getOutputSize(spi, *len, false, &need) == HCF_SUCCESS) && (need <= room));
+}
+
+static HcfResult UpdateBounced(OH_HCF_CipherGeneratorSpi *spi, HcfBlob *input, CipherVecWriter *writer)
+{
+    uint8_t bounce[CIPHER_VEC_STAGE_LEN];
+    HcfBlob output = { .data = bounce, .len = sizeof(bounce) };
+    HcfResult ret = spi->updateToBuffer(spi, input, &output);
+    if (ret == HCF_SUCCESS) {
+        ret = ScatterOutput(writer, bounce, output.len);
+    }
+    (void)memset_s(bounce, sizeof(bounce), 0, sizeof(bounce));
+    return ret;
+}
+
+/* output in place if it fits the current segment or the piece is long, small pieces go through a bounce buffer */
+static HcfResult CipherUpdatePiece(OH_HCF_CipherGeneratorSpi *spi, HcfBlob *piece, CipherVecWriter *writer)
+{
+    uint32_t room = GetWriterRoom(writer);
+    uint32_t len = piece->len;
+    HcfResult ret;
+    if ((room > 0) && FitPiece(spi, room, &len) && ((len == piece->len) || (piece->len > CIPHER_VEC_STAGE_LEN))) {
+        HcfBlob input = { .data = piece->data, .len = len };
+        HcfBlob output = { .data = writer->outputs[writer->index].data + writer->used, .len = room };
+        ret = spi->updateToBuffer(spi, &input, &output);
+        if (ret == HCF_SUCCESS) {
+            writer->used += output.len;
+        }
+    } else {
+        len = piece->len;
+        if (!FitPiece(spi, CIPHER_VEC_STAGE_LEN, &len)) {
+            LOGE("Algo output does not fit the bounce buffer!");
+            return HCF_NOT_SUPPORT;
+        }
+        HcfBlob input = { .data = piece->data, .len = len };
+        ret = UpdateBounced(spi, &input, writer);
+    }
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    piece->data += len;
+    piece->len -= len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult CipherUpdateData(OH_HCF_CipherGeneratorSpi *spi, uint8_t *data, uint32_t len,
+    CipherVecWriter *writer)
+{
+    HcfBlob piece = { .data = data, .len = len };
+    while (piece.len > 0) {
+        HcfResult ret = CipherUpdatePiece(spi, &piece, writer);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult CipherUpdateSegments(OH_HCF_CipherGeneratorSpi *spi, const HcfBlob *inputs, uint32_t inputCount,
+    CipherVecWriter *writer, uint8_t *stage)
+{
+    uint32_t staged = 0;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        uint32_t len = inputs[i].len;
+        if (len == 0) {
+            continue;
+        }
+        if (staged + len <= CIPHER_VEC_STAGE_LEN) {
+            (void)memcpy_s(stage + staged, CIPHER_VEC_STAGE_LEN - staged, inputs[i].data, len);
+            staged += len;
+            continue;
+        }
+        HcfResult ret = CipherUpdateData(spi, stage, staged, writer);
+        staged = 0;
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        if (len <= CIPHER_VEC_STAGE_LEN) {
+            (void)memcpy_s(stage, CIPHER_VEC_STAGE_LEN, inputs[i].data, len);
+            staged = len;
+            continue;
+        }
+        ret = CipherUpdateData(spi, inputs[i].data, len, writer);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return CipherUpdateData(spi, stage, staged, writer);
+}
+
+static HcfResult CipherUpdateVec(OH_HCF_CipherGeneratorSpi *spi, const HcfBlob *inputs, uint32_t inputCount,
+    CipherVecWriter *writer)
+{
+    if ((spi->updateToBuffer == NULL) || (spi->getOutputSize == NULL)) {
+        LOGE("Algo not support updateToBuffer!");
+        return HCF_NOT_SUPPORT;
+    }
+    uint8_t stage[CIPHER_VEC_STAGE_LEN];
+    HcfResult ret = CipherUpdateSegments(spi, inputs, inputCount, writer, stage);
+    (void)memset_s(stage, sizeof(stage), 0, sizeof(stage));
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    /* segments report what they got, the ones after the last written byte get nothing */
+    for (uint32_t i = writer->index; i < writer->count; i++) {
+        writer->outputs[i].len = (i == writer->index) ? writer->used : 0;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetVecCipherSpi(HcfCipher *cipher, const HcfBlob *inputs, uint32_t inputCount,
+    OH_HCF_CipherGeneratorSpi **spi)
+{
+    if ((cipher == NULL) || !IsBlobArrayValid(inputs, inputCount)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    *spi = ((CipherGenImpl *)cipher)->spiObj;
+    return HCF_SUCCESS;
+}
+
+HcfResult HcfCipherUpdateVec(HcfCipher *cipher, const HcfBlob *inputs, uint32_t inputCount, HcfBlob *output)
+{
+    OH_HCF_CipherGeneratorSpi *spi = NULL;
+    HcfResult ret = GetVecCipherSpi(cipher, inputs, inputCount, &spi);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (output == NULL) {
+        LOGE("Invalid output parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    uint64_t totalLen = 0;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        totalLen += inputs[i].len;
+    }
+    uint32_t outLen = 0;
+    if ((totalLen > UINT32_MAX) || (spi->getOutputSize == NULL) ||
+        (spi->getOutputSize(spi, (uint32_t)totalLen, false, &outLen) != HCF_SUCCESS)) {
+        LOGE("Can not get the output size!");
+        return HCF_INVALID_PARAMS;
+    }
+    /* HcfMalloc rejects zero, an algo that keeps everything back still gets a valid buffer */
+    output->data = (uint8_t *)HcfMalloc((outLen > 0) ? outLen : 1, 0);
+    if (output->data == NULL) {
+        LOGE("malloc output failed!");
+        return HCF_ERR_MALLOC;
+    }
+    output->len = outLen;
+    CipherVecWriter writer = { .outputs = output, .count = 1, .index = 0, .used = 0 };
+    ret = CipherUpdateVec(spi, inputs, inputCount, &writer);
+    if (ret != HCF_SUCCESS) {
+        HcfBlobDataClearAndFree(output);
+    }
+    return ret;
+}
+
+HcfResult HcfCipherUpdateVecToBuffers(HcfCipher *cipher, const HcfBlob *inputs, uint32_t inputCount,
+    HcfBlob *outputs, uint32_t outputCount)
+{
+    OH_HCF_CipherGeneratorSpi *spi = NULL;
+    HcfResult ret = GetVecCipherSpi(cipher, inputs, inputCount, &spi);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (!IsBlobArrayValid(outputs, outputCount)) {
+        LOGE("Invalid output segments.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherVecWriter writer = { .outputs = outputs, .count = outputCount, .index = 0, .used = 0 };
+    return CipherUpdateVec(spi, inputs, inputCount, &writer);
+}
+
+static HcfResult CipherAeadInPlace(HcfCipher *cipher, enum HcfCryptoMode opMode, HcfCipherPacket *packet)
+{
+    if ((cipher == NULL) || (packet == NULL) || (packet->data == NULL) || (packet->offset > packet->capacity) ||
+        (packet->len > packet->capacity - packet->offset)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)cipher;
+    if (impl->spiObj->aeadInPlace == NULL) {
+        LOGE("Algo not support in place aead!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->aeadInPlace(impl->spiObj, opMode, packet);
+}
+
+HcfResult HcfCipherSealInPlace(HcfCipher *cipher, HcfCipherPacket *packet)
+{
+    return CipherAeadInPlace(cipher, ENCRYPT_MODE, packet);
+}
+
+HcfResult HcfCipherOpenInPlace(HcfCipher *cipher, HcfCipherPacket *packet)
+{
+    return CipherAeadInPlace(cipher, DECRYPT_MODE, packet);
+}
+
+HcfResult HcfCipherSeek(HcfCipher *cipher, uint64_t offset)
+{
+    if (cipher == NULL) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherGenImpl *impl = (CipherGenImpl *)cipher;
+    if (impl->spiObj->seek == NULL) {
+        LOGE("Algo not support seek!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->seek(impl->spiObj, offset);
+}
+
+/*
+ * Re-encryption runs in tiles that fit the L1 cache, the plaintext of a tile lives only in a stack scratch
+ * that is wiped after the tile. The slack takes the block a decrypt update may keep back from the tile before.
+ */
+#define CIPHER_REKEY_TILE_LEN (16 * 1024)
+#define CIPHER_REKEY_SLACK_LEN 32
+
+typedef struct {
+    HcfCipher **decryptors;
+    HcfCipher **encryptors;
+    const HcfBlob *input;
+    HcfBlob *output;
+    uint32_t stripeLen;
+} CipherRekeyTask;
+
+static HcfResult GetRekeySpi(HcfCipher *cipher, OH_HCF_CipherGeneratorSpi **spi)
+{
+    if ((cipher == NULL) || !IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Invalid cipher.");
+        return HCF_INVALID_PARAMS;
+    }
+    *spi = ((CipherGenImpl *)cipher)->spiObj;
+    if (((*spi)->updateToBuffer == NULL) || ((*spi)->doFinalToBuffer == NULL)) {
+        LOGE("Algo not support rekey!");
+        return HCF_NOT_SUPPORT;
+    }
+    return HCF_SUCCESS;
+}
+
+/* decrypt the tile into scratch and encrypt it to output at *used, the final call finishes both messages */
+static HcfResult RekeyTile(OH_HCF_CipherGeneratorSpi *decSpi, OH_HCF_CipherGeneratorSpi *encSpi, HcfBlob *tile,
+    bool isFinal, HcfBlob *output, uint32_t *used)
+{
+    uint8_t scratch[CIPHER_REKEY_TILE_LEN + CIPHER_REKEY_SLACK_LEN];
+    HcfBlob plain = { .data = scratch, .len = sizeof(scratch) };
+    HcfResult ret = isFinal ? decSpi->doFinalToBuffer(decSpi, tile, &plain) :
+        decSpi->updateToBuffer(decSpi, tile, &plain);
+    if (ret != HCF_SUCCESS) {
+        LOGE("rekey decrypt failed!");
+        (void)memset_s(scratch, sizeof(scratch), 0, sizeof(scratch));
+        return ret;
+    }
+    HcfBlob out = { .data = output->data + *used, .len = output->len - *used };
+    if (isFinal) {
+        ret = encSpi->doFinalToBuffer(encSpi, &plain, &out);
+    } else if (plain.len > 0) {
+        ret = encSpi->updateToBuffer(encSpi, &plain, &out);
+    } else {
+        out.len = 0;
+    }
+    (void)memset_s(scratch, sizeof(scratch), 0, plain.len);
+    if (ret != HCF_SUCCESS) {
+        LOGE("rekey encrypt failed!");
+        return ret;
+    }
+    *used += out.len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult RekeyTiles(OH_HCF_CipherGeneratorSpi *decSpi, OH_HCF_CipherGeneratorSpi *encSpi,
+    const HcfBlob *input, HcfBlob *output, uint32_t *used)
+{
+    for (uint32_t offset = 0; offset < input->len; offset += CIPHER_REKEY_TILE_LEN) {
+        uint32_t len = (input->len - offset > CIPHER_REKEY_TILE_LEN) ? CIPHER_REKEY_TILE_LEN : (input->len - offset);
+        HcfBlob tile = { .data = input->data + offset, .len = len };
+        HcfResult ret = RekeyTile(decSpi, encSpi, &tile, false, output, used);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+/* tile offsets are 32 bit, like the lengths of the spi calls */
+static bool IsRekeyBlobValid(const HcfBlob *input, const HcfBlob *output)
+{
+    return (input != NULL) && ((input->data != NULL) || (input->len == 0)) &&
+        (input->len <= UINT32_MAX - CIPHER_REKEY_TILE_LEN) && (output != NULL) && (output->data != NULL) &&
+        (output->len <= UINT32_MAX);
+}
+
+HcfResult HcfCipherRekey(HcfCipher *decryptor, HcfCipher *encryptor, const HcfBlob *input, HcfBlob *output)
+{
+    if (!IsRekeyBlobValid(input, output)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    OH_HCF_CipherGeneratorSpi *decSpi = NULL;
+    OH_HCF_CipherGeneratorSpi *encSpi = NULL;
+    HcfResult ret = GetRekeySpi(decryptor, &decSpi);
+    if (ret == HCF_SUCCESS) {
+        ret = GetRekeySpi(encryptor, &encSpi);
+    }
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint32_t used = 0;
+    ret = RekeyTiles(decSpi, encSpi, input, output, &used);
+    if (ret == HCF_SUCCESS) {
+        HcfBlob empty = { .data = NULL, .len = 0 };
+        ret = RekeyTile(decSpi, encSpi, &empty, true, output, &used);
+    }
+    if (ret != HCF_SUCCESS) {
+        /* an aead decrypt verifies at the end, by then its unverified plaintext went to output */
+        (void)memset_s(output->data, output->len, 0, used);
+        return ret;
+    }
+    output->len = used;
+    return HCF_SUCCESS;
+}
+
+static HcfResult RunRekeyStripes(void *arg, uint32_t begin, uint32_t end)
+{
+    CipherRekeyTask *task = (CipherRekeyTask *)arg;
+    for (uint32_t i = begin; i < end; i++) {
+        uint64_t start = (uint64_t)i * task->stripeLen;
+        if (start >= task->input->len) {
+            break;
+        }
+        uint32_t len = (task->input->len - start > task->stripeLen) ? task->stripeLen :
+            (uint32_t)(task->input->len - start);
+        OH_HCF_CipherGeneratorSpi *decSpi = ((CipherGenImpl *)task->decryptors[i])->spiObj;
+        OH_HCF_CipherGeneratorSpi *encSpi = ((CipherGenImpl *)task->encryptors[i])->spiObj;
+        HcfResult ret = HcfCipherSeek(task->decryptors[i], start);
+        if (ret == HCF_SUCCESS) {
+            ret = HcfCipherSeek(task->encryptors[i], start);
+        }
+        if (ret != HCF_SUCCESS) {
+            LOGE("rekey stripe %u can not seek!", i);
+            return ret;
+        }
+        HcfBlob stripe = { .data = task->input->data + start, .len = len };
+        HcfBlob out = { .data = task->output->data + start, .len = task->output->len - (uint32_t)start };
+        uint32_t used = 0;
+        ret = RekeyTiles(decSpi, encSpi, &stripe, &out, &used);
+        if ((ret == HCF_SUCCESS) && (used != len)) {
+            LOGE("rekey stripe %u is not a stream cipher!", i);
+            ret = HCF_NOT_SUPPORT;
+        }
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+HcfResult HcfCipherRekeyParallel(HcfCipher **decryptors, HcfCipher **encryptors, uint32_t count,
+    const HcfBlob *input, HcfBlob *output)
+{
+    if ((decryptors == NULL) || (encryptors == NULL) || (count == 0) || !IsRekeyBlobValid(input, output)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (output->len < input->len) {
+        LOGE("output buffer is too small, need %u bytes!", (uint32_t)input->len);
+        return HCF_INVALID_PARAMS;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        OH_HCF_CipherGeneratorSpi *spi = NULL;
+        HcfResult ret = GetRekeySpi(decryptors[i], &spi);
+        if (ret == HCF_SUCCESS) {
+            ret = GetRekeySpi(encryptors[i], &spi);
+        }
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    /* whole tiles per stripe, so only the last tile of the input is short */
+    uint32_t tiles = input->len / CIPHER_REKEY_TILE_LEN + ((input->len % CIPHER_REKEY_TILE_LEN > 0) ? 1 : 0);
+    uint32_t stripeTiles = tiles / count + ((tiles % count > 0) ? 1 : 0);
+    CipherRekeyTask task = {
+        .decryptors = decryptors,
+        .encryptors = encryptors,
+        .input = input,
+        .output = output,
+        .stripeLen = ((stripeTiles > 0) ? stripeTiles : 1) * CIPHER_REKEY_TILE_LEN,
+    };
+    HcfResult ret = HcfParallelRun(count, count, RunRekeyStripes, &task);
+    if (ret != HCF_SUCCESS) {
+        (void)memset_s(output->data, output->len, 0, input->len);
+        return ret;
+    }
+    output->len = input->len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult PoolCreateCipher(const char *algoName, HcfObjectBase **obj)
+{
+    return HcfCipherCreate(algoName, (HcfCipher **)obj);
+}
+
+static bool PoolClearCipher(HcfObjectBase *obj)
+{
+    CipherGenImpl *impl = (CipherGenImpl *)obj;
+    if (impl->spiObj->clear == NULL) {
+        return false;
+    }
+    impl->spiObj->clear(impl->spiObj);
+    return true;
+}
+
+static const char *PoolGetCipherAlgoName(HcfObjectBase *obj)
+{
+    return ((CipherGenImpl *)obj)->algoName;
+}
+
+static const HcfObjectPoolType CIPHER_POOL_TYPE = {
+    .create = PoolCreateCipher,
+    .clear = PoolClearCipher,
+    .getAlgoName = PoolGetCipherAlgoName
+};
+
+HcfResult HcfCipherPoolAcquire(const char *transformation, HcfCipher **cipher)
+{
+    if (!IsStrValid(transformation, HCF_MAX_ALGO_NAME_LEN) || (cipher == NULL)) {
+        LOGE("Invalid input params while acquiring cipher!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HcfObjectPoolAcquire(&CIPHER_POOL_TYPE, transformation, (HcfObjectBase **)cipher);
+}
+
+void HcfCipherPoolRelease(HcfCipher *cipher)
+{
+    if (cipher == NULL) {
+        return;
+    }
+    if (!IsClassMatch((HcfObjectBase *)cipher, GetCipherGeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfObjectPoolRelease(&CIPHER_POOL_TYPE, (HcfObjectBase *)cipher);
+}
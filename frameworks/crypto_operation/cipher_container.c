@@ -0,0 +1,428 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cipher_container.h"
+
+#include <string.h>
+#include "securec.h"
+
+#include "cipher.h"
+#include "config.h"
+#include "log.h"
+#include "memory.h"
+#include "rand.h"
+#include "utils.h"
+
+#define CONTAINER_VERSION 2
+#define CONTAINER_MAGIC_LEN 4
+#define CONTAINER_VERSION_OFFSET 4
+#define CONTAINER_ID_OFFSET 5
+#define CONTAINER_ID_LEN 7
+#define CONTAINER_CHUNK_SIZE_OFFSET 12
+/* header || chunk index || last flag */
+#define CONTAINER_AAD_LEN (HCF_CONTAINER_HEADER_LEN + UINT32_BYTES + 1)
+#define CONTAINER_AAD_LAST_FLAG_OFFSET (HCF_CONTAINER_HEADER_LEN + UINT32_BYTES)
+/* chunks handed to one batch call, their aads and items live on the stack */
+#define CONTAINER_BATCH_CHUNKS 64
+#define BITS_PER_BYTE 8
+#define UINT32_BYTES 4
+
+static const uint8_t CONTAINER_MAGIC[CONTAINER_MAGIC_LEN] = { 'H', 'C', 'F', 'C' };
+
+typedef struct {
+    HcfCipherContainer base;
+
+    HcfCipher *cipher;
+
+    HcfRand *rand;
+
+    HcfSymKey *key;
+
+    uint32_t chunkSize;
+
+    uint32_t threadNum;
+
+    uint8_t header[HCF_CONTAINER_HEADER_LEN];
+} HcfCipherContainerImpl;
+
+/* the chunks of one seal or open call */
+typedef struct {
+    enum HcfCryptoMode mode;
+    uint32_t firstChunk;
+    bool isLast;
+    uint32_t count;
+    /* length of a whole chunk in the input and in the output */
+    uint32_t inChunkLen;
+    uint32_t outChunkLen;
+    uint64_t outputLen;
+} ChunkRun;
+
+static const char *GetContainerClass(void)
+{
+    return "HcfCipherContainer";
+}
+
+static void StoreBe32(uint32_t value, uint8_t *out)
+{
+    for (int32_t i = UINT32_BYTES - 1; i >= 0; i--) {
+        out[i] = (uint8_t)value;
+        value >>= BITS_PER_BYTE;
+    }
+}
+
+static uint32_t LoadBe32(const uint8_t *in)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < UINT32_BYTES; i++) {
+        value = (value << BITS_PER_BYTE) | in[i];
+    }
+    return value;
+}
+
+static HcfResult GetHeader(HcfCipherContainer *self, HcfBlob *header)
+{
+    if ((self == NULL) || (header == NULL) || (header->data == NULL) || (header->len < HCF_CONTAINER_HEADER_LEN)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetContainerClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherContainerImpl *impl = (HcfCipherContainerImpl *)self;
+    (void)memcpy_s(header->data, header->len, impl->header, HCF_CONTAINER_HEADER_LEN);
+    header->len = HCF_CONTAINER_HEADER_LEN;
+    return HCF_SUCCESS;
+}
+
+static uint32_t GetChunkSize(HcfCipherContainer *self)
+{
+    if ((self == NULL) || !IsClassMatch((HcfObjectBase *)self, GetContainerClass())) {
+        LOGE("Invalid input parameter.");
+        return 0;
+    }
+    return ((HcfCipherContainerImpl *)self)->chunkSize;
+}
+
+static HcfResult GetChunkCount(HcfCipherContainer *self, uint64_t containerLen, uint32_t *count)
+{
+    if ((self == NULL) || (count == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetContainerClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    uint64_t sealedChunkLen = (uint64_t)((HcfCipherContainerImpl *)self)->chunkSize + HCF_CONTAINER_CHUNK_OVERHEAD;
+    if (containerLen < HCF_CONTAINER_HEADER_LEN + HCF_CONTAINER_CHUNK_OVERHEAD) {
+        LOGE("container is too short!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint64_t bodyLen = containerLen - HCF_CONTAINER_HEADER_LEN;
+    uint64_t rest = bodyLen % sealedChunkLen;
+    uint64_t chunks = bodyLen / sealedChunkLen + ((rest > 0) ? 1 : 0);
+    if (((rest > 0) && (rest < HCF_CONTAINER_CHUNK_OVERHEAD)) || (chunks > UINT32_MAX)) {
+        LOGE("container length is invalid!");
+        return HCF_INVALID_PARAMS;
+    }
+    *count = (uint32_t)chunks;
+    return HCF_SUCCESS;
+}
+
+static uint64_t GetChunkOffset(HcfCipherContainer *self, uint32_t chunk)
+{
+    if ((self == NULL) || !IsClassMatch((HcfObjectBase *)self, GetContainerClass())) {
+        LOGE("Invalid input parameter.");
+        return 0;
+    }
+    uint64_t sealedChunkLen = (uint64_t)((HcfCipherContainerImpl *)self)->chunkSize + HCF_CONTAINER_CHUNK_OVERHEAD;
+    return HCF_CONTAINER_HEADER_LEN + (uint64_t)chunk * sealedChunkLen;
+}
+
+/* split input into chunks, only the last chunk of the container may be short */
+static HcfResult InitChunkRun(const HcfCipherContainerImpl *impl, const HcfBlob *input, const HcfBlob *output,
+    ChunkRun *run)
+{
+    bool isSeal = (run->mode == ENCRYPT_MODE);
+    run->inChunkLen = isSeal ? impl->chunkSize : (impl->chunkSize + HCF_CONTAINER_CHUNK_OVERHEAD);
+    run->outChunkLen = isSeal ? (impl->chunkSize + HCF_CONTAINER_CHUNK_OVERHEAD) : impl->chunkSize;
+    uint32_t rest = input->len % run->inChunkLen;
+    if (!run->isLast && ((input->len == 0) || (rest != 0))) {
+        LOGE("input is not a whole number of chunks!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!isSeal && ((input->len == 0) || ((rest > 0) && (rest < HCF_CONTAINER_CHUNK_OVERHEAD)))) {
+        LOGE("input is not a whole number of sealed chunks!");
+        return HCF_INVALID_PARAMS;
+    }
+    /* an empty file is one empty chunk */
+    run->count = input->len / run->inChunkLen + (((rest > 0) || (input->len == 0)) ? 1 : 0);
+    if (run->count - 1 > UINT32_MAX - run->firstChunk) {
+        LOGE("chunk number is too large!");
+        return HCF_INVALID_PARAMS;
+    }
+    run->outputLen = isSeal ? ((uint64_t)input->len + (uint64_t)run->count * HCF_CONTAINER_CHUNK_OVERHEAD) :
+        ((uint64_t)input->len - (uint64_t)run->count * HCF_CONTAINER_CHUNK_OVERHEAD);
+    if ((output->data == NULL) || (output->len < run->outputLen)) {
+        LOGE("output buffer is too small, need %llu bytes!", (unsigned long long)run->outputLen);
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static void BuildAad(const HcfCipherContainerImpl *impl, uint32_t chunk, bool isLastChunk, uint8_t *aad)
+{
+    (void)memcpy_s(aad, CONTAINER_AAD_LEN, impl->header, HCF_CONTAINER_HEADER_LEN);
+    StoreBe32(chunk, aad + HCF_CONTAINER_HEADER_LEN);
+    aad[CONTAINER_AAD_LAST_FLAG_OFFSET] = isLastChunk ? 1 : 0;
+}
+
+/* a fresh random nonce in front of every chunk of [begin, end) that is about to be sealed */
+static HcfResult DrawNonces(HcfCipherContainerImpl *impl, const ChunkRun *run, uint32_t begin, uint32_t end,
+    HcfBlob *output)
+{
+    HcfBlob random = { .data = NULL, .len = 0 };
+    HcfResult ret = impl->rand->generateRandom(impl->rand, (int32_t)((end - begin) * HCF_CONTAINER_NONCE_LEN),
+        &random);
+    if (ret != HCF_SUCCESS) {
+        LOGE("generate chunk nonces failed!");
+        return ret;
+    }
+    for (uint32_t i = begin; i < end; i++) {
+        (void)memcpy_s(output->data + (uint64_t)i * run->outChunkLen, HCF_CONTAINER_NONCE_LEN,
+            random.data + (i - begin) * HCF_CONTAINER_NONCE_LEN, HCF_CONTAINER_NONCE_LEN);
+    }
+    HcfBlobDataFree(&random);
+    return HCF_SUCCESS;
+}
+
+/* the chunks of [begin, end) of run as one batch */
+static HcfResult CryptChunkBatch(HcfCipherContainerImpl *impl, const ChunkRun *run, uint32_t begin, uint32_t end,
+    HcfBlob *input, HcfBlob *output)
+{
+    bool isSeal = (run->mode == ENCRYPT_MODE);
+    if (isSeal) {
+        HcfResult ret = DrawNonces(impl, run, begin, end, output);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    HcfCipherBatchItem items[CONTAINER_BATCH_CHUNKS];
+    uint8_t aads[CONTAINER_BATCH_CHUNKS][CONTAINER_AAD_LEN];
+    (void)memset_s(items, sizeof(items), 0, sizeof(items));
+    for (uint32_t i = begin; i < end; i++) {
+        HcfCipherBatchItem *item = &items[i - begin];
+        uint64_t inOffset = (uint64_t)i * run->inChunkLen;
+        uint32_t inLen = (i + 1 < run->count) ? run->inChunkLen : (uint32_t)(input->len - inOffset);
+        uint8_t *inChunk = input->data + inOffset;
+        uint8_t *outChunk = output->data + (uint64_t)i * run->outChunkLen;
+        BuildAad(impl, run->firstChunk + i, run->isLast && (i + 1 == run->count), aads[i - begin]);
+        /* the nonce leads the sealed chunk */
+        item->iv.data = isSeal ? outChunk : inChunk;
+        item->iv.len = HCF_CONTAINER_NONCE_LEN;
+        item->aad.data = aads[i - begin];
+        item->aad.len = CONTAINER_AAD_LEN;
+        item->input.data = isSeal ? inChunk : (inChunk + HCF_CONTAINER_NONCE_LEN);
+        item->input.len = isSeal ? inLen : (inLen - HCF_CONTAINER_NONCE_LEN);
+        item->output.data = isSeal ? (outChunk + HCF_CONTAINER_NONCE_LEN) : outChunk;
+        item->output.len = isSeal ? (inLen + HCF_CONTAINER_TAG_LEN) : (inLen - HCF_CONTAINER_CHUNK_OVERHEAD);
+    }
+    HcfCipherBatchParams params = { .tagLen = HCF_CONTAINER_TAG_LEN, .threadNum = impl->threadNum };
+    if (isSeal) {
+        return HcfCipherSealBatch(impl->cipher, (HcfKey *)impl->key, &params, items, end - begin);
+    }
+    return HcfCipherOpenBatch(impl->cipher, (HcfKey *)impl->key, &params, items, end - begin);
+}
+
+static HcfResult CryptChunks(HcfCipherContainer *self, ChunkRun *run, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || ((input->data == NULL) && (input->len > 0)) || (output == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetContainerClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherContainerImpl *impl = (HcfCipherContainerImpl *)self;
+    HcfResult ret = InitChunkRun(impl, input, output, run);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    for (uint32_t begin = 0; begin < run->count; begin += CONTAINER_BATCH_CHUNKS) {
+        uint32_t end = (run->count - begin > CONTAINER_BATCH_CHUNKS) ? (begin + CONTAINER_BATCH_CHUNKS) : run->count;
+        ret = CryptChunkBatch(impl, run, begin, end, input, output);
+        if (ret != HCF_SUCCESS) {
+            LOGE("chunks from %u failed!", run->firstChunk + begin);
+            /* the chunks before the failed one verified, but a partial file is not handed out either */
+            (void)memset_s(output->data, output->len, 0, run->outputLen);
+            return ret;
+        }
+    }
+    output->len = (uint32_t)run->outputLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult SealChunks(HcfCipherContainer *self, uint32_t firstChunk, bool isLast, HcfBlob *input,
+    HcfBlob *output)
+{
+    ChunkRun run = { .mode = ENCRYPT_MODE, .firstChunk = firstChunk, .isLast = isLast };
+    return CryptChunks(self, &run, input, output);
+}
+
+static HcfResult OpenChunks(HcfCipherContainer *self, uint32_t firstChunk, bool isLast, HcfBlob *input,
+    HcfBlob *output)
+{
+    ChunkRun run = { .mode = DECRYPT_MODE, .firstChunk = firstChunk, .isLast = isLast };
+    return CryptChunks(self, &run, input, output);
+}
+
+static void ContainerDestroy(HcfObjectBase *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch(self, GetContainerClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherContainerImpl *impl = (HcfCipherContainerImpl *)self;
+    OH_HCF_OBJ_DESTROY(impl->cipher);
+    OH_HCF_OBJ_DESTROY(impl->rand);
+    HcfFree(impl);
+}
+
+static HcfResult CreateGcmCipher(HcfSymKey *key, HcfCipher **cipher)
+{
+    const char *keyAlgo = key->key.getAlgorithm((HcfKey *)key);
+    if ((keyAlgo == NULL) || (strncmp(keyAlgo, "AES", strlen("AES")) != 0)) {
+        LOGE("container only support aes keys!");
+        return HCF_NOT_SUPPORT;
+    }
+    char transformation[HCF_MAX_ALGO_NAME_LEN] = { 0 };
+    if (sprintf_s(transformation, sizeof(transformation), "%s|GCM|NoPadding", keyAlgo) < 0) {
+        LOGE("build transformation failed!");
+        return HCF_ERR_COPY;
+    }
+    return HcfCipherCreate(transformation, cipher);
+}
+
+static HcfResult CreateContainer(HcfSymKey *key, const uint8_t *header, uint32_t threadNum,
+    HcfCipherContainer **returnObj)
+{
+    HcfCipher *cipher = NULL;
+    HcfResult ret = CreateGcmCipher(key, &cipher);
+    if (ret != HCF_SUCCESS) {
+        LOGE("create gcm cipher failed!");
+        return ret;
+    }
+    HcfRand *rand = NULL;
+    ret = HcfRandCreate(&rand);
+    if (ret != HCF_SUCCESS) {
+        LOGE("create rand failed!");
+        OH_HCF_OBJ_DESTROY(cipher);
+        return ret;
+    }
+    HcfCipherContainerImpl *impl = (HcfCipherContainerImpl *)HcfMalloc(sizeof(HcfCipherContainerImpl), 0);
+    if (impl == NULL) {
+        LOGE("Failed to allocate container memory!");
+        OH_HCF_OBJ_DESTROY(rand);
+        OH_HCF_OBJ_DESTROY(cipher);
+        return HCF_ERR_MALLOC;
+    }
+    impl->base.base.getClass = GetContainerClass;
+    impl->base.base.destroy = ContainerDestroy;
+    impl->base.getHeader = GetHeader;
+    impl->base.getChunkSize = GetChunkSize;
+    impl->base.getChunkCount = GetChunkCount;
+    impl->base.getChunkOffset = GetChunkOffset;
+    impl->base.sealChunks = SealChunks;
+    impl->base.openChunks = OpenChunks;
+    impl->cipher = cipher;
+    impl->rand = rand;
+    impl->key = key;
+    impl->chunkSize = LoadBe32(header + CONTAINER_CHUNK_SIZE_OFFSET);
+    impl->threadNum = threadNum;
+    (void)memcpy_s(impl->header, HCF_CONTAINER_HEADER_LEN, header, HCF_CONTAINER_HEADER_LEN);
+    *returnObj = (HcfCipherContainer *)impl;
+    return HCF_SUCCESS;
+}
+
+static bool IsChunkSizeValid(uint32_t chunkSize)
+{
+    return (chunkSize > 0) && (chunkSize <= HCF_CONTAINER_MAX_CHUNK_SIZE);
+}
+
+static HcfResult GenerateContainerId(uint8_t *id)
+{
+    HcfRand *rand = NULL;
+    HcfResult ret = HcfRandCreate(&rand);
+    if (ret != HCF_SUCCESS) {
+        LOGE("create rand failed!");
+        return ret;
+    }
+    HcfBlob random = { .data = NULL, .len = 0 };
+    ret = rand->generateRandom(rand, CONTAINER_ID_LEN, &random);
+    OH_HCF_OBJ_DESTROY(rand);
+    if (ret != HCF_SUCCESS) {
+        LOGE("generate container id failed!");
+        return ret;
+    }
+    (void)memcpy_s(id, CONTAINER_ID_LEN, random.data, random.len);
+    HcfBlobDataFree(&random);
+    return HCF_SUCCESS;
+}
+
+HcfResult HcfCipherContainerCreate(HcfSymKey *key, const HcfCipherContainerParams *params,
+    HcfCipherContainer **returnObj)
+{
+    if ((key == NULL) || (params == NULL) || !IsChunkSizeValid(params->chunkSize) || (returnObj == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    uint8_t header[HCF_CONTAINER_HEADER_LEN] = { 0 };
+    (void)memcpy_s(header, sizeof(header), CONTAINER_MAGIC, CONTAINER_MAGIC_LEN);
+    header[CONTAINER_VERSION_OFFSET] = CONTAINER_VERSION;
+    HcfResult ret = GenerateContainerId(header + CONTAINER_ID_OFFSET);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    StoreBe32(params->chunkSize, header + CONTAINER_CHUNK_SIZE_OFFSET);
+    return CreateContainer(key, header, params->threadNum, returnObj);
+}
+
+HcfResult HcfCipherContainerLoad(HcfSymKey *key, const HcfBlob *header, uint32_t threadNum,
+    HcfCipherContainer **returnObj)
+{
+    if ((key == NULL) || (header == NULL) || (header->data == NULL) || (returnObj == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((header->len < HCF_CONTAINER_HEADER_LEN) ||
+        (memcmp(header->data, CONTAINER_MAGIC, CONTAINER_MAGIC_LEN) != 0)) {
+        LOGE("not a container header!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (header->data[CONTAINER_VERSION_OFFSET] != CONTAINER_VERSION) {
+        LOGE("container version %u is not supported!", header->data[CONTAINER_VERSION_OFFSET]);
+        return HCF_NOT_SUPPORT;
+    }
+    if (!IsChunkSizeValid(LoadBe32(header->data + CONTAINER_CHUNK_SIZE_OFFSET))) {
+        LOGE("chunk size is invalid!");
+        return HCF_INVALID_PARAMS;
+    }
+    return CreateContainer(key, header->data, threadNum, returnObj);
+}
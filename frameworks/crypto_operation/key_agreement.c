@@ -144,7 +144,7 @@ HcfResult HcfKeyAgreementCreate(const char *algoName, HcfKeyAgreement **returnOb
     }
 
     HcfKeyAgreementParams params = { 0 };
-    if (ParseAndSetParameter(algoName, &params, ParseKeyAgreementParams) != HCF_SUCCESS) {
+    if (ParseAndSetParameterCached(algoName, &params, sizeof(params), ParseKeyAgreementParams) != HCF_SUCCESS) {
         LOGE("Failed to parser parmas!");
         return HCF_INVALID_PARAMS;
     }
@@ -22,6 +22,7 @@
 
 #include "log.h"
 #include "config.h"
+#include "hcf_object_pool.h"
 #include "memory.h"
 #include "utils.h"
 
@@ -47,6 +48,12 @@ static const HcfMacAbility MAC_ABILITY_SET[] = {
     { "SHA256", OpensslMacSpiCreate },
     { "SHA384", OpensslMacSpiCreate },
     { "SHA512", OpensslMacSpiCreate },
+    { "SHA3-224", OpensslMacSpiCreate },
+    { "SHA3-256", OpensslMacSpiCreate },
+    { "SHA3-384", OpensslMacSpiCreate },
+    { "SHA3-512", OpensslMacSpiCreate },
+    { "BLAKE2b512", OpensslMacSpiCreate },
+    { "BLAKE2s256", OpensslMacSpiCreate },
 };
 
 static const char *GetMacClass(void)
@@ -149,6 +156,60 @@ static void MacDestroy(HcfObjectBase *self)
     HcfFree(impl);
 }
 
+static HcfResult Clone(HcfMac *self, HcfMac **newMac);
+
+// wrap spiObj into a new mac object, spiObj is destroyed on failure
+static HcfResult NewMacImpl(const char *algoName, HcfMacSpi *spiObj, HcfMac **macApi)
+{
+    HcfMacImpl *impl = (HcfMacImpl *)HcfMalloc(sizeof(HcfMacImpl), 0);
+    if (impl == NULL) {
+        LOGE("Failed to allocate Mac Obj memory!");
+        OH_HCF_OBJ_DESTROY(spiObj);
+        return HCF_ERR_MALLOC;
+    }
+    if (strcpy_s(impl->algoName, HCF_MAX_ALGO_NAME_LEN, algoName) != EOK) {
+        LOGE("Failed to copy algoName!");
+        OH_HCF_OBJ_DESTROY(spiObj);
+        HcfFree(impl);
+        return HCF_ERR_COPY;
+    }
+    impl->base.base.getClass = GetMacClass;
+    impl->base.base.destroy = MacDestroy;
+    impl->base.init = Init;
+    impl->base.update = Update;
+    impl->base.doFinal = DoFinal;
+    impl->base.getMacLength = GetMacLength;
+    impl->base.clone = Clone;
+    impl->base.getAlgoName = GetAlgoName;
+    impl->spiObj = spiObj;
+    *macApi = (HcfMac *)impl;
+    return HCF_SUCCESS;
+}
+
+static HcfResult Clone(HcfMac *self, HcfMac **newMac)
+{
+    if ((self == NULL) || (newMac == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetMacClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMacSpi *spiObj = ((HcfMacImpl *)self)->spiObj;
+    if (spiObj->engineCloneMac == NULL) {
+        LOGE("Clone is not supported!");
+        return HCF_NOT_SUPPORT;
+    }
+    HcfMacSpi *newSpi = NULL;
+    HcfResult res = spiObj->engineCloneMac(spiObj, &newSpi);
+    if (res != HCF_SUCCESS) {
+        LOGE("Failed to clone spi object!");
+        return res;
+    }
+    return NewMacImpl(((HcfMacImpl *)self)->algoName, newSpi, newMac);
+}
+
 HcfResult HcfMacCreate(const char *algoName, HcfMac **macApi)
 {
     if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (macApi == NULL)) {
@@ -160,31 +221,82 @@ HcfResult HcfMacCreate(const char *algoName, HcfMac **macApi)
         LOGE("Algo not supported!");
         return HCF_NOT_SUPPORT;
     }
-    HcfMacImpl *returnMacApi = (HcfMacImpl *)HcfMalloc(sizeof(HcfMacImpl), 0);
-    if (returnMacApi == NULL) {
-        LOGE("Failed to allocate Mac Obj memory!");
-        return HCF_ERR_MALLOC;
-    }
-    if (strcpy_s(returnMacApi->algoName, HCF_MAX_ALGO_NAME_LEN, algoName) != EOK) {
-        LOGE("Failed to copy algoName!");
-        HcfFree(returnMacApi);
-        return HCF_ERR_COPY;
-    }
     HcfMacSpi *spiObj = NULL;
     HcfResult res = createSpifunc(algoName, &spiObj);
     if (res != HCF_SUCCESS) {
         LOGE("Failed to create spi object!");
-        HcfFree(returnMacApi);
         return res;
     }
-    returnMacApi->base.base.getClass = GetMacClass;
-    returnMacApi->base.base.destroy = MacDestroy;
-    returnMacApi->base.init = Init;
-    returnMacApi->base.update = Update;
-    returnMacApi->base.doFinal = DoFinal;
-    returnMacApi->base.getMacLength = GetMacLength;
-    returnMacApi->base.getAlgoName = GetAlgoName;
-    returnMacApi->spiObj = spiObj;
-    *macApi = (HcfMac *)returnMacApi;
+    return NewMacImpl(algoName, spiObj, macApi);
+}
+
+HcfResult HcfMacUpdateVec(HcfMac *mac, const HcfBlob *inputs, uint32_t inputCount)
+{
+    if ((mac == NULL) || !IsBlobArrayValid(inputs, inputCount)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)mac, GetMacClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMacSpi *spiObj = ((HcfMacImpl *)mac)->spiObj;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        if (inputs[i].len == 0) {
+            continue;
+        }
+        HcfBlob input = { .data = inputs[i].data, .len = inputs[i].len };
+        HcfResult ret = spiObj->engineUpdateMac(spiObj, &input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
     return HCF_SUCCESS;
-}
\ No newline at end of file
+}
+
+static HcfResult PoolCreateMac(const char *algoName, HcfObjectBase **obj)
+{
+    return HcfMacCreate(algoName, (HcfMac **)obj);
+}
+
+static bool PoolClearMac(HcfObjectBase *obj)
+{
+    HcfMacImpl *impl = (HcfMacImpl *)obj;
+    if (impl->spiObj->engineClearMac == NULL) {
+        return false;
+    }
+    impl->spiObj->engineClearMac(impl->spiObj);
+    return true;
+}
+
+static const char *PoolGetMacAlgoName(HcfObjectBase *obj)
+{
+    return ((HcfMacImpl *)obj)->algoName;
+}
+
+static const HcfObjectPoolType MAC_POOL_TYPE = {
+    .create = PoolCreateMac,
+    .clear = PoolClearMac,
+    .getAlgoName = PoolGetMacAlgoName
+};
+
+HcfResult HcfMacPoolAcquire(const char *algoName, HcfMac **mac)
+{
+    if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (mac == NULL)) {
+        LOGE("Invalid input params while acquiring mac!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HcfObjectPoolAcquire(&MAC_POOL_TYPE, algoName, (HcfObjectBase **)mac);
+}
+
+void HcfMacPoolRelease(HcfMac *mac)
+{
+    if (mac == NULL) {
+        return;
+    }
+    if (!IsClassMatch((HcfObjectBase *)mac, GetMacClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfObjectPoolRelease(&MAC_POOL_TYPE, (HcfObjectBase *)mac);
+}
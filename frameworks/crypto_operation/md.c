@@ -23,11 +23,14 @@
 
 #include "log.h"
 #include "config.h"
+#include "hcf_object_pool.h"
 #include "memory.h"
 #include "utils.h"
 
 typedef HcfResult (*HcfMdSpiCreateFunc)(const char *, HcfMdSpi **);
 
+typedef HcfResult (*HcfMdDigestManyFunc)(const char *, const HcfBlob *, HcfBlob *, uint32_t);
+
 typedef struct {
     HcfMd base;
 
@@ -40,15 +43,27 @@ typedef struct {
     char *algoName;
 
     HcfMdSpiCreateFunc createSpifunc;
+
+    // hashes a batch of messages without a md object, NULL falls back to one md per batch
+    HcfMdDigestManyFunc digestManyFunc;
 } HcfMdAbility;
 
 static const HcfMdAbility MD_ABILITY_SET[] = {
-    { "SHA1", OpensslMdSpiCreate },
-    { "SHA224", OpensslMdSpiCreate },
-    { "SHA256", OpensslMdSpiCreate },
-    { "SHA384", OpensslMdSpiCreate },
-    { "SHA512", OpensslMdSpiCreate },
-    { "MD5", OpensslMdSpiCreate },
+    { "SHA1", OpensslMdSpiCreate, NULL },
+    { "SHA224", OpensslMdSpiCreate, OpensslMdDigestMany },
+    { "SHA256", OpensslMdSpiCreate, OpensslMdDigestMany },
+    { "SHA384", OpensslMdSpiCreate, OpensslMdDigestMany },
+    { "SHA512", OpensslMdSpiCreate, OpensslMdDigestMany },
+    { "MD5", OpensslMdSpiCreate, NULL },
+    { "SHA3-224", OpensslMdSpiCreate, NULL },
+    { "SHA3-256", OpensslMdSpiCreate, NULL },
+    { "SHA3-384", OpensslMdSpiCreate, NULL },
+    { "SHA3-512", OpensslMdSpiCreate, NULL },
+    { "SHAKE128", OpensslMdSpiCreate, NULL },
+    { "SHAKE256", OpensslMdSpiCreate, NULL },
+    { "BLAKE2b512", OpensslMdSpiCreate, NULL },
+    { "BLAKE2s256", OpensslMdSpiCreate, NULL },
+    { "SHA256-TREE", OpensslTreeMdSpiCreate, NULL },
 };
 
 static const char *GetMdClass(void)
@@ -56,17 +71,23 @@ static const char *GetMdClass(void)
     return "Md";
 }
 
-static HcfMdSpiCreateFunc FindAbility(const char *algoName)
+static const HcfMdAbility *FindMdAbility(const char *algoName)
 {
     for (uint32_t i = 0; i < (sizeof(MD_ABILITY_SET) / sizeof(MD_ABILITY_SET[0])); i++) {
         if (strcmp(MD_ABILITY_SET[i].algoName, algoName) == 0) {
-            return MD_ABILITY_SET[i].createSpifunc;
+            return &MD_ABILITY_SET[i];
         }
     }
     LOGE("Algo not support! [Algo]: %s", algoName);
     return NULL;
 }
 
+static HcfMdSpiCreateFunc FindAbility(const char *algoName)
+{
+    const HcfMdAbility *ability = FindMdAbility(algoName);
+    return (ability == NULL) ? NULL : ability->createSpifunc;
+}
+
 static HcfResult Update(HcfMd *self, HcfBlob *input)
 {
     if ((self == NULL) || (!IsBlobValid(input))) {
@@ -91,8 +112,37 @@ static HcfResult DoFinal(HcfMd *self, HcfBlob *output)
         LOGE("Class is not match.");
         return HCF_INVALID_PARAMS;
     }
-    return ((HcfMdImpl *)self)->spiObj->engineDoFinalMd(
-        ((HcfMdImpl *)self)->spiObj, output);
+    HcfMdSpi *spiObj = ((HcfMdImpl *)self)->spiObj;
+    HcfResult ret = spiObj->engineDoFinalMd(spiObj, output);
+    if (spiObj->engineResetMd == NULL) {
+        return ret;
+    }
+    // start the next message even if this one failed, a md that can not do so is unusable
+    HcfResult resetRet = spiObj->engineResetMd(spiObj);
+    if ((ret == HCF_SUCCESS) && (resetRet != HCF_SUCCESS)) {
+        LOGE("Failed to reset md after doFinal!");
+        HcfBlobDataFree(output);
+        return resetRet;
+    }
+    return ret;
+}
+
+static HcfResult Reset(HcfMd *self)
+{
+    if (self == NULL) {
+        LOGE("The input self ptr is NULL!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetMdClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMdSpi *spiObj = ((HcfMdImpl *)self)->spiObj;
+    if (spiObj->engineResetMd == NULL) {
+        LOGE("Reset is not supported!");
+        return HCF_NOT_SUPPORT;
+    }
+    return spiObj->engineResetMd(spiObj);
 }
 
 static uint32_t GetMdLength(HcfMd *self)
@@ -109,6 +159,24 @@ static uint32_t GetMdLength(HcfMd *self)
         ((HcfMdImpl *)self)->spiObj);
 }
 
+static HcfResult SetMdLength(HcfMd *self, uint32_t len)
+{
+    if (self == NULL) {
+        LOGE("The input self ptr is NULL!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetMdClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMdSpi *spiObj = ((HcfMdImpl *)self)->spiObj;
+    if (spiObj->engineSetMdLength == NULL) {
+        LOGE("Set md length is not supported!");
+        return HCF_NOT_SUPPORT;
+    }
+    return spiObj->engineSetMdLength(spiObj, len);
+}
+
 static const char *GetAlgoName(HcfMd *self)
 {
     if (self == NULL) {
@@ -137,6 +205,61 @@ static void MdDestroy(HcfObjectBase *self)
     HcfFree(impl);
 }
 
+static HcfResult Clone(HcfMd *self, HcfMd **newMd);
+
+// wrap spiObj into a new md object, spiObj is destroyed on failure
+static HcfResult NewMdImpl(const char *algoName, HcfMdSpi *spiObj, HcfMd **mdApi)
+{
+    HcfMdImpl *impl = (HcfMdImpl *)HcfMalloc(sizeof(HcfMdImpl), 0);
+    if (impl == NULL) {
+        LOGE("Failed to allocate Md Obj memory!");
+        OH_HCF_OBJ_DESTROY(spiObj);
+        return HCF_ERR_MALLOC;
+    }
+    if (strcpy_s(impl->algoName, HCF_MAX_ALGO_NAME_LEN, algoName) != EOK) {
+        LOGE("Failed to copy algoName!");
+        OH_HCF_OBJ_DESTROY(spiObj);
+        HcfFree(impl);
+        return HCF_ERR_COPY;
+    }
+    impl->base.base.getClass = GetMdClass;
+    impl->base.base.destroy = MdDestroy;
+    impl->base.update = Update;
+    impl->base.doFinal = DoFinal;
+    impl->base.reset = Reset;
+    impl->base.getMdLength = GetMdLength;
+    impl->base.setMdLength = SetMdLength;
+    impl->base.clone = Clone;
+    impl->base.getAlgoName = GetAlgoName;
+    impl->spiObj = spiObj;
+    *mdApi = (HcfMd *)impl;
+    return HCF_SUCCESS;
+}
+
+static HcfResult Clone(HcfMd *self, HcfMd **newMd)
+{
+    if ((self == NULL) || (newMd == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetMdClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMdSpi *spiObj = ((HcfMdImpl *)self)->spiObj;
+    if (spiObj->engineCloneMd == NULL) {
+        LOGE("Clone is not supported!");
+        return HCF_NOT_SUPPORT;
+    }
+    HcfMdSpi *newSpi = NULL;
+    HcfResult res = spiObj->engineCloneMd(spiObj, &newSpi);
+    if (res != HCF_SUCCESS) {
+        LOGE("Failed to clone spi object!");
+        return res;
+    }
+    return NewMdImpl(((HcfMdImpl *)self)->algoName, newSpi, newMd);
+}
+
 HcfResult HcfMdCreate(const char *algoName, HcfMd **mdApi)
 {
     if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (mdApi == NULL)) {
@@ -148,30 +271,134 @@ HcfResult HcfMdCreate(const char *algoName, HcfMd **mdApi)
         LOGE("Algo not supported!");
         return HCF_NOT_SUPPORT;
     }
-    HcfMdImpl *returnMdApi = (HcfMdImpl *)HcfMalloc(sizeof(HcfMdImpl), 0);
-    if (returnMdApi == NULL) {
-        LOGE("Failed to allocate Md Obj memory!");
-        return HCF_ERR_MALLOC;
-    }
-    if (strcpy_s(returnMdApi->algoName, HCF_MAX_ALGO_NAME_LEN, algoName) != EOK) {
-        LOGE("Failed to copy algoName!");
-        HcfFree(returnMdApi);
-        return HCF_ERR_COPY;
-    }
     HcfMdSpi *spiObj = NULL;
     HcfResult res = createSpifunc(algoName, &spiObj);
     if (res != HCF_SUCCESS) {
         LOGE("Failed to create spi object!");
-        HcfFree(returnMdApi);
         return res;
     }
-    returnMdApi->base.base.getClass = GetMdClass;
-    returnMdApi->base.base.destroy = MdDestroy;
-    returnMdApi->base.update = Update;
-    returnMdApi->base.doFinal = DoFinal;
-    returnMdApi->base.getMdLength = GetMdLength;
-    returnMdApi->base.getAlgoName = GetAlgoName;
-    returnMdApi->spiObj = spiObj;
-    *mdApi = (HcfMd *)returnMdApi;
+    return NewMdImpl(algoName, spiObj, mdApi);
+}
+
+HcfResult HcfMdUpdateVec(HcfMd *md, const HcfBlob *inputs, uint32_t inputCount)
+{
+    if ((md == NULL) || !IsBlobArrayValid(inputs, inputCount)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)md, GetMdClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMdSpi *spiObj = ((HcfMdImpl *)md)->spiObj;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        if (inputs[i].len == 0) {
+            continue;
+        }
+        HcfBlob input = { .data = inputs[i].data, .len = inputs[i].len };
+        HcfResult ret = spiObj->engineUpdateMd(spiObj, &input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
     return HCF_SUCCESS;
-}
\ No newline at end of file
+}
+
+// the fallback of HcfMdDigestMany: one md for the whole batch, doFinal resets it for the next message
+static HcfResult DigestManyWithMd(const char *algoName, const HcfBlob *inputs, HcfBlob *outputs, uint32_t count)
+{
+    HcfMd *md = NULL;
+    HcfResult ret = HcfMdCreate(algoName, &md);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint32_t mdLen = md->getMdLength(md);
+    for (uint32_t i = 0; i < count; i++) {
+        if ((outputs[i].data == NULL) || (outputs[i].len < mdLen)) {
+            LOGE("Output %u is too short!", i);
+            OH_HCF_OBJ_DESTROY(md);
+            return HCF_INVALID_PARAMS;
+        }
+    }
+    for (uint32_t i = 0; (ret == HCF_SUCCESS) && (i < count); i++) {
+        HcfBlob input = { .data = inputs[i].data, .len = inputs[i].len };
+        HcfBlob digest = { .data = NULL, .len = 0 };
+        if (input.len > 0) {
+            ret = md->update(md, &input);
+        }
+        if (ret == HCF_SUCCESS) {
+            ret = md->doFinal(md, &digest);
+        }
+        if (ret == HCF_SUCCESS) {
+            (void)memcpy_s(outputs[i].data, outputs[i].len, digest.data, digest.len);
+            outputs[i].len = digest.len;
+        }
+        HcfBlobDataFree(&digest);
+    }
+    OH_HCF_OBJ_DESTROY(md);
+    return ret;
+}
+
+HcfResult HcfMdDigestMany(const char *algoName, const HcfBlob *inputs, HcfBlob *outputs, uint32_t count)
+{
+    if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (outputs == NULL) ||
+        !IsBlobArrayValid(inputs, count)) {
+        LOGE("Invalid input params while digesting many!");
+        return HCF_INVALID_PARAMS;
+    }
+    const HcfMdAbility *ability = FindMdAbility(algoName);
+    if (ability == NULL) {
+        return HCF_NOT_SUPPORT;
+    }
+    if (ability->digestManyFunc == NULL) {
+        return DigestManyWithMd(algoName, inputs, outputs, count);
+    }
+    return ability->digestManyFunc(algoName, inputs, outputs, count);
+}
+
+static HcfResult PoolCreateMd(const char *algoName, HcfObjectBase **obj)
+{
+    return HcfMdCreate(algoName, (HcfMd **)obj);
+}
+
+static bool PoolClearMd(HcfObjectBase *obj)
+{
+    // an output length set by the last user must not leak to the next one
+    HcfResult lenRet = SetMdLength((HcfMd *)obj, 0);
+    if ((lenRet != HCF_SUCCESS) && (lenRet != HCF_NOT_SUPPORT)) {
+        return false;
+    }
+    return (Reset((HcfMd *)obj) == HCF_SUCCESS);
+}
+
+static const char *PoolGetMdAlgoName(HcfObjectBase *obj)
+{
+    return ((HcfMdImpl *)obj)->algoName;
+}
+
+static const HcfObjectPoolType MD_POOL_TYPE = {
+    .create = PoolCreateMd,
+    .clear = PoolClearMd,
+    .getAlgoName = PoolGetMdAlgoName
+};
+
+HcfResult HcfMdPoolAcquire(const char *algoName, HcfMd **md)
+{
+    if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (md == NULL)) {
+        LOGE("Invalid input params while acquiring md!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HcfObjectPoolAcquire(&MD_POOL_TYPE, algoName, (HcfObjectBase **)md);
+}
+
+void HcfMdPoolRelease(HcfMd *md)
+{
+    if (md == NULL) {
+        return;
+    }
+    if (!IsClassMatch((HcfObjectBase *)md, GetMdClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfObjectPoolRelease(&MD_POOL_TYPE, (HcfObjectBase *)md);
+}
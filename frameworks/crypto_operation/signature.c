@@ -19,6 +19,7 @@
 
 #include "config.h"
 #include "ecdsa_openssl.h"
+#include "hcf_object_pool.h"
 #include "log.h"
 #include "memory.h"
 #include "params_parser.h"
@@ -289,7 +290,7 @@ HcfResult HcfSignCreate(const char *algoName, HcfSign **returnObj)
     }
 
     HcfSignatureParams params = { 0 };
-    if (ParseAndSetParameter(algoName, &params, ParseSignatureParams) != HCF_SUCCESS) {
+    if (ParseAndSetParameterCached(algoName, &params, sizeof(params), ParseSignatureParams) != HCF_SUCCESS) {
         LOGE("Failed to parser parmas!");
         return HCF_INVALID_PARAMS;
     }
@@ -337,7 +338,7 @@ HcfResult HcfVerifyCreate(const char *algoName, HcfVerify **returnObj)
         return HCF_INVALID_PARAMS;
     }
     HcfSignatureParams params = {0};
-    if (ParseAndSetParameter(algoName, &params, ParseSignatureParams) != HCF_SUCCESS) {
+    if (ParseAndSetParameterCached(algoName, &params, sizeof(params), ParseSignatureParams) != HCF_SUCCESS) {
         LOGE("Failed to parser parmas!");
         return HCF_INVALID_PARAMS;
     }
@@ -375,3 +376,98 @@ HcfResult HcfVerifyCreate(const char *algoName, HcfVerify **returnObj)
     LOGI("HcfVerifyCreate end");
     return HCF_SUCCESS;
 }
+
+HcfResult HcfSignUpdateVec(HcfSign *sign, const HcfBlob *inputs, uint32_t inputCount)
+{
+    if ((sign == NULL) || !IsBlobArrayValid(inputs, inputCount)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)sign, GetSignClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfSignSpi *spiObj = ((HcfSignImpl *)sign)->spiObj;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        if (inputs[i].len == 0) {
+            continue;
+        }
+        HcfBlob input = { .data = inputs[i].data, .len = inputs[i].len };
+        HcfResult ret = spiObj->engineUpdate(spiObj, &input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+HcfResult HcfVerifyUpdateVec(HcfVerify *verify, const HcfBlob *inputs, uint32_t inputCount)
+{
+    if ((verify == NULL) || !IsBlobArrayValid(inputs, inputCount)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)verify, GetVerifyClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfVerifySpi *spiObj = ((HcfVerifyImpl *)verify)->spiObj;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        if (inputs[i].len == 0) {
+            continue;
+        }
+        HcfBlob input = { .data = inputs[i].data, .len = inputs[i].len };
+        HcfResult ret = spiObj->engineUpdate(spiObj, &input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult PoolCreateSign(const char *algoName, HcfObjectBase **obj)
+{
+    return HcfSignCreate(algoName, (HcfSign **)obj);
+}
+
+static bool PoolClearSign(HcfObjectBase *obj)
+{
+    HcfSignImpl *impl = (HcfSignImpl *)obj;
+    if (impl->spiObj->engineClear == NULL) {
+        return false;
+    }
+    impl->spiObj->engineClear(impl->spiObj);
+    return true;
+}
+
+static const char *PoolGetSignAlgoName(HcfObjectBase *obj)
+{
+    return ((HcfSignImpl *)obj)->algoName;
+}
+
+static const HcfObjectPoolType SIGN_POOL_TYPE = {
+    .create = PoolCreateSign,
+    .clear = PoolClearSign,
+    .getAlgoName = PoolGetSignAlgoName
+};
+
+HcfResult HcfSignPoolAcquire(const char *algoName, HcfSign **sign)
+{
+    if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (sign == NULL)) {
+        LOGE("Invalid input params while acquiring sign!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HcfObjectPoolAcquire(&SIGN_POOL_TYPE, algoName, (HcfObjectBase **)sign);
+}
+
+void HcfSignPoolRelease(HcfSign *sign)
+{
+    if (sign == NULL) {
+        return;
+    }
+    if (!IsClassMatch((HcfObjectBase *)sign, GetSignClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfObjectPoolRelease(&SIGN_POOL_TYPE, (HcfObjectBase *)sign);
+}
@@ -218,7 +218,7 @@ HcfResult HcfAsyKeyGeneratorCreate(const char *algoName, HcfAsyKeyGenerator **re
     }
 
     HcfAsyKeyGenParams params = { 0 };
-    if (ParseAndSetParameter(algoName, &params, ParseAsyKeyGenParams) != HCF_SUCCESS) {
+    if (ParseAndSetParameterCached(algoName, &params, sizeof(params), ParseAsyKeyGenParams) != HCF_SUCCESS) {
         LOGE("Failed to parser parmas!");
         return HCF_INVALID_PARAMS;
     }
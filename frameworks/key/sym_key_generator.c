@@ -29,6 +29,9 @@
 #define AES_KEY_SIZE_192 192
 #define AES_KEY_SIZE_256 256
 #define DES_KEY_SIZE_192 192
+#define CHACHA20_KEY_SIZE_256 256
+#define XTS_KEY_NUM 2
+#define ETM_KEY_NUM 2
 
 typedef HcfResult (*SymKeyGeneratorSpiCreateFunc)(SymKeyAttr *, OH_HCF_SymKeyGeneratorSpi **);
 
@@ -49,7 +52,8 @@ typedef struct {
 
 static const SymKeyGenAbility SYMKEY_ABILITY_SET[] = {
     { HCF_ALG_AES, { HcfSymKeyGeneratorSpiCreate }},
-    { HCF_ALG_DES, { HcfSymKeyGeneratorSpiCreate }}
+    { HCF_ALG_DES, { HcfSymKeyGeneratorSpiCreate }},
+    { HCF_ALG_CHACHA20, { HcfSymKeyGeneratorSpiCreate }}
 };
 
 static const SymKeyGenFuncSet *FindAbility(SymKeyAttr *attr)
@@ -86,6 +90,11 @@ static void SetKeyLength(HCF_ALG_PARA_VALUE value, void *attr)
         case HCF_ALG_3DES_192:
             keyAttr->algo = HCF_ALG_DES;
             keyAttr->keySize = DES_KEY_SIZE_192;
+            break;
+        case HCF_ALG_CHACHA20_256:
+            keyAttr->algo = HCF_ALG_CHACHA20;
+            keyAttr->keySize = CHACHA20_KEY_SIZE_256;
+            break;
         default:
             break;
     }
@@ -103,6 +112,18 @@ static HcfResult OnSetSymKeyParameter(const HcfParaConfig* config, void *attr)
         case HCF_ALG_KEY_TYPE:
             SetKeyLength(config->paraValue, attr);
             break;
+        case HCF_ALG_MODE:
+            /* only xts changes the key, "AES256|XTS" is a data key and a tweak key of 256 bits each */
+            if (config->paraValue != HCF_ALG_MODE_XTS) {
+                ret = HCF_INVALID_PARAMS;
+                break;
+            }
+            ((SymKeyAttr *)attr)->mode = config->paraValue;
+            break;
+        case HCF_ALG_MAC_DIGEST:
+            /* "AES256|HMAC-SHA256" is the mac key and the aes key of an encrypt-then-mac cipher */
+            ((SymKeyAttr *)attr)->macMd = config->paraValue;
+            break;
         default:
             ret = HCF_INVALID_PARAMS;
             break;
@@ -110,6 +131,27 @@ static HcfResult OnSetSymKeyParameter(const HcfParaConfig* config, void *attr)
     return ret;
 }
 
+static HcfResult ApplyKeyMode(SymKeyAttr *attr)
+{
+    if (attr->macMd != 0) {
+        if ((attr->algo != HCF_ALG_AES) || (attr->mode != 0)) {
+            LOGE("encrypt-then-mac keys are only AES without a mode!");
+            return HCF_INVALID_PARAMS;
+        }
+        attr->keySize *= ETM_KEY_NUM;
+        return HCF_SUCCESS;
+    }
+    if (attr->mode != HCF_ALG_MODE_XTS) {
+        return HCF_SUCCESS;
+    }
+    if ((attr->algo != HCF_ALG_AES) || (attr->keySize == AES_KEY_SIZE_192)) {
+        LOGE("xts keys are only AES128 or AES256!");
+        return HCF_INVALID_PARAMS;
+    }
+    attr->keySize *= XTS_KEY_NUM;
+    return HCF_SUCCESS;
+}
+
 static const char *GetSymKeyGeneratorClass(void)
 {
     return "HcfSymKeyGenerator";
@@ -175,6 +217,50 @@ static HcfResult ConvertSymmKey(HcfSymKeyGenerator *self, const HcfBlob *key, Hc
     return impl->spiObj->engineConvertSymmKey(impl->spiObj, key, symmKey);
 }
 
+static HcfResult WrapSymmKey(HcfSymKeyGenerator *self, HcfKeyWrapMode mode, HcfSymKey *kek, HcfSymKey *key,
+    HcfBlob *wrapped)
+{
+    if ((self == NULL) || (kek == NULL) || (key == NULL) || (wrapped == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetSymKeyGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfSymmKeyGeneratorImpl *impl = (HcfSymmKeyGeneratorImpl *)self;
+    if (impl->spiObj->engineWrapSymmKey == NULL) {
+        LOGE("Algo not support key wrap!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->engineWrapSymmKey(impl->spiObj, mode, kek, key, wrapped);
+}
+
+static HcfResult UnwrapSymmKeyBatch(HcfSymKeyGenerator *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+    const HcfBlob *wrapped, HcfSymKey **symmKeys, uint32_t count)
+{
+    if ((self == NULL) || (kek == NULL) || (wrapped == NULL) || (symmKeys == NULL) || (count == 0)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetSymKeyGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfSymmKeyGeneratorImpl *impl = (HcfSymmKeyGeneratorImpl *)self;
+    if (impl->spiObj->engineUnwrapSymmKey == NULL) {
+        LOGE("Algo not support key unwrap!");
+        return HCF_NOT_SUPPORT;
+    }
+    return impl->spiObj->engineUnwrapSymmKey(impl->spiObj, mode, kek, wrapped, symmKeys, count);
+}
+
+static HcfResult UnwrapSymmKey(HcfSymKeyGenerator *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+    const HcfBlob *wrapped, HcfSymKey **symmKey)
+{
+    return UnwrapSymmKeyBatch(self, mode, kek, wrapped, symmKey, 1);
+}
+
 HcfResult HcfSymKeyGeneratorCreate(const char *algoName, HcfSymKeyGenerator **generator)
 {
     if (!IsStrValid(algoName, HCF_MAX_ALGO_NAME_LEN) || (generator == NULL)) {
@@ -183,7 +269,8 @@ HcfResult HcfSymKeyGeneratorCreate(const char *algoName, HcfSymKeyGenerator **ge
     }
     
     SymKeyAttr attr = {0};
-    if (ParseAndSetParameter(algoName, (void *)&attr, OnSetSymKeyParameter) != HCF_SUCCESS) {
+    if ((ParseAndSetParameterCached(algoName, (void *)&attr, sizeof(attr), OnSetSymKeyParameter) != HCF_SUCCESS) ||
+        (ApplyKeyMode(&attr) != HCF_SUCCESS)) {
         LOGE("ParseAndSetParameter Failed!");
         return HCF_NOT_SUPPORT;
     }
@@ -215,6 +302,9 @@ HcfResult HcfSymKeyGeneratorCreate(const char *algoName, HcfSymKeyGenerator **ge
     returnGenerator->base.base.destroy = DestroySymmKeyGenerator;
     returnGenerator->base.base.getClass = GetSymKeyGeneratorClass;
     returnGenerator->base.getAlgoName = GetAlgoName;
+    returnGenerator->base.wrapSymKey = WrapSymmKey;
+    returnGenerator->base.unwrapSymKey = UnwrapSymmKey;
+    returnGenerator->base.unwrapSymKeyBatch = UnwrapSymmKeyBatch;
     returnGenerator->spiObj = spiObj;
 
     *generator = (HcfSymKeyGenerator *)returnGenerator;
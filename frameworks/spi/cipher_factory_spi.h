@@ -16,6 +16,7 @@
 #ifndef HCF_CIPHER_FACTORY_SPI_H
 #define HCF_CIPHER_FACTORY_SPI_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "cipher.h"
 #include "algorithm_parameter.h"
@@ -35,6 +36,31 @@ struct OH_HCF_CipherGeneratorSpi {
     HcfResult (*update)(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output);
 
     HcfResult (*doFinal)(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output);
+
+    HcfResult (*getOutputSize)(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+        uint32_t *outputLen);
+
+    HcfResult (*updateToBuffer)(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output);
+
+    HcfResult (*doFinalToBuffer)(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output);
+
+    HcfResult (*reset)(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params);
+
+    HcfResult (*setCipherSpecUint)(OH_HCF_CipherGeneratorSpi *self, CipherSpecItem item, uint32_t value);
+
+    HcfResult (*updateAad)(OH_HCF_CipherGeneratorSpi *self, HcfBlob *aad);
+
+    HcfResult (*aeadBatch)(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode, HcfKey *key,
+        const HcfCipherBatchParams *params, HcfCipherBatchItem *items, uint32_t count);
+
+    HcfResult (*cryptSectors)(OH_HCF_CipherGeneratorSpi *self, const HcfCipherSectorParams *params,
+        HcfBlob *input, HcfBlob *output);
+
+    HcfResult (*aeadInPlace)(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode, HcfCipherPacket *packet);
+
+    HcfResult (*seek)(OH_HCF_CipherGeneratorSpi *self, uint64_t offset);
+
+    void (*clear)(OH_HCF_CipherGeneratorSpi *self);
 };
 
 #endif
@@ -32,6 +32,10 @@ struct HcfMacSpi {
     HcfResult (*engineDoFinalMac)(HcfMacSpi *self, HcfBlob *output);
     // get the length of chosen hash algo
     uint32_t (*engineGetMacLength)(HcfMacSpi *self);
+    // drop the key and the running state
+    void (*engineClearMac)(HcfMacSpi *self);
+    // copy the key and the running state into a new spi
+    HcfResult (*engineCloneMac)(HcfMacSpi *self, HcfMacSpi **newSpi);
 };
 
 #endif
\ No newline at end of file
@@ -31,6 +31,12 @@ struct HcfMdSpi {
     HcfResult (*engineDoFinalMd)(HcfMdSpi *self, HcfBlob *output);
 
     uint32_t (*engineGetMdLength)(HcfMdSpi *self);
+
+    HcfResult (*engineResetMd)(HcfMdSpi *self);
+
+    HcfResult (*engineSetMdLength)(HcfMdSpi *self, uint32_t len);
+
+    HcfResult (*engineCloneMd)(HcfMdSpi *self, HcfMdSpi **newSpi);
 };
 
 #endif
\ No newline at end of file
@@ -36,6 +36,8 @@ struct HcfSignSpi {
     HcfResult (*engineUpdate)(HcfSignSpi *self, HcfBlob *data);
 
     HcfResult (*engineSign)(HcfSignSpi *self, HcfBlob *data, HcfBlob *returnSignatureData);
+
+    void (*engineClear)(HcfSignSpi *self);
 };
 
 typedef struct HcfVerifySpi HcfVerifySpi;
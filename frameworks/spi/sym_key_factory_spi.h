@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include "result.h"
 #include "sym_key.h"
+#include "sym_key_generator.h"
 
 typedef struct OH_HCF_SymKeyGeneratorSpi OH_HCF_SymKeyGeneratorSpi;
 
@@ -26,6 +27,10 @@ struct OH_HCF_SymKeyGeneratorSpi {
     HcfObjectBase base;
     HcfResult (*engineGenerateSymmKey)(OH_HCF_SymKeyGeneratorSpi *self, HcfSymKey **symmKey);
     HcfResult (*engineConvertSymmKey)(OH_HCF_SymKeyGeneratorSpi *self, const HcfBlob *key, HcfSymKey **symmKey);
+    HcfResult (*engineWrapSymmKey)(OH_HCF_SymKeyGeneratorSpi *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+        HcfSymKey *key, HcfBlob *wrapped);
+    HcfResult (*engineUnwrapSymmKey)(OH_HCF_SymKeyGeneratorSpi *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+        const HcfBlob *wrapped, HcfSymKey **symmKeys, uint32_t count);
 };
 #define OPENSSL_SYM_GENERATOR_CLASS "OPENSSL.SYM.KEYGENERATOR"
 #define OPENSSL_SYM_KEY_CLASS "OPENSSL.SYM.KEY"
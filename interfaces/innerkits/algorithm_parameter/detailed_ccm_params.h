@@ -16,6 +16,7 @@
 #ifndef HCF_DETAILED_CCM_PARAMS_H
 #define HCF_DETAILED_CCM_PARAMS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "algorithm_parameter.h"
 #include "blob.h"
@@ -27,6 +28,13 @@ struct HcfCcmParamsSpec {
     HcfBlob iv;
     HcfBlob aad;
     HcfBlob tag;
+    /*
+     * When isDataLenSet, dataLen is the total length of the message data (without the tag) and update
+     * may be called any number of times, so the message streams with bounded memory. Otherwise the
+     * whole message has to be passed to a single update or doFinal.
+     */
+    bool isDataLenSet;
+    uint64_t dataLen;
 };
 
 #endif // HCF_DETAILED_CCM_PARAMS_H
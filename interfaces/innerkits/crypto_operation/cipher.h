@@ -16,6 +16,8 @@
 #ifndef HCF_CIPHER_H
 #define HCF_CIPHER_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "blob.h"
 #include "key.h"
 #include "algorithm_parameter.h"
@@ -36,6 +38,66 @@ enum HcfCryptoMode {
     DECRYPT_MODE = 1,
 };
 
+typedef enum {
+    /* inputs of at least this many bytes are split over threads where the mode allows it */
+    CIPHER_PARALLEL_THRESHOLD = 0,
+    /* number of threads used for such inputs, defaults to 1, 0 or 1 keeps the parallel engine off */
+    CIPHER_PARALLEL_THREAD_NUM = 1,
+    /*
+     * non zero makes a one shot AES-GCM decrypt check the tag before it decrypts, a forged message is rejected
+     * after a single pass and gets no output buffer. Takes effect from the next init or reset.
+     */
+    CIPHER_GCM_VERIFY_FIRST = 2,
+} CipherSpecItem;
+
+/**
+ * @brief One message of a batch AEAD operation.
+ *
+ * For seal, input is the plaintext and output receives ciphertext || tag.
+ * For open, input is ciphertext || tag and output receives the plaintext.
+ * output->data and output->len describe a caller buffer and its capacity, output->len is set to the
+ * number of bytes written. result is the status of this message.
+ */
+typedef struct {
+    HcfBlob iv;
+    HcfBlob aad;
+    HcfBlob input;
+    HcfBlob output;
+    HcfResult result;
+} HcfCipherBatchItem;
+
+typedef struct {
+    /* length of the tag appended to every ciphertext */
+    uint32_t tagLen;
+    /* number of threads to spread the batch over, 0 or 1 runs on the calling thread */
+    uint32_t threadNum;
+} HcfCipherBatchParams;
+
+/**
+ * @brief A run of consecutive sectors of a storage device for a sector cipher such as "AES256|XTS|NoPadding".
+ *
+ * The tweak of sector n is n as a 128 bit little endian number, the same as the plain64 iv of dm-crypt.
+ */
+typedef struct {
+    /* number of the first sector of the input */
+    uint64_t startSector;
+    /* bytes per sector, at least 16, the input holds a whole number of sectors */
+    uint32_t sectorSize;
+} HcfCipherSectorParams;
+
+/**
+ * @brief A packet buffer for in place AEAD.
+ *
+ * The payload is data[offset, offset + len). The headroom before it is not touched, the tailroom after it,
+ * up to capacity, receives the tag on seal.
+ */
+typedef struct {
+    uint8_t *data;
+    uint32_t capacity;
+    uint32_t offset;
+    uint32_t len;
+} HcfCipherPacket;
+
 typedef struct HcfCipher HcfCipher;
 /**
  * @brief his class provides cipher algorithms for cryptographic operations,
@@ -55,6 +117,55 @@ struct HcfCipher {
     HcfResult (*doFinal)(HcfCipher *self, HcfBlob *input, HcfBlob *output);
 
     const char *(*getAlgorithm)(HcfCipher *self);
+
+    /**
+     * @brief Get the maximum number of bytes the next update or doFinal call can output.
+     *
+     * @param inputLen Length of the input that will be passed to the next call.
+     * @param isFinal Whether the size is queried for doFinal instead of update.
+     * @param outputLen Returns the required output buffer capacity.
+     */
+    HcfResult (*getOutputSize)(HcfCipher *self, uint32_t inputLen, bool isFinal, uint32_t *outputLen);
+
+    /**
+     * @brief Same as update, but writes into a buffer owned by the caller.
+     *
+     * output->data and output->len describe the caller buffer and its capacity, which must be at least
+     * the size returned by getOutputSize. On success output->len is set to the number of bytes written.
+     */
+    HcfResult (*updateToBuffer)(HcfCipher *self, HcfBlob *input, HcfBlob *output);
+
+    /**
+     * @brief Same as doFinal, but writes into a buffer owned by the caller, see updateToBuffer.
+     */
+    HcfResult (*doFinalToBuffer)(HcfCipher *self, HcfBlob *input, HcfBlob *output);
+
+    /**
+     * @brief Start a new message with the key and mode of the last init, only swapping iv, aad and tag.
+     *
+     * The cipher context and the expanded key are kept, so this is much cheaper than calling init again.
+     * It may be called after doFinal or in the middle of a message, which drops the unfinished message.
+     *
+     * @param params The new iv, gcm or ccm params of the message, same as the params of init.
+     */
+    HcfResult (*reset)(HcfCipher *self, HcfParamsSpec *params);
+
+    /**
+     * @brief Set an unsigned integer option of the cipher, see CipherSpecItem.
+     *
+     * AES splits ECB, CTR and CBC decrypt updates and one shot GCM doFinal above the threshold, the
+     * output is identical to the single thread path.
+     */
+    HcfResult (*setCipherSpecUint)(HcfCipher *self, CipherSpecItem item, uint32_t value);
+
+    /**
+     * @brief Feed more additional authenticated data of a GCM or CCM message, after the aad of the params.
+     *
+     * May be called any number of times between init (or reset) and the first update or doFinal, the
+     * aad may be empty and has no upper bound. GCM authenticates every chunk directly without copying it,
+     * CCM buffers the aad because its length has to be known before the first chunk is processed.
+     */
+    HcfResult (*updateAad)(HcfCipher *self, HcfBlob *aad);
 };
 
 #ifdef __cplusplus
@@ -72,6 +183,151 @@ extern "C" {
  */
 HcfResult HcfCipherCreate(const char *algoName, HcfCipher **returnObj);
 
+/**
+ * @brief Encrypt and authenticate a batch of messages under one key, the key schedule is computed once.
+ *
+ * @param cipher An AEAD cipher object, such as "AES128|GCM|NoPadding". It is not initialized by this call.
+ * @param key The key of all messages.
+ * @param params The tag length and number of worker threads.
+ * @param items The messages, see HcfCipherBatchItem.
+ * @param count The number of messages.
+ * @return HCF_SUCCESS if all messages succeed, otherwise the first failure. Each item keeps its own result.
+ */
+HcfResult HcfCipherSealBatch(HcfCipher *cipher, HcfKey *key, const HcfCipherBatchParams *params,
+    HcfCipherBatchItem *items, uint32_t count);
+
+/**
+ * @brief Verify and decrypt a batch of messages under one key, see HcfCipherSealBatch.
+ *
+ * The output of a message that fails authentication is cleared.
+ */
+HcfResult HcfCipherOpenBatch(HcfCipher *cipher, HcfKey *key, const HcfCipherBatchParams *params,
+    HcfCipherBatchItem *items, uint32_t count);
+
+/**
+ * @brief Encrypt or decrypt consecutive sectors in one call with the expanded keys of the last init.
+ *
+ * @param cipher A sector cipher initialized with the key and the direction, the iv of init is not used.
+ * @param params The first sector number and the sector size.
+ * @param input A whole number of sectors.
+ * @param output A caller buffer of at least input->len bytes, may be the input buffer. On success
+ * output->len is set to input->len.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherCryptSectors(HcfCipher *cipher, const HcfCipherSectorParams *params, HcfBlob *input,
+    HcfBlob *output);
+
+/**
+ * @brief Update the cipher with the concatenation of several input segments.
+ *
+ * The same as one update with the segments joined. Short segments are gathered into one update, long
+ * segments are passed on as they are. Do not use it with modes that take only one update per message, such as CCM.
+ *
+ * @param cipher An initialized cipher.
+ * @param inputs The input segments, empty segments are skipped.
+ * @param inputCount The number of input segments.
+ * @param output Allocated by this call, free it with HcfBlobDataFree.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherUpdateVec(HcfCipher *cipher, const HcfBlob *inputs, uint32_t inputCount, HcfBlob *output);
+
+/**
+ * @brief Update the cipher with several input segments and write the output across caller segments.
+ *
+ * The output fills the segments in order. Output of a long input is written in place, output of up to 2 KiB
+ * goes through a bounce buffer. On success outputs[i].len is set to the bytes written to segment i.
+ * On failure the contents of the segments are undefined and the cipher must be initialized again.
+ *
+ * @param cipher An initialized cipher that supports updateToBuffer.
+ * @param inputs The input segments, empty segments are skipped.
+ * @param inputCount The number of input segments.
+ * @param outputs The output segments, len is the capacity of each segment.
+ * @param outputCount The number of output segments.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherUpdateVecToBuffers(HcfCipher *cipher, const HcfBlob *inputs, uint32_t inputCount,
+    HcfBlob *outputs, uint32_t outputCount);
+
+/**
+ * @brief Encrypt the payload of a packet in place and append the tag in its tailroom, see HcfCipherPacket.
+ *
+ * This finishes the message like doFinal, without allocating an output. The tag length is the one of the
+ * init params.
+ *
+ * @param cipher An AEAD cipher such as "AES128|GCM|NoPadding", initialized for encryption.
+ * @param packet The packet, on success len is increased by the tag length.
+ * @return HCF_INVALID_PARAMS if the tailroom can not hold the tag, otherwise the status code of the execution.
+ */
+HcfResult HcfCipherSealInPlace(HcfCipher *cipher, HcfCipherPacket *packet);
+
+/**
+ * @brief Verify and decrypt a payload of ciphertext || tag in place, see HcfCipherSealInPlace.
+ *
+ * The tag of the payload is used instead of the tag of the init params. On success len is decreased
+ * by the tag length. If authentication fails the decrypted bytes are cleared.
+ */
+HcfResult HcfCipherOpenInPlace(HcfCipher *cipher, HcfCipherPacket *packet);
+
+/**
+ * @brief Move a stream cipher to a byte offset of the message, such as for a range read of a ctr object.
+ *
+ * The next update starts at keystream byte offset, counted from the iv of init. Only the counter is set,
+ * the bytes before offset are not processed.
+ *
+ * @param cipher A cipher such as "AES128|CTR|NoPadding", initialized with a 16 byte iv.
+ * @param offset The byte offset in the message, it may be before the current position.
+ * @return HCF_NOT_SUPPORT for other modes, otherwise the status code of the execution.
+ */
+HcfResult HcfCipherSeek(HcfCipher *cipher, uint64_t offset);
+
+/**
+ * @brief Re-encrypt a message from one key to another without holding its plaintext.
+ *
+ * The input is decrypted and encrypted again in tiles of 16 KiB. The plaintext of a tile exists only in
+ * a stack buffer that is wiped after the tile. Both messages are finished like doFinal. Modes that take
+ * only one update per message, such as CCM, are not supported.
+ *
+ * @param decryptor A cipher initialized to decrypt the input with the old key.
+ * @param encryptor A cipher initialized to encrypt with the new key.
+ * @param input The whole ciphertext under the old key.
+ * @param output A caller buffer and its capacity, at least getOutputSize of the encryptor for the input
+ * length plus one block. On success output->len is set to the bytes written, on failure output is cleared.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherRekey(HcfCipher *decryptor, HcfCipher *encryptor, const HcfBlob *input, HcfBlob *output);
+
+/**
+ * @brief HcfCipherRekey on count threads, for ciphers that can seek such as "AES256|CTR|NoPadding".
+ *
+ * The input is split into count stripes of whole tiles, stripe i runs on decryptors[i] and encryptors[i].
+ * Every pair is initialized like for HcfCipherRekey, with the same keys and ivs. The stripes are not
+ * finished, the ciphers must be initialized again before other use.
+ *
+ * @param output A caller buffer of at least input->len bytes, output->len is set to input->len.
+ */
+HcfResult HcfCipherRekeyParallel(HcfCipher **decryptors, HcfCipher **encryptors, uint32_t count,
+    const HcfBlob *input, HcfBlob *output);
+
+/**
+ * @brief Take a cipher of the transformation from the object pool, or create one if none is pooled.
+ *
+ * The pool of the calling thread is searched first, then the shared overflow. A pooled cipher holds no
+ * key and must be initialized before use, like a created one.
+ *
+ * @param transformation The same string as for HcfCipherCreate.
+ * @param cipher The acquired cipher, give it back with HcfCipherPoolRelease or destroy it.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherPoolAcquire(const char *transformation, HcfCipher **cipher);
+
+/**
+ * @brief Wipe the key and message state of cipher and keep it for a later acquire.
+ *
+ * Ciphers whose algorithm can not be wiped in place, and ciphers released while the pools are full,
+ * are destroyed instead. cipher must not be used after this call.
+ */
+void HcfCipherPoolRelease(HcfCipher *cipher);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HCF_CIPHER_CONTAINER_H
+#define HCF_CIPHER_CONTAINER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "blob.h"
+#include "object_base.h"
+#include "result.h"
+#include "sym_key.h"
+
+/*
+ * A container of a file encrypted with AES-GCM in chunks that are authenticated on their own:
+ *
+ *     header || chunk 0 || chunk 1 || ... || chunk n - 1
+ *
+ * The header is the magic "HCFC", the version 2, a random 7 byte container id and the chunk size as a 32 bit
+ * big endian number. Chunk k is a 12 byte nonce, the ciphertext of plaintext bytes
+ * [k * chunkSize, (k + 1) * chunkSize) and a 16 byte tag. Only the last chunk may be shorter, down to an
+ * empty one for an empty file.
+ *
+ * Every seal of a chunk draws a fresh random nonce, so sealing a chunk again, as an append does with a short
+ * last chunk, never repeats a nonce under the key. The aad of chunk k is the header || k as 32 bit big endian
+ * || 1 for the last chunk, else 0. So chunks can not be reordered, dropped from the end or moved to another
+ * container. Chunk k starts at HCF_CONTAINER_HEADER_LEN + k * (chunkSize + HCF_CONTAINER_CHUNK_OVERHEAD), the
+ * index of the container is this formula, so finding and opening one chunk takes constant work.
+ */
+#define HCF_CONTAINER_HEADER_LEN 16
+#define HCF_CONTAINER_NONCE_LEN 12
+#define HCF_CONTAINER_TAG_LEN 16
+#define HCF_CONTAINER_CHUNK_OVERHEAD (HCF_CONTAINER_NONCE_LEN + HCF_CONTAINER_TAG_LEN)
+#define HCF_CONTAINER_MAX_CHUNK_SIZE (64 * 1024 * 1024)
+
+typedef struct {
+    /* plaintext bytes per chunk, 1 to HCF_CONTAINER_MAX_CHUNK_SIZE */
+    uint32_t chunkSize;
+    /* number of threads to spread the chunks of one call over, 0 or 1 runs on the calling thread */
+    uint32_t threadNum;
+} HcfCipherContainerParams;
+
+typedef struct HcfCipherContainer HcfCipherContainer;
+
+struct HcfCipherContainer {
+    HcfObjectBase base;
+
+    /* Copy the header into a caller buffer of at least HCF_CONTAINER_HEADER_LEN bytes. */
+    HcfResult (*getHeader)(HcfCipherContainer *self, HcfBlob *header);
+
+    uint32_t (*getChunkSize)(HcfCipherContainer *self);
+
+    /* The number of chunks of a whole container of containerLen bytes, header included. */
+    HcfResult (*getChunkCount)(HcfCipherContainer *self, uint64_t containerLen, uint32_t *count);
+
+    /* The offset of chunk k in the container, header included. */
+    uint64_t (*getChunkOffset)(HcfCipherContainer *self, uint32_t chunk);
+
+    /*
+     * Encrypt consecutive chunks starting at firstChunk. input holds whole chunks, unless isLast: then the
+     * last chunk of input is the last of the file and may be shorter or, for an empty file, empty.
+     * output is a caller buffer and its capacity, output->len is set to the bytes written.
+     */
+    HcfResult (*sealChunks)(HcfCipherContainer *self, uint32_t firstChunk, bool isLast, HcfBlob *input,
+        HcfBlob *output);
+
+    /*
+     * Verify and decrypt consecutive chunks starting at firstChunk, see sealChunks. isLast tells whether
+     * input ends with the last chunk of the container. If a chunk fails to verify, nothing is returned.
+     */
+    HcfResult (*openChunks)(HcfCipherContainer *self, uint32_t firstChunk, bool isLast, HcfBlob *input,
+        HcfBlob *output);
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start a new container with a random container id.
+ *
+ * @param key An AES key, it must live as long as the container.
+ * @param params The chunk size and the number of threads.
+ * @param returnObj The container, write its header in front of the chunks.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherContainerCreate(HcfSymKey *key, const HcfCipherContainerParams *params,
+    HcfCipherContainer **returnObj);
+
+/**
+ * @brief Load an existing container from its header, to read or append chunks.
+ *
+ * An append seals the short last chunk again, it gets a fresh nonce like any other seal.
+ *
+ * @param key The AES key of the container, it must live as long as the container.
+ * @param header The first HCF_CONTAINER_HEADER_LEN bytes of the container.
+ * @param threadNum The number of threads, see HcfCipherContainerParams.
+ * @param returnObj The container.
+ * @return Returns the status code of the execution.
+ */
+HcfResult HcfCipherContainerLoad(HcfSymKey *key, const HcfBlob *header, uint32_t threadNum,
+    HcfCipherContainer **returnObj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
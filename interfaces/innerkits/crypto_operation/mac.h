@@ -35,6 +35,9 @@ struct HcfMac {
 
     uint32_t (*getMacLength)(HcfMac *self);
 
+    // copy the key and the data updated so far into a new mac, the two continue independently
+    HcfResult (*clone)(HcfMac *self, HcfMac **newMac);
+
     const char *(*getAlgoName)(HcfMac *self);
 };
 
@@ -44,6 +47,15 @@ extern "C" {
 
 HcfResult HcfMacCreate(const char *algoName, HcfMac **mac);
 
+// update mac with each of the input segments in order, empty segments are skipped
+HcfResult HcfMacUpdateVec(HcfMac *mac, const HcfBlob *inputs, uint32_t inputCount);
+
+// take a mac of algoName from the object pool or create one, the mac must be initialized with a key
+HcfResult HcfMacPoolAcquire(const char *algoName, HcfMac **mac);
+
+// drop the key of mac and keep it for a later acquire, mac must not be used after this call
+void HcfMacPoolRelease(HcfMac *mac);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,10 @@
 #include "result.h"
 #include "object_base.h"
 
+// "SHA256-TREE" is the merkle tree hash of RFC 6962 with SHA-256 over leaves of HCF_TREE_MD_LEAF_LEN bytes, the
+// last leaf may be shorter. Leaves are hashed on all cores, the digest only depends on the input.
+#define HCF_TREE_MD_LEAF_LEN (64 * 1024)
+
 typedef struct HcfMd HcfMd;
 
 struct HcfMd {
@@ -27,10 +31,22 @@ struct HcfMd {
 
     HcfResult (*update)(HcfMd *self, HcfBlob *input);
 
+    // the md is reset afterwards, ready for the next message
     HcfResult (*doFinal)(HcfMd *self, HcfBlob *output);
 
+    // drop the data updated so far and start a new message
+    HcfResult (*reset)(HcfMd *self);
+
     uint32_t (*getMdLength)(HcfMd *self);
 
+    // set the output length in bytes of "SHAKE128" and "SHAKE256", 0 restores the default of 16 and 32 bytes.
+    // The length is kept across doFinal and reset, mds of fixed length return HCF_NOT_SUPPORT.
+    HcfResult (*setMdLength)(HcfMd *self, uint32_t len);
+
+    // copy the data updated so far and the output length into a new md, the two continue independently.
+    // Hash a shared prefix once and clone it for each message that starts with it.
+    HcfResult (*clone)(HcfMd *self, HcfMd **newMd);
+
     const char *(*getAlgoName)(HcfMd *self);
 };
 
@@ -40,6 +56,19 @@ extern "C" {
 
 HcfResult HcfMdCreate(const char *algoName, HcfMd **md);
 
+// update md with each of the input segments in order, empty segments are skipped
+HcfResult HcfMdUpdateVec(HcfMd *md, const HcfBlob *inputs, uint32_t inputCount);
+
+// hash each of the count messages on its own, outputs[i] is a caller buffer of at least the md length and its len
+// is set to the md length. Empty messages are allowed, on failure the content of outputs is undefined.
+HcfResult HcfMdDigestMany(const char *algoName, const HcfBlob *inputs, HcfBlob *outputs, uint32_t count);
+
+// take a md of algoName from the object pool or create one, the md is ready for update
+HcfResult HcfMdPoolAcquire(const char *algoName, HcfMd **md);
+
+// reset md and keep it for a later acquire, md must not be used after this call
+void HcfMdPoolRelease(HcfMd *md);
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,6 +58,17 @@ HcfResult HcfSignCreate(const char *algoName, HcfSign **returnObj);
 
 HcfResult HcfVerifyCreate(const char *algoName, HcfVerify **returnObj);
 
+// update sign or verify with each of the input segments in order, empty segments are skipped
+HcfResult HcfSignUpdateVec(HcfSign *sign, const HcfBlob *inputs, uint32_t inputCount);
+
+HcfResult HcfVerifyUpdateVec(HcfVerify *verify, const HcfBlob *inputs, uint32_t inputCount);
+
+// take a sign of algoName from the object pool or create one, the sign must be initialized with a key
+HcfResult HcfSignPoolAcquire(const char *algoName, HcfSign **sign);
+
+// drop the private key of sign and keep it for a later acquire, sign must not be used after this call
+void HcfSignPoolRelease(HcfSign *sign);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,16 @@
  */
 typedef struct HcfSymKeyGenerator HcfSymKeyGenerator;
 
+/**
+ * @brief AES key wrap algorithms, the key encryption key is an AES128, AES192 or AES256 key.
+ */
+typedef enum {
+    /* RFC 3394, the wrapped key is a multiple of 8 bytes and at least 16 bytes */
+    HCF_KEY_WRAP_AES = 0,
+    /* RFC 5649, the wrapped key may have any length */
+    HCF_KEY_WRAP_AES_PAD = 1,
+} HcfKeyWrapMode;
+
 /**
  * @brief Provides generation capabilities for symmetric key objects.
  *
@@ -45,6 +55,27 @@ struct HcfSymKeyGenerator {
 
     /** Get the algorithm name of the current these key generator objects */
     const char *(*getAlgoName)(HcfSymKeyGenerator *self);
+
+    /**
+     * @brief Wrap key under kek, wrapped receives a newly allocated blob.
+     */
+    HcfResult (*wrapSymKey)(HcfSymKeyGenerator *self, HcfKeyWrapMode mode, HcfSymKey *kek, HcfSymKey *key,
+        HcfBlob *wrapped);
+
+    /**
+     * @brief Unwrap a key of the algorithm of this generator, the integrity check of the wrap must pass.
+     */
+    HcfResult (*unwrapSymKey)(HcfSymKeyGenerator *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+        const HcfBlob *wrapped, HcfSymKey **symKey);
+
+    /**
+     * @brief Unwrap count keys under one kek, which is expanded once for the whole batch.
+     *
+     * symKeys[i] receives the key of wrapped[i], or NULL if that key fails to unwrap.
+     * @return HCF_SUCCESS if all keys are unwrapped, otherwise the first failure.
+     */
+    HcfResult (*unwrapSymKeyBatch)(HcfSymKeyGenerator *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+        const HcfBlob *wrapped, HcfSymKey **symKeys, uint32_t count);
 };
 
 #ifdef __cplusplus
@@ -99,5 +99,9 @@ typedef struct {
 #define OPENSSL_RSA_CIPHER_CLASS "OPENSSL.RSA.CIPHER"
 #define OPENSSL_3DES_CIPHER_CLASS "OPENSSL.3DES.CIPHER"
 #define OPENSSL_AES_CIPHER_CLASS "OPENSSL.AES.CIPHER"
+#define OPENSSL_AES_GCM_SIV_CIPHER_CLASS "OPENSSL.AES.GCMSIV.CIPHER"
+#define OPENSSL_AES_XTS_CIPHER_CLASS "OPENSSL.AES.XTS.CIPHER"
+#define OPENSSL_AES_ETM_CIPHER_CLASS "OPENSSL.AES.ETM.CIPHER"
+#define OPENSSL_CHACHA20_CIPHER_CLASS "OPENSSL.CHACHA20.CIPHER"
 
 #endif
@@ -20,19 +20,53 @@
 #include "params_parser.h"
 #include "cipher_factory_spi.h"
 
+#define CIPHER_MAX_BLOCK_SIZE 16
+#define CIPHER_MAX_TAG_SIZE 16
+#define CIPHER_MAX_KEY_SIZE 32
+
+/* inputs of at least threshold bytes are split over threadNum threads where the mode allows it */
+typedef struct {
+    uint32_t threshold;
+    uint32_t threadNum;
+} AesParallelConfig;
+
+typedef struct CcmStream CcmStream;
+
 typedef struct {
     EVP_CIPHER_CTX *ctx;
     enum HcfCryptoMode enc;
     /* EVP_CIPH_GCM_MODE, EVP_CIPH_CCM_MODE need AEAD */
     bool aead;
     uint32_t updateLen;
-    unsigned char *iv;
+    /* the iv of the message, ivLen is 0 for a mode without one */
+    unsigned char iv[CIPHER_MAX_BLOCK_SIZE];
     uint32_t ivLen;
-    /* GCM, CCM only */
+    /* GCM, CCM only: aad is the buffered CCM aad, aadLen counts the aad of both modes */
     unsigned char *aad;
-    uint32_t aadLen;
-    unsigned char *tag;
+    uint64_t aadLen;
+    /* decrypt only: the expected tag of the message, set when hasTag */
+    unsigned char tag[CIPHER_MAX_TAG_SIZE];
     uint32_t tagLen;
+    bool hasTag;
+    /* parallel engine only */
+    HCF_ALG_PARA_VALUE mode;
+    const AesParallelConfig *parallel;
+    /* bytes fed to and returned by ctx since the iv was set */
+    uint64_t inputLen;
+    uint64_t outputLen;
+    /* cbc decrypt: the last ciphertext block fed to ctx */
+    unsigned char lastBlock[CIPHER_MAX_BLOCK_SIZE];
+    /* gcm: the key of the parallel segments, ccm: the key of the stream contexts, keyLen is 0 if not kept */
+    unsigned char key[CIPHER_MAX_KEY_SIZE];
+    uint32_t keyLen;
+    /* gcm verify first: the hash key E(key, 0), computed once per key */
+    unsigned char gcmH[CIPHER_MAX_BLOCK_SIZE];
+    bool isGcmHReady;
+    /* ccm with a declared data length runs on ccmStream instead of ctx, which is kept across messages */
+    bool isCcmStream;
+    CcmStream *ccmStream;
+    /* gcm decrypt of a one shot message checks the tag before it decrypts, see CIPHER_GCM_VERIFY_FIRST */
+    bool isVerifyFirst;
 } CipherData;
 
 #ifdef __cplusplus
@@ -43,6 +77,17 @@ HcfResult HcfCipherDesGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGenerato
 
 HcfResult HcfCipherAesGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator);
 
+/* AES-GCM-SIV (RFC 8452), created by HcfCipherAesGeneratorSpiCreate for the GCMSIV mode */
+HcfResult HcfCipherAesGcmSivGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator);
+
+/* AES-XTS (IEEE 1619), created by HcfCipherAesGeneratorSpiCreate for the XTS mode */
+HcfResult HcfCipherAesXtsGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator);
+
+/* AES-CBC or AES-CTR with HMAC encrypt-then-mac, created by HcfCipherAesGeneratorSpiCreate for a mac digest */
+HcfResult HcfCipherAesEtmGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator);
+
+HcfResult HcfCipherChaCha20GeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HCF_AES_OPENSSL_CCM_STREAM_H
+#define HCF_AES_OPENSSL_CCM_STREAM_H
+
+#include "aes_openssl.h"
+#include "blob.h"
+#include "detailed_ccm_params.h"
+#include "result.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * OpenSSL ccm needs the whole message in one call, so a message with a declared data length is run
+ * as cbc-mac plus ctr on two contexts keyed with data->key. Start a message with the nonce of params,
+ * the aad buffered in data is authenticated at the first update.
+ */
+HcfResult CcmStreamStart(CipherData *data, const HcfCcmParamsSpec *params);
+
+HcfResult CcmStreamUpdate(CipherData *data, HcfBlob *input, HcfBlob *output);
+
+/* Check that the declared length was reached, then append (encrypt) or verify (decrypt) the tag. */
+HcfResult CcmStreamDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output);
+
+void FreeCcmStream(CcmStream **stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -54,8 +54,25 @@ void *GetGcmTag(HcfParamsSpec *params);
 
 void *GetCcmTag(HcfParamsSpec *params);
 
+void ClearCipherMessageData(CipherData *data);
+
 void FreeCipherData(CipherData **data);
 
+/* Reuse the current or idle cipher data if there is one, otherwise allocate a new one with an empty ctx. */
+HcfResult AcquireCipherData(CipherData **data, CipherData **idleData);
+
+/* Finish the current message but keep the keyed ctx in idleData, so that it can be reset with a new iv. */
+void RetainCipherData(CipherData **data, CipherData **idleData);
+
+/* Like RetainCipherData, then wipe the key from the ctx and the buffers of idleData, which stay allocated. */
+void DropCipherKey(CipherData **data, CipherData **idleData);
+
+/* Whether data holds a ctx with a cipher and key, which reset can start a new message on. */
+bool IsCipherDataKeyed(const CipherData *data);
+
+/* out = counter + blocks, both 128 bit big endian, wrapping like the ctr mode of openssl */
+void AddAesCounter(const unsigned char *counter, uint64_t blocks, unsigned char *out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HCF_AES_OPENSSL_PARALLEL_H
+#define HCF_AES_OPENSSL_PARALLEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "aes_openssl.h"
+#include "blob.h"
+#include "result.h"
+
+#define AES_PARALLEL_DEFAULT_THRESHOLD (1024 * 1024)
+/* the parallel engine stays off until the caller sets CIPHER_PARALLEL_THREAD_NUM */
+#define AES_PARALLEL_DEFAULT_THREAD_NUM 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Process the longest prefix of input that can be split into independent segments, which is
+ * only possible for ECB, CTR and CBC decrypt. The main ctx is moved past the prefix, so the rest
+ * of the input can be fed to it as usual. *processedLen returns the length of the prefix,
+ * the output of the prefix has the same length.
+ */
+HcfResult AesParallelUpdate(CipherData *data, HcfBlob *input, HcfBlob *output, uint32_t *processedLen);
+
+/* Whether a gcm doFinal on input can run on the parallel engine, only one shot messages can. */
+bool IsAesParallelGcm(const CipherData *data, const HcfBlob *input);
+
+/* One shot gcm: counter segments on worker threads, their ghash values are combined into the tag. */
+HcfResult AesParallelGcmDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output);
+
+/* Whether a gcm decrypt doFinal on input checks the tag before it decrypts, nothing may be updated yet. */
+bool IsAesGcmVerifyFirst(const CipherData *data);
+
+/*
+ * The tag check of a verify first decrypt: one ghash pass over the ciphertext on a copy of the message ctx,
+ * nothing is decrypted. The message itself is left for the usual doFinal.
+ */
+HcfResult AesGcmVerifyTag(CipherData *data, const HcfBlob *input);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
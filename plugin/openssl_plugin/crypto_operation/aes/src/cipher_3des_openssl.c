@@ -31,6 +31,8 @@ typedef struct {
     OH_HCF_CipherGeneratorSpi base;
     CipherAttr attr;
     CipherData *cipherData;
+    /* keyed ctx of the last finished message, reused by reset and init */
+    CipherData *idleData;
 } HcfCipherDesGeneratorSpiOpensslImpl;
 
 static const char *GetDesGeneratorClass(void)
@@ -65,31 +67,6 @@ static const EVP_CIPHER *GetCipherType(HcfCipherDesGeneratorSpiOpensslImpl *impl
     return DefautCiherType();
 }
 
-static HcfResult InitCipherData(enum HcfCryptoMode opMode, CipherData **cipherData)
-{
-    HcfResult ret = HCF_INVALID_PARAMS;
-
-    *cipherData = (CipherData *)HcfMalloc(sizeof(CipherData), 0);
-    if (*cipherData == NULL) {
-        LOGE("malloc failed!");
-        return HCF_ERR_MALLOC;
-    }
-
-    (*cipherData)->enc = opMode;
-    (*cipherData)->ctx = EVP_CIPHER_CTX_new();
-    if ((*cipherData)->ctx == NULL) {
-        HcfPrintOpensslError();
-        LOGE("Failed to allocate ctx memroy!");
-        goto clearup;
-    }
-
-    ret = HCF_SUCCESS;
-    return ret;
-clearup:
-    FreeCipherData(cipherData);
-    return ret;
-}
-
 static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
     HcfKey *key, HcfParamsSpec *params)
 {
@@ -111,20 +88,21 @@ static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCrypt
 
     int32_t enc = (opMode == ENCRYPT_MODE) ? 1 : 0;
 
-    if (InitCipherData(opMode,  &(cipherImpl->cipherData)) != HCF_SUCCESS) {
-        LOGE("InitCipherData failed");
-        return HCF_INVALID_PARAMS;
+    HcfResult ret = AcquireCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    if (ret != HCF_SUCCESS) {
+        LOGE("AcquireCipherData failed");
+        return ret;
     }
-    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    ret = HCF_ERR_CRYPTO_OPERATION;
     CipherData *data = cipherImpl->cipherData;
-    if (EVP_CipherInit(data->ctx, GetCipherType(cipherImpl), NULL, NULL, enc) != HCF_OPENSSL_SUCCESS) {
-        HcfPrintOpensslError();
-        LOGE("cipher init failed!");
+    data->enc = opMode;
+    if (HcfSymKeyInitCipherCtx(keyImpl, GetCipherType(cipherImpl), enc, data->ctx) != HCF_SUCCESS) {
+        LOGE("cipher init key failed!");
         goto clearup;
     }
-    if (EVP_CipherInit(data->ctx, NULL, keyImpl->keyMaterial.data, GetIv(params), enc) != HCF_OPENSSL_SUCCESS) {
+    if (EVP_CipherInit_ex(data->ctx, NULL, NULL, NULL, GetIv(params), enc) != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
-        LOGE("cipher init key and iv failed!");
+        LOGE("cipher init iv failed!");
         goto clearup;
     }
     int32_t padding = (cipherImpl->attr.paddingMode == HCF_ALG_NOPADDING) ? 0 : EVP_PADDING_PKCS7;
@@ -139,17 +117,48 @@ clearup:
     return ret;
 }
 
-static HcfResult AllocateOutput(HcfBlob *input, HcfBlob *output)
+static HcfResult EngineReset(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params)
 {
-    uint32_t outLen = 0;
-    if (IsBlobValid(input)) {
-        outLen += input->len;
+    if (self == NULL) { /* params maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetDesGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
     }
-    outLen += DES_BLOCK_SIZE;
-    if (outLen == 0) {
-        LOGE("output size is invaild!");
+    HcfCipherDesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
+    CipherData *last = (cipherImpl->cipherData != NULL) ? cipherImpl->cipherData : cipherImpl->idleData;
+    if (!IsCipherDataKeyed(last)) {
+        LOGE("cipher has not been initialized!");
         return HCF_INVALID_PARAMS;
     }
+    (void)AcquireCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    CipherData *data = cipherImpl->cipherData;
+    /* keep the cipher and the key schedule, only load the new iv */
+    if (EVP_CipherInit_ex(data->ctx, NULL, NULL, NULL, GetIv(params), (data->enc == ENCRYPT_MODE) ? 1 : 0) !=
+        HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher reset iv failed!");
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static uint32_t GetOutputLen(const CipherData *data, uint32_t inputLen, bool isFinal)
+{
+    if (!isFinal) {
+        return inputLen + DES_BLOCK_SIZE;
+    }
+    /* the partial block held back by earlier updates is flushed together with the padding block */
+    uint32_t bufLen = (uint32_t)(data->inputLen - data->outputLen);
+    return (bufLen + inputLen + DES_BLOCK_SIZE - 1) / DES_BLOCK_SIZE * DES_BLOCK_SIZE + DES_BLOCK_SIZE;
+}
+
+static HcfResult AllocateOutput(const CipherData *data, HcfBlob *input, HcfBlob *output, bool isFinal)
+{
+    uint32_t outLen = GetOutputLen(data, IsBlobValid(input) ? input->len : 0, isFinal);
     output->data = (uint8_t *)HcfMalloc(outLen, 0);
     if (output->data == NULL) {
         LOGE("malloc output failed!");
@@ -159,42 +168,90 @@ static HcfResult AllocateOutput(HcfBlob *input, HcfBlob *output)
     return HCF_SUCCESS;
 }
 
-static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+static HcfResult CheckOutputBuffer(const CipherData *data, HcfBlob *input, HcfBlob *output, bool isFinal)
 {
-    if ((self == NULL) || (input == NULL) || (output == NULL)) {
-        LOGE("Invalid input parameter!");
+    uint32_t outLen = GetOutputLen(data, IsBlobValid(input) ? input->len : 0, isFinal);
+    if ((output->data == NULL) || (output->len < outLen)) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
         return HCF_INVALID_PARAMS;
     }
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetDesCipherData(OH_HCF_CipherGeneratorSpi *self, CipherData **data)
+{
     if (!IsClassMatch((const HcfObjectBase *)self, GetDesGeneratorClass())) {
         LOGE("Class is not match.");
         return HCF_INVALID_PARAMS;
     }
-
-    HcfCipherDesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
-    CipherData *data = cipherImpl->cipherData;
-    if (data == NULL) {
+    *data = ((HcfCipherDesGeneratorSpiOpensslImpl *)self)->cipherData;
+    if (*data == NULL) {
         LOGE("cipherData is null!");
         return HCF_INVALID_PARAMS;
     }
-    HcfResult res = AllocateOutput(input, output);
-    if (res != HCF_SUCCESS) {
-        LOGE("AllocateOutput failed!");
-        goto clearup;
-    }
+    return HCF_SUCCESS;
+}
 
-    int32_t ret = EVP_CipherUpdate(data->ctx, output->data, (int *)&output->len,
-        input->data, input->len);
+static HcfResult DesUpdate(CipherData *data, HcfBlob *input, HcfBlob *output)
+{
+    int32_t outLen = 0;
+    int32_t ret = EVP_CipherUpdate(data->ctx, output->data, &outLen, input->data, input->len);
     if (ret != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
         LOGE("cipher update failed!");
-        res = HCF_ERR_CRYPTO_OPERATION;
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    output->len = (uint32_t)outLen;
+    data->inputLen += input->len;
+    data->outputLen += output->len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetDesCipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    HcfCipherDesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
+    res = AllocateOutput(data, input, output, false);
+    if (res != HCF_SUCCESS) {
+        LOGE("AllocateOutput failed!");
         goto clearup;
     }
-    res = HCF_SUCCESS;
+    res = DesUpdate(data, input, output);
 clearup:
     if (res != HCF_SUCCESS) {
         HcfBlobDataFree(output);
-        FreeCipherData(&(cipherImpl->cipherData));
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return res;
+}
+
+static HcfResult EngineUpdateToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetDesCipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = CheckOutputBuffer(data, input, output, false);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = DesUpdate(data, input, output);
+    if (res != HCF_SUCCESS) {
+        HcfCipherDesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
     }
     return res;
 }
@@ -203,24 +260,22 @@ static HcfResult DesDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
 {
     int32_t ret;
     uint32_t len = 0;
+    int32_t finalLen = 0;
 
     if (IsBlobValid(input)) {
-        ret = EVP_CipherUpdate(data->ctx, output->data, (int *)&output->len,
-            input->data, input->len);
-        if (ret != HCF_OPENSSL_SUCCESS) {
-            HcfPrintOpensslError();
-            LOGE("cipher update failed!");
-            return HCF_ERR_CRYPTO_OPERATION;
+        HcfResult res = DesUpdate(data, input, output);
+        if (res != HCF_SUCCESS) {
+            return res;
         }
-        len += output->len;
+        len = output->len;
     }
-    ret = EVP_CipherFinal_ex(data->ctx, output->data + len, (int *)&output->len);
+    ret = EVP_CipherFinal_ex(data->ctx, output->data + len, &finalLen);
     if (ret != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
         LOGE("cipher final filed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    output->len += len;
+    output->len = len + (uint32_t)finalLen;
     return HCF_SUCCESS;
 }
 
@@ -230,18 +285,13 @@ static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input,
         LOGE("Invalid input parameter!");
         return HCF_INVALID_PARAMS;
     }
-    if (!IsClassMatch((const HcfObjectBase *)self, GetDesGeneratorClass())) {
-        LOGE("Class is not match.");
-        return HCF_INVALID_PARAMS;
+    CipherData *data = NULL;
+    HcfResult res = GetDesCipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
     }
     HcfCipherDesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
-    CipherData *data = cipherImpl->cipherData;
-    if (data == NULL) {
-        LOGE("cipherData is null!");
-        return HCF_INVALID_PARAMS;
-    }
-
-    HcfResult res = AllocateOutput(input, output);
+    res = AllocateOutput(data, input, output, true);
     if (res != HCF_SUCCESS) {
         LOGE("AllocateOutput failed!");
         goto clearup;
@@ -252,12 +302,70 @@ static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input,
     }
 clearup:
     if (res != HCF_SUCCESS) {
-        HcfBlobDataFree(output);
+        HcfBlobDataClearAndFree(output);
     }
-    FreeCipherData(&(cipherImpl->cipherData));
+    RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
     return res;
 }
 
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetDesCipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = CheckOutputBuffer(data, input, output, true);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint8_t *outBuf = output->data;
+    uint32_t outLen = GetOutputLen(data, IsBlobValid(input) ? input->len : 0, true);
+    res = DesDoFinal(data, input, output);
+    if (res != HCF_SUCCESS) {
+        LOGE("DesDoFinal failed!");
+        /* the blocks decrypted before a padding failure must not stay in the caller's buffer */
+        (void)memset_s(outBuf, outLen, 0, outLen);
+        output->len = 0;
+    }
+    HcfCipherDesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
+    RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    return res;
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetDesCipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    *outputLen = GetOutputLen(data, inputLen, isFinal);
+    return HCF_SUCCESS;
+}
+
+static void EngineClear(OH_HCF_CipherGeneratorSpi *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetDesGeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherDesGeneratorSpiOpensslImpl *impl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
+    DropCipherKey(&(impl->cipherData), &(impl->idleData));
+}
+
 static void EngineDesGeneratorDestroy(HcfObjectBase *self)
 {
     if (self == NULL) {
@@ -269,6 +377,7 @@ static void EngineDesGeneratorDestroy(HcfObjectBase *self)
     }
     HcfCipherDesGeneratorSpiOpensslImpl *impl = (HcfCipherDesGeneratorSpiOpensslImpl *)self;
     FreeCipherData(&(impl->cipherData));
+    FreeCipherData(&(impl->idleData));
     HcfFree(impl);
 }
 
@@ -288,6 +397,11 @@ HcfResult HcfCipherDesGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGenerato
     returnImpl->base.init = EngineCipherInit;
     returnImpl->base.update = EngineUpdate;
     returnImpl->base.doFinal = EngineDoFinal;
+    returnImpl->base.getOutputSize = EngineGetOutputSize;
+    returnImpl->base.updateToBuffer = EngineUpdateToBuffer;
+    returnImpl->base.doFinalToBuffer = EngineDoFinalToBuffer;
+    returnImpl->base.reset = EngineReset;
+    returnImpl->base.clear = EngineClear;
     returnImpl->base.base.destroy = EngineDesGeneratorDestroy;
     returnImpl->base.base.getClass = GetDesGeneratorClass;
 
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aes_openssl_ccm_stream.h"
+
+#include <openssl/crypto.h>
+#include "securec.h"
+#include "log.h"
+#include "memory.h"
+#include "openssl_common.h"
+#include "utils.h"
+
+#define CCM_BLOCK_LEN 16
+#define CCM_NONCE_MIN_LEN 7
+#define CCM_NONCE_MAX_LEN 13
+#define CCM_TAG_MIN_LEN 4
+#define CCM_TAG_MAX_LEN 16
+#define CCM_ADATA_FLAG 0x40
+#define CCM_TAG_FLAG_SHIFT 3
+/* aad shorter than this is prefixed with a 2 byte length, longer aad with 0xFFFE and a 4 byte length */
+#define CCM_SHORT_AAD_LIMIT 0xFF00
+#define CCM_SHORT_AAD_PREFIX_LEN 2
+#define CCM_LONG_AAD_PREFIX_LEN 6
+#define CCM_MAC_CHUNK_LEN 1024
+#define BITS_PER_BYTE 8
+
+typedef const EVP_CIPHER *(*AesCipherFunc)(void);
+
+typedef struct {
+    uint32_t keyLen;
+    AesCipherFunc cbc;
+    AesCipherFunc ctr;
+} CcmCipherSet;
+
+static const CcmCipherSet CCM_CIPHER_SET[] = {
+    { 16, EVP_aes_128_cbc, EVP_aes_128_ctr },
+    { 24, EVP_aes_192_cbc, EVP_aes_192_ctr },
+    { 32, EVP_aes_256_cbc, EVP_aes_256_ctr },
+};
+
+struct CcmStream {
+    /* cbc with a zero iv, the last output block is the cbc-mac */
+    EVP_CIPHER_CTX *macCtx;
+    /* ctr from A0, the first key stream block is S0 and the data starts at A1 */
+    EVP_CIPHER_CTX *ctrCtx;
+    unsigned char b0[CCM_BLOCK_LEN];
+    unsigned char mac[CCM_BLOCK_LEN];
+    unsigned char s0[CCM_BLOCK_LEN];
+    /* mac input that does not fill a block yet */
+    unsigned char partial[CCM_BLOCK_LEN];
+    uint32_t partialLen;
+    uint32_t tagLen;
+    uint64_t dataLen;
+    uint64_t processedLen;
+    bool isHeaderDone;
+};
+
+static const CcmCipherSet *FindCcmCipherSet(uint32_t keyLen)
+{
+    for (uint32_t i = 0; i < sizeof(CCM_CIPHER_SET) / sizeof(CCM_CIPHER_SET[0]); i++) {
+        if (CCM_CIPHER_SET[i].keyLen == keyLen) {
+            return &CCM_CIPHER_SET[i];
+        }
+    }
+    return NULL;
+}
+
+static HcfResult NewCcmStream(const CipherData *data, CcmStream **stream)
+{
+    const CcmCipherSet *cipherSet = FindCcmCipherSet(data->keyLen);
+    if ((cipherSet == NULL) || (data->keyLen == 0)) {
+        LOGE("ccm stream key is invalid!");
+        return HCF_INVALID_PARAMS;
+    }
+    CcmStream *tmp = (CcmStream *)HcfMalloc(sizeof(CcmStream), 0);
+    if (tmp == NULL) {
+        LOGE("malloc ccm stream failed!");
+        return HCF_ERR_MALLOC;
+    }
+    tmp->macCtx = EVP_CIPHER_CTX_new();
+    tmp->ctrCtx = EVP_CIPHER_CTX_new();
+    if ((tmp->macCtx == NULL) || (tmp->ctrCtx == NULL)) {
+        LOGE("Failed to allocate ctx memroy!");
+        FreeCcmStream(&tmp);
+        return HCF_ERR_MALLOC;
+    }
+    if ((EVP_EncryptInit_ex(tmp->macCtx, cipherSet->cbc(), NULL, data->key, NULL) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CIPHER_CTX_set_padding(tmp->macCtx, 0) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptInit_ex(tmp->ctrCtx, cipherSet->ctr(), NULL, data->key, NULL) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("init ccm stream ctx failed!");
+        FreeCcmStream(&tmp);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    *stream = tmp;
+    return HCF_SUCCESS;
+}
+
+static bool IsCcmStreamParamsValid(const CipherData *data, const HcfCcmParamsSpec *params)
+{
+    if ((params->iv.len < CCM_NONCE_MIN_LEN) || (params->iv.len > CCM_NONCE_MAX_LEN)) {
+        LOGE("ccm nonce is invalid!");
+        return false;
+    }
+    if ((data->tagLen < CCM_TAG_MIN_LEN) || (data->tagLen > CCM_TAG_MAX_LEN) || ((data->tagLen & 1) != 0)) {
+        LOGE("ccm tag length is invalid!");
+        return false;
+    }
+    /* the data length is encoded in the 15 - nonceLen bytes left in the first block */
+    uint32_t lenBytes = CCM_BLOCK_LEN - 1 - params->iv.len;
+    if ((lenBytes < sizeof(uint64_t)) && ((params->dataLen >> (lenBytes * BITS_PER_BYTE)) != 0)) {
+        LOGE("ccm data length does not fit the nonce length!");
+        return false;
+    }
+    return true;
+}
+
+HcfResult CcmStreamStart(CipherData *data, const HcfCcmParamsSpec *params)
+{
+    if ((data == NULL) || (params == NULL) || !IsCcmStreamParamsValid(data, params)) {
+        return HCF_INVALID_PARAMS;
+    }
+    if (data->ccmStream == NULL) {
+        HcfResult ret = NewCcmStream(data, &(data->ccmStream));
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    CcmStream *stream = data->ccmStream;
+    uint32_t lenBytes = CCM_BLOCK_LEN - 1 - params->iv.len;
+    unsigned char a0[CCM_BLOCK_LEN] = { 0 };
+    unsigned char zero[CCM_BLOCK_LEN] = { 0 };
+    a0[0] = (unsigned char)(lenBytes - 1);
+    (void)memcpy_s(a0 + 1, CCM_BLOCK_LEN - 1, params->iv.data, params->iv.len);
+    (void)memcpy_s(stream->b0, CCM_BLOCK_LEN, a0, CCM_BLOCK_LEN);
+    stream->b0[0] |= (unsigned char)(((data->tagLen - 2) / 2) << CCM_TAG_FLAG_SHIFT);
+    uint64_t dataLen = params->dataLen;
+    for (uint32_t i = 0; i < lenBytes; i++) {
+        stream->b0[CCM_BLOCK_LEN - 1 - i] = (unsigned char)dataLen;
+        dataLen = (i + 1 < sizeof(uint64_t)) ? (dataLen >> BITS_PER_BYTE) : 0;
+    }
+
+    int32_t outLen = 0;
+    if ((EVP_EncryptInit_ex(stream->macCtx, NULL, NULL, NULL, zero) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptInit_ex(stream->ctrCtx, NULL, NULL, NULL, a0) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptUpdate(stream->ctrCtx, stream->s0, &outLen, zero, CCM_BLOCK_LEN) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("start ccm stream failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    (void)memset_s(stream->mac, CCM_BLOCK_LEN, 0, CCM_BLOCK_LEN);
+    stream->partialLen = 0;
+    stream->tagLen = data->tagLen;
+    stream->dataLen = params->dataLen;
+    stream->processedLen = 0;
+    stream->isHeaderDone = false;
+    return HCF_SUCCESS;
+}
+
+static HcfResult MacBlocks(CcmStream *stream, const unsigned char *in, uint32_t len)
+{
+    unsigned char out[CCM_MAC_CHUNK_LEN];
+    while (len > 0) {
+        int32_t chunkLen = (len < CCM_MAC_CHUNK_LEN) ? (int32_t)len : CCM_MAC_CHUNK_LEN;
+        int32_t outLen = 0;
+        if (EVP_EncryptUpdate(stream->macCtx, out, &outLen, in, chunkLen) != HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("ccm cbc-mac failed!");
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        (void)memcpy_s(stream->mac, CCM_BLOCK_LEN, out + chunkLen - CCM_BLOCK_LEN, CCM_BLOCK_LEN);
+        in += chunkLen;
+        len -= (uint32_t)chunkLen;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult MacUpdate(CcmStream *stream, const unsigned char *in, uint32_t len)
+{
+    if (stream->partialLen > 0) {
+        uint32_t fill = CCM_BLOCK_LEN - stream->partialLen;
+        fill = (len < fill) ? len : fill;
+        (void)memcpy_s(stream->partial + stream->partialLen, CCM_BLOCK_LEN - stream->partialLen, in, fill);
+        stream->partialLen += fill;
+        in += fill;
+        len -= fill;
+        if (stream->partialLen < CCM_BLOCK_LEN) {
+            return HCF_SUCCESS;
+        }
+        stream->partialLen = 0;
+        HcfResult ret = MacBlocks(stream, stream->partial, CCM_BLOCK_LEN);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    uint32_t fullLen = len - len % CCM_BLOCK_LEN;
+    HcfResult ret = MacBlocks(stream, in, fullLen);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (len > fullLen) {
+        (void)memcpy_s(stream->partial, CCM_BLOCK_LEN, in + fullLen, len - fullLen);
+        stream->partialLen = len - fullLen;
+    }
+    return HCF_SUCCESS;
+}
+
+/* the aad and the data are each zero padded to a block boundary */
+static HcfResult MacPad(CcmStream *stream)
+{
+    if (stream->partialLen == 0) {
+        return HCF_SUCCESS;
+    }
+    (void)memset_s(stream->partial + stream->partialLen, CCM_BLOCK_LEN - stream->partialLen, 0,
+        CCM_BLOCK_LEN - stream->partialLen);
+    stream->partialLen = 0;
+    return MacBlocks(stream, stream->partial, CCM_BLOCK_LEN);
+}
+
+static HcfResult MacHeader(CcmStream *stream, const CipherData *data)
+{
+    if (data->aadLen > 0) {
+        stream->b0[0] |= CCM_ADATA_FLAG;
+    }
+    HcfResult ret = MacUpdate(stream, stream->b0, CCM_BLOCK_LEN);
+    if ((ret != HCF_SUCCESS) || (data->aadLen == 0)) {
+        stream->isHeaderDone = (ret == HCF_SUCCESS);
+        return ret;
+    }
+    unsigned char prefix[CCM_LONG_AAD_PREFIX_LEN] = { 0xFF, 0xFE };
+    uint32_t prefixLen = (data->aadLen < CCM_SHORT_AAD_LIMIT) ? CCM_SHORT_AAD_PREFIX_LEN : CCM_LONG_AAD_PREFIX_LEN;
+    uint32_t aadLen = (uint32_t)data->aadLen;
+    for (uint32_t i = 1; (i <= prefixLen) && (i <= sizeof(uint32_t)); i++) {
+        prefix[prefixLen - i] = (unsigned char)aadLen;
+        aadLen >>= BITS_PER_BYTE;
+    }
+    ret = MacUpdate(stream, prefix, prefixLen);
+    if (ret == HCF_SUCCESS) {
+        ret = MacUpdate(stream, data->aad, data->aadLen);
+    }
+    if (ret == HCF_SUCCESS) {
+        ret = MacPad(stream);
+    }
+    stream->isHeaderDone = (ret == HCF_SUCCESS);
+    return ret;
+}
+
+static HcfResult CtrUpdate(CcmStream *stream, const unsigned char *in, unsigned char *out, uint32_t len)
+{
+    int32_t outLen = 0;
+    if ((len > 0) && (EVP_EncryptUpdate(stream->ctrCtx, out, &outLen, in, (int32_t)len) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("ccm ctr failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+HcfResult CcmStreamUpdate(CipherData *data, HcfBlob *input, HcfBlob *output)
+{
+    CcmStream *stream = data->ccmStream;
+    uint32_t len = IsBlobValid(input) ? input->len : 0;
+    if ((len > INT32_MAX) || (len > stream->dataLen - stream->processedLen)) {
+        LOGE("ccm data is longer than the declared length!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfResult ret = HCF_SUCCESS;
+    if (!stream->isHeaderDone) {
+        ret = MacHeader(stream, data);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    /* the cbc-mac covers the plaintext: before ctr when encrypting, after it when decrypting */
+    if (data->enc == ENCRYPT_MODE) {
+        ret = MacUpdate(stream, input->data, len);
+        if (ret == HCF_SUCCESS) {
+            ret = CtrUpdate(stream, input->data, output->data, len);
+        }
+    } else {
+        ret = CtrUpdate(stream, input->data, output->data, len);
+        if (ret == HCF_SUCCESS) {
+            ret = MacUpdate(stream, output->data, len);
+        }
+    }
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    stream->processedLen += len;
+    output->len = len;
+    return HCF_SUCCESS;
+}
+
+HcfResult CcmStreamDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
+{
+    CcmStream *stream = data->ccmStream;
+    HcfResult ret = CcmStreamUpdate(data, input, output);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (stream->processedLen != stream->dataLen) {
+        LOGE("ccm data is shorter than the declared length!");
+        return HCF_INVALID_PARAMS;
+    }
+    ret = MacPad(stream);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    unsigned char tag[CCM_BLOCK_LEN] = { 0 };
+    for (uint32_t i = 0; i < CCM_BLOCK_LEN; i++) {
+        tag[i] = stream->mac[i] ^ stream->s0[i];
+    }
+    if (data->enc == ENCRYPT_MODE) {
+        (void)memcpy_s(output->data + output->len, stream->tagLen, tag, stream->tagLen);
+        output->len += stream->tagLen;
+        return HCF_SUCCESS;
+    }
+    if (!data->hasTag || (CRYPTO_memcmp(tag, data->tag, stream->tagLen) != 0)) {
+        LOGE("ccm decrypt verify AuthTag failed!");
+        (void)memset_s(output->data, output->len, 0, output->len);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+void FreeCcmStream(CcmStream **stream)
+{
+    if ((stream == NULL) || (*stream == NULL)) {
+        return;
+    }
+    EVP_CIPHER_CTX_free((*stream)->macCtx);
+    EVP_CIPHER_CTX_free((*stream)->ctrCtx);
+    (void)memset_s(*stream, sizeof(CcmStream), 0, sizeof(CcmStream));
+    HcfFree(*stream);
+    *stream = NULL;
+}
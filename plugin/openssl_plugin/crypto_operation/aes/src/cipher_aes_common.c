@@ -15,9 +15,14 @@
 
 #include "aes_openssl_common.h"
 
+#include "aes_openssl_ccm_stream.h"
 #include "log.h"
+#include "openssl_common.h"
 #include "memory.h"
 #include "result.h"
+#include "securec.h"
+
+#define BITS_PER_BYTE 8
 
 const unsigned char *GetIv(HcfParamsSpec *params)
 {
@@ -79,6 +84,26 @@ void *GetCcmTag(HcfParamsSpec *params)
     return (void *)tag;
 }
 
+void ClearCipherMessageData(CipherData *data)
+{
+    if (data == NULL) {
+        return;
+    }
+    if (data->aad != NULL) {
+        HcfFree(data->aad);
+        data->aad = NULL;
+    }
+    data->hasTag = false;
+    data->aead = false;
+    data->isCcmStream = false;
+    data->updateLen = 0;
+    data->inputLen = 0;
+    data->outputLen = 0;
+    data->ivLen = 0;
+    data->aadLen = 0;
+    data->tagLen = 0;
+}
+
 void FreeCipherData(CipherData **data)
 {
     if (data == NULL || *data == NULL) {
@@ -88,18 +113,83 @@ void FreeCipherData(CipherData **data)
         EVP_CIPHER_CTX_free((*data)->ctx);
         (*data)->ctx = NULL;
     }
-    if ((*data)->aad != NULL) {
-        HcfFree((*data)->aad);
-        (*data)->aad = NULL;
+    ClearCipherMessageData(*data);
+    FreeCcmStream(&((*data)->ccmStream));
+    (void)memset_s((*data)->gcmH, sizeof((*data)->gcmH), 0, sizeof((*data)->gcmH));
+    (void)memset_s((*data)->key, sizeof((*data)->key), 0, sizeof((*data)->key));
+    HcfFree(*data);
+    *data = NULL;
+}
+
+HcfResult AcquireCipherData(CipherData **data, CipherData **idleData)
+{
+    if (*data != NULL) {
+        ClearCipherMessageData(*data);
+        return HCF_SUCCESS;
     }
-    if ((*data)->iv != NULL) {
-        HcfFree((*data)->iv);
-        (*data)->iv = NULL;
+    if (*idleData != NULL) {
+        *data = *idleData;
+        *idleData = NULL;
+        return HCF_SUCCESS;
     }
-    if ((*data)->tag != NULL) {
-        HcfFree((*data)->tag);
-        (*data)->tag = NULL;
+    *data = (CipherData *)HcfMalloc(sizeof(CipherData), 0);
+    if (*data == NULL) {
+        LOGE("malloc is failed!");
+        return HCF_ERR_MALLOC;
     }
-    HcfFree(*data);
+    (*data)->ctx = EVP_CIPHER_CTX_new();
+    if ((*data)->ctx == NULL) {
+        HcfPrintOpensslError();
+        LOGE("Failed to allocate ctx memroy!");
+        HcfFree(*data);
+        *data = NULL;
+        return HCF_ERR_MALLOC;
+    }
+    return HCF_SUCCESS;
+}
+
+void RetainCipherData(CipherData **data, CipherData **idleData)
+{
+    if (data == NULL || *data == NULL || idleData == NULL) {
+        return;
+    }
+    ClearCipherMessageData(*data);
+    FreeCipherData(idleData);
+    *idleData = *data;
     *data = NULL;
 }
+
+void DropCipherKey(CipherData **data, CipherData **idleData)
+{
+    RetainCipherData(data, idleData);
+    CipherData *idle = *idleData;
+    if (idle == NULL) {
+        return;
+    }
+    /* the reset ctx keeps its allocation but no cipher, so reset reports the cipher as not initialized */
+    if (EVP_CIPHER_CTX_reset(idle->ctx) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        FreeCipherData(idleData);
+        return;
+    }
+    FreeCcmStream(&(idle->ccmStream));
+    (void)memset_s(idle->gcmH, sizeof(idle->gcmH), 0, sizeof(idle->gcmH));
+    idle->isGcmHReady = false;
+    (void)memset_s(idle->key, sizeof(idle->key), 0, sizeof(idle->key));
+    idle->keyLen = 0;
+}
+
+bool IsCipherDataKeyed(const CipherData *data)
+{
+    return (data != NULL) && (EVP_CIPHER_CTX_cipher(data->ctx) != NULL);
+}
+
+void AddAesCounter(const unsigned char *counter, uint64_t blocks, unsigned char *out)
+{
+    uint64_t carry = blocks;
+    for (int32_t i = CIPHER_MAX_BLOCK_SIZE - 1; i >= 0; i--) {
+        carry += counter[i];
+        out[i] = (unsigned char)carry;
+        carry >>= BITS_PER_BYTE;
+    }
+}
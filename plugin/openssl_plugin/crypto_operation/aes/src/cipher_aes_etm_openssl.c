@@ -0,0 +1,612 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <openssl/crypto.h>
+#include <openssl/hmac.h>
+#include "log.h"
+#include "blob.h"
+#include "memory.h"
+#include "result.h"
+#include "utils.h"
+#include "securec.h"
+#include "aes_openssl_common.h"
+#include "sym_common_defines.h"
+#include "openssl_common.h"
+#include "openssl_class.h"
+
+/*
+ * Encrypt-then-mac of AES-CBC or AES-CTR with HMAC, such as "AES256|CBC|PKCS7|HMAC-SHA256". The key is the mac
+ * key followed by the aes key, both of the aes key size, as generated for "AES256|HMAC-SHA256". The tag is the
+ * whole hmac of iv || ciphertext and follows the ciphertext.
+ *
+ * Encryption macs each tile of ciphertext right after it is written, while it is still in the cache. Decryption
+ * collects ciphertext || tag and verifies the tag before any plaintext is returned.
+ */
+#define ETM_BLOCK_SIZE 16
+#define ETM_IV_LEN 16
+#define ETM_KEY_NUM 2
+#define ETM_TILE_LEN (16 * 1024)
+
+typedef struct {
+    OH_HCF_CipherGeneratorSpi base;
+    CipherAttr attr;
+    EVP_CIPHER_CTX *ctx;
+    HMAC_CTX *hmac;
+    bool isKeySet;
+    enum HcfCryptoMode enc;
+    /* a message is open for update and doFinal */
+    bool isStarted;
+    uint32_t tagLen;
+    /* encrypt: the bytes of a partial cbc block kept back by ctx */
+    uint32_t heldLen;
+    /* decrypt: ciphertext and tag collected by update, the buffer is kept for the next message */
+    uint8_t *buf;
+    uint32_t bufLen;
+    uint32_t bufCap;
+} HcfCipherAesEtmGeneratorSpiOpensslImpl;
+
+static const char *GetAesEtmGeneratorClass(void)
+{
+    return OPENSSL_AES_ETM_CIPHER_CLASS;
+}
+
+static uint32_t GetAesKeyLen(const CipherAttr *attr)
+{
+    switch (attr->keySize) {
+        case HCF_ALG_AES_192:
+            return 24;
+        case HCF_ALG_AES_256:
+            return 32;
+        default:
+            return 16;
+    }
+}
+
+static const EVP_CIPHER *GetEtmType(const CipherAttr *attr)
+{
+    bool isCbc = (attr->mode == HCF_ALG_MODE_CBC);
+    switch (attr->keySize) {
+        case HCF_ALG_AES_192:
+            return isCbc ? EVP_aes_192_cbc() : EVP_aes_192_ctr();
+        case HCF_ALG_AES_256:
+            return isCbc ? EVP_aes_256_cbc() : EVP_aes_256_ctr();
+        default:
+            return isCbc ? EVP_aes_128_cbc() : EVP_aes_128_ctr();
+    }
+}
+
+static bool IsPadding(const CipherAttr *attr)
+{
+    return (attr->mode == HCF_ALG_MODE_CBC) &&
+        ((attr->paddingMode == HCF_ALG_PADDING_PKCS5) || (attr->paddingMode == HCF_ALG_PADDING_PKCS7));
+}
+
+static const unsigned char *GetEtmIv(HcfParamsSpec *params)
+{
+    HcfIvParamsSpec *spec = (HcfIvParamsSpec *)params;
+    if ((spec == NULL) || (spec->iv.data == NULL) || (spec->iv.len != ETM_IV_LEN)) {
+        LOGE("encrypt-then-mac iv must be %d bytes!", ETM_IV_LEN);
+        return NULL;
+    }
+    return spec->iv.data;
+}
+
+static void ClearMessage(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl)
+{
+    if (impl->buf != NULL) {
+        (void)memset_s(impl->buf, impl->bufCap, 0, impl->bufLen);
+    }
+    impl->bufLen = 0;
+    impl->heldLen = 0;
+    impl->isStarted = false;
+}
+
+/* start a message under iv, the keys of ctx and hmac are kept */
+static HcfResult StartMessage(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, const unsigned char *iv)
+{
+    ClearMessage(impl);
+    if (EVP_CipherInit_ex(impl->ctx, NULL, NULL, NULL, iv, -1) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("set iv failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if ((HMAC_Init_ex(impl->hmac, NULL, 0, NULL, NULL) != HCF_OPENSSL_SUCCESS) ||
+        (HMAC_Update(impl->hmac, iv, ETM_IV_LEN) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("hmac init failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    impl->isStarted = true;
+    return HCF_SUCCESS;
+}
+
+static HcfResult SetEtmKey(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, enum HcfCryptoMode opMode,
+    const HcfBlob *key)
+{
+    uint32_t aesKeyLen = GetAesKeyLen(&(impl->attr));
+    if (key->len != aesKeyLen * ETM_KEY_NUM) {
+        LOGE("encrypt-then-mac key must be %u bytes!", aesKeyLen * ETM_KEY_NUM);
+        return HCF_INVALID_PARAMS;
+    }
+    if (impl->ctx == NULL) {
+        impl->ctx = EVP_CIPHER_CTX_new();
+    }
+    if (impl->hmac == NULL) {
+        impl->hmac = HMAC_CTX_new();
+    }
+    if ((impl->ctx == NULL) || (impl->hmac == NULL)) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    if (EVP_CipherInit_ex(impl->ctx, GetEtmType(&(impl->attr)), NULL, key->data + aesKeyLen, NULL,
+        (opMode == ENCRYPT_MODE) ? 1 : 0) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher init key failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    (void)EVP_CIPHER_CTX_set_padding(impl->ctx, IsPadding(&(impl->attr)) ? 1 : 0);
+    if (HMAC_Init_ex(impl->hmac, key->data, (int32_t)aesKeyLen, GetOpensslDigestAlg(impl->attr.macMd),
+        NULL) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("hmac init key failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    impl->tagLen = (uint32_t)HMAC_size(impl->hmac);
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
+    HcfKey *key, HcfParamsSpec *params)
+{
+    if ((self == NULL) || (key == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((opMode != ENCRYPT_MODE) && (opMode != DECRYPT_MODE)) {
+        LOGE("Invalid opMode %d", opMode);
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesEtmGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)key, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = (HcfCipherAesEtmGeneratorSpiOpensslImpl *)self;
+    const unsigned char *iv = GetEtmIv(params);
+    if (iv == NULL) {
+        return HCF_INVALID_PARAMS;
+    }
+    ClearMessage(impl);
+    impl->isKeySet = false;
+    HcfResult ret = SetEtmKey(impl, opMode, &(((SymKeyImpl *)key)->keyMaterial));
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    impl->enc = opMode;
+    impl->isKeySet = true;
+    return StartMessage(impl, iv);
+}
+
+static HcfResult EngineReset(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params)
+{
+    if (self == NULL) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesEtmGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = (HcfCipherAesEtmGeneratorSpiOpensslImpl *)self;
+    if (!impl->isKeySet) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    const unsigned char *iv = GetEtmIv(params);
+    if (iv == NULL) {
+        return HCF_INVALID_PARAMS;
+    }
+    return StartMessage(impl, iv);
+}
+
+static HcfResult GetStartedImpl(OH_HCF_CipherGeneratorSpi *self, HcfCipherAesEtmGeneratorSpiOpensslImpl **impl)
+{
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesEtmGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    *impl = (HcfCipherAesEtmGeneratorSpiOpensslImpl *)self;
+    if (!(*impl)->isStarted) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+/* encrypt in tiles and mac each tile of ciphertext while it is still in the cache */
+static HcfResult EncryptAndMac(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, const HcfBlob *input, uint8_t *out,
+    uint32_t *outLen)
+{
+    uint32_t written = 0;
+    uint32_t inputLen = IsBlobValid(input) ? input->len : 0;
+    for (uint32_t offset = 0; offset < inputLen; offset += ETM_TILE_LEN) {
+        uint32_t len = (inputLen - offset > ETM_TILE_LEN) ? ETM_TILE_LEN : (inputLen - offset);
+        int32_t tileLen = 0;
+        if (EVP_EncryptUpdate(impl->ctx, out + written, &tileLen, input->data + offset, (int32_t)len) !=
+            HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("cipher update failed!");
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        if (HMAC_Update(impl->hmac, out + written, (size_t)tileLen) != HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("hmac update failed!");
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        written += (uint32_t)tileLen;
+    }
+    impl->heldLen = impl->heldLen + inputLen - written;
+    *outLen = written;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EncryptFinal(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, const HcfBlob *input,
+    HcfBlob *output)
+{
+    uint32_t written = 0;
+    HcfResult ret = EncryptAndMac(impl, input, output->data, &written);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    int32_t lastLen = 0;
+    if (EVP_EncryptFinal_ex(impl->ctx, output->data + written, &lastLen) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher final failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    uint32_t tagLen = 0;
+    if ((HMAC_Update(impl->hmac, output->data + written, (size_t)lastLen) != HCF_OPENSSL_SUCCESS) ||
+        (HMAC_Final(impl->hmac, output->data + written + lastLen, &tagLen) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("hmac final failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    output->len = written + (uint32_t)lastLen + tagLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult VerifyTag(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, const uint8_t *cipherText,
+    uint32_t cipherTextLen)
+{
+    uint8_t tag[EVP_MAX_MD_SIZE] = {0};
+    uint32_t tagLen = 0;
+    if ((HMAC_Update(impl->hmac, cipherText, cipherTextLen) != HCF_OPENSSL_SUCCESS) ||
+        (HMAC_Final(impl->hmac, tag, &tagLen) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("hmac final failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if (CRYPTO_memcmp(tag, cipherText + cipherTextLen, tagLen) != 0) {
+        LOGE("encrypt-then-mac tag verify failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult DecryptVerified(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, const uint8_t *cipherText,
+    uint32_t cipherTextLen, HcfBlob *output)
+{
+    int32_t len = 0;
+    int32_t lastLen = 0;
+    if (EVP_DecryptUpdate(impl->ctx, output->data, &len, cipherText, (int32_t)cipherTextLen) !=
+        HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if (EVP_DecryptFinal_ex(impl->ctx, output->data + len, &lastLen) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher final failed!");
+        (void)memset_s(output->data, output->len, 0, (uint32_t)len);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    output->len = (uint32_t)(len + lastLen);
+    return HCF_SUCCESS;
+}
+
+static HcfResult AppendMessage(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, const HcfBlob *input)
+{
+    if (!IsBlobValid(input)) {
+        return HCF_SUCCESS;
+    }
+    uint64_t len = (uint64_t)impl->bufLen + input->len;
+    if (len > INT32_MAX) {
+        LOGE("encrypt-then-mac message is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (len > impl->bufCap) {
+        uint32_t newCap = (impl->bufCap > 0) ? (impl->bufCap * 2) : (uint32_t)len;
+        newCap = (newCap < len) ? (uint32_t)len : newCap;
+        uint8_t *newBuf = (uint8_t *)HcfMalloc(newCap, 0);
+        if (newBuf == NULL) {
+            LOGE("malloc message buffer failed!");
+            return HCF_ERR_MALLOC;
+        }
+        if (impl->bufLen > 0) {
+            (void)memcpy_s(newBuf, newCap, impl->buf, impl->bufLen);
+            (void)memset_s(impl->buf, impl->bufCap, 0, impl->bufLen);
+        }
+        HcfFree(impl->buf);
+        impl->buf = newBuf;
+        impl->bufCap = newCap;
+    }
+    (void)memcpy_s(impl->buf + impl->bufLen, impl->bufCap - impl->bufLen, input->data, input->len);
+    impl->bufLen += input->len;
+    return HCF_SUCCESS;
+}
+
+/* the whole ciphertext || tag, from the update buffer or straight from input */
+static HcfResult DecryptFinal(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, HcfBlob *input, HcfBlob *output)
+{
+    const uint8_t *message = IsBlobValid(input) ? input->data : NULL;
+    uint32_t messageLen = IsBlobValid(input) ? input->len : 0;
+    if (impl->bufLen > 0) {
+        HcfResult ret = AppendMessage(impl, input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        message = impl->buf;
+        messageLen = impl->bufLen;
+    }
+    HcfResult ret = VerifyTag(impl, message, messageLen - impl->tagLen);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    return DecryptVerified(impl, message, messageLen - impl->tagLen, output);
+}
+
+static uint32_t GetEtmOutputLen(const HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, uint32_t inputLen,
+    bool isFinal)
+{
+    if (impl->enc == DECRYPT_MODE) {
+        return isFinal ? (impl->bufLen + inputLen - impl->tagLen) : 0;
+    }
+    if (impl->attr.mode != HCF_ALG_MODE_CBC) {
+        return isFinal ? (inputLen + impl->tagLen) : inputLen;
+    }
+    /* cbc keeps back less than a block, which comes out with the next input or with the padding block */
+    if (!isFinal) {
+        return inputLen + ETM_BLOCK_SIZE;
+    }
+    uint32_t outLen = (impl->heldLen + inputLen + ETM_BLOCK_SIZE - 1) / ETM_BLOCK_SIZE * ETM_BLOCK_SIZE;
+    return outLen + ETM_BLOCK_SIZE + impl->tagLen;
+}
+
+static HcfResult CheckDecryptLen(const HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, uint32_t inputLen)
+{
+    if ((impl->enc == DECRYPT_MODE) && ((uint64_t)impl->bufLen + inputLen < impl->tagLen)) {
+        LOGE("encrypt-then-mac message is shorter than the tag!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult EtmUpdate(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, HcfBlob *input, HcfBlob *output)
+{
+    if (impl->enc == DECRYPT_MODE) {
+        output->len = 0;
+        return AppendMessage(impl, input);
+    }
+    uint32_t written = 0;
+    HcfResult ret = EncryptAndMac(impl, input, output->data, &written);
+    if (ret == HCF_SUCCESS) {
+        output->len = written;
+    }
+    return ret;
+}
+
+static HcfResult EtmDoFinal(HcfCipherAesEtmGeneratorSpiOpensslImpl *impl, HcfBlob *input, HcfBlob *output)
+{
+    HcfResult ret = (impl->enc == ENCRYPT_MODE) ? EncryptFinal(impl, input, output) :
+        DecryptFinal(impl, input, output);
+    if (ret != HCF_SUCCESS) {
+        LOGE("encrypt-then-mac final failed!");
+    }
+    ClearMessage(impl);
+    return ret;
+}
+
+static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult ret = GetStartedImpl(self, &impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint32_t outLen = GetEtmOutputLen(impl, IsBlobValid(input) ? input->len : 0, false);
+    /* HcfMalloc rejects zero, an update that only buffers still gets a valid buffer */
+    output->data = (uint8_t *)HcfMalloc((outLen > 0) ? outLen : 1, 0);
+    if (output->data == NULL) {
+        LOGE("malloc output failed!");
+        return HCF_ERR_MALLOC;
+    }
+    ret = EtmUpdate(impl, input, output);
+    if (ret != HCF_SUCCESS) {
+        HcfBlobDataFree(output);
+        ClearMessage(impl);
+    }
+    return ret;
+}
+
+static HcfResult EngineUpdateToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult ret = GetStartedImpl(self, &impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint32_t outLen = GetEtmOutputLen(impl, IsBlobValid(input) ? input->len : 0, false);
+    if ((outLen > 0) && ((output->data == NULL) || (output->len < outLen))) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
+        return HCF_INVALID_PARAMS;
+    }
+    ret = EtmUpdate(impl, input, output);
+    if (ret != HCF_SUCCESS) {
+        ClearMessage(impl);
+    }
+    return ret;
+}
+
+static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult ret = GetStartedImpl(self, &impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint32_t inputLen = IsBlobValid(input) ? input->len : 0;
+    ret = CheckDecryptLen(impl, inputLen);
+    if (ret != HCF_SUCCESS) {
+        ClearMessage(impl);
+        return ret;
+    }
+    uint32_t outLen = GetEtmOutputLen(impl, inputLen, true);
+    output->data = (uint8_t *)HcfMalloc((outLen > 0) ? outLen : 1, 0);
+    if (output->data == NULL) {
+        LOGE("malloc output failed!");
+        ClearMessage(impl);
+        return HCF_ERR_MALLOC;
+    }
+    output->len = outLen;
+    ret = EtmDoFinal(impl, input, output);
+    if (ret != HCF_SUCCESS) {
+        HcfBlobDataFree(output);
+    }
+    return ret;
+}
+
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult ret = GetStartedImpl(self, &impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint32_t inputLen = IsBlobValid(input) ? input->len : 0;
+    ret = CheckDecryptLen(impl, inputLen);
+    if (ret != HCF_SUCCESS) {
+        ClearMessage(impl);
+        return ret;
+    }
+    uint32_t outLen = GetEtmOutputLen(impl, inputLen, true);
+    if ((output->data == NULL) || (output->len < outLen)) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
+        return HCF_INVALID_PARAMS;
+    }
+    return EtmDoFinal(impl, input, output);
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult ret = GetStartedImpl(self, &impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (isFinal) {
+        ret = CheckDecryptLen(impl, inputLen);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    *outputLen = GetEtmOutputLen(impl, inputLen, isFinal);
+    return HCF_SUCCESS;
+}
+
+static void EngineAesEtmGeneratorDestroy(HcfObjectBase *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch(self, GetAesEtmGeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *impl = (HcfCipherAesEtmGeneratorSpiOpensslImpl *)self;
+    ClearMessage(impl);
+    HcfFree(impl->buf);
+    EVP_CIPHER_CTX_free(impl->ctx);
+    HMAC_CTX_free(impl->hmac);
+    HcfFree(impl);
+}
+
+HcfResult HcfCipherAesEtmGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator)
+{
+    if ((attr == NULL) || (generator == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((attr->mode != HCF_ALG_MODE_CBC) && (attr->mode != HCF_ALG_MODE_CTR)) {
+        LOGE("encrypt-then-mac only supports CBC and CTR!");
+        return HCF_NOT_SUPPORT;
+    }
+    if (GetOpensslDigestAlg(attr->macMd) == NULL) {
+        LOGE("Invalid encrypt-then-mac digest!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesEtmGeneratorSpiOpensslImpl *returnImpl = (HcfCipherAesEtmGeneratorSpiOpensslImpl *)HcfMalloc(
+        sizeof(HcfCipherAesEtmGeneratorSpiOpensslImpl), 0);
+    if (returnImpl == NULL) {
+        LOGE("Failed to allocate returnImpl memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    (void)memcpy_s(&returnImpl->attr, sizeof(CipherAttr), attr, sizeof(CipherAttr));
+    returnImpl->base.init = EngineCipherInit;
+    returnImpl->base.update = EngineUpdate;
+    returnImpl->base.doFinal = EngineDoFinal;
+    returnImpl->base.getOutputSize = EngineGetOutputSize;
+    returnImpl->base.updateToBuffer = EngineUpdateToBuffer;
+    returnImpl->base.doFinalToBuffer = EngineDoFinalToBuffer;
+    returnImpl->base.reset = EngineReset;
+    returnImpl->base.base.destroy = EngineAesEtmGeneratorDestroy;
+    returnImpl->base.base.getClass = GetAesEtmGeneratorClass;
+
+    *generator = (OH_HCF_CipherGeneratorSpi *)returnImpl;
+    return HCF_SUCCESS;
+}
@@ -0,0 +1,756 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <openssl/crypto.h>
+#include "log.h"
+#include "blob.h"
+#include "memory.h"
+#include "result.h"
+#include "utils.h"
+#include "securec.h"
+#include "aes_openssl_common.h"
+#include "sym_common_defines.h"
+#include "openssl_common.h"
+#include "openssl_class.h"
+
+/*
+ * AES-GCM-SIV of RFC 8452. The tag is a POLYVAL of the aad and the plaintext encrypted under a key derived from the
+ * nonce, and it is also the initial counter, so a repeated nonce only reveals that two messages are equal. The key
+ * generating key stays scheduled in keyGenCtx across reset, only the per nonce keys are derived for each message.
+ * The whole message is needed before any output, update only collects it and doFinal returns the result.
+ */
+#define GCM_SIV_BLOCK_SIZE 16
+#define GCM_SIV_NONCE_LEN 12
+#define GCM_SIV_TAG_LEN 16
+#define GCM_SIV_KEY_HALF_LEN 8
+#define GCM_SIV_AES128_KEY_LEN 16
+#define GCM_SIV_AES256_KEY_LEN 32
+/* 2^36 bytes, the limit of both the aad and the plaintext */
+#define GCM_SIV_MAX_INPUT_LEN 0x1000000000ULL
+/* counter blocks encrypted by one EVP call */
+#define GCM_SIV_CTR_BATCH_BLOCKS 64
+#define BITS_PER_BYTE 8
+#define BITS_PER_UINT64 64
+#define GHASH_REDUCTION 0xe100000000000000ULL
+
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} PolyvalElem;
+
+/* POLYVAL computed as GHASH on byte reversed blocks, acc and h live in the GHASH domain */
+typedef struct {
+    PolyvalElem h;
+    uint8_t acc[GCM_SIV_BLOCK_SIZE];
+    uint8_t partial[GCM_SIV_BLOCK_SIZE];
+    uint32_t partialLen;
+} PolyvalCtx;
+
+typedef struct {
+    OH_HCF_CipherGeneratorSpi base;
+    CipherAttr attr;
+    /* ecb under the key generating key, scheduled by init and reused by reset */
+    EVP_CIPHER_CTX *keyGenCtx;
+    /* ecb under the message encryption key of the current nonce */
+    EVP_CIPHER_CTX *encCtx;
+    uint32_t keyLen;
+    enum HcfCryptoMode enc;
+    /* a message is open, and whether its data has started so that no more aad is taken */
+    bool isStarted;
+    bool isDataStarted;
+    uint8_t nonce[GCM_SIV_NONCE_LEN];
+    /* decrypt: the expected tag of params */
+    uint8_t tag[GCM_SIV_TAG_LEN];
+    uint64_t aadLen;
+    PolyvalCtx polyval;
+    /* message data collected by update, the buffer is kept for the next message */
+    uint8_t *buf;
+    uint32_t bufLen;
+    uint32_t bufCap;
+} HcfCipherAesGcmSivGeneratorSpiOpensslImpl;
+
+static const char *GetAesGcmSivGeneratorClass(void)
+{
+    return OPENSSL_AES_GCM_SIV_CIPHER_CLASS;
+}
+
+static uint64_t LoadBe64(const uint8_t *in)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < sizeof(uint64_t); i++) {
+        value = (value << BITS_PER_BYTE) | in[i];
+    }
+    return value;
+}
+
+static void StoreBe64(uint64_t value, uint8_t *out)
+{
+    for (int32_t i = sizeof(uint64_t) - 1; i >= 0; i--) {
+        out[i] = (uint8_t)value;
+        value >>= BITS_PER_BYTE;
+    }
+}
+
+static void StoreLe64(uint64_t value, uint8_t *out)
+{
+    for (uint32_t i = 0; i < sizeof(uint64_t); i++) {
+        out[i] = (uint8_t)value;
+        value >>= BITS_PER_BYTE;
+    }
+}
+
+/* multiply by x in the GHASH field */
+static PolyvalElem MulX(PolyvalElem v)
+{
+    uint64_t carry = GHASH_REDUCTION & (0 - (v.lo & 1));
+    v.lo = (v.hi << 63) | (v.lo >> 1);
+    v.hi = (v.hi >> 1) ^ carry;
+    return v;
+}
+
+/* POLYVAL(H, X) = ByteReverse(GHASH(MulX(ByteReverse(H)), ByteReverse(X))), see RFC 8452 appendix A */
+static void PolyvalInit(PolyvalCtx *ctx, const uint8_t *authKey)
+{
+    uint8_t reversed[GCM_SIV_BLOCK_SIZE];
+    for (uint32_t i = 0; i < GCM_SIV_BLOCK_SIZE; i++) {
+        reversed[i] = authKey[GCM_SIV_BLOCK_SIZE - 1 - i];
+    }
+    PolyvalElem h = { LoadBe64(reversed), LoadBe64(reversed + sizeof(uint64_t)) };
+    ctx->h = MulX(h);
+    (void)memset_s(ctx->acc, sizeof(ctx->acc), 0, sizeof(ctx->acc));
+    ctx->partialLen = 0;
+    (void)memset_s(reversed, sizeof(reversed), 0, sizeof(reversed));
+}
+
+/*
+ * acc = acc * H by masked shift and xor, no memory access or branch depends on the auth key or on acc, so the
+ * multiply leaks nothing through the cache or the branch predictor
+ */
+static void PolyvalMul(PolyvalCtx *ctx)
+{
+    uint8_t *acc = ctx->acc;
+    PolyvalElem x = { LoadBe64(acc), LoadBe64(acc + sizeof(uint64_t)) };
+    PolyvalElem z = { 0, 0 };
+    PolyvalElem v = ctx->h;
+    for (uint32_t i = 0; i < GCM_SIV_BLOCK_SIZE * BITS_PER_BYTE; i++) {
+        uint64_t word = (i < BITS_PER_UINT64) ? x.hi : x.lo;
+        uint64_t mask = 0 - ((word >> (BITS_PER_UINT64 - 1 - (i % BITS_PER_UINT64))) & 1);
+        z.hi ^= v.hi & mask;
+        z.lo ^= v.lo & mask;
+        v = MulX(v);
+    }
+    StoreBe64(z.hi, acc);
+    StoreBe64(z.lo, acc + sizeof(uint64_t));
+}
+
+static void PolyvalBlock(PolyvalCtx *ctx, const uint8_t *block)
+{
+    for (uint32_t i = 0; i < GCM_SIV_BLOCK_SIZE; i++) {
+        ctx->acc[i] ^= block[GCM_SIV_BLOCK_SIZE - 1 - i];
+    }
+    PolyvalMul(ctx);
+}
+
+static void PolyvalUpdate(PolyvalCtx *ctx, const uint8_t *in, uint32_t len)
+{
+    if (ctx->partialLen > 0) {
+        uint32_t fill = GCM_SIV_BLOCK_SIZE - ctx->partialLen;
+        fill = (len < fill) ? len : fill;
+        (void)memcpy_s(ctx->partial + ctx->partialLen, GCM_SIV_BLOCK_SIZE - ctx->partialLen, in, fill);
+        ctx->partialLen += fill;
+        in += fill;
+        len -= fill;
+        if (ctx->partialLen < GCM_SIV_BLOCK_SIZE) {
+            return;
+        }
+        PolyvalBlock(ctx, ctx->partial);
+        ctx->partialLen = 0;
+    }
+    while (len >= GCM_SIV_BLOCK_SIZE) {
+        PolyvalBlock(ctx, in);
+        in += GCM_SIV_BLOCK_SIZE;
+        len -= GCM_SIV_BLOCK_SIZE;
+    }
+    if (len > 0) {
+        (void)memcpy_s(ctx->partial, GCM_SIV_BLOCK_SIZE, in, len);
+        ctx->partialLen = len;
+    }
+}
+
+/* the aad and the plaintext are each zero padded to a whole block */
+static void PolyvalPad(PolyvalCtx *ctx)
+{
+    if (ctx->partialLen == 0) {
+        return;
+    }
+    (void)memset_s(ctx->partial + ctx->partialLen, GCM_SIV_BLOCK_SIZE - ctx->partialLen, 0,
+        GCM_SIV_BLOCK_SIZE - ctx->partialLen);
+    PolyvalBlock(ctx, ctx->partial);
+    ctx->partialLen = 0;
+}
+
+static HcfResult EcbEncrypt(EVP_CIPHER_CTX *ctx, const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    int32_t outLen = 0;
+    if (EVP_EncryptUpdate(ctx, out, &outLen, in, (int32_t)len) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("ecb encrypt failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static const EVP_CIPHER *GetEcbType(uint32_t keyLen)
+{
+    return (keyLen == GCM_SIV_AES256_KEY_LEN) ? EVP_aes_256_ecb() : EVP_aes_128_ecb();
+}
+
+/* derive the per nonce keys: block i is AES(K, LE32(i) || nonce), the first half of each block is used */
+static HcfResult DeriveMessageKeys(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl)
+{
+    uint32_t blockNum = (GCM_SIV_BLOCK_SIZE + impl->keyLen) / GCM_SIV_KEY_HALF_LEN;
+    uint8_t blocks[(GCM_SIV_BLOCK_SIZE + GCM_SIV_AES256_KEY_LEN) / GCM_SIV_KEY_HALF_LEN][GCM_SIV_BLOCK_SIZE] = {0};
+    uint8_t keys[GCM_SIV_BLOCK_SIZE + GCM_SIV_AES256_KEY_LEN] = {0};
+    for (uint32_t i = 0; i < blockNum; i++) {
+        blocks[i][0] = (uint8_t)i;
+        (void)memcpy_s(blocks[i] + sizeof(uint32_t), GCM_SIV_NONCE_LEN, impl->nonce, GCM_SIV_NONCE_LEN);
+    }
+    HcfResult ret = EcbEncrypt(impl->keyGenCtx, (uint8_t *)blocks, (uint8_t *)blocks, blockNum * GCM_SIV_BLOCK_SIZE);
+    if (ret == HCF_SUCCESS) {
+        for (uint32_t i = 0; i < blockNum; i++) {
+            (void)memcpy_s(keys + i * GCM_SIV_KEY_HALF_LEN, sizeof(keys) - i * GCM_SIV_KEY_HALF_LEN, blocks[i],
+                GCM_SIV_KEY_HALF_LEN);
+        }
+        PolyvalInit(&(impl->polyval), keys);
+        if (EVP_EncryptInit_ex(impl->encCtx, NULL, NULL, keys + GCM_SIV_BLOCK_SIZE, NULL) != HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("set message encryption key failed!");
+            ret = HCF_ERR_CRYPTO_OPERATION;
+        }
+    }
+    (void)memset_s(blocks, sizeof(blocks), 0, sizeof(blocks));
+    (void)memset_s(keys, sizeof(keys), 0, sizeof(keys));
+    return ret;
+}
+
+/* the message params are a HcfGcmParamsSpec: a 12 byte nonce, the aad and a 16 byte tag */
+static bool IsGcmSivParamsValid(HcfGcmParamsSpec *params)
+{
+    if (params == NULL) {
+        LOGE("params is null!");
+        return false;
+    }
+    if (((params->aad.len > 0) && (params->aad.data == NULL)) || (params->aad.len > INT32_MAX)) {
+        LOGE("aad is invalid!");
+        return false;
+    }
+    if ((params->iv.data == NULL) || (params->iv.len != GCM_SIV_NONCE_LEN)) {
+        LOGE("iv is invalid!");
+        return false;
+    }
+    if ((params->tag.data == NULL) || (params->tag.len != GCM_SIV_TAG_LEN)) {
+        LOGE("tag is invalid!");
+        return false;
+    }
+    return true;
+}
+
+static void ClearMessage(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl)
+{
+    if (impl->buf != NULL) {
+        (void)memset_s(impl->buf, impl->bufCap, 0, impl->bufLen);
+    }
+    impl->bufLen = 0;
+    impl->aadLen = 0;
+    impl->isStarted = false;
+    impl->isDataStarted = false;
+    (void)memset_s(&(impl->polyval), sizeof(PolyvalCtx), 0, sizeof(PolyvalCtx));
+}
+
+static HcfResult StartMessage(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, HcfGcmParamsSpec *params)
+{
+    ClearMessage(impl);
+    (void)memcpy_s(impl->nonce, sizeof(impl->nonce), params->iv.data, GCM_SIV_NONCE_LEN);
+    if (impl->enc == DECRYPT_MODE) {
+        (void)memcpy_s(impl->tag, sizeof(impl->tag), params->tag.data, GCM_SIV_TAG_LEN);
+    }
+    HcfResult ret = DeriveMessageKeys(impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    PolyvalUpdate(&(impl->polyval), params->aad.data, params->aad.len);
+    impl->aadLen = params->aad.len;
+    impl->isStarted = true;
+    return HCF_SUCCESS;
+}
+
+static HcfResult InitKeyGenCtx(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, const HcfBlob *key)
+{
+    if (impl->keyGenCtx == NULL) {
+        impl->keyGenCtx = EVP_CIPHER_CTX_new();
+        impl->encCtx = EVP_CIPHER_CTX_new();
+        if ((impl->keyGenCtx == NULL) || (impl->encCtx == NULL)) {
+            LOGE("Failed to allocate ctx memroy!");
+            return HCF_ERR_MALLOC;
+        }
+    }
+    const EVP_CIPHER *type = GetEcbType(key->len);
+    if ((EVP_EncryptInit_ex(impl->keyGenCtx, type, NULL, key->data, NULL) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptInit_ex(impl->encCtx, type, NULL, NULL, NULL) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("cipher init key failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    (void)EVP_CIPHER_CTX_set_padding(impl->keyGenCtx, 0);
+    (void)EVP_CIPHER_CTX_set_padding(impl->encCtx, 0);
+    impl->keyLen = key->len;
+    return HCF_SUCCESS;
+}
+
+static uint32_t GetExpectKeyLen(const CipherAttr *attr)
+{
+    return (attr->keySize == HCF_ALG_AES_256) ? GCM_SIV_AES256_KEY_LEN : GCM_SIV_AES128_KEY_LEN;
+}
+
+static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
+    HcfKey *key, HcfParamsSpec *params)
+{
+    if ((self == NULL) || (key == NULL) || !IsGcmSivParamsValid((HcfGcmParamsSpec *)params)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((opMode != ENCRYPT_MODE) && (opMode != DECRYPT_MODE)) {
+        LOGE("Invalid opMode %d", opMode);
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesGcmSivGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)key, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = (HcfCipherAesGcmSivGeneratorSpiOpensslImpl *)self;
+    SymKeyImpl *keyImpl = (SymKeyImpl *)key;
+    if (keyImpl->keyMaterial.len != GetExpectKeyLen(&(impl->attr))) {
+        LOGE("key length does not match the cipher!");
+        return HCF_INVALID_PARAMS;
+    }
+    impl->keyLen = 0;
+    HcfResult ret = InitKeyGenCtx(impl, &(keyImpl->keyMaterial));
+    if (ret != HCF_SUCCESS) {
+        impl->keyLen = 0;
+        return ret;
+    }
+    impl->enc = opMode;
+    ret = StartMessage(impl, (HcfGcmParamsSpec *)params);
+    if (ret != HCF_SUCCESS) {
+        ClearMessage(impl);
+    }
+    return ret;
+}
+
+static HcfResult EngineReset(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params)
+{
+    if ((self == NULL) || !IsGcmSivParamsValid((HcfGcmParamsSpec *)params)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesGcmSivGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = (HcfCipherAesGcmSivGeneratorSpiOpensslImpl *)self;
+    if (impl->keyLen == 0) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    /* keep the scheduled key generating key, only derive the keys of the new nonce */
+    HcfResult ret = StartMessage(impl, (HcfGcmParamsSpec *)params);
+    if (ret != HCF_SUCCESS) {
+        ClearMessage(impl);
+    }
+    return ret;
+}
+
+static HcfResult GetStartedImpl(OH_HCF_CipherGeneratorSpi *self, HcfCipherAesGcmSivGeneratorSpiOpensslImpl **impl)
+{
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesGcmSivGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    *impl = (HcfCipherAesGcmSivGeneratorSpiOpensslImpl *)self;
+    if (!(*impl)->isStarted) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetMessageLen(const HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, uint32_t inputLen,
+    uint64_t *msgLen)
+{
+    *msgLen = (uint64_t)impl->bufLen + inputLen;
+    if ((*msgLen > GCM_SIV_MAX_INPUT_LEN) || (*msgLen + GCM_SIV_TAG_LEN > UINT32_MAX)) {
+        LOGE("message is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static uint32_t GetOutputLen(const HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, uint32_t inputLen, bool isFinal)
+{
+    /* nothing is returned before the whole message is there */
+    if (!isFinal) {
+        return 0;
+    }
+    uint32_t outLen = impl->bufLen + inputLen;
+    return (impl->enc == ENCRYPT_MODE) ? (outLen + GCM_SIV_TAG_LEN) : outLen;
+}
+
+static HcfResult AppendMessage(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, const HcfBlob *input)
+{
+    if (!IsBlobValid(input)) {
+        return HCF_SUCCESS;
+    }
+    uint64_t msgLen = 0;
+    HcfResult ret = GetMessageLen(impl, input->len, &msgLen);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (msgLen > impl->bufCap) {
+        uint64_t newCap = (impl->bufCap > 0) ? ((uint64_t)impl->bufCap * 2) : msgLen;
+        newCap = (newCap < msgLen) ? msgLen : newCap;
+        newCap = (newCap > UINT32_MAX) ? UINT32_MAX : newCap;
+        uint8_t *newBuf = (uint8_t *)HcfMalloc((uint32_t)newCap, 0);
+        if (newBuf == NULL) {
+            LOGE("malloc message buffer failed!");
+            return HCF_ERR_MALLOC;
+        }
+        if (impl->bufLen > 0) {
+            (void)memcpy_s(newBuf, (uint32_t)newCap, impl->buf, impl->bufLen);
+            (void)memset_s(impl->buf, impl->bufCap, 0, impl->bufLen);
+        }
+        HcfFree(impl->buf);
+        impl->buf = newBuf;
+        impl->bufCap = (uint32_t)newCap;
+    }
+    (void)memcpy_s(impl->buf + impl->bufLen, impl->bufCap - impl->bufLen, input->data, input->len);
+    impl->bufLen += input->len;
+    impl->isDataStarted = true;
+    return HCF_SUCCESS;
+}
+
+/* counter mode with the tag as initial block, the first 32 bits are a little endian counter */
+static HcfResult CtrXor(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, const uint8_t *tag,
+    const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    uint8_t counters[GCM_SIV_CTR_BATCH_BLOCKS * GCM_SIV_BLOCK_SIZE];
+    uint8_t stream[GCM_SIV_CTR_BATCH_BLOCKS * GCM_SIV_BLOCK_SIZE];
+    uint8_t counter[GCM_SIV_BLOCK_SIZE];
+    (void)memcpy_s(counter, sizeof(counter), tag, GCM_SIV_TAG_LEN);
+    counter[GCM_SIV_BLOCK_SIZE - 1] |= 0x80;
+    uint32_t ctr = (uint32_t)counter[0] | ((uint32_t)counter[1] << 8) | ((uint32_t)counter[2] << 16) |
+        ((uint32_t)counter[3] << 24);
+    HcfResult ret = HCF_SUCCESS;
+    while (len > 0) {
+        uint32_t chunk = (len < sizeof(stream)) ? len : sizeof(stream);
+        uint32_t blocks = (chunk + GCM_SIV_BLOCK_SIZE - 1) / GCM_SIV_BLOCK_SIZE;
+        for (uint32_t i = 0; i < blocks; i++) {
+            uint8_t *block = counters + i * GCM_SIV_BLOCK_SIZE;
+            (void)memcpy_s(block, GCM_SIV_BLOCK_SIZE, counter, GCM_SIV_BLOCK_SIZE);
+            block[0] = (uint8_t)ctr;
+            block[1] = (uint8_t)(ctr >> 8);
+            block[2] = (uint8_t)(ctr >> 16);
+            block[3] = (uint8_t)(ctr >> 24);
+            ctr++;
+        }
+        ret = EcbEncrypt(impl->encCtx, counters, stream, blocks * GCM_SIV_BLOCK_SIZE);
+        if (ret != HCF_SUCCESS) {
+            break;
+        }
+        for (uint32_t i = 0; i < chunk; i++) {
+            out[i] = in[i] ^ stream[i];
+        }
+        in += chunk;
+        out += chunk;
+        len -= chunk;
+    }
+    (void)memset_s(stream, sizeof(stream), 0, sizeof(stream));
+    return ret;
+}
+
+/* tag = AES(encryption key, POLYVAL(aad, plaintext, lengths) ^ nonce with the top bit cleared) */
+static HcfResult ComputeTag(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, const uint8_t *plainText,
+    uint32_t len, uint8_t *tag)
+{
+    PolyvalCtx *polyval = &(impl->polyval);
+    PolyvalPad(polyval);
+    PolyvalUpdate(polyval, plainText, len);
+    PolyvalPad(polyval);
+    uint8_t lengthBlock[GCM_SIV_BLOCK_SIZE];
+    StoreLe64(impl->aadLen * BITS_PER_BYTE, lengthBlock);
+    StoreLe64((uint64_t)len * BITS_PER_BYTE, lengthBlock + sizeof(uint64_t));
+    PolyvalBlock(polyval, lengthBlock);
+    uint8_t s[GCM_SIV_BLOCK_SIZE];
+    for (uint32_t i = 0; i < GCM_SIV_BLOCK_SIZE; i++) {
+        s[i] = polyval->acc[GCM_SIV_BLOCK_SIZE - 1 - i];
+    }
+    for (uint32_t i = 0; i < GCM_SIV_NONCE_LEN; i++) {
+        s[i] ^= impl->nonce[i];
+    }
+    s[GCM_SIV_BLOCK_SIZE - 1] &= 0x7f;
+    HcfResult ret = EcbEncrypt(impl->encCtx, s, tag, GCM_SIV_BLOCK_SIZE);
+    (void)memset_s(s, sizeof(s), 0, sizeof(s));
+    return ret;
+}
+
+static HcfResult GcmSivDoFinal(HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl, HcfBlob *input, HcfBlob *output)
+{
+    const uint8_t *msg = IsBlobValid(input) ? input->data : NULL;
+    uint32_t msgLen = IsBlobValid(input) ? input->len : 0;
+    if (impl->bufLen > 0) {
+        HcfResult ret = AppendMessage(impl, input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        msg = impl->buf;
+        msgLen = impl->bufLen;
+    }
+    uint8_t tag[GCM_SIV_TAG_LEN];
+    if (impl->enc == ENCRYPT_MODE) {
+        /* the tag is taken over the plaintext before the output, which may be the input, is written */
+        HcfResult ret = ComputeTag(impl, msg, msgLen, tag);
+        if (ret == HCF_SUCCESS) {
+            ret = CtrXor(impl, tag, msg, output->data, msgLen);
+        }
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        (void)memcpy_s(output->data + msgLen, output->len - msgLen, tag, GCM_SIV_TAG_LEN);
+        output->len = msgLen + GCM_SIV_TAG_LEN;
+        return HCF_SUCCESS;
+    }
+    HcfResult ret = CtrXor(impl, impl->tag, msg, output->data, msgLen);
+    if (ret == HCF_SUCCESS) {
+        ret = ComputeTag(impl, output->data, msgLen, tag);
+    }
+    if ((ret == HCF_SUCCESS) && (CRYPTO_memcmp(tag, impl->tag, GCM_SIV_TAG_LEN) != 0)) {
+        LOGE("tag check failed!");
+        ret = HCF_ERR_CRYPTO_OPERATION;
+    }
+    if (ret != HCF_SUCCESS) {
+        if (msgLen > 0) {
+            (void)memset_s(output->data, output->len, 0, msgLen);
+        }
+        return ret;
+    }
+    output->len = msgLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdateAad(OH_HCF_CipherGeneratorSpi *self, HcfBlob *aad)
+{
+    if ((self == NULL) || (aad == NULL) || ((aad->len > 0) && (aad->data == NULL)) || (aad->len > INT32_MAX)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    if (impl->isDataStarted) {
+        LOGE("aad must be given before the message data!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (impl->aadLen + aad->len > GCM_SIV_MAX_INPUT_LEN) {
+        LOGE("aad is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    PolyvalUpdate(&(impl->polyval), aad->data, aad->len);
+    impl->aadLen += aad->len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = AppendMessage(impl, input);
+    if (res != HCF_SUCCESS) {
+        ClearMessage(impl);
+        return res;
+    }
+    output->data = NULL;
+    output->len = 0;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdateToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = AppendMessage(impl, input);
+    if (res != HCF_SUCCESS) {
+        ClearMessage(impl);
+        return res;
+    }
+    output->len = 0;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint64_t msgLen = 0;
+    res = GetMessageLen(impl, IsBlobValid(input) ? input->len : 0, &msgLen);
+    if (res == HCF_SUCCESS) {
+        uint32_t outLen = GetOutputLen(impl, IsBlobValid(input) ? input->len : 0, true);
+        /* HcfMalloc rejects zero, an empty message still gets a valid buffer */
+        output->data = (uint8_t *)HcfMalloc((outLen > 0) ? outLen : 1, 0);
+        output->len = outLen;
+        res = (output->data == NULL) ? HCF_ERR_MALLOC : GcmSivDoFinal(impl, input, output);
+    }
+    if (res != HCF_SUCCESS) {
+        LOGE("GcmSivDoFinal failed!");
+        HcfBlobDataFree(output);
+    }
+    ClearMessage(impl);
+    return res;
+}
+
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint64_t msgLen = 0;
+    res = GetMessageLen(impl, IsBlobValid(input) ? input->len : 0, &msgLen);
+    if (res != HCF_SUCCESS) {
+        ClearMessage(impl);
+        return res;
+    }
+    uint32_t outLen = GetOutputLen(impl, IsBlobValid(input) ? input->len : 0, true);
+    if (((output->data == NULL) && (outLen > 0)) || (output->len < outLen)) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
+        return HCF_INVALID_PARAMS;
+    }
+    res = GcmSivDoFinal(impl, input, output);
+    if (res != HCF_SUCCESS) {
+        LOGE("GcmSivDoFinal failed!");
+    }
+    ClearMessage(impl);
+    return res;
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint64_t msgLen = 0;
+    res = GetMessageLen(impl, inputLen, &msgLen);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    *outputLen = GetOutputLen(impl, inputLen, isFinal);
+    return HCF_SUCCESS;
+}
+
+static void EngineAesGcmSivGeneratorDestroy(HcfObjectBase *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch(self, GetAesGcmSivGeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *impl = (HcfCipherAesGcmSivGeneratorSpiOpensslImpl *)self;
+    ClearMessage(impl);
+    HcfFree(impl->buf);
+    EVP_CIPHER_CTX_free(impl->keyGenCtx);
+    EVP_CIPHER_CTX_free(impl->encCtx);
+    HcfFree(impl);
+}
+
+HcfResult HcfCipherAesGcmSivGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator)
+{
+    if ((attr == NULL) || (generator == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((attr->keySize != HCF_ALG_AES_128) && (attr->keySize != HCF_ALG_AES_256)) {
+        LOGE("GCM-SIV only supports AES128 and AES256!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGcmSivGeneratorSpiOpensslImpl *returnImpl = (HcfCipherAesGcmSivGeneratorSpiOpensslImpl *)HcfMalloc(
+        sizeof(HcfCipherAesGcmSivGeneratorSpiOpensslImpl), 0);
+    if (returnImpl == NULL) {
+        LOGE("Failed to allocate returnImpl memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    (void)memcpy_s(&returnImpl->attr, sizeof(CipherAttr), attr, sizeof(CipherAttr));
+    returnImpl->base.init = EngineCipherInit;
+    returnImpl->base.update = EngineUpdate;
+    returnImpl->base.doFinal = EngineDoFinal;
+    returnImpl->base.getOutputSize = EngineGetOutputSize;
+    returnImpl->base.updateToBuffer = EngineUpdateToBuffer;
+    returnImpl->base.doFinalToBuffer = EngineDoFinalToBuffer;
+    returnImpl->base.reset = EngineReset;
+    returnImpl->base.updateAad = EngineUpdateAad;
+    returnImpl->base.base.destroy = EngineAesGcmSivGeneratorDestroy;
+    returnImpl->base.base.getClass = GetAesGcmSivGeneratorClass;
+
+    *generator = (OH_HCF_CipherGeneratorSpi *)returnImpl;
+    return HCF_SUCCESS;
+}
@@ -19,23 +19,27 @@
 #include "memory.h"
 #include "result.h"
 #include "utils.h"
+#include "hcf_parallel.h"
 #include "aes_openssl_common.h"
+#include "aes_openssl_parallel.h"
+#include "aes_openssl_ccm_stream.h"
 #include "sym_common_defines.h"
 #include "openssl_common.h"
 #include "openssl_class.h"
 
-#define MAX_AAD_LEN 2048
 #define GCM_IV_LEN 12
 #define CCM_IV_MIN_LEN 7
 #define CCM_IV_MAX_LEN 13
 #define AES_BLOCK_SIZE 16
-#define GCM_TAG_SIZE 16
-#define CCM_TAG_SIZE 12
 
 typedef struct {
     OH_HCF_CipherGeneratorSpi base;
     CipherAttr attr;
     CipherData *cipherData;
+    /* keyed ctx of the last finished message, reused by reset and init */
+    CipherData *idleData;
+    AesParallelConfig parallel;
+    bool isGcmVerifyFirst;
 } HcfCipherAesGeneratorSpiOpensslImpl;
 
 static const char *GetAesGeneratorClass(void)
@@ -228,13 +232,19 @@ static const EVP_CIPHER *GetCipherType(HcfCipherAesGeneratorSpiOpensslImpl *impl
     return DefautCiherType();
 }
 
+/* the aad may be empty, EVP_CipherUpdate takes an int length */
+static bool IsAadValid(const HcfBlob *aad)
+{
+    return ((aad->len == 0) || (aad->data != NULL)) && (aad->len <= INT32_MAX);
+}
+
 static bool IsGcmParamsValid(HcfGcmParamsSpec *params)
 {
     if (params == NULL) {
         LOGE("params is null!");
         return false;
     }
-    if ((params->aad.data == NULL) || (params->aad.len == 0) || (params->aad.len > MAX_AAD_LEN)) {
+    if (!IsAadValid(&(params->aad))) {
         LOGE("aad is invalid!");
         return false;
     }
@@ -242,7 +252,7 @@ static bool IsGcmParamsValid(HcfGcmParamsSpec *params)
         LOGE("iv is invalid!");
         return false;
     }
-    if ((params->tag.data == NULL) || (params->tag.len == 0)) {
+    if ((params->tag.data == NULL) || (params->tag.len == 0) || (params->tag.len > CIPHER_MAX_TAG_SIZE)) {
         LOGE("tag is invalid!");
         return false;
     }
@@ -255,7 +265,7 @@ static bool IsCcmParamsValid(HcfCcmParamsSpec *params)
         LOGE("params is null!");
         return false;
     }
-    if ((params->aad.data == NULL) || (params->aad.len == 0) || (params->aad.len > MAX_AAD_LEN)) {
+    if (!IsAadValid(&(params->aad))) {
         LOGE("aad is invalid!");
         return false;
     }
@@ -263,7 +273,7 @@ static bool IsCcmParamsValid(HcfCcmParamsSpec *params)
         LOGE("iv is invalid!");
         return false;
     }
-    if ((params->tag.data == NULL) || (params->tag.len == 0)) {
+    if ((params->tag.data == NULL) || (params->tag.len == 0) || (params->tag.len > CIPHER_MAX_TAG_SIZE)) {
         LOGE("tag is invalid!");
         return false;
     }
@@ -277,26 +287,54 @@ static HcfResult InitAadAndTagFromGcmParams(enum HcfCryptoMode opMode, HcfGcmPar
         return HCF_INVALID_PARAMS;
     }
 
-    data->aad = (uint8_t *)HcfMalloc(params->aad.len, 0);
-    if (data->aad == NULL) {
-        LOGE("aad malloc failed!");
-        return HCF_ERR_MALLOC;
-    }
-    (void)memcpy_s(data->aad, params->aad.len, params->aad.data, params->aad.len);
-    data->aadLen = params->aad.len;
+    /* the aad is authenticated straight from params once the iv is set, see FeedGcmAad */
     data->aead = true;
     data->tagLen = params->tag.len;
-    if (opMode == ENCRYPT_MODE) {
+    if (opMode == DECRYPT_MODE) {
+        (void)memcpy_s(data->tag, sizeof(data->tag), params->tag.data, params->tag.len);
+        data->hasTag = true;
+    }
+    return HCF_SUCCESS;
+}
+
+/* ccm takes the whole aad in one call after the message length, so it is buffered until the first update */
+static HcfResult AppendCcmAad(CipherData *data, const HcfBlob *aad)
+{
+    if (aad->len == 0) {
         return HCF_SUCCESS;
     }
-    data->tag = (uint8_t *)HcfMalloc(params->tag.len, 0);
-    if (data->tag == NULL) {
-        HcfFree(data->aad);
-        data->aad = NULL;
-        LOGE("tag malloc failed!");
+    if (aad->len > INT32_MAX - data->aadLen) {
+        LOGE("aad is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint32_t newLen = (uint32_t)data->aadLen + aad->len;
+    uint8_t *newAad = (uint8_t *)HcfMalloc(newLen, 0);
+    if (newAad == NULL) {
+        LOGE("aad malloc failed!");
         return HCF_ERR_MALLOC;
     }
-    (void)memcpy_s(data->tag, params->tag.len, params->tag.data, params->tag.len);
+    if (data->aad != NULL) {
+        (void)memcpy_s(newAad, newLen, data->aad, data->aadLen);
+        HcfFree(data->aad);
+    }
+    (void)memcpy_s(newAad + data->aadLen, newLen - data->aadLen, aad->data, aad->len);
+    data->aad = newAad;
+    data->aadLen = newLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult FeedGcmAad(CipherData *data, const HcfBlob *aad)
+{
+    if (aad->len == 0) {
+        return HCF_SUCCESS;
+    }
+    int32_t outLen = 0;
+    if (EVP_CipherUpdate(data->ctx, NULL, &outLen, aad->data, (int32_t)aad->len) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("aad cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    data->aadLen += aad->len;
     return HCF_SUCCESS;
 }
 
@@ -307,63 +345,164 @@ static HcfResult InitAadAndTagFromCcmParams(enum HcfCryptoMode opMode, HcfCcmPar
         return HCF_INVALID_PARAMS;
     }
 
-    data->aad = (uint8_t *)HcfMalloc(params->aad.len, 0);
-    if (data->aad == NULL) {
-        LOGE("aad malloc failed!");
-        return HCF_ERR_MALLOC;
+    HcfResult ret = AppendCcmAad(data, &(params->aad));
+    if (ret != HCF_SUCCESS) {
+        return ret;
     }
-    (void)memcpy_s(data->aad, params->aad.len, params->aad.data, params->aad.len);
-    data->aadLen = params->aad.len;
     data->aead = true;
+    data->isCcmStream = params->isDataLenSet;
     data->tagLen = params->tag.len;
-    if (opMode == ENCRYPT_MODE) {
+    if (opMode == DECRYPT_MODE) {
+        (void)memcpy_s(data->tag, sizeof(data->tag), params->tag.data, params->tag.len);
+        data->hasTag = true;
+    }
+    return HCF_SUCCESS;
+}
+
+/* the parallel engine derives the iv of every segment from the message iv */
+static HcfResult InitIv(HcfParamsSpec *params, CipherData *data)
+{
+    const unsigned char *iv = GetIv(params);
+    int32_t ivLen = GetIvLen(params);
+    if ((iv == NULL) || (ivLen <= 0) || (ivLen > CIPHER_MAX_BLOCK_SIZE)) {
         return HCF_SUCCESS;
     }
-    data->tag = (uint8_t *)HcfMalloc(params->tag.len, 0);
-    if (data->tag == NULL) {
-        HcfFree(data->aad);
-        data->aad = NULL;
-        LOGE("tag malloc failed!");
-        return HCF_ERR_MALLOC;
+    (void)memcpy_s(data->iv, sizeof(data->iv), iv, ivLen);
+    data->ivLen = (uint32_t)ivLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult InitKey(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, SymKeyImpl *keyImpl)
+{
+    CipherData *data = cipherImpl->cipherData;
+    FreeCcmStream(&(data->ccmStream));
+    (void)memset_s(data->gcmH, sizeof(data->gcmH), 0, sizeof(data->gcmH));
+    data->isGcmHReady = false;
+    (void)memset_s(data->key, sizeof(data->key), 0, sizeof(data->key));
+    data->keyLen = 0;
+    if ((cipherImpl->attr.mode != HCF_ALG_MODE_GCM) && (cipherImpl->attr.mode != HCF_ALG_MODE_CCM)) {
+        return HCF_SUCCESS;
     }
-    (void)memcpy_s(data->tag, params->tag.len, params->tag.data, params->tag.len);
+    if (memcpy_s(data->key, sizeof(data->key), keyImpl->keyMaterial.data, keyImpl->keyMaterial.len) != EOK) {
+        LOGE("key is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    data->keyLen = keyImpl->keyMaterial.len;
     return HCF_SUCCESS;
 }
 
-static HcfResult InitCipherData(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
-    HcfParamsSpec *params, CipherData **cipherData)
+static HcfResult InitCipherData(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, enum HcfCryptoMode opMode,
+    HcfParamsSpec *params)
 {
-    HcfResult ret = HCF_ERR_MALLOC;
-    *cipherData = (CipherData *)HcfMalloc(sizeof(CipherData), 0);
-    if (*cipherData == NULL) {
-        LOGE("malloc is failed!");
+    HcfResult ret = AcquireCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    if (ret != HCF_SUCCESS) {
+        LOGE("AcquireCipherData failed!");
         return ret;
     }
-    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    CipherData *data = cipherImpl->cipherData;
     HCF_ALG_PARA_VALUE mode = cipherImpl->attr.mode;
 
-    (*cipherData)->enc = opMode;
-    (*cipherData)->ctx = EVP_CIPHER_CTX_new();
-    if ((*cipherData)->ctx == NULL) {
-        HcfPrintOpensslError();
-        LOGE("Failed to allocate ctx memroy!");
-        goto clearup;
+    data->enc = opMode;
+    data->mode = mode;
+    data->parallel = &(cipherImpl->parallel);
+    data->isVerifyFirst = cipherImpl->isGcmVerifyFirst;
+    if ((mode == HCF_ALG_MODE_CBC) || (mode == HCF_ALG_MODE_CTR) || (mode == HCF_ALG_MODE_GCM)) {
+        ret = InitIv(params, data);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
     }
-
-    ret = HCF_SUCCESS;
     if (mode == HCF_ALG_MODE_GCM) {
-        ret = InitAadAndTagFromGcmParams(opMode, (HcfGcmParamsSpec *)params, *cipherData);
+        ret = InitAadAndTagFromGcmParams(opMode, (HcfGcmParamsSpec *)params, data);
     } else if (mode == HCF_ALG_MODE_CCM) {
-        ret = InitAadAndTagFromCcmParams(opMode, (HcfCcmParamsSpec *)params, *cipherData);
+        ret = InitAadAndTagFromCcmParams(opMode, (HcfCcmParamsSpec *)params, data);
     }
     if (ret != HCF_SUCCESS) {
         LOGE("gcm or ccm init failed!");
-        goto clearup;
     }
     return ret;
-clearup:
-    FreeCipherData(cipherData);
-    return ret;
+}
+
+/* ccm fixes the nonce and tag lengths when the key is set, so both go in before the key */
+static HcfResult SetCcmIvLen(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfParamsSpec *params)
+{
+    if (cipherImpl->attr.mode != HCF_ALG_MODE_CCM) {
+        return HCF_SUCCESS;
+    }
+    if (EVP_CIPHER_CTX_ctrl(cipherImpl->cipherData->ctx, EVP_CTRL_AEAD_SET_IVLEN, GetIvLen(params), NULL) !=
+        HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("set ccm iv length failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult SetCcmTag(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfParamsSpec *params)
+{
+    CipherData *data = cipherImpl->cipherData;
+    if (cipherImpl->attr.mode != HCF_ALG_MODE_CCM) {
+        return HCF_SUCCESS;
+    }
+    /* ccm decrypt need set tag, encrypt only sets the tag length */
+    void *tag = (data->enc == ENCRYPT_MODE) ? NULL : GetCcmTag(params);
+    if (EVP_CIPHER_CTX_ctrl(data->ctx, EVP_CTRL_AEAD_SET_TAG, GetCcmTagLen(params), tag) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("set AuthTag failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult InitGcmAad(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfParamsSpec *params)
+{
+    if (cipherImpl->attr.mode != HCF_ALG_MODE_GCM) {
+        return HCF_SUCCESS;
+    }
+    return FeedGcmAad(cipherImpl->cipherData, &(((HcfGcmParamsSpec *)params)->aad));
+}
+
+static HcfResult InitCcmStream(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfParamsSpec *params)
+{
+    CipherData *data = cipherImpl->cipherData;
+    if ((cipherImpl->attr.mode != HCF_ALG_MODE_CCM) || !data->isCcmStream) {
+        return HCF_SUCCESS;
+    }
+    return CcmStreamStart(data, (HcfCcmParamsSpec *)params);
+}
+
+/* ccm takes the nonce length before the key, the other modes start from the key schedule kept by the key */
+static HcfResult InitCtxWithKey(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, SymKeyImpl *keyImpl,
+    HcfParamsSpec *params, int enc)
+{
+    EVP_CIPHER_CTX *ctx = cipherImpl->cipherData->ctx;
+    if (cipherImpl->attr.mode != HCF_ALG_MODE_CCM) {
+        HcfResult ret = HcfSymKeyInitCipherCtx(keyImpl, GetCipherType(cipherImpl), enc, ctx);
+        if (ret != HCF_SUCCESS) {
+            LOGE("init key failed!");
+            return ret;
+        }
+    } else {
+        if (keyImpl->keyMaterial.len != (size_t)EVP_CIPHER_key_length(GetCipherType(cipherImpl))) {
+            LOGE("key length does not match the cipher!");
+            return HCF_INVALID_PARAMS;
+        }
+        if (EVP_CipherInit(ctx, GetCipherType(cipherImpl), NULL, NULL, enc) != HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("EVP_CipherInit failed!");
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        if ((SetCcmIvLen(cipherImpl, params) != HCF_SUCCESS) || (SetCcmTag(cipherImpl, params) != HCF_SUCCESS)) {
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+    }
+    const unsigned char *key = (cipherImpl->attr.mode == HCF_ALG_MODE_CCM) ? keyImpl->keyMaterial.data : NULL;
+    if (EVP_CipherInit_ex(ctx, NULL, NULL, key, GetIv(params), enc) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("EVP_CipherInit_ex failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
 }
 
 static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
@@ -385,18 +524,18 @@ static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCrypt
     SymKeyImpl *keyImpl = (SymKeyImpl *)key;
     int enc = (opMode == ENCRYPT_MODE) ? 1 : 0;
 
-    if (InitCipherData(self, opMode, params, &(cipherImpl->cipherData)) != HCF_SUCCESS) {
+    HcfResult ret = InitCipherData(cipherImpl, opMode, params);
+    if (ret != HCF_SUCCESS) {
         LOGE("InitCipherData failed!");
-        return HCF_INVALID_PARAMS;
+        FreeCipherData(&(cipherImpl->cipherData));
+        return (ret == HCF_ERR_MALLOC) ? ret : HCF_INVALID_PARAMS;
     }
     CipherData *data = cipherImpl->cipherData;
-    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
-    if (EVP_CipherInit(data->ctx, GetCipherType(cipherImpl), keyImpl->keyMaterial.data, GetIv(params), enc) !=
-        HCF_OPENSSL_SUCCESS) {
-        HcfPrintOpensslError();
-        LOGE("EVP_CipherInit failed!");
+    ret = InitCtxWithKey(cipherImpl, keyImpl, params, enc);
+    if (ret != HCF_SUCCESS) {
         goto clearup;
     }
+    ret = HCF_ERR_CRYPTO_OPERATION;
     int32_t padding = (cipherImpl->attr.paddingMode == HCF_ALG_NOPADDING) ? 0 : EVP_PADDING_PKCS7;
 
     if (EVP_CIPHER_CTX_set_padding(data->ctx, padding) != HCF_OPENSSL_SUCCESS) {
@@ -404,15 +543,15 @@ static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCrypt
         LOGE("set padding failed!");
         goto clearup;
     }
-
-    if (opMode == ENCRYPT_MODE || cipherImpl->attr.mode != HCF_ALG_MODE_CCM) {
-        return HCF_SUCCESS;
+    if (InitGcmAad(cipherImpl, params) != HCF_SUCCESS) {
+        goto clearup;
     }
-    /* ccm decrypt need set tag */
-    if (EVP_CIPHER_CTX_ctrl(data->ctx, EVP_CTRL_AEAD_SET_TAG, GetCcmTagLen(params), GetCcmTag(params)) !=
-        HCF_OPENSSL_SUCCESS) {
-        HcfPrintOpensslError();
-        LOGE("set AuthTag failed!");
+    ret = InitKey(cipherImpl, keyImpl);
+    if (ret != HCF_SUCCESS) {
+        goto clearup;
+    }
+    ret = InitCcmStream(cipherImpl, params);
+    if (ret != HCF_SUCCESS) {
         goto clearup;
     }
     return HCF_SUCCESS;
@@ -421,56 +560,155 @@ clearup:
     return ret;
 }
 
+static HcfResult EngineReset(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params)
+{
+    if (self == NULL) { /* params maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    CipherData *last = (cipherImpl->cipherData != NULL) ? cipherImpl->cipherData : cipherImpl->idleData;
+    if (!IsCipherDataKeyed(last)) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    enum HcfCryptoMode opMode = last->enc;
+    HcfResult ret = InitCipherData(cipherImpl, opMode, params);
+    if (ret != HCF_SUCCESS) {
+        LOGE("InitCipherData failed!");
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+        return ret;
+    }
+    CipherData *data = cipherImpl->cipherData;
+    /* keep the cipher and the expanded key, only load the new iv, ccm sets its kept key again with the lengths */
+    const unsigned char *key = (cipherImpl->attr.mode == HCF_ALG_MODE_CCM) ? data->key : NULL;
+    if ((SetCcmIvLen(cipherImpl, params) != HCF_SUCCESS) || (SetCcmTag(cipherImpl, params) != HCF_SUCCESS) ||
+        (EVP_CipherInit_ex(data->ctx, NULL, NULL, key, GetIv(params), (opMode == ENCRYPT_MODE) ? 1 : 0) !=
+        HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("EVP_CipherInit_ex failed!");
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    ret = InitGcmAad(cipherImpl, params);
+    if (ret == HCF_SUCCESS) {
+        ret = InitCcmStream(cipherImpl, params);
+    }
+    if (ret != HCF_SUCCESS) {
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return ret;
+}
+
+static void SaveLastBlock(CipherData *data, const HcfBlob *input)
+{
+    if (input->len >= CIPHER_MAX_BLOCK_SIZE) {
+        (void)memcpy_s(data->lastBlock, CIPHER_MAX_BLOCK_SIZE, input->data + input->len - CIPHER_MAX_BLOCK_SIZE,
+            CIPHER_MAX_BLOCK_SIZE);
+        return;
+    }
+    uint32_t keep = CIPHER_MAX_BLOCK_SIZE - input->len;
+    (void)memmove_s(data->lastBlock, CIPHER_MAX_BLOCK_SIZE, data->lastBlock + input->len, keep);
+    (void)memcpy_s(data->lastBlock + keep, input->len, input->data, input->len);
+}
+
 static HcfResult CommonUpdate(CipherData *data, HcfBlob *input, HcfBlob *output)
 {
-    int32_t ret = EVP_CipherUpdate(data->ctx, output->data, (int *)&output->len,
-        input->data, input->len);
+    uint32_t parallelLen = 0;
+    HcfResult res = AesParallelUpdate(data, input, output, &parallelLen);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    int32_t outLen = 0;
+    int32_t ret = EVP_CipherUpdate(data->ctx, output->data + parallelLen, &outLen, input->data + parallelLen,
+        input->len - parallelLen);
     if (ret != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
         LOGE("cipher update failed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
+    output->len = parallelLen + (uint32_t)outLen;
+    if ((data->mode == HCF_ALG_MODE_CBC) && (data->enc == DECRYPT_MODE) && IsBlobValid(input)) {
+        SaveLastBlock(data, input);
+    }
+    data->inputLen += input->len;
+    data->outputLen += output->len;
     return HCF_SUCCESS;
 }
 
 static HcfResult AeadUpdate(CipherData *data, HCF_ALG_PARA_VALUE mode, HcfBlob *input, HcfBlob *output)
 {
+    int32_t outLen = 0;
     if (mode == HCF_ALG_MODE_CCM) {
-        if (EVP_CipherUpdate(data->ctx, NULL, (int *)&output->len, NULL, input->len) != HCF_OPENSSL_SUCCESS) {
+        if (EVP_CipherUpdate(data->ctx, NULL, &outLen, NULL, input->len) != HCF_OPENSSL_SUCCESS) {
             HcfPrintOpensslError();
             LOGE("ccm cipher update failed!");
             return HCF_ERR_CRYPTO_OPERATION;
         }
     }
 
-    int32_t ret = EVP_CipherUpdate(data->ctx, NULL, (int *)&output->len, data->aad, data->aadLen);
-    if (ret != HCF_OPENSSL_SUCCESS) {
+    /* the gcm aad went to the ctx when it was given, the ccm aad needs the message length first */
+    if ((mode == HCF_ALG_MODE_CCM) && (data->aadLen > 0) &&
+        (EVP_CipherUpdate(data->ctx, NULL, &outLen, data->aad, (int32_t)data->aadLen) != HCF_OPENSSL_SUCCESS)) {
         HcfPrintOpensslError();
         LOGE("aad cipher update failed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    ret = EVP_CipherUpdate(data->ctx, output->data, (int *)&output->len, input->data, input->len);
+    int32_t ret = EVP_CipherUpdate(data->ctx, output->data, &outLen, input->data, input->len);
     if (ret != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
         LOGE("gcm cipher update failed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
+    output->len = (uint32_t)outLen;
     return HCF_SUCCESS;
 }
 
-static HcfResult AllocateOutput(HcfBlob *input, HcfBlob *output, bool *isUpdateInput)
+/* modes whose update returns exactly its input, nothing is kept back for a partial block */
+static bool IsStreamMode(HCF_ALG_PARA_VALUE mode)
 {
-    uint32_t outLen = 0;
-    if (IsBlobValid(input)) {
-        outLen += input->len;
-        *isUpdateInput = true;
+    switch (mode) {
+        case HCF_ALG_MODE_CTR:
+        case HCF_ALG_MODE_OFB:
+        case HCF_ALG_MODE_CFB:
+        case HCF_ALG_MODE_CFB1:
+        case HCF_ALG_MODE_CFB8:
+        case HCF_ALG_MODE_CFB128:
+        case HCF_ALG_MODE_GCM:
+            return true;
+        default:
+            return false;
     }
-    outLen += AES_BLOCK_SIZE;
-    if (outLen == 0) {
-        LOGE("output size is invaild!");
-        return HCF_INVALID_PARAMS;
+}
+
+static uint32_t GetOutputLen(const CipherData *data, HCF_ALG_PARA_VALUE mode, uint32_t inputLen, bool isFinal)
+{
+    if (!isFinal) {
+        return IsStreamMode(mode) ? inputLen : (inputLen + AES_BLOCK_SIZE);
+    }
+    uint32_t outLen = inputLen + AES_BLOCK_SIZE;
+    if (!IsStreamMode(mode) && (mode != HCF_ALG_MODE_CCM)) {
+        /* the partial block held back by earlier updates is flushed together with the padding block */
+        uint32_t bufLen = (uint32_t)(data->inputLen - data->outputLen);
+        outLen = (bufLen + inputLen + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE * AES_BLOCK_SIZE + AES_BLOCK_SIZE;
+    }
+    if (mode == HCF_ALG_MODE_GCM) {
+        outLen += data->updateLen;
     }
-    output->data = (uint8_t *)HcfMalloc(outLen, 0);
+    if ((data->enc == ENCRYPT_MODE) && ((mode == HCF_ALG_MODE_GCM) || (mode == HCF_ALG_MODE_CCM))) {
+        outLen += data->tagLen;
+    }
+    return outLen;
+}
+
+static HcfResult AllocateOutput(uint32_t outLen, HcfBlob *output)
+{
+    /* HcfMalloc rejects zero, an empty stream mode update still gets a valid buffer */
+    output->data = (uint8_t *)HcfMalloc((outLen > 0) ? outLen : 1, 0);
     if (output->data == NULL) {
         LOGE("malloc output failed!");
         return HCF_ERR_MALLOC;
@@ -479,101 +717,112 @@ static HcfResult AllocateOutput(HcfBlob *input, HcfBlob *output, bool *isUpdateI
     return HCF_SUCCESS;
 }
 
-static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+static HcfResult CheckOutputBuffer(uint32_t outLen, HcfBlob *output)
 {
-    if ((self == NULL) || (input == NULL) || (output == NULL)) {
-        LOGE("Invalid input parameter!");
+    if ((output->data == NULL) || (output->len < outLen)) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
         return HCF_INVALID_PARAMS;
     }
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetAesCipherData(OH_HCF_CipherGeneratorSpi *self, CipherData **data)
+{
     if (!IsClassMatch((const HcfObjectBase *)self, GetAesGeneratorClass())) {
         LOGE("Class is not match.");
         return HCF_INVALID_PARAMS;
     }
-
-    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
-    CipherData *data = cipherImpl->cipherData;
-    if (data == NULL) {
+    *data = ((HcfCipherAesGeneratorSpiOpensslImpl *)self)->cipherData;
+    if (*data == NULL) {
         LOGE("cipherData is null!");
         return HCF_INVALID_PARAMS;
     }
-    bool isUpdateInput = false;
-    HcfResult ret = AllocateOutput(input, output, &isUpdateInput);
-    if (ret != HCF_SUCCESS) {
-        LOGE("AllocateOutput failed!");
-        return ret;
-    }
+    return HCF_SUCCESS;
+}
 
-    if (!data->aead) {
+static HcfResult DoUpdate(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfBlob *input, HcfBlob *output)
+{
+    CipherData *data = cipherImpl->cipherData;
+    HcfResult ret;
+    if (data->isCcmStream) {
+        ret = CcmStreamUpdate(data, input, output);
+    } else if (!data->aead) {
         ret = CommonUpdate(data, input, output);
     } else {
         ret = AeadUpdate(data, cipherImpl->attr.mode, input, output);
     }
     if (ret != HCF_SUCCESS) {
-        HcfBlobDataFree(output);
-        FreeCipherData(&(cipherImpl->cipherData));
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+        return ret;
     }
     data->aead = false;
     return ret;
 }
 
-static HcfResult CommonDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
+static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
 {
-    int32_t ret;
-    uint32_t len = 0;
-    bool isUpdateInput = false;
-    HcfResult res = AllocateOutput(input, output, &isUpdateInput);
-    if (res != HCF_SUCCESS) {
-        LOGE("AllocateOutput failed!");
-        return res;
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
     }
-    if (isUpdateInput) {
-        ret = EVP_CipherUpdate(data->ctx, output->data, (int32_t *)&len, input->data, input->len);
-        if (ret != HCF_OPENSSL_SUCCESS) {
-            HcfPrintOpensslError();
-            LOGE("EVP_CipherUpdate failed!");
-            return HCF_ERR_CRYPTO_OPERATION;
-        }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
     }
-    ret = EVP_CipherFinal_ex(data->ctx, output->data + len, (int *)&output->len);
-    if (ret != HCF_OPENSSL_SUCCESS) {
-        HcfPrintOpensslError();
-        LOGE("EVP_CipherFinal_ex failed!");
-        return HCF_ERR_CRYPTO_OPERATION;
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    uint32_t inputLen = IsBlobValid(input) ? input->len : 0;
+    ret = AllocateOutput(GetOutputLen(data, cipherImpl->attr.mode, inputLen, false), output);
+    if (ret != HCF_SUCCESS) {
+        LOGE("AllocateOutput failed!");
+        return ret;
     }
-    output->len += len;
-    return HCF_SUCCESS;
+    ret = DoUpdate(cipherImpl, input, output);
+    if (ret != HCF_SUCCESS) {
+        HcfBlobDataFree(output);
+    }
+    return ret;
 }
 
-static HcfResult AllocateCcmOutput(CipherData *data, HcfBlob *input, HcfBlob *output, bool *isUpdateInput)
+static HcfResult EngineUpdateToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
 {
-    uint32_t outLen = 0;
-    if (IsBlobValid(input)) {
-        outLen += input->len;
-        *isUpdateInput = true;
-    }
-    int32_t authTagLen = data->enc == ENCRYPT_MODE ? CCM_TAG_SIZE : 0;
-    outLen += authTagLen + AES_BLOCK_SIZE;
-    if (outLen == 0) {
-        LOGE("output size is invaild!");
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
         return HCF_INVALID_PARAMS;
     }
-    output->data = (uint8_t *)HcfMalloc(outLen, 0);
-    if (output->data == NULL) {
-        LOGE("malloc output failed!");
-        return HCF_ERR_MALLOC;
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
     }
-    output->len = outLen;
-    return HCF_SUCCESS;
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    uint32_t inputLen = IsBlobValid(input) ? input->len : 0;
+    ret = CheckOutputBuffer(GetOutputLen(data, cipherImpl->attr.mode, inputLen, false), output);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    return DoUpdate(cipherImpl, input, output);
 }
 
-static HcfResult CcmDecryptDoFinal(HcfBlob *output, bool isUpdateInput)
+static HcfResult CommonDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
 {
-    if (isUpdateInput) { /* DecryptFinal this does not occur in CCM mode */
-        return HCF_SUCCESS;
+    int32_t ret;
+    uint32_t len = 0;
+    int32_t finalLen = 0;
+    if (IsBlobValid(input)) {
+        HcfResult res = CommonUpdate(data, input, output);
+        if (res != HCF_SUCCESS) {
+            return res;
+        }
+        len = output->len;
     }
-    if (output->data != NULL) {
-        HcfBlobDataFree(output);
+    ret = EVP_CipherFinal_ex(data->ctx, output->data + len, &finalLen);
+    if (ret != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("EVP_CipherFinal_ex failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
     }
+    output->len = len + (uint32_t)finalLen;
     return HCF_SUCCESS;
 }
 
@@ -591,14 +840,8 @@ static HcfResult CcmEncryptDoFinal(CipherData *data, HcfBlob *output, uint32_t l
 
 static HcfResult CcmDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
 {
-    bool isUpdateInput = false;
     uint32_t len = 0;
-    HcfResult res = AllocateCcmOutput(data, input, output, &isUpdateInput);
-    if (res != HCF_SUCCESS) {
-        LOGE("AllocateCcmOutput failed!");
-        return res;
-    }
-    if (isUpdateInput) {
+    if (IsBlobValid(input)) {
         HcfResult result = AeadUpdate(data, HCF_ALG_MODE_CCM, input, output);
         if (result != HCF_SUCCESS) {
             LOGE("AeadUpdate failed!");
@@ -609,15 +852,17 @@ static HcfResult CcmDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
     if (data->enc == ENCRYPT_MODE) {
         return CcmEncryptDoFinal(data, output, len);
     } else if (data->enc == DECRYPT_MODE) {
-        return CcmDecryptDoFinal(output, isUpdateInput);
+        /* DecryptFinal this does not occur in CCM mode */
+        output->len = len;
+        return HCF_SUCCESS;
     } else {
         return HCF_INVALID_PARAMS;
     }
 }
 
-static HcfResult GcmDecryptDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output, uint32_t len)
+static HcfResult GcmDecryptDoFinal(CipherData *data, HcfBlob *output, uint32_t len)
 {
-    if (data->tag == NULL) {
+    if (!data->hasTag) {
         LOGE("gcm decrypt has not AuthTag!");
         return HCF_INVALID_PARAMS;
     }
@@ -627,25 +872,27 @@ static HcfResult GcmDecryptDoFinal(CipherData *data, HcfBlob *input, HcfBlob *ou
         LOGE("gcm decrypt set AuthTag failed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    ret = EVP_CipherFinal_ex(data->ctx, output->data + len, (int *)&output->len);
+    int32_t finalLen = 0;
+    ret = EVP_CipherFinal_ex(data->ctx, output->data + len, &finalLen);
     if (ret != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
         LOGE("EVP_CipherFinal_ex failed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    output->len = output->len + len;
+    output->len = len + (uint32_t)finalLen;
     return HCF_SUCCESS;
 }
 
-static HcfResult GcmEncryptDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output, uint32_t len)
+static HcfResult GcmEncryptDoFinal(CipherData *data, HcfBlob *output, uint32_t len)
 {
-    int32_t ret = EVP_CipherFinal_ex(data->ctx, output->data + len, (int *)&output->len);
+    int32_t finalLen = 0;
+    int32_t ret = EVP_CipherFinal_ex(data->ctx, output->data + len, &finalLen);
     if (ret != HCF_OPENSSL_SUCCESS) {
         HcfPrintOpensslError();
         LOGE("EVP_CipherFinal_ex failed!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    output->len += len;
+    output->len = len + (uint32_t)finalLen;
     ret = EVP_CIPHER_CTX_ctrl(data->ctx, EVP_CTRL_AEAD_GET_TAG, data->tagLen,
         output->data + output->len);
     if (ret != HCF_OPENSSL_SUCCESS) {
@@ -657,40 +904,15 @@ static HcfResult GcmEncryptDoFinal(CipherData *data, HcfBlob *input, HcfBlob *ou
     return HCF_SUCCESS;
 }
 
-static HcfResult AllocateGcmOutput(CipherData *data, HcfBlob *input, HcfBlob *output, bool *isUpdateInput)
-{
-    uint32_t outLen = 0;
-    if (IsBlobValid(input)) {
-        outLen += input->len;
-        *isUpdateInput = true;
-    }
-    int32_t authTagLen = data->enc == ENCRYPT_MODE ? GCM_TAG_SIZE : 0;
-    outLen += data->updateLen + authTagLen + AES_BLOCK_SIZE;
-    if (outLen == 0) {
-        LOGE("output size is invaild!");
-        return HCF_INVALID_PARAMS;
-    }
-    output->data = (uint8_t *)HcfMalloc(outLen, 0);
-    if (output->data == NULL) {
-        LOGE("malloc output failed!");
-        return HCF_ERR_MALLOC;
-    }
-    output->len = outLen;
-    return HCF_SUCCESS;
-}
-
 static HcfResult GcmDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
 {
     uint32_t len = 0;
-    bool isUpdateInput = false;
-    HcfResult res = AllocateGcmOutput(data, input, output, &isUpdateInput);
-    if (res != HCF_SUCCESS) {
-        LOGE("AllocateGcmOutput failed!");
-        return res;
+    if (IsAesParallelGcm(data, input)) {
+        return AesParallelGcmDoFinal(data, input, output);
     }
-
-    if (isUpdateInput) {
-        HcfResult result = AeadUpdate(data, HCF_ALG_MODE_GCM, input, output);
+    if (IsBlobValid(input)) {
+        HcfResult result = data->aead ? AeadUpdate(data, HCF_ALG_MODE_GCM, input, output) :
+            CommonUpdate(data, input, output);
         if (result != HCF_SUCCESS) {
             LOGE("AeadUpdate failed!");
             return result;
@@ -698,48 +920,491 @@ static HcfResult GcmDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
         len = output->len;
     }
     if (data->enc == ENCRYPT_MODE) {
-        return GcmEncryptDoFinal(data, input, output, len);
+        return GcmEncryptDoFinal(data, output, len);
     } else if (data->enc == DECRYPT_MODE) {
-        return GcmDecryptDoFinal(data, input, output, len);
+        return GcmDecryptDoFinal(data, output, len);
     } else {
         return HCF_INVALID_PARAMS;
     }
 }
 
+static HcfResult DoFinal(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfBlob *input, HcfBlob *output)
+{
+    HcfResult ret;
+    CipherData *data = cipherImpl->cipherData;
+    HCF_ALG_PARA_VALUE mode = cipherImpl->attr.mode;
+    if (mode == HCF_ALG_MODE_CCM) {
+        ret = data->isCcmStream ? CcmStreamDoFinal(data, input, output) : CcmDoFinal(data, input, output);
+    } else if (mode == HCF_ALG_MODE_GCM) {
+        ret = GcmDoFinal(data, input, output);
+    } else { /* only ECB CBC CTR CFB OFB support */
+        ret = CommonDoFinal(data, input, output);
+    }
+    RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    return ret;
+}
+
+/* a forged verify first gcm message fails here, before any output is allocated or written */
+static HcfResult GcmVerifyFirst(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfBlob *input)
+{
+    HcfResult ret = AesGcmVerifyTag(cipherImpl->cipherData, input);
+    if (ret != HCF_SUCCESS) {
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return ret;
+}
+
 static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
 {
     if ((self == NULL) || (output == NULL)) { /* input maybe is null */
         LOGE("Invalid input parameter!");
         return HCF_INVALID_PARAMS;
     }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    if (IsAesGcmVerifyFirst(data)) {
+        ret = GcmVerifyFirst(cipherImpl, input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    bool isUpdateInput = IsBlobValid(input);
+    uint32_t inputLen = isUpdateInput ? input->len : 0;
+    bool isCcmDecrypt = (cipherImpl->attr.mode == HCF_ALG_MODE_CCM) && (data->enc == DECRYPT_MODE);
+    ret = AllocateOutput(GetOutputLen(data, cipherImpl->attr.mode, inputLen, true), output);
+    if (ret != HCF_SUCCESS) {
+        LOGE("AllocateOutput failed!");
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+        return ret;
+    }
+    ret = DoFinal(cipherImpl, input, output);
+    if (ret != HCF_SUCCESS) {
+        /* the part decrypted before a failed tag or padding check must not stay in freed memory */
+        HcfBlobDataClearAndFree(output);
+    } else if (isCcmDecrypt && !isUpdateInput) {
+        HcfBlobDataFree(output);
+    }
+    return ret;
+}
+
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    if (IsAesGcmVerifyFirst(data)) {
+        ret = GcmVerifyFirst(cipherImpl, input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    uint32_t inputLen = IsBlobValid(input) ? input->len : 0;
+    uint32_t outLen = GetOutputLen(data, cipherImpl->attr.mode, inputLen, true);
+    ret = CheckOutputBuffer(outLen, output);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    uint8_t *outBuf = output->data;
+    ret = DoFinal(cipherImpl, input, output);
+    if (ret != HCF_SUCCESS) {
+        /* never leave plaintext that failed authentication or padding in the caller's buffer */
+        (void)memset_s(outBuf, outLen, 0, outLen);
+        output->len = 0;
+    }
+    return ret;
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    *outputLen = GetOutputLen(data, ((HcfCipherAesGeneratorSpiOpensslImpl *)self)->attr.mode, inputLen, isFinal);
+    return HCF_SUCCESS;
+}
+
+/* openssl ccm takes the whole message in one update, an empty one would skip the update and the tag */
+static bool IsCcmPayloadEmpty(const HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, uint32_t textLen)
+{
+    return (cipherImpl->attr.mode == HCF_ALG_MODE_CCM) && !cipherImpl->cipherData->isCcmStream && (textLen == 0);
+}
+
+static HcfResult AeadSealInPlace(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfCipherPacket *packet)
+{
+    CipherData *data = cipherImpl->cipherData;
+    uint32_t room = packet->capacity - packet->offset;
+    if (room - packet->len < data->tagLen) {
+        LOGE("tailroom is too small for the tag!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (IsCcmPayloadEmpty(cipherImpl, packet->len)) {
+        LOGE("ccm payload is empty!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint8_t *payload = packet->data + packet->offset;
+    HcfBlob input = { .data = payload, .len = packet->len };
+    HcfBlob output = { .data = payload, .len = room };
+    HcfResult ret = DoFinal(cipherImpl, &input, &output);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    packet->len = output.len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult AeadOpenInPlace(HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl, HcfCipherPacket *packet)
+{
+    CipherData *data = cipherImpl->cipherData;
+    if (!data->hasTag || (packet->len < data->tagLen)) {
+        LOGE("payload is shorter than the tag!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint32_t textLen = packet->len - data->tagLen;
+    if (IsCcmPayloadEmpty(cipherImpl, textLen)) {
+        LOGE("ccm payload is empty!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint8_t *payload = packet->data + packet->offset;
+    /* the tag of the packet replaces the one of the init params, ccm checks it in the update */
+    (void)memcpy_s(data->tag, data->tagLen, payload + textLen, data->tagLen);
+    if ((cipherImpl->attr.mode == HCF_ALG_MODE_CCM) && !data->isCcmStream &&
+        (EVP_CIPHER_CTX_ctrl(data->ctx, EVP_CTRL_AEAD_SET_TAG, data->tagLen, data->tag) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("ccm set AuthTag failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    HcfBlob input = { .data = payload, .len = textLen };
+    HcfBlob output = { .data = payload, .len = textLen };
+    HcfResult ret = DoFinal(cipherImpl, &input, &output);
+    if (ret != HCF_SUCCESS) {
+        /* never leave plaintext that failed authentication in the packet */
+        (void)memset_s(payload, packet->len, 0, textLen);
+        return ret;
+    }
+    packet->len = output.len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineAeadInPlace(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
+    HcfCipherPacket *packet)
+{
+    if ((self == NULL) || (packet == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    if ((cipherImpl->attr.mode != HCF_ALG_MODE_GCM) && (cipherImpl->attr.mode != HCF_ALG_MODE_CCM)) {
+        LOGE("in place aead only support gcm and ccm mode!");
+        return HCF_NOT_SUPPORT;
+    }
+    if (data->enc != opMode) {
+        LOGE("cipher is not initialized for this direction!");
+        return HCF_INVALID_PARAMS;
+    }
+    return (opMode == ENCRYPT_MODE) ? AeadSealInPlace(cipherImpl, packet) : AeadOpenInPlace(cipherImpl, packet);
+}
+
+static HcfResult EngineSeek(OH_HCF_CipherGeneratorSpi *self, uint64_t offset)
+{
+    if (self == NULL) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    if (((HcfCipherAesGeneratorSpiOpensslImpl *)self)->attr.mode != HCF_ALG_MODE_CTR) {
+        LOGE("seek only support ctr mode!");
+        return HCF_NOT_SUPPORT;
+    }
+    if (data->ivLen != AES_BLOCK_SIZE) {
+        LOGE("ctr iv is invalid!");
+        return HCF_INVALID_PARAMS;
+    }
+    unsigned char counter[AES_BLOCK_SIZE] = { 0 };
+    AddAesCounter(data->iv, offset / AES_BLOCK_SIZE, counter);
+    if (EVP_CipherInit_ex(data->ctx, NULL, NULL, NULL, counter, (data->enc == ENCRYPT_MODE) ? 1 : 0) !=
+        HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("set ctr counter failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    /* the ctx can not start inside a block, so the head of the block is run into a scratch buffer */
+    int32_t skip = (int32_t)(offset % AES_BLOCK_SIZE);
+    if (skip > 0) {
+        unsigned char scratch[AES_BLOCK_SIZE] = { 0 };
+        int32_t outLen = 0;
+        int32_t res = EVP_CipherUpdate(data->ctx, scratch, &outLen, scratch, skip);
+        (void)memset_s(scratch, sizeof(scratch), 0, sizeof(scratch));
+        if (res != HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("skip ctr keystream failed!");
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+    }
+    /* the parallel engine derives its counters from these */
+    data->inputLen = offset;
+    data->outputLen = offset;
+    return HCF_SUCCESS;
+}
+
+typedef struct {
+    const EVP_CIPHER_CTX *keyCtx;
+    int enc;
+    uint32_t tagLen;
+    HcfCipherBatchItem *items;
+} AeadBatchTask;
+
+static bool IsBatchItemValid(const AeadBatchTask *task, const HcfCipherBatchItem *item)
+{
+    if ((item->iv.data == NULL) || (item->iv.len != GCM_IV_LEN)) {
+        LOGE("iv is invalid!");
+        return false;
+    }
+    if ((item->aad.len > 0 && item->aad.data == NULL) || (item->aad.len > INT32_MAX)) {
+        LOGE("aad is invalid!");
+        return false;
+    }
+    if ((item->input.len > 0 && item->input.data == NULL) || (item->input.len > INT32_MAX - task->tagLen)) {
+        LOGE("input is invalid!");
+        return false;
+    }
+    if ((task->enc == 0) && (item->input.len < task->tagLen)) {
+        LOGE("input is shorter than the tag!");
+        return false;
+    }
+    uint32_t outLen = (task->enc == 1) ? (item->input.len + task->tagLen) : (item->input.len - task->tagLen);
+    if ((item->output.data == NULL) || (item->output.len < outLen)) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
+        return false;
+    }
+    return true;
+}
+
+static HcfResult AeadBatchItemCrypt(EVP_CIPHER_CTX *ctx, const AeadBatchTask *task, HcfCipherBatchItem *item)
+{
+    if (!IsBatchItemValid(task, item)) {
+        return HCF_INVALID_PARAMS;
+    }
+    int dataLen = (task->enc == 1) ? (int)item->input.len : (int)(item->input.len - task->tagLen);
+    int outLen = 0;
+    int finalLen = 0;
+    /* only the iv is loaded, the cipher and the expanded key come from the key ctx */
+    if (EVP_CipherInit_ex(ctx, NULL, NULL, NULL, item->iv.data, task->enc) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("EVP_CipherInit_ex failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if ((item->aad.len > 0) &&
+        (EVP_CipherUpdate(ctx, NULL, &outLen, item->aad.data, (int)item->aad.len) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("aad cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    outLen = 0;
+    if ((dataLen > 0) &&
+        (EVP_CipherUpdate(ctx, item->output.data, &outLen, item->input.data, dataLen) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("gcm cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if ((task->enc == 0) && (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, (int)task->tagLen,
+        item->input.data + dataLen) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("gcm decrypt set AuthTag failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if (EVP_CipherFinal_ex(ctx, item->output.data + outLen, &finalLen) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("EVP_CipherFinal_ex failed!");
+        /* never hand out plaintext that failed authentication */
+        (void)memset_s(item->output.data, item->output.len, 0, outLen);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    outLen += finalLen;
+    if ((task->enc == 1) && (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, (int)task->tagLen,
+        item->output.data + outLen) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("get AuthTag failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    item->output.len = (task->enc == 1) ? ((uint32_t)outLen + task->tagLen) : (uint32_t)outLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult RunAeadBatch(void *arg, uint32_t begin, uint32_t end)
+{
+    AeadBatchTask *task = (AeadBatchTask *)arg;
+    HcfResult ret = HCF_SUCCESS;
+    /* every worker needs its own ctx, copying the key ctx skips the key schedule */
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if ((ctx == NULL) || (EVP_CIPHER_CTX_copy(ctx, task->keyCtx) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("copy cipher ctx failed!");
+        ret = (ctx == NULL) ? HCF_ERR_MALLOC : HCF_ERR_CRYPTO_OPERATION;
+        for (uint32_t i = begin; i < end; i++) {
+            task->items[i].result = ret;
+        }
+        EVP_CIPHER_CTX_free(ctx);
+        return ret;
+    }
+    for (uint32_t i = begin; i < end; i++) {
+        task->items[i].result = AeadBatchItemCrypt(ctx, task, &task->items[i]);
+        if ((ret == HCF_SUCCESS) && (task->items[i].result != HCF_SUCCESS)) {
+            ret = task->items[i].result;
+        }
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+static HcfResult EngineAeadBatch(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode, HcfKey *key,
+    const HcfCipherBatchParams *params, HcfCipherBatchItem *items, uint32_t count)
+{
+    if ((self == NULL) || (key == NULL) || (params == NULL) || (items == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
     if (!IsClassMatch((const HcfObjectBase *)self, GetAesGeneratorClass())) {
         LOGE("Class is not match.");
         return HCF_INVALID_PARAMS;
     }
-    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    if (!IsClassMatch((const HcfObjectBase *)key, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
     HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
-    CipherData *data = cipherImpl->cipherData;
-    HCF_ALG_PARA_VALUE mode = cipherImpl->attr.mode;
-    if (data == NULL) {
-        LOGE("cipherData is null!");
+    if (cipherImpl->attr.mode != HCF_ALG_MODE_GCM) {
+        LOGE("batch aead only support gcm mode!");
+        return HCF_NOT_SUPPORT;
+    }
+    if ((params->tagLen == 0) || (params->tagLen > AES_BLOCK_SIZE)) {
+        LOGE("tag length is invalid!");
         return HCF_INVALID_PARAMS;
     }
+    AeadBatchTask task = {
+        .keyCtx = NULL,
+        .enc = (opMode == ENCRYPT_MODE) ? 1 : 0,
+        .tagLen = params->tagLen,
+        .items = items,
+    };
+    EVP_CIPHER_CTX *keyCtx = EVP_CIPHER_CTX_new();
+    if (keyCtx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    HcfResult ret = HcfSymKeyInitCipherCtx((SymKeyImpl *)key, GetCipherType(cipherImpl), task.enc, keyCtx);
+    if (ret != HCF_SUCCESS) {
+        LOGE("init key failed!");
+        EVP_CIPHER_CTX_free(keyCtx);
+        return ret;
+    }
+    task.keyCtx = keyCtx;
+    ret = HcfParallelRun(count, params->threadNum, RunAeadBatch, &task);
+    EVP_CIPHER_CTX_free(keyCtx);
+    return ret;
+}
 
-    if (mode == HCF_ALG_MODE_CCM) {
-        ret = CcmDoFinal(data, input, output);
-    } else if (mode == HCF_ALG_MODE_GCM) {
-        ret = GcmDoFinal(data, input, output);
-    } else { /* only ECB CBC CTR CFB OFB support */
-        ret = CommonDoFinal(data, input, output);
+static HcfResult EngineSetCipherSpecUint(OH_HCF_CipherGeneratorSpi *self, CipherSpecItem item, uint32_t value)
+{
+    if (self == NULL) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
     }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    switch (item) {
+        case CIPHER_PARALLEL_THRESHOLD:
+            cipherImpl->parallel.threshold = value;
+            break;
+        case CIPHER_PARALLEL_THREAD_NUM:
+            cipherImpl->parallel.threadNum = value;
+            break;
+        case CIPHER_GCM_VERIFY_FIRST:
+            cipherImpl->isGcmVerifyFirst = (value != 0);
+            break;
+        default:
+            LOGE("Invalid cipher spec item %d!", item);
+            return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
 
-    FreeCipherData(&(cipherImpl->cipherData));
+static HcfResult EngineUpdateAad(OH_HCF_CipherGeneratorSpi *self, HcfBlob *aad)
+{
+    if ((self == NULL) || (aad == NULL) || !IsAadValid(aad)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult ret = GetAesCipherData(self, &data);
     if (ret != HCF_SUCCESS) {
-        HcfBlobDataFree(output);
+        return ret;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *cipherImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    HCF_ALG_PARA_VALUE mode = cipherImpl->attr.mode;
+    if ((mode != HCF_ALG_MODE_GCM) && (mode != HCF_ALG_MODE_CCM)) {
+        LOGE("only gcm and ccm support aad!");
+        return HCF_NOT_SUPPORT;
+    }
+    if (!data->aead) {
+        LOGE("aad must be given before the message data!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (mode == HCF_ALG_MODE_CCM) {
+        return AppendCcmAad(data, aad);
+    }
+    ret = FeedGcmAad(data, aad);
+    if (ret != HCF_SUCCESS) {
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
     }
     return ret;
 }
 
+static void EngineClear(OH_HCF_CipherGeneratorSpi *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesGeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherAesGeneratorSpiOpensslImpl *impl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
+    DropCipherKey(&(impl->cipherData), &(impl->idleData));
+    impl->parallel.threshold = AES_PARALLEL_DEFAULT_THRESHOLD;
+    impl->parallel.threadNum = AES_PARALLEL_DEFAULT_THREAD_NUM;
+    impl->isGcmVerifyFirst = false;
+}
+
 static void EngineAesGeneratorDestroy(HcfObjectBase *self)
 {
     if (self == NULL) {
@@ -752,6 +1417,7 @@ static void EngineAesGeneratorDestroy(HcfObjectBase *self)
 
     HcfCipherAesGeneratorSpiOpensslImpl *impl = (HcfCipherAesGeneratorSpiOpensslImpl *)self;
     FreeCipherData(&(impl->cipherData));
+    FreeCipherData(&(impl->idleData));
     HcfFree(impl);
 }
 
@@ -761,6 +1427,15 @@ HcfResult HcfCipherAesGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGenerato
         LOGE("Invalid input parameter.");
         return HCF_INVALID_PARAMS;
     }
+    if (attr->macMd != 0) {
+        return HcfCipherAesEtmGeneratorSpiCreate(attr, generator);
+    }
+    if (attr->mode == HCF_ALG_MODE_GCM_SIV) {
+        return HcfCipherAesGcmSivGeneratorSpiCreate(attr, generator);
+    }
+    if (attr->mode == HCF_ALG_MODE_XTS) {
+        return HcfCipherAesXtsGeneratorSpiCreate(attr, generator);
+    }
     HcfCipherAesGeneratorSpiOpensslImpl *returnImpl = (HcfCipherAesGeneratorSpiOpensslImpl *)HcfMalloc(
         sizeof(HcfCipherAesGeneratorSpiOpensslImpl), 0);
     if (returnImpl == NULL) {
@@ -771,6 +1446,18 @@ HcfResult HcfCipherAesGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGenerato
     returnImpl->base.init = EngineCipherInit;
     returnImpl->base.update = EngineUpdate;
     returnImpl->base.doFinal = EngineDoFinal;
+    returnImpl->base.getOutputSize = EngineGetOutputSize;
+    returnImpl->base.updateToBuffer = EngineUpdateToBuffer;
+    returnImpl->base.doFinalToBuffer = EngineDoFinalToBuffer;
+    returnImpl->base.reset = EngineReset;
+    returnImpl->base.aeadBatch = EngineAeadBatch;
+    returnImpl->base.aeadInPlace = EngineAeadInPlace;
+    returnImpl->base.seek = EngineSeek;
+    returnImpl->base.setCipherSpecUint = EngineSetCipherSpecUint;
+    returnImpl->base.updateAad = EngineUpdateAad;
+    returnImpl->base.clear = EngineClear;
+    returnImpl->parallel.threshold = AES_PARALLEL_DEFAULT_THRESHOLD;
+    returnImpl->parallel.threadNum = AES_PARALLEL_DEFAULT_THREAD_NUM;
     returnImpl->base.base.destroy = EngineAesGeneratorDestroy;
     returnImpl->base.base.getClass = GetAesGeneratorClass;
 
@@ -0,0 +1,607 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aes_openssl_parallel.h"
+
+#include <pthread.h>
+#include <openssl/crypto.h>
+#include "securec.h"
+#include "aes_openssl_common.h"
+#include "hcf_parallel.h"
+#include "log.h"
+#include "openssl_common.h"
+#include "utils.h"
+
+#define AES_BLOCK_LEN 16
+#define GCM_IV_LEN 12
+#define GCM_COUNTER_LEN 4
+/* the 32 bit gcm counter of the data starts at 2 and must not wrap */
+#define GCM_MAX_DATA_BLOCKS 0xFFFFFFFDULL
+#define GCM_REDUCTION 0xE100000000000000ULL
+#define BITS_PER_BYTE 8
+#define BITS_PER_UINT64 64
+/* openssl updates take an int length */
+#define GCM_AAD_STEP_LEN (1U << 30)
+
+typedef const EVP_CIPHER *(*AesCipherFunc)(void);
+
+typedef struct {
+    uint32_t keyLen;
+    AesCipherFunc ecb;
+    AesCipherFunc ctr;
+    AesCipherFunc gcm;
+} AesCipherSet;
+
+static const AesCipherSet AES_CIPHER_SET[] = {
+    { 16, EVP_aes_128_ecb, EVP_aes_128_ctr, EVP_aes_128_gcm },
+    { 24, EVP_aes_192_ecb, EVP_aes_192_ctr, EVP_aes_192_gcm },
+    { 32, EVP_aes_256_ecb, EVP_aes_256_ctr, EVP_aes_256_gcm },
+};
+
+/* element of GF(2^128) in gcm bit order, hi holds the first 8 bytes */
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} GcmBlock;
+
+typedef struct {
+    CipherData *data;
+    const unsigned char *in;
+    unsigned char *out;
+    /* ctr: counter of the first block, cbc: iv of the first block */
+    const unsigned char *iv;
+} BlockTask;
+
+typedef struct {
+    const AesCipherSet *cipherSet;
+    const unsigned char *key;
+    const unsigned char *in;
+    unsigned char *out;
+    uint32_t len;
+    uint64_t blocks;
+    int enc;
+    unsigned char counter[AES_BLOCK_LEN];
+    GcmBlock h;
+    /* E(K, 0^96 || 1), the mask of a gmac with an all zero iv */
+    GcmBlock zeroIvMask;
+    pthread_mutex_t lock;
+    GcmBlock ghash;
+} GcmTask;
+
+static GcmBlock LoadGcmBlock(const unsigned char *in)
+{
+    GcmBlock block = { 0, 0 };
+    for (uint32_t i = 0; i < AES_BLOCK_LEN / 2; i++) {
+        block.hi = (block.hi << BITS_PER_BYTE) | in[i];
+        block.lo = (block.lo << BITS_PER_BYTE) | in[i + AES_BLOCK_LEN / 2];
+    }
+    return block;
+}
+
+static void StoreGcmBlock(GcmBlock block, unsigned char *out)
+{
+    for (int32_t i = AES_BLOCK_LEN / 2 - 1; i >= 0; i--) {
+        out[i] = (unsigned char)block.hi;
+        out[i + AES_BLOCK_LEN / 2] = (unsigned char)block.lo;
+        block.hi >>= BITS_PER_BYTE;
+        block.lo >>= BITS_PER_BYTE;
+    }
+}
+
+static GcmBlock GcmXor(GcmBlock x, GcmBlock y)
+{
+    GcmBlock z = { x.hi ^ y.hi, x.lo ^ y.lo };
+    return z;
+}
+
+/* multiplication in GF(2^128) as defined by NIST SP 800-38D, without secret dependent branches */
+static GcmBlock GcmMul(GcmBlock x, GcmBlock y)
+{
+    GcmBlock z = { 0, 0 };
+    GcmBlock v = y;
+    for (uint32_t i = 0; i < AES_BLOCK_LEN * BITS_PER_BYTE; i++) {
+        uint64_t word = (i < BITS_PER_UINT64) ? x.hi : x.lo;
+        uint64_t mask = 0 - ((word >> (BITS_PER_UINT64 - 1 - (i % BITS_PER_UINT64))) & 1);
+        z.hi ^= v.hi & mask;
+        z.lo ^= v.lo & mask;
+        uint64_t carry = 0 - (v.lo & 1);
+        v.lo = (v.lo >> 1) | (v.hi << (BITS_PER_UINT64 - 1));
+        v.hi = (v.hi >> 1) ^ (GCM_REDUCTION & carry);
+    }
+    return z;
+}
+
+static GcmBlock GcmPow(GcmBlock h, uint64_t n)
+{
+    GcmBlock result = { 1ULL << (BITS_PER_UINT64 - 1), 0 }; /* the multiplicative identity */
+    while (n > 0) {
+        if ((n & 1) != 0) {
+            result = GcmMul(result, h);
+        }
+        h = GcmMul(h, h);
+        n >>= 1;
+    }
+    return result;
+}
+
+/* the length block of a gmac over len bytes of aad, multiplied by h */
+static GcmBlock GcmAadLenMulH(uint64_t len, GcmBlock h)
+{
+    GcmBlock lenBlock = { len * BITS_PER_BYTE, 0 };
+    return GcmMul(lenBlock, h);
+}
+
+static const AesCipherSet *FindAesCipherSet(uint32_t keyLen)
+{
+    for (uint32_t i = 0; i < sizeof(AES_CIPHER_SET) / sizeof(AES_CIPHER_SET[0]); i++) {
+        if (AES_CIPHER_SET[i].keyLen == keyLen) {
+            return &AES_CIPHER_SET[i];
+        }
+    }
+    return NULL;
+}
+
+static bool IsParallelEnabled(const CipherData *data, const HcfBlob *input)
+{
+    return (data->parallel != NULL) && (data->parallel->threadNum > 1) && IsBlobValid(input) &&
+        (input->len >= data->parallel->threshold);
+}
+
+static bool IsOverlap(const HcfBlob *input, const HcfBlob *output)
+{
+    return (output->data < input->data + input->len) && (input->data < output->data + input->len);
+}
+
+static uint32_t GetParallelBulkLen(const CipherData *data, const HcfBlob *input, const HcfBlob *output)
+{
+    if (!IsParallelEnabled(data, input) || (data->inputLen != data->outputLen)) {
+        /* the ctx still holds bytes of an earlier update */
+        return 0;
+    }
+    bool isCbcDecrypt = (data->mode == HCF_ALG_MODE_CBC) && (data->enc == DECRYPT_MODE);
+    if ((data->mode != HCF_ALG_MODE_ECB) && (data->mode != HCF_ALG_MODE_CTR) && !isCbcDecrypt) {
+        return 0;
+    }
+    if ((data->mode != HCF_ALG_MODE_ECB) && (data->ivLen != AES_BLOCK_LEN)) {
+        return 0;
+    }
+    if ((data->mode == HCF_ALG_MODE_CTR) && (data->inputLen % AES_BLOCK_LEN != 0)) {
+        return 0;
+    }
+    /* in place is fine for ecb and ctr, cbc decrypt needs the previous ciphertext block */
+    if (IsOverlap(input, output) && (isCbcDecrypt || (input->data != output->data))) {
+        return 0;
+    }
+    uint32_t bulk = input->len - input->len % AES_BLOCK_LEN;
+    /* with padding, the ctx keeps back the last block of a block aligned decrypt input */
+    if ((data->enc == DECRYPT_MODE) && (data->mode != HCF_ALG_MODE_CTR) && (bulk == input->len) &&
+        (EVP_CIPHER_CTX_test_flags(data->ctx, EVP_CIPH_NO_PADDING) == 0)) {
+        bulk -= AES_BLOCK_LEN;
+    }
+    return bulk;
+}
+
+static HcfResult RunBlockSegment(void *arg, uint32_t begin, uint32_t end)
+{
+    BlockTask *task = (BlockTask *)arg;
+    CipherData *data = task->data;
+    uint32_t offset = begin * AES_BLOCK_LEN;
+    int32_t segmentLen = (int32_t)((end - begin) * AES_BLOCK_LEN);
+    unsigned char counter[AES_BLOCK_LEN] = { 0 };
+    const unsigned char *iv = NULL;
+    if (data->mode == HCF_ALG_MODE_CTR) {
+        AddAesCounter(task->iv, begin, counter);
+        iv = counter;
+    } else if (data->mode == HCF_ALG_MODE_CBC) {
+        iv = (begin == 0) ? task->iv : (task->in + offset - AES_BLOCK_LEN);
+    }
+
+    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    int32_t outLen = 0;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    /* the copy keeps the expanded key of the main ctx */
+    if ((EVP_CIPHER_CTX_copy(ctx, data->ctx) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CIPHER_CTX_set_padding(ctx, 0) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, (data->enc == ENCRYPT_MODE) ? 1 : 0) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CipherUpdate(ctx, task->out + offset, &outLen, task->in + offset, segmentLen) != HCF_OPENSSL_SUCCESS) ||
+        (outLen != segmentLen)) {
+        HcfPrintOpensslError();
+        LOGE("parallel segment failed!");
+        goto clearup;
+    }
+    ret = HCF_SUCCESS;
+clearup:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+HcfResult AesParallelUpdate(CipherData *data, HcfBlob *input, HcfBlob *output, uint32_t *processedLen)
+{
+    *processedLen = 0;
+    uint32_t bulk = GetParallelBulkLen(data, input, output);
+    if (bulk == 0) {
+        return HCF_SUCCESS;
+    }
+    unsigned char counter[AES_BLOCK_LEN] = { 0 };
+    BlockTask task = { .data = data, .in = input->data, .out = output->data, .iv = NULL };
+    if (data->mode == HCF_ALG_MODE_CTR) {
+        AddAesCounter(data->iv, data->inputLen / AES_BLOCK_LEN, counter);
+        task.iv = counter;
+    } else if (data->mode == HCF_ALG_MODE_CBC) {
+        task.iv = (data->inputLen == 0) ? data->iv : data->lastBlock;
+    }
+    HcfResult ret = HcfParallelRun(bulk / AES_BLOCK_LEN, data->parallel->threadNum, RunBlockSegment, &task);
+    if (ret != HCF_SUCCESS) {
+        LOGE("parallel update failed!");
+        return ret;
+    }
+
+    /* move the main ctx behind the segments, the remaining input continues from there */
+    const unsigned char *next = NULL;
+    if (data->mode == HCF_ALG_MODE_CTR) {
+        AddAesCounter(data->iv, (data->inputLen + bulk) / AES_BLOCK_LEN, counter);
+        next = counter;
+    } else if (data->mode == HCF_ALG_MODE_CBC) {
+        next = input->data + bulk - AES_BLOCK_LEN;
+    }
+    if ((next != NULL) &&
+        (EVP_CipherInit_ex(data->ctx, NULL, NULL, NULL, next, (data->enc == ENCRYPT_MODE) ? 1 : 0) !=
+        HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("move ctx iv failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    *processedLen = bulk;
+    return HCF_SUCCESS;
+}
+
+bool IsAesParallelGcm(const CipherData *data, const HcfBlob *input)
+{
+    if (!IsParallelEnabled(data, input) || !data->aead || (data->keyLen == 0)) {
+        return false;
+    }
+    if ((data->ivLen != GCM_IV_LEN) || (data->tagLen == 0) || (data->tagLen > AES_BLOCK_LEN)) {
+        return false;
+    }
+    if ((data->enc == DECRYPT_MODE) && !data->hasTag) {
+        return false;
+    }
+    return ((input->len + AES_BLOCK_LEN - 1) / AES_BLOCK_LEN <= GCM_MAX_DATA_BLOCKS) &&
+        (FindAesCipherSet(data->keyLen) != NULL);
+}
+
+static HcfResult EncryptAesBlocks(const AesCipherSet *cipherSet, const unsigned char *key,
+    const unsigned char *in, unsigned char *out, int32_t len)
+{
+    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    int32_t outLen = 0;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    if ((EVP_EncryptInit_ex(ctx, cipherSet->ecb(), NULL, key, NULL) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CIPHER_CTX_set_padding(ctx, 0) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptUpdate(ctx, out, &outLen, in, len) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("ecb encrypt failed!");
+        goto clearup;
+    }
+    ret = HCF_SUCCESS;
+clearup:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+/* gmac with an all zero iv over in as aad, without the mask: GHASH(in || len) */
+static HcfResult GcmGhashWithLen(const GcmTask *task, const unsigned char *in, uint32_t len, GcmBlock *ghash)
+{
+    unsigned char zeroIv[GCM_IV_LEN] = { 0 };
+    unsigned char tag[AES_BLOCK_LEN] = { 0 };
+    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    int32_t outLen = 0;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    if ((EVP_EncryptInit_ex(ctx, task->cipherSet->gcm(), NULL, task->key, zeroIv) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptUpdate(ctx, NULL, &outLen, in, (int32_t)len) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptFinal_ex(ctx, tag, &outLen) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, AES_BLOCK_LEN, tag) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("gmac failed!");
+        goto clearup;
+    }
+    *ghash = GcmXor(LoadGcmBlock(tag), task->zeroIvMask);
+    ret = HCF_SUCCESS;
+clearup:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+/*
+ * Contribution of a segment to GHASH(A || C || L) * H^-1, when blocksAfter ghash blocks follow it:
+ * (GHASH(segment || Ls) ^ Ls * H) * H^blocksAfter.
+ */
+static HcfResult GcmSegmentGhash(const GcmTask *task, const unsigned char *in, uint32_t len, uint64_t blocksAfter,
+    GcmBlock *ghash)
+{
+    GcmBlock withLen = { 0, 0 };
+    HcfResult ret = GcmGhashWithLen(task, in, len, &withLen);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    *ghash = GcmMul(GcmXor(withLen, GcmAadLenMulH(len, task->h)), GcmPow(task->h, blocksAfter));
+    return HCF_SUCCESS;
+}
+
+static HcfResult RunGcmSegment(void *arg, uint32_t begin, uint32_t end)
+{
+    GcmTask *task = (GcmTask *)arg;
+    uint32_t offset = begin * AES_BLOCK_LEN;
+    uint32_t segmentEnd = ((uint64_t)end * AES_BLOCK_LEN < task->len) ? end * AES_BLOCK_LEN : task->len;
+    uint32_t segmentLen = segmentEnd - offset;
+    unsigned char counter[AES_BLOCK_LEN] = { 0 };
+    int32_t outLen = 0;
+    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    GcmBlock ghash = { 0, 0 };
+    /* ghash covers the ciphertext, when decrypting read it before an in place decrypt overwrites it */
+    if (task->enc == 0) {
+        ret = GcmSegmentGhash(task, task->in + offset, segmentLen, task->blocks - end, &ghash);
+        if (ret != HCF_SUCCESS) {
+            goto clearup;
+        }
+    }
+    /* the data counter never wraps its low 32 bits, so a 128 bit ctr counter matches gcm */
+    AddAesCounter(task->counter, begin, counter);
+    if ((EVP_EncryptInit_ex(ctx, task->cipherSet->ctr(), NULL, task->key, counter) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptUpdate(ctx, task->out + offset, &outLen, task->in + offset, (int32_t)segmentLen) !=
+        HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("gcm counter segment failed!");
+        ret = HCF_ERR_CRYPTO_OPERATION;
+        goto clearup;
+    }
+    if (task->enc == 1) {
+        ret = GcmSegmentGhash(task, task->out + offset, segmentLen, task->blocks - end, &ghash);
+        if (ret != HCF_SUCCESS) {
+            goto clearup;
+        }
+    }
+    (void)pthread_mutex_lock(&task->lock);
+    task->ghash = GcmXor(task->ghash, ghash);
+    (void)pthread_mutex_unlock(&task->lock);
+    ret = HCF_SUCCESS;
+clearup:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+static HcfResult InitGcmTask(CipherData *data, HcfBlob *input, HcfBlob *output, GcmTask *task,
+    unsigned char *tagMask)
+{
+    /* H = E(K, 0), the zero iv gmac mask and the tag mask E(K, J0) in one ecb call */
+    unsigned char blocks[AES_BLOCK_LEN * 3] = { 0 };
+    blocks[AES_BLOCK_LEN * 2 - 1] = 1;
+    (void)memcpy_s(blocks + AES_BLOCK_LEN * 2, AES_BLOCK_LEN, data->iv, GCM_IV_LEN);
+    blocks[AES_BLOCK_LEN * 3 - 1] = 1;
+
+    task->cipherSet = FindAesCipherSet(data->keyLen);
+    task->key = data->key;
+    task->in = input->data;
+    task->out = output->data;
+    task->len = input->len;
+    task->blocks = (input->len + AES_BLOCK_LEN - 1) / AES_BLOCK_LEN;
+    task->enc = (data->enc == ENCRYPT_MODE) ? 1 : 0;
+    (void)memset_s(task->counter, AES_BLOCK_LEN, 0, AES_BLOCK_LEN);
+    (void)memcpy_s(task->counter, AES_BLOCK_LEN, data->iv, GCM_IV_LEN);
+    task->counter[AES_BLOCK_LEN - 1] = 2; /* the first data block uses inc32(J0) */
+    task->ghash.hi = 0;
+    task->ghash.lo = 0;
+    HcfResult ret = EncryptAesBlocks(task->cipherSet, data->key, blocks, blocks, sizeof(blocks));
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    task->h = LoadGcmBlock(blocks);
+    task->zeroIvMask = LoadGcmBlock(blocks + AES_BLOCK_LEN);
+    (void)memcpy_s(tagMask, AES_BLOCK_LEN, blocks + AES_BLOCK_LEN * 2, AES_BLOCK_LEN);
+    (void)memset_s(blocks, sizeof(blocks), 0, sizeof(blocks));
+    return HCF_SUCCESS;
+}
+
+/*
+ * The aad was streamed into the main ctx and is not kept. Finishing a copy of the ctx as an empty
+ * encryption gives GHASH(A || L0) ^ E(K, J0), from which the contribution of the aad follows.
+ */
+static HcfResult GcmAadGhash(const CipherData *data, const GcmTask *task, const unsigned char *tagMask,
+    GcmBlock *ghash)
+{
+    unsigned char tag[AES_BLOCK_LEN] = { 0 };
+    HcfResult ret = HCF_ERR_CRYPTO_OPERATION;
+    int32_t outLen = 0;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    if ((EVP_CIPHER_CTX_copy(ctx, data->ctx) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CipherInit_ex(ctx, NULL, NULL, NULL, NULL, 1) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_EncryptFinal_ex(ctx, tag, &outLen) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, AES_BLOCK_LEN, tag) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("aad ghash failed!");
+        goto clearup;
+    }
+    GcmBlock withLen = GcmXor(LoadGcmBlock(tag), LoadGcmBlock(tagMask));
+    *ghash = GcmMul(GcmXor(withLen, GcmAadLenMulH(data->aadLen, task->h)), GcmPow(task->h, task->blocks));
+    ret = HCF_SUCCESS;
+clearup:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+static HcfResult ComputeGcmTag(CipherData *data, GcmTask *task, const unsigned char *tagMask, unsigned char *tag)
+{
+    GcmBlock aadGhash = { 0, 0 };
+    if (data->aadLen > 0) {
+        HcfResult ret = GcmAadGhash(data, task, tagMask, &aadGhash);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    GcmBlock lenBlock = { data->aadLen * BITS_PER_BYTE, (uint64_t)task->len * BITS_PER_BYTE };
+    GcmBlock ghash = GcmXor(GcmXor(task->ghash, aadGhash), GcmMul(lenBlock, task->h));
+    StoreGcmBlock(GcmXor(ghash, LoadGcmBlock(tagMask)), tag);
+    return HCF_SUCCESS;
+}
+
+HcfResult AesParallelGcmDoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
+{
+    GcmTask task;
+    unsigned char tagMask[AES_BLOCK_LEN] = { 0 };
+    unsigned char tag[AES_BLOCK_LEN] = { 0 };
+    HcfResult ret = InitGcmTask(data, input, output, &task, tagMask);
+    if (ret != HCF_SUCCESS) {
+        LOGE("init parallel gcm failed!");
+        return ret;
+    }
+    if (pthread_mutex_init(&task.lock, NULL) != 0) {
+        LOGE("init mutex failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    ret = HcfParallelRun((uint32_t)task.blocks, data->parallel->threadNum, RunGcmSegment, &task);
+    (void)pthread_mutex_destroy(&task.lock);
+    if (ret == HCF_SUCCESS) {
+        ret = ComputeGcmTag(data, &task, tagMask, tag);
+    }
+    if (ret != HCF_SUCCESS) {
+        LOGE("parallel gcm failed!");
+        (void)memset_s(output->data, input->len, 0, input->len);
+        return ret;
+    }
+    data->aead = false;
+    if (data->enc == ENCRYPT_MODE) {
+        (void)memcpy_s(output->data + input->len, data->tagLen, tag, data->tagLen);
+        output->len = input->len + data->tagLen;
+        return HCF_SUCCESS;
+    }
+    if (CRYPTO_memcmp(tag, data->tag, data->tagLen) != 0) {
+        LOGE("gcm decrypt verify AuthTag failed!");
+        /* never hand out plaintext that failed authentication */
+        (void)memset_s(output->data, input->len, 0, input->len);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    output->len = input->len;
+    return HCF_SUCCESS;
+}
+
+bool IsAesGcmVerifyFirst(const CipherData *data)
+{
+    return data->isVerifyFirst && (data->mode == HCF_ALG_MODE_GCM) && (data->enc == DECRYPT_MODE) &&
+        data->aead && (data->keyLen != 0) && data->hasTag && (data->tagLen <= AES_BLOCK_LEN);
+}
+
+static HcfResult GetGcmHashKey(CipherData *data, GcmBlock *h)
+{
+    if (!data->isGcmHReady) {
+        const AesCipherSet *cipherSet = FindAesCipherSet(data->keyLen);
+        if (cipherSet == NULL) {
+            LOGE("Invalid gcm key length %u!", data->keyLen);
+            return HCF_INVALID_PARAMS;
+        }
+        unsigned char zero[AES_BLOCK_LEN] = { 0 };
+        HcfResult ret = EncryptAesBlocks(cipherSet, data->key, zero, data->gcmH, AES_BLOCK_LEN);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        data->isGcmHReady = true;
+    }
+    *h = LoadGcmBlock(data->gcmH);
+    return HCF_SUCCESS;
+}
+
+/* gcm takes any number of aad updates, the ciphertext goes in as more aad right after the padded aad */
+static HcfResult GcmAbsorbAsAad(EVP_CIPHER_CTX *ctx, uint64_t aadLen, const HcfBlob *input, uint64_t *absorbedLen)
+{
+    unsigned char zero[AES_BLOCK_LEN] = { 0 };
+    uint32_t padLen = (uint32_t)((AES_BLOCK_LEN - aadLen % AES_BLOCK_LEN) % AES_BLOCK_LEN);
+    int32_t outLen = 0;
+    if ((padLen > 0) && (EVP_EncryptUpdate(ctx, NULL, &outLen, zero, (int32_t)padLen) != HCF_OPENSSL_SUCCESS)) {
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    size_t offset = 0;
+    size_t len = IsBlobValid(input) ? input->len : 0;
+    while (offset < len) {
+        size_t stepLen = ((len - offset) > GCM_AAD_STEP_LEN) ? GCM_AAD_STEP_LEN : (len - offset);
+        if (EVP_EncryptUpdate(ctx, NULL, &outLen, input->data + offset, (int32_t)stepLen) != HCF_OPENSSL_SUCCESS) {
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        offset += stepLen;
+    }
+    *absorbedLen = aadLen + padLen + len;
+    return HCF_SUCCESS;
+}
+
+/*
+ * With the ciphertext fed as aad, the tag of the ctx differs from the real one only in the length block, the
+ * last ghash block which is multiplied by H once: tag = tag' ^ (L ^ L') * H.
+ */
+HcfResult AesGcmVerifyTag(CipherData *data, const HcfBlob *input)
+{
+    GcmBlock h = { 0, 0 };
+    HcfResult ret = GetGcmHashKey(data, &h);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    unsigned char tag[AES_BLOCK_LEN] = { 0 };
+    uint64_t absorbedLen = 0;
+    int32_t outLen = 0;
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    if ((EVP_CIPHER_CTX_copy(ctx, data->ctx) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CipherInit_ex(ctx, NULL, NULL, NULL, NULL, 1) != HCF_OPENSSL_SUCCESS) ||
+        (GcmAbsorbAsAad(ctx, data->aadLen, input, &absorbedLen) != HCF_SUCCESS) ||
+        (EVP_EncryptFinal_ex(ctx, tag, &outLen) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, AES_BLOCK_LEN, tag) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("gcm verify ghash failed!");
+        ret = HCF_ERR_CRYPTO_OPERATION;
+        goto clearup;
+    }
+    uint64_t textLen = IsBlobValid(input) ? input->len : 0;
+    GcmBlock lenDiff = { (data->aadLen * BITS_PER_BYTE) ^ (absorbedLen * BITS_PER_BYTE),
+        textLen * BITS_PER_BYTE };
+    StoreGcmBlock(GcmXor(LoadGcmBlock(tag), GcmMul(lenDiff, h)), tag);
+    if (CRYPTO_memcmp(tag, data->tag, data->tagLen) != 0) {
+        LOGE("gcm decrypt verify AuthTag failed!");
+        ret = HCF_ERR_CRYPTO_OPERATION;
+    }
+clearup:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
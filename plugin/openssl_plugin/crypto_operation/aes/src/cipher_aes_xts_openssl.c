@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <openssl/crypto.h>
+#include "log.h"
+#include "blob.h"
+#include "memory.h"
+#include "result.h"
+#include "utils.h"
+#include "securec.h"
+#include "aes_openssl_common.h"
+#include "sym_common_defines.h"
+#include "openssl_common.h"
+#include "openssl_class.h"
+
+/*
+ * AES-XTS of IEEE 1619. The key is the data key followed by the tweak key, both are expanded once by init and
+ * kept in ctx, reset and the sector batch only load a new tweak. Every doFinal and every sector is a whole data
+ * unit, so update only collects the data unit.
+ */
+#define XTS_BLOCK_SIZE 16
+#define XTS_TWEAK_LEN 16
+#define XTS_KEY_NUM 2
+#define XTS_AES128_KEY_LEN 16
+#define XTS_AES256_KEY_LEN 32
+/* IEEE 1619 allows at most 2^20 blocks in a data unit */
+#define XTS_MAX_DATA_UNIT_LEN (XTS_BLOCK_SIZE << 20)
+#define BITS_PER_BYTE 8
+
+typedef struct {
+    OH_HCF_CipherGeneratorSpi base;
+    CipherAttr attr;
+    /* keyed with the data key and the tweak key by init, reused by reset and the sector batch */
+    EVP_CIPHER_CTX *ctx;
+    bool isKeySet;
+    enum HcfCryptoMode enc;
+    /* a data unit is open for update and doFinal */
+    bool isStarted;
+    uint8_t tweak[XTS_TWEAK_LEN];
+    /* data collected by update, the buffer is kept for the next data unit */
+    uint8_t *buf;
+    uint32_t bufLen;
+    uint32_t bufCap;
+} HcfCipherAesXtsGeneratorSpiOpensslImpl;
+
+static const char *GetAesXtsGeneratorClass(void)
+{
+    return OPENSSL_AES_XTS_CIPHER_CLASS;
+}
+
+static uint32_t GetXtsKeyLen(const CipherAttr *attr)
+{
+    return ((attr->keySize == HCF_ALG_AES_256) ? XTS_AES256_KEY_LEN : XTS_AES128_KEY_LEN) * XTS_KEY_NUM;
+}
+
+static const EVP_CIPHER *GetXtsType(const CipherAttr *attr)
+{
+    return (attr->keySize == HCF_ALG_AES_256) ? EVP_aes_256_xts() : EVP_aes_128_xts();
+}
+
+/* the params are an optional HcfIvParamsSpec with the 16 byte tweak, no params is tweak 0 */
+static HcfResult GetTweak(HcfParamsSpec *params, uint8_t *tweak)
+{
+    (void)memset_s(tweak, XTS_TWEAK_LEN, 0, XTS_TWEAK_LEN);
+    if (params == NULL) {
+        return HCF_SUCCESS;
+    }
+    HcfIvParamsSpec *spec = (HcfIvParamsSpec *)params;
+    if ((spec->iv.data == NULL) || (spec->iv.len != XTS_TWEAK_LEN)) {
+        LOGE("xts tweak must be %d bytes!", XTS_TWEAK_LEN);
+        return HCF_INVALID_PARAMS;
+    }
+    (void)memcpy_s(tweak, XTS_TWEAK_LEN, spec->iv.data, XTS_TWEAK_LEN);
+    return HCF_SUCCESS;
+}
+
+static void ClearDataUnit(HcfCipherAesXtsGeneratorSpiOpensslImpl *impl)
+{
+    if (impl->buf != NULL) {
+        (void)memset_s(impl->buf, impl->bufCap, 0, impl->bufLen);
+    }
+    impl->bufLen = 0;
+    impl->isStarted = false;
+}
+
+static HcfResult CheckXtsKey(const CipherAttr *attr, const HcfBlob *key)
+{
+    uint32_t keyLen = GetXtsKeyLen(attr);
+    if (key->len != keyLen) {
+        LOGE("xts key must be %u bytes!", keyLen);
+        return HCF_INVALID_PARAMS;
+    }
+    /* equal halves make the tweak predictable, IEEE 1619 requires two different keys */
+    if (CRYPTO_memcmp(key->data, key->data + keyLen / XTS_KEY_NUM, keyLen / XTS_KEY_NUM) == 0) {
+        LOGE("xts data key and tweak key must differ!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
+    HcfKey *key, HcfParamsSpec *params)
+{
+    if ((self == NULL) || (key == NULL)) { /* params maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((opMode != ENCRYPT_MODE) && (opMode != DECRYPT_MODE)) {
+        LOGE("Invalid opMode %d", opMode);
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesXtsGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)key, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = (HcfCipherAesXtsGeneratorSpiOpensslImpl *)self;
+    SymKeyImpl *keyImpl = (SymKeyImpl *)key;
+    HcfResult ret = CheckXtsKey(&(impl->attr), &(keyImpl->keyMaterial));
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    ret = GetTweak(params, impl->tweak);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    ClearDataUnit(impl);
+    impl->isKeySet = false;
+    if (impl->ctx == NULL) {
+        impl->ctx = EVP_CIPHER_CTX_new();
+        if (impl->ctx == NULL) {
+            LOGE("Failed to allocate ctx memroy!");
+            return HCF_ERR_MALLOC;
+        }
+    }
+    if (EVP_CipherInit_ex(impl->ctx, GetXtsType(&(impl->attr)), NULL, keyImpl->keyMaterial.data, NULL,
+        (opMode == ENCRYPT_MODE) ? 1 : 0) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher init key failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    impl->enc = opMode;
+    impl->isKeySet = true;
+    impl->isStarted = true;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineReset(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params)
+{
+    if (self == NULL) { /* params maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesXtsGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = (HcfCipherAesXtsGeneratorSpiOpensslImpl *)self;
+    if (!impl->isKeySet) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    ClearDataUnit(impl);
+    HcfResult ret = GetTweak(params, impl->tweak);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    impl->isStarted = true;
+    return HCF_SUCCESS;
+}
+
+/* one whole data unit under tweak, the expanded keys of ctx are kept */
+static HcfResult CryptDataUnit(HcfCipherAesXtsGeneratorSpiOpensslImpl *impl, const uint8_t *tweak,
+    const uint8_t *in, uint8_t *out, uint32_t len)
+{
+    if (EVP_CipherInit_ex(impl->ctx, NULL, NULL, NULL, tweak, -1) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("set tweak failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    int32_t outLen = 0;
+    if (EVP_CipherUpdate(impl->ctx, out, &outLen, in, (int32_t)len) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetStartedImpl(OH_HCF_CipherGeneratorSpi *self, HcfCipherAesXtsGeneratorSpiOpensslImpl **impl)
+{
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesXtsGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    *impl = (HcfCipherAesXtsGeneratorSpiOpensslImpl *)self;
+    if (!(*impl)->isStarted) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult AppendDataUnit(HcfCipherAesXtsGeneratorSpiOpensslImpl *impl, const HcfBlob *input)
+{
+    if (!IsBlobValid(input)) {
+        return HCF_SUCCESS;
+    }
+    uint64_t unitLen = (uint64_t)impl->bufLen + input->len;
+    if (unitLen > XTS_MAX_DATA_UNIT_LEN) {
+        LOGE("xts data unit is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (unitLen > impl->bufCap) {
+        uint32_t newCap = (impl->bufCap > 0) ? (impl->bufCap * 2) : (uint32_t)unitLen;
+        newCap = (newCap < unitLen) ? (uint32_t)unitLen : newCap;
+        uint8_t *newBuf = (uint8_t *)HcfMalloc(newCap, 0);
+        if (newBuf == NULL) {
+            LOGE("malloc data unit buffer failed!");
+            return HCF_ERR_MALLOC;
+        }
+        if (impl->bufLen > 0) {
+            (void)memcpy_s(newBuf, newCap, impl->buf, impl->bufLen);
+            (void)memset_s(impl->buf, impl->bufCap, 0, impl->bufLen);
+        }
+        HcfFree(impl->buf);
+        impl->buf = newBuf;
+        impl->bufCap = newCap;
+    }
+    (void)memcpy_s(impl->buf + impl->bufLen, impl->bufCap - impl->bufLen, input->data, input->len);
+    impl->bufLen += input->len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetDataUnitLen(const HcfCipherAesXtsGeneratorSpiOpensslImpl *impl, uint32_t inputLen,
+    uint32_t *unitLen)
+{
+    uint64_t len = (uint64_t)impl->bufLen + inputLen;
+    if ((len < XTS_BLOCK_SIZE) || (len > XTS_MAX_DATA_UNIT_LEN)) {
+        LOGE("xts data unit must be 16 bytes to 16 MiB!");
+        return HCF_INVALID_PARAMS;
+    }
+    *unitLen = (uint32_t)len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult XtsDoFinal(HcfCipherAesXtsGeneratorSpiOpensslImpl *impl, HcfBlob *input, HcfBlob *output)
+{
+    const uint8_t *unit = IsBlobValid(input) ? input->data : NULL;
+    uint32_t unitLen = IsBlobValid(input) ? input->len : 0;
+    if (impl->bufLen > 0) {
+        HcfResult ret = AppendDataUnit(impl, input);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        unit = impl->buf;
+        unitLen = impl->bufLen;
+    }
+    HcfResult ret = CryptDataUnit(impl, impl->tweak, unit, output->data, unitLen);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    output->len = unitLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = AppendDataUnit(impl, input);
+    if (res != HCF_SUCCESS) {
+        ClearDataUnit(impl);
+        return res;
+    }
+    output->data = NULL;
+    output->len = 0;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdateToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = AppendDataUnit(impl, input);
+    if (res != HCF_SUCCESS) {
+        ClearDataUnit(impl);
+        return res;
+    }
+    output->len = 0;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint32_t unitLen = 0;
+    res = GetDataUnitLen(impl, IsBlobValid(input) ? input->len : 0, &unitLen);
+    if (res == HCF_SUCCESS) {
+        output->data = (uint8_t *)HcfMalloc(unitLen, 0);
+        output->len = unitLen;
+        res = (output->data == NULL) ? HCF_ERR_MALLOC : XtsDoFinal(impl, input, output);
+    }
+    if (res != HCF_SUCCESS) {
+        LOGE("XtsDoFinal failed!");
+        HcfBlobDataFree(output);
+    }
+    ClearDataUnit(impl);
+    return res;
+}
+
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint32_t unitLen = 0;
+    res = GetDataUnitLen(impl, IsBlobValid(input) ? input->len : 0, &unitLen);
+    if (res != HCF_SUCCESS) {
+        ClearDataUnit(impl);
+        return res;
+    }
+    if ((output->data == NULL) || (output->len < unitLen)) {
+        LOGE("output buffer is too small, need %u bytes!", unitLen);
+        return HCF_INVALID_PARAMS;
+    }
+    res = XtsDoFinal(impl, input, output);
+    if (res != HCF_SUCCESS) {
+        LOGE("XtsDoFinal failed!");
+    }
+    ClearDataUnit(impl);
+    return res;
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = NULL;
+    HcfResult res = GetStartedImpl(self, &impl);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    if (!isFinal) {
+        *outputLen = 0;
+        return HCF_SUCCESS;
+    }
+    return GetDataUnitLen(impl, inputLen, outputLen);
+}
+
+/* the tweak of a sector is its number as a 128 bit little endian value */
+static void SetSectorTweak(uint64_t sector, uint8_t *tweak)
+{
+    for (uint32_t i = 0; i < sizeof(uint64_t); i++) {
+        tweak[i] = (uint8_t)sector;
+        sector >>= BITS_PER_BYTE;
+    }
+}
+
+static HcfResult EngineCryptSectors(OH_HCF_CipherGeneratorSpi *self, const HcfCipherSectorParams *params,
+    HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (params == NULL) || !IsBlobValid(input) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetAesXtsGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = (HcfCipherAesXtsGeneratorSpiOpensslImpl *)self;
+    if (!impl->isKeySet) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint32_t sectorSize = params->sectorSize;
+    if ((sectorSize < XTS_BLOCK_SIZE) || (sectorSize > XTS_MAX_DATA_UNIT_LEN) || (input->len % sectorSize != 0)) {
+        LOGE("input must be whole sectors of 16 bytes to 16 MiB!");
+        return HCF_INVALID_PARAMS;
+    }
+    size_t sectorNum = input->len / sectorSize;
+    if (params->startSector > UINT64_MAX - (uint64_t)(sectorNum - 1)) {
+        LOGE("sector number overflows!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((output->data == NULL) || (output->len < input->len)) {
+        LOGE("output buffer is smaller than the input!");
+        return HCF_INVALID_PARAMS;
+    }
+    uint8_t tweak[XTS_TWEAK_LEN] = {0};
+    for (size_t i = 0; i < sectorNum; i++) {
+        SetSectorTweak(params->startSector + i, tweak);
+        HcfResult res = CryptDataUnit(impl, tweak, input->data + i * sectorSize, output->data + i * sectorSize,
+            sectorSize);
+        if (res != HCF_SUCCESS) {
+            /* never return the sectors done before the failure as if the call had worked */
+            (void)memset_s(output->data, output->len, 0, input->len);
+            output->len = 0;
+            return res;
+        }
+    }
+    output->len = input->len;
+    return HCF_SUCCESS;
+}
+
+static void EngineAesXtsGeneratorDestroy(HcfObjectBase *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch(self, GetAesXtsGeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *impl = (HcfCipherAesXtsGeneratorSpiOpensslImpl *)self;
+    ClearDataUnit(impl);
+    HcfFree(impl->buf);
+    EVP_CIPHER_CTX_free(impl->ctx);
+    HcfFree(impl);
+}
+
+HcfResult HcfCipherAesXtsGeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator)
+{
+    if ((attr == NULL) || (generator == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if ((attr->keySize != HCF_ALG_AES_128) && (attr->keySize != HCF_ALG_AES_256)) {
+        LOGE("XTS only supports AES128 and AES256!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherAesXtsGeneratorSpiOpensslImpl *returnImpl = (HcfCipherAesXtsGeneratorSpiOpensslImpl *)HcfMalloc(
+        sizeof(HcfCipherAesXtsGeneratorSpiOpensslImpl), 0);
+    if (returnImpl == NULL) {
+        LOGE("Failed to allocate returnImpl memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    (void)memcpy_s(&returnImpl->attr, sizeof(CipherAttr), attr, sizeof(CipherAttr));
+    returnImpl->base.init = EngineCipherInit;
+    returnImpl->base.update = EngineUpdate;
+    returnImpl->base.doFinal = EngineDoFinal;
+    returnImpl->base.getOutputSize = EngineGetOutputSize;
+    returnImpl->base.updateToBuffer = EngineUpdateToBuffer;
+    returnImpl->base.doFinalToBuffer = EngineDoFinalToBuffer;
+    returnImpl->base.reset = EngineReset;
+    returnImpl->base.cryptSectors = EngineCryptSectors;
+    returnImpl->base.base.destroy = EngineAesXtsGeneratorDestroy;
+    returnImpl->base.base.getClass = GetAesXtsGeneratorClass;
+
+    *generator = (OH_HCF_CipherGeneratorSpi *)returnImpl;
+    return HCF_SUCCESS;
+}
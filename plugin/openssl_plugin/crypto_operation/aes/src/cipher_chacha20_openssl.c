@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "log.h"
+#include "blob.h"
+#include "memory.h"
+#include "result.h"
+#include "utils.h"
+#include "securec.h"
+#include "aes_openssl_common.h"
+#include "sym_common_defines.h"
+#include "openssl_common.h"
+#include "openssl_class.h"
+
+#define CHACHA20_KEY_LEN 32
+#define CHACHA20_POLY1305_IV_LEN 12
+#define POLY1305_TAG_MAX_LEN 16
+
+typedef struct {
+    OH_HCF_CipherGeneratorSpi base;
+    CipherAttr attr;
+    CipherData *cipherData;
+    /* keyed ctx of the last finished message, reused by reset and init */
+    CipherData *idleData;
+} HcfCipherChaCha20GeneratorSpiOpensslImpl;
+
+static const char *GetChaCha20GeneratorClass(void)
+{
+    return OPENSSL_CHACHA20_CIPHER_CLASS;
+}
+
+/* the message params are a HcfGcmParamsSpec: a 12 byte nonce, the aad and the tag */
+static bool IsChaCha20ParamsValid(HcfGcmParamsSpec *params)
+{
+    if (params == NULL) {
+        LOGE("params is null!");
+        return false;
+    }
+    if (((params->aad.len > 0) && (params->aad.data == NULL)) || (params->aad.len > INT32_MAX)) {
+        LOGE("aad is invalid!");
+        return false;
+    }
+    if ((params->iv.data == NULL) || (params->iv.len != CHACHA20_POLY1305_IV_LEN)) {
+        LOGE("iv is invalid!");
+        return false;
+    }
+    if ((params->tag.data == NULL) || (params->tag.len == 0) || (params->tag.len > POLY1305_TAG_MAX_LEN)) {
+        LOGE("tag is invalid!");
+        return false;
+    }
+    return true;
+}
+
+static HcfResult FeedAad(CipherData *data, const HcfBlob *aad)
+{
+    if (aad->len == 0) {
+        return HCF_SUCCESS;
+    }
+    int32_t outLen = 0;
+    if (EVP_CipherUpdate(data->ctx, NULL, &outLen, aad->data, (int32_t)aad->len) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("aad cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    data->aadLen += aad->len;
+    return HCF_SUCCESS;
+}
+
+/* load the nonce of a new message into the keyed ctx, then the tag and the aad of params */
+static HcfResult StartMessage(CipherData *data, enum HcfCryptoMode opMode, const unsigned char *key,
+    HcfGcmParamsSpec *params)
+{
+    data->enc = opMode;
+    data->aead = true;
+    data->tagLen = params->tag.len;
+    if (opMode == DECRYPT_MODE) {
+        (void)memcpy_s(data->tag, sizeof(data->tag), params->tag.data, params->tag.len);
+        data->hasTag = true;
+    }
+    if (EVP_CipherInit_ex(data->ctx, NULL, NULL, key, params->iv.data, (opMode == ENCRYPT_MODE) ? 1 : 0) !=
+        HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher init key and iv failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return FeedAad(data, &(params->aad));
+}
+
+static HcfResult EngineCipherInit(OH_HCF_CipherGeneratorSpi *self, enum HcfCryptoMode opMode,
+    HcfKey *key, HcfParamsSpec *params)
+{
+    if ((self == NULL) || (key == NULL) || !IsChaCha20ParamsValid((HcfGcmParamsSpec *)params)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetChaCha20GeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)key, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    SymKeyImpl *keyImpl = (SymKeyImpl *)key;
+    if (keyImpl->keyMaterial.len != CHACHA20_KEY_LEN) {
+        LOGE("chacha20 key must be %d bytes!", CHACHA20_KEY_LEN);
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+    HcfResult ret = AcquireCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    if (ret != HCF_SUCCESS) {
+        LOGE("AcquireCipherData failed");
+        return ret;
+    }
+    CipherData *data = cipherImpl->cipherData;
+    if (EVP_CipherInit(data->ctx, EVP_chacha20_poly1305(), NULL, NULL, (opMode == ENCRYPT_MODE) ? 1 : 0) !=
+        HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher init failed!");
+        FreeCipherData(&(cipherImpl->cipherData));
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    ret = StartMessage(data, opMode, keyImpl->keyMaterial.data, (HcfGcmParamsSpec *)params);
+    if (ret != HCF_SUCCESS) {
+        FreeCipherData(&(cipherImpl->cipherData));
+    }
+    return ret;
+}
+
+static HcfResult EngineReset(OH_HCF_CipherGeneratorSpi *self, HcfParamsSpec *params)
+{
+    if ((self == NULL) || !IsChaCha20ParamsValid((HcfGcmParamsSpec *)params)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetChaCha20GeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+    CipherData *last = (cipherImpl->cipherData != NULL) ? cipherImpl->cipherData : cipherImpl->idleData;
+    if (!IsCipherDataKeyed(last)) {
+        LOGE("cipher has not been initialized!");
+        return HCF_INVALID_PARAMS;
+    }
+    enum HcfCryptoMode opMode = last->enc;
+    (void)AcquireCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    /* keep the cipher and the key, only load the new nonce */
+    HcfResult ret = StartMessage(cipherImpl->cipherData, opMode, NULL, (HcfGcmParamsSpec *)params);
+    if (ret != HCF_SUCCESS) {
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return ret;
+}
+
+static uint32_t GetOutputLen(const CipherData *data, uint32_t inputLen, bool isFinal)
+{
+    /* a stream cipher keeps nothing back, only the tag is added */
+    if (isFinal && (data->enc == ENCRYPT_MODE)) {
+        return inputLen + data->tagLen;
+    }
+    return inputLen;
+}
+
+static HcfResult AllocateOutput(uint32_t outLen, HcfBlob *output)
+{
+    /* HcfMalloc rejects zero, an empty message still gets a valid buffer */
+    output->data = (uint8_t *)HcfMalloc((outLen > 0) ? outLen : 1, 0);
+    if (output->data == NULL) {
+        LOGE("malloc output failed!");
+        return HCF_ERR_MALLOC;
+    }
+    output->len = outLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult CheckOutputBuffer(uint32_t outLen, HcfBlob *output)
+{
+    if (((output->data == NULL) && (outLen > 0)) || (output->len < outLen)) {
+        LOGE("output buffer is too small, need %u bytes!", outLen);
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult GetChaCha20CipherData(OH_HCF_CipherGeneratorSpi *self, CipherData **data)
+{
+    if (!IsClassMatch((const HcfObjectBase *)self, GetChaCha20GeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    *data = ((HcfCipherChaCha20GeneratorSpiOpensslImpl *)self)->cipherData;
+    if (*data == NULL) {
+        LOGE("cipherData is null!");
+        return HCF_INVALID_PARAMS;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult ChaCha20Update(CipherData *data, HcfBlob *input, HcfBlob *output)
+{
+    int32_t outLen = 0;
+    if (IsBlobValid(input) &&
+        (EVP_CipherUpdate(data->ctx, output->data, &outLen, input->data, input->len) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("cipher update failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    output->len = (uint32_t)outLen;
+    data->aead = false;
+    return HCF_SUCCESS;
+}
+
+static HcfResult ChaCha20DoFinal(CipherData *data, HcfBlob *input, HcfBlob *output)
+{
+    HcfResult res = ChaCha20Update(data, input, output);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint32_t len = output->len;
+    if ((data->enc == DECRYPT_MODE) &&
+        (EVP_CIPHER_CTX_ctrl(data->ctx, EVP_CTRL_AEAD_SET_TAG, data->tagLen, data->tag) != HCF_OPENSSL_SUCCESS)) {
+        HcfPrintOpensslError();
+        LOGE("set AuthTag failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    int32_t finalLen = 0;
+    if (EVP_CipherFinal_ex(data->ctx, output->data + len, &finalLen) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("cipher final failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    len += (uint32_t)finalLen;
+    if (data->enc == ENCRYPT_MODE) {
+        if (EVP_CIPHER_CTX_ctrl(data->ctx, EVP_CTRL_AEAD_GET_TAG, data->tagLen, output->data + len) !=
+            HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("get AuthTag failed!");
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        len += data->tagLen;
+    }
+    output->len = len;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUpdateAad(OH_HCF_CipherGeneratorSpi *self, HcfBlob *aad)
+{
+    if ((self == NULL) || (aad == NULL) || ((aad->len > 0) && (aad->data == NULL)) || (aad->len > INT32_MAX)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetChaCha20CipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    if (!data->aead) {
+        LOGE("aad must be given before the message data!");
+        return HCF_INVALID_PARAMS;
+    }
+    res = FeedAad(data, aad);
+    if (res != HCF_SUCCESS) {
+        HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return res;
+}
+
+static HcfResult EngineUpdate(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetChaCha20CipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+    res = AllocateOutput(GetOutputLen(data, IsBlobValid(input) ? input->len : 0, false), output);
+    if (res != HCF_SUCCESS) {
+        LOGE("AllocateOutput failed!");
+        return res;
+    }
+    res = ChaCha20Update(data, input, output);
+    if (res != HCF_SUCCESS) {
+        HcfBlobDataFree(output);
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return res;
+}
+
+static HcfResult EngineUpdateToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (input == NULL) || (output == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetChaCha20CipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = CheckOutputBuffer(GetOutputLen(data, IsBlobValid(input) ? input->len : 0, false), output);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    res = ChaCha20Update(data, input, output);
+    if (res != HCF_SUCCESS) {
+        HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+        RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    }
+    return res;
+}
+
+static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetChaCha20CipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+    res = AllocateOutput(GetOutputLen(data, IsBlobValid(input) ? input->len : 0, true), output);
+    if (res == HCF_SUCCESS) {
+        res = ChaCha20DoFinal(data, input, output);
+    }
+    if (res != HCF_SUCCESS) {
+        LOGE("ChaCha20DoFinal failed!");
+        /* the part decrypted before a failed tag check must not stay in freed memory */
+        HcfBlobDataClearAndFree(output);
+    }
+    RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    return res;
+}
+
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if ((self == NULL) || (output == NULL)) { /* input maybe is null */
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetChaCha20CipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint32_t outLen = GetOutputLen(data, IsBlobValid(input) ? input->len : 0, true);
+    res = CheckOutputBuffer(outLen, output);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    uint8_t *outBuf = output->data;
+    res = ChaCha20DoFinal(data, input, output);
+    if (res != HCF_SUCCESS) {
+        LOGE("ChaCha20DoFinal failed!");
+        /* never leave plaintext that failed authentication in the caller's buffer */
+        (void)memset_s(outBuf, outLen, 0, outLen);
+        output->len = 0;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *cipherImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+    RetainCipherData(&(cipherImpl->cipherData), &(cipherImpl->idleData));
+    return res;
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    if ((self == NULL) || (outputLen == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    CipherData *data = NULL;
+    HcfResult res = GetChaCha20CipherData(self, &data);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    *outputLen = GetOutputLen(data, inputLen, isFinal);
+    return HCF_SUCCESS;
+}
+
+static void EngineChaCha20GeneratorDestroy(HcfObjectBase *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch(self, GetChaCha20GeneratorClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *impl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)self;
+    FreeCipherData(&(impl->cipherData));
+    FreeCipherData(&(impl->idleData));
+    HcfFree(impl);
+}
+
+HcfResult HcfCipherChaCha20GeneratorSpiCreate(CipherAttr *attr, OH_HCF_CipherGeneratorSpi **generator)
+{
+    if ((attr == NULL) || (generator == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (attr->mode != HCF_ALG_MODE_POLY1305) {
+        LOGE("chacha20 only supports Poly1305!");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherChaCha20GeneratorSpiOpensslImpl *returnImpl = (HcfCipherChaCha20GeneratorSpiOpensslImpl *)HcfMalloc(
+        sizeof(HcfCipherChaCha20GeneratorSpiOpensslImpl), 0);
+    if (returnImpl == NULL) {
+        LOGE("Failed to allocate returnImpl memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    (void)memcpy_s(&returnImpl->attr, sizeof(CipherAttr), attr, sizeof(CipherAttr));
+    returnImpl->base.init = EngineCipherInit;
+    returnImpl->base.update = EngineUpdate;
+    returnImpl->base.doFinal = EngineDoFinal;
+    returnImpl->base.getOutputSize = EngineGetOutputSize;
+    returnImpl->base.updateToBuffer = EngineUpdateToBuffer;
+    returnImpl->base.doFinalToBuffer = EngineDoFinalToBuffer;
+    returnImpl->base.reset = EngineReset;
+    returnImpl->base.updateAad = EngineUpdateAad;
+    returnImpl->base.base.destroy = EngineChaCha20GeneratorDestroy;
+    returnImpl->base.base.getClass = GetChaCha20GeneratorClass;
+
+    *generator = (OH_HCF_CipherGeneratorSpi *)returnImpl;
+    return HCF_SUCCESS;
+}
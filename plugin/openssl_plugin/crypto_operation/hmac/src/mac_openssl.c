@@ -59,6 +59,18 @@ static const EVP_MD *OpensslGetMacAlgoFromString(const char *mdName)
         return EVP_sha384();
     } else if (strcmp(mdName, "SHA512") == 0) {
         return EVP_sha512();
+    } else if (strcmp(mdName, "SHA3-224") == 0) {
+        return EVP_sha3_224();
+    } else if (strcmp(mdName, "SHA3-256") == 0) {
+        return EVP_sha3_256();
+    } else if (strcmp(mdName, "SHA3-384") == 0) {
+        return EVP_sha3_384();
+    } else if (strcmp(mdName, "SHA3-512") == 0) {
+        return EVP_sha3_512();
+    } else if (strcmp(mdName, "BLAKE2b512") == 0) {
+        return EVP_blake2b512();
+    } else if (strcmp(mdName, "BLAKE2s256") == 0) {
+        return EVP_blake2s256();
     }
     return NULL;
 }
@@ -144,6 +156,20 @@ static uint32_t OpensslEngineGetMacLength(HcfMacSpi *self)
     return HMAC_size(OpensslGetMacCtx(self));
 }
 
+static void OpensslEngineClearMac(HcfMacSpi *self)
+{
+    HMAC_CTX *ctx = OpensslGetMacCtx(self);
+    if (ctx == NULL) {
+        LOGE("The CTX is NULL!");
+        return;
+    }
+    // HMAC_CTX_reset cleanses the padded key blocks as well
+    if (HMAC_CTX_reset(ctx) != HCF_OPENSSL_SUCCESS) {
+        LOGE("HMAC_CTX_reset return error!");
+        HcfPrintOpensslError();
+    }
+}
+
 static void OpensslDestroyMac(HcfObjectBase *self)
 {
     if (self == NULL) {
@@ -160,34 +186,72 @@ static void OpensslDestroyMac(HcfObjectBase *self)
     HcfFree(self);
 }
 
-HcfResult OpensslMacSpiCreate(const char *opensslAlgoName, HcfMacSpi **spiObj)
+static HcfResult OpensslEngineCloneMac(HcfMacSpi *self, HcfMacSpi **newSpi);
+
+static HcfResult NewOpensslMacSpi(const char *opensslAlgoName, HcfMacSpiImpl **implObj)
 {
-    if (spiObj == NULL) {
-        LOGE("Invalid input parameter.");
-        return HCF_INVALID_PARAMS;
-    }
-    HcfMacSpiImpl *returnSpiImpl = (HcfMacSpiImpl *)HcfMalloc(sizeof(HcfMacSpiImpl), 0);
-    if (returnSpiImpl == NULL) {
+    HcfMacSpiImpl *impl = (HcfMacSpiImpl *)HcfMalloc(sizeof(HcfMacSpiImpl), 0);
+    if (impl == NULL) {
         LOGE("Failed to allocate returnImpl memory!");
         return HCF_ERR_MALLOC;
     }
-    if (strcpy_s(returnSpiImpl->opensslAlgoName, HCF_MAX_ALGO_NAME_LEN, opensslAlgoName) != EOK) {
+    if (strcpy_s(impl->opensslAlgoName, HCF_MAX_ALGO_NAME_LEN, opensslAlgoName) != EOK) {
         LOGE("Failed to copy algoName!");
-        HcfFree(returnSpiImpl);
+        HcfFree(impl);
         return HCF_ERR_COPY;
     }
-    returnSpiImpl->ctx = HMAC_CTX_new();
-    if (returnSpiImpl->ctx == NULL) {
+    impl->ctx = HMAC_CTX_new();
+    if (impl->ctx == NULL) {
         LOGE("Failed to create ctx!");
-        HcfFree(returnSpiImpl);
+        HcfFree(impl);
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    returnSpiImpl->base.base.getClass = OpensslGetMacClass;
-    returnSpiImpl->base.base.destroy = OpensslDestroyMac;
-    returnSpiImpl->base.engineInitMac = OpensslEngineInitMac;
-    returnSpiImpl->base.engineUpdateMac = OpensslEngineUpdateMac;
-    returnSpiImpl->base.engineDoFinalMac = OpensslEngineDoFinalMac;
-    returnSpiImpl->base.engineGetMacLength = OpensslEngineGetMacLength;
+    impl->base.base.getClass = OpensslGetMacClass;
+    impl->base.base.destroy = OpensslDestroyMac;
+    impl->base.engineInitMac = OpensslEngineInitMac;
+    impl->base.engineUpdateMac = OpensslEngineUpdateMac;
+    impl->base.engineDoFinalMac = OpensslEngineDoFinalMac;
+    impl->base.engineGetMacLength = OpensslEngineGetMacLength;
+    impl->base.engineClearMac = OpensslEngineClearMac;
+    impl->base.engineCloneMac = OpensslEngineCloneMac;
+    *implObj = impl;
+    return HCF_SUCCESS;
+}
+
+static HcfResult OpensslEngineCloneMac(HcfMacSpi *self, HcfMacSpi **newSpi)
+{
+    HMAC_CTX *ctx = OpensslGetMacCtx(self);
+    if (ctx == NULL) {
+        LOGE("The CTX is NULL!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    HcfMacSpiImpl *impl = NULL;
+    HcfResult ret = NewOpensslMacSpi(((HcfMacSpiImpl *)self)->opensslAlgoName, &impl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    /* a mac without a key has no state to copy, the clone is left without a key as well */
+    if ((HMAC_CTX_get_md(ctx) != NULL) && (HMAC_CTX_copy(impl->ctx, ctx) != HCF_OPENSSL_SUCCESS)) {
+        LOGE("HMAC_CTX_copy return error!");
+        HcfPrintOpensslError();
+        OpensslDestroyMac((HcfObjectBase *)impl);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    *newSpi = (HcfMacSpi *)impl;
+    return HCF_SUCCESS;
+}
+
+HcfResult OpensslMacSpiCreate(const char *opensslAlgoName, HcfMacSpi **spiObj)
+{
+    if (spiObj == NULL) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfMacSpiImpl *returnSpiImpl = NULL;
+    HcfResult ret = NewOpensslMacSpi(opensslAlgoName, &returnSpiImpl);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
     *spiObj = (HcfMacSpi *)returnSpiImpl;
     return HCF_SUCCESS;
 }
\ No newline at end of file
@@ -23,6 +23,15 @@ extern "C" {
 
 HcfResult OpensslMdSpiCreate(const char *opensslAlgoName, HcfMdSpi **spiObj);
 
+/* SHA256-TREE, the RFC 6962 merkle tree hash over HCF_TREE_MD_LEAF_LEN byte leaves, see md.h */
+HcfResult OpensslTreeMdSpiCreate(const char *opensslAlgoName, HcfMdSpi **spiObj);
+
+/*
+ * Hash count independent messages of the SHA-2 family with EVP_Digest, see HcfMdDigestMany. The digest is
+ * fetched once for the whole batch, large batches are spread over threads.
+ */
+HcfResult OpensslMdDigestMany(const char *opensslAlgoName, const HcfBlob *inputs, HcfBlob *outputs, uint32_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@
 
 #include "md_openssl.h"
 
+#include "hcf_parallel.h"
 #include "openssl_common.h"
 #include "securec.h"
 #include "log.h"
@@ -24,11 +25,26 @@
 
 #include <openssl/evp.h>
 
+/* batches with fewer bytes than this hash on the calling thread */
+#define MD_MANY_PARALLEL_THRESHOLD (256 * 1024)
+
+/* the longest output a caller can ask of SHAKE128 and SHAKE256 */
+#define MAX_XOF_MD_LEN HCF_MAX_BUFFER_LEN
+
+typedef struct {
+    const EVP_MD *md;
+    const HcfBlob *inputs;
+    HcfBlob *outputs;
+} MdManyTask;
+
 typedef struct {
     HcfMdSpi base;
 
     EVP_MD_CTX *ctx;
 
+    /* output length of an extendable output function, 0 for a md of fixed length */
+    uint32_t xofLen;
+
     char opensslAlgoName[HCF_MAX_ALGO_NAME_LEN];
 } OpensslMdSpiImpl;
 
@@ -60,6 +76,22 @@ static const EVP_MD *OpensslGetMdAlgoFromString(const char *mdName)
         return EVP_sha512();
     } else if (strcmp(mdName, "MD5") == 0) {
         return EVP_md5();
+    } else if (strcmp(mdName, "SHA3-224") == 0) {
+        return EVP_sha3_224();
+    } else if (strcmp(mdName, "SHA3-256") == 0) {
+        return EVP_sha3_256();
+    } else if (strcmp(mdName, "SHA3-384") == 0) {
+        return EVP_sha3_384();
+    } else if (strcmp(mdName, "SHA3-512") == 0) {
+        return EVP_sha3_512();
+    } else if (strcmp(mdName, "SHAKE128") == 0) {
+        return EVP_shake128();
+    } else if (strcmp(mdName, "SHAKE256") == 0) {
+        return EVP_shake256();
+    } else if (strcmp(mdName, "BLAKE2b512") == 0) {
+        return EVP_blake2b512();
+    } else if (strcmp(mdName, "BLAKE2s256") == 0) {
+        return EVP_blake2s256();
     }
     return NULL;
 }
@@ -78,6 +110,24 @@ static HcfResult OpensslEngineUpdateMd(HcfMdSpi *self, HcfBlob *input)
     return HCF_SUCCESS;
 }
 
+static HcfResult OpensslDoFinalXof(EVP_MD_CTX *ctx, uint32_t xofLen, HcfBlob *output)
+{
+    output->data = (uint8_t *)HcfMalloc(xofLen, 0);
+    if (output->data == NULL) {
+        LOGE("Failed to allocate output->data memory!");
+        return HCF_ERR_MALLOC;
+    }
+    if (EVP_DigestFinalXOF(ctx, output->data, xofLen) != HCF_OPENSSL_SUCCESS) {
+        LOGE("EVP_DigestFinalXOF return error!");
+        HcfPrintOpensslError();
+        HcfFree(output->data);
+        output->data = NULL;
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    output->len = xofLen;
+    return HCF_SUCCESS;
+}
+
 static HcfResult OpensslEngineDoFinalMd(HcfMdSpi *self, HcfBlob *output)
 {
     EVP_MD_CTX *localCtx = OpensslGetMdCtx(self);
@@ -85,6 +135,9 @@ static HcfResult OpensslEngineDoFinalMd(HcfMdSpi *self, HcfBlob *output)
         LOGE("The CTX is NULL!");
         return HCF_ERR_CRYPTO_OPERATION;
     }
+    if (((OpensslMdSpiImpl *)self)->xofLen != 0) {
+        return OpensslDoFinalXof(localCtx, ((OpensslMdSpiImpl *)self)->xofLen, output);
+    }
     unsigned char outputBuf[EVP_MAX_MD_SIZE];
     uint32_t outputLen;
     int32_t ret = EVP_DigestFinal_ex(localCtx, outputBuf, &outputLen);
@@ -114,6 +167,9 @@ static uint32_t OpensslEngineGetMdLength(HcfMdSpi *self)
         LOGE("The CTX is NULL!");
         return 0;
     }
+    if (((OpensslMdSpiImpl *)self)->xofLen != 0) {
+        return ((OpensslMdSpiImpl *)self)->xofLen;
+    }
     int32_t size = EVP_MD_CTX_size(OpensslGetMdCtx(self));
     if (size < 0) {
         LOGE("Get the overflow path length in openssl!");
@@ -122,6 +178,40 @@ static uint32_t OpensslEngineGetMdLength(HcfMdSpi *self)
     return size;
 }
 
+static HcfResult OpensslEngineResetMd(HcfMdSpi *self)
+{
+    EVP_MD_CTX *localCtx = OpensslGetMdCtx(self);
+    if (localCtx == NULL) {
+        LOGE("The CTX is NULL!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if (EVP_DigestInit_ex(localCtx, EVP_MD_CTX_md(localCtx), NULL) != HCF_OPENSSL_SUCCESS) {
+        LOGE("EVP_DigestInit_ex return error!");
+        HcfPrintOpensslError();
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult OpensslEngineSetMdLength(HcfMdSpi *self, uint32_t len)
+{
+    EVP_MD_CTX *localCtx = OpensslGetMdCtx(self);
+    if (localCtx == NULL) {
+        LOGE("The CTX is NULL!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    if ((EVP_MD_flags(EVP_MD_CTX_md(localCtx)) & EVP_MD_FLAG_XOF) == 0) {
+        LOGE("The md length is fixed!");
+        return HCF_NOT_SUPPORT;
+    }
+    if (len > MAX_XOF_MD_LEN) {
+        LOGE("The md length is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    ((OpensslMdSpiImpl *)self)->xofLen = (len == 0) ? (uint32_t)EVP_MD_CTX_size(localCtx) : len;
+    return HCF_SUCCESS;
+}
+
 static void OpensslDestroyMd(HcfObjectBase *self)
 {
     if (self == NULL) {
@@ -138,36 +228,138 @@ static void OpensslDestroyMd(HcfObjectBase *self)
     HcfFree(self);
 }
 
+static HcfResult OpensslEngineCloneMd(HcfMdSpi *self, HcfMdSpi **newSpi);
+
+static OpensslMdSpiImpl *NewOpensslMdSpi(void)
+{
+    OpensslMdSpiImpl *impl = (OpensslMdSpiImpl *)HcfMalloc(sizeof(OpensslMdSpiImpl), 0);
+    if (impl == NULL) {
+        LOGE("Failed to allocate returnImpl memory!");
+        return NULL;
+    }
+    impl->ctx = EVP_MD_CTX_new();
+    if (impl->ctx == NULL) {
+        LOGE("Failed to create ctx!");
+        HcfFree(impl);
+        return NULL;
+    }
+    impl->base.base.getClass = OpensslGetMdClass;
+    impl->base.base.destroy = OpensslDestroyMd;
+    impl->base.engineUpdateMd = OpensslEngineUpdateMd;
+    impl->base.engineDoFinalMd = OpensslEngineDoFinalMd;
+    impl->base.engineGetMdLength = OpensslEngineGetMdLength;
+    impl->base.engineResetMd = OpensslEngineResetMd;
+    impl->base.engineSetMdLength = OpensslEngineSetMdLength;
+    impl->base.engineCloneMd = OpensslEngineCloneMd;
+    return impl;
+}
+
+static HcfResult OpensslEngineCloneMd(HcfMdSpi *self, HcfMdSpi **newSpi)
+{
+    EVP_MD_CTX *localCtx = OpensslGetMdCtx(self);
+    if (localCtx == NULL) {
+        LOGE("The CTX is NULL!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    OpensslMdSpiImpl *impl = NewOpensslMdSpi();
+    if (impl == NULL) {
+        return HCF_ERR_MALLOC;
+    }
+    /* the copy shares the fetched digest with localCtx, no provider lookup is done */
+    if (EVP_MD_CTX_copy_ex(impl->ctx, localCtx) != HCF_OPENSSL_SUCCESS) {
+        LOGE("EVP_MD_CTX_copy_ex return error!");
+        HcfPrintOpensslError();
+        OpensslDestroyMd((HcfObjectBase *)impl);
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    impl->xofLen = ((OpensslMdSpiImpl *)self)->xofLen;
+    *newSpi = (HcfMdSpi *)impl;
+    return HCF_SUCCESS;
+}
+
 HcfResult OpensslMdSpiCreate(const char *opensslAlgoName, HcfMdSpi **spiObj)
 {
     if (spiObj == NULL) {
         LOGE("Invalid input parameter.");
         return HCF_INVALID_PARAMS;
     }
-    OpensslMdSpiImpl *returnSpiImpl = (OpensslMdSpiImpl *)HcfMalloc(sizeof(OpensslMdSpiImpl), 0);
+    OpensslMdSpiImpl *returnSpiImpl = NewOpensslMdSpi();
     if (returnSpiImpl == NULL) {
-        LOGE("Failed to allocate returnImpl memory!");
-        return HCF_ERR_MALLOC;
-    }
-    returnSpiImpl->ctx = EVP_MD_CTX_new();
-    if (returnSpiImpl->ctx == NULL) {
-        LOGE("Failed to create ctx!");
-        HcfFree(returnSpiImpl);
         return HCF_ERR_MALLOC;
     }
     const EVP_MD *mdfunc = OpensslGetMdAlgoFromString(opensslAlgoName);
     int32_t ret = EVP_DigestInit_ex(returnSpiImpl->ctx, mdfunc, NULL);
     if (ret != HCF_OPENSSL_SUCCESS) {
         LOGE("Failed to init MD!");
-        HcfFree(returnSpiImpl);
-        EVP_MD_CTX_free(returnSpiImpl->ctx);
+        OpensslDestroyMd((HcfObjectBase *)returnSpiImpl);
         return HCF_ERR_CRYPTO_OPERATION;
     }
-    returnSpiImpl->base.base.getClass = OpensslGetMdClass;
-    returnSpiImpl->base.base.destroy = OpensslDestroyMd;
-    returnSpiImpl->base.engineUpdateMd = OpensslEngineUpdateMd;
-    returnSpiImpl->base.engineDoFinalMd = OpensslEngineDoFinalMd;
-    returnSpiImpl->base.engineGetMdLength = OpensslEngineGetMdLength;
+    if ((EVP_MD_flags(mdfunc) & EVP_MD_FLAG_XOF) != 0) {
+        returnSpiImpl->xofLen = (uint32_t)EVP_MD_size(mdfunc);
+    }
     *spiObj = (HcfMdSpi *)returnSpiImpl;
     return HCF_SUCCESS;
-}
\ No newline at end of file
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/* one fetch serves the whole batch, a built in EVP_MD would be looked up in the provider for every message */
+static const EVP_MD *FetchBatchMd(const char *opensslAlgoName)
+{
+    return EVP_MD_fetch(NULL, opensslAlgoName, NULL);
+}
+
+static void FreeBatchMd(const EVP_MD *md)
+{
+    EVP_MD_free((EVP_MD *)md);
+}
+#else
+static const EVP_MD *FetchBatchMd(const char *opensslAlgoName)
+{
+    return OpensslGetMdAlgoFromString(opensslAlgoName);
+}
+
+static void FreeBatchMd(const EVP_MD *md)
+{
+    (void)md;
+}
+#endif
+
+static HcfResult RunMdManySegment(void *arg, uint32_t begin, uint32_t end)
+{
+    MdManyTask *task = (MdManyTask *)arg;
+    for (uint32_t i = begin; i < end; i++) {
+        unsigned int mdLen = 0;
+        if (EVP_Digest(task->inputs[i].data, task->inputs[i].len, task->outputs[i].data, &mdLen, task->md,
+            NULL) != HCF_OPENSSL_SUCCESS) {
+            LOGE("EVP_Digest return error!");
+            HcfPrintOpensslError();
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+        task->outputs[i].len = mdLen;
+    }
+    return HCF_SUCCESS;
+}
+
+HcfResult OpensslMdDigestMany(const char *opensslAlgoName, const HcfBlob *inputs, HcfBlob *outputs, uint32_t count)
+{
+    const EVP_MD *md = FetchBatchMd(opensslAlgoName);
+    if (md == NULL) {
+        LOGE("Algo not support in batch! [Algo]: %s", opensslAlgoName);
+        return HCF_NOT_SUPPORT;
+    }
+    uint32_t mdLen = (uint32_t)EVP_MD_size(md);
+    uint64_t totalLen = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if ((outputs[i].data == NULL) || (outputs[i].len < mdLen)) {
+            LOGE("Output %u is too short!", i);
+            FreeBatchMd(md);
+            return HCF_INVALID_PARAMS;
+        }
+        totalLen += inputs[i].len;
+    }
+    MdManyTask task = { .md = md, .inputs = inputs, .outputs = outputs };
+    uint32_t threadNum = (totalLen >= MD_MANY_PARALLEL_THRESHOLD) ? HcfGetDefaultThreadNum() : 1;
+    HcfResult ret = HcfParallelRun(count, threadNum, RunMdManySegment, &task);
+    FreeBatchMd(md);
+    return ret;
+}
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "md_openssl.h"
+
+#include "hcf_parallel.h"
+#include "md.h"
+#include "openssl_common.h"
+#include "securec.h"
+#include "log.h"
+#include "memory.h"
+#include "utils.h"
+
+#include <openssl/evp.h>
+
+#define TREE_DIGEST_LEN 32
+/* each worker gets at least this many leaves (256 KiB), so that hashing them outweighs starting the thread */
+#define TREE_MIN_LEAVES_PER_THREAD 4
+/* one subtree per bit of the leaf count */
+#define TREE_MAX_DEPTH 64
+#define TREE_LEAF_PREFIX 0x00
+#define TREE_NODE_PREFIX 0x01
+
+/*
+ * The merkle tree hash of RFC 6962 over leaves of HCF_TREE_MD_LEAF_LEN bytes. The roots of the finished
+ * subtrees are kept on a stack, one per set bit of the leaf count, so update never needs more than one
+ * buffered leaf. The shape only depends on the input length, not on the number of threads.
+ */
+typedef struct {
+    HcfMdSpi base;
+
+    uint32_t threadNum;
+
+    EVP_MD_CTX *ctx;
+
+    unsigned char *leaf;
+
+    uint32_t leafLen;
+
+    uint64_t leafCount;
+
+    uint32_t stackLen;
+
+    unsigned char stack[TREE_MAX_DEPTH][TREE_DIGEST_LEN];
+} OpensslTreeMdSpiImpl;
+
+typedef struct {
+    const unsigned char *data;
+    unsigned char (*digests)[TREE_DIGEST_LEN];
+} TreeLeafTask;
+
+static const char *OpensslGetTreeMdClass(void)
+{
+    return "OpensslTreeMd";
+}
+
+static OpensslTreeMdSpiImpl *OpensslGetTreeMd(HcfMdSpi *self)
+{
+    if (!IsClassMatch((HcfObjectBase *)self, OpensslGetTreeMdClass())) {
+        LOGE("Class is not match.");
+        return NULL;
+    }
+    return (OpensslTreeMdSpiImpl *)self;
+}
+
+static HcfResult HashPrefixed(EVP_MD_CTX *ctx, unsigned char prefix, const unsigned char *first, size_t firstLen,
+    const unsigned char *second, size_t secondLen, unsigned char *digest)
+{
+    if ((EVP_DigestInit_ex(ctx, EVP_sha256(), NULL) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_DigestUpdate(ctx, &prefix, sizeof(prefix)) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_DigestUpdate(ctx, first, firstLen) != HCF_OPENSSL_SUCCESS) ||
+        ((secondLen > 0) && (EVP_DigestUpdate(ctx, second, secondLen) != HCF_OPENSSL_SUCCESS)) ||
+        (EVP_DigestFinal_ex(ctx, digest, NULL) != HCF_OPENSSL_SUCCESS)) {
+        LOGE("Failed to hash tree node!");
+        HcfPrintOpensslError();
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult HashLeaf(EVP_MD_CTX *ctx, const unsigned char *data, size_t len, unsigned char *digest)
+{
+    return HashPrefixed(ctx, TREE_LEAF_PREFIX, data, len, NULL, 0, digest);
+}
+
+static HcfResult HashNode(EVP_MD_CTX *ctx, const unsigned char *left, const unsigned char *right,
+    unsigned char *digest)
+{
+    return HashPrefixed(ctx, TREE_NODE_PREFIX, left, TREE_DIGEST_LEN, right, TREE_DIGEST_LEN, digest);
+}
+
+/* a complete subtree of 2^k leaves is merged with its left sibling as soon as it exists */
+static HcfResult PushLeafDigest(OpensslTreeMdSpiImpl *impl, const unsigned char *digest)
+{
+    (void)memcpy_s(impl->stack[impl->stackLen], TREE_DIGEST_LEN, digest, TREE_DIGEST_LEN);
+    impl->stackLen++;
+    impl->leafCount++;
+    for (uint64_t count = impl->leafCount; (count & 1) == 0; count >>= 1) {
+        impl->stackLen--;
+        HcfResult ret = HashNode(impl->ctx, impl->stack[impl->stackLen - 1], impl->stack[impl->stackLen],
+            impl->stack[impl->stackLen - 1]);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+/* one digest context per worker, reused for every leaf of its range */
+static HcfResult RunTreeLeaves(void *arg, uint32_t begin, uint32_t end)
+{
+    TreeLeafTask *task = (TreeLeafTask *)arg;
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    if (ctx == NULL) {
+        LOGE("EVP_MD_CTX_new failed!");
+        return HCF_ERR_MALLOC;
+    }
+    HcfResult ret = HCF_SUCCESS;
+    for (uint32_t i = begin; (i < end) && (ret == HCF_SUCCESS); i++) {
+        ret = HashLeaf(ctx, task->data + (size_t)i * HCF_TREE_MD_LEAF_LEN, HCF_TREE_MD_LEAF_LEN, task->digests[i]);
+    }
+    EVP_MD_CTX_free(ctx);
+    return ret;
+}
+
+/*
+ * Whole leaves straight from the caller buffer. The range of one update is split over the threads once,
+ * the leaf digests are only 1/2048 of the input so they are all kept until the workers are joined. An update
+ * of less than two threads worth of leaves is hashed on the calling thread.
+ */
+static HcfResult HashWholeLeaves(OpensslTreeMdSpiImpl *impl, const unsigned char *data, uint32_t leafNum)
+{
+    if (leafNum == 0) {
+        return HCF_SUCCESS;
+    }
+    TreeLeafTask task = { .data = data, .digests = NULL };
+    task.digests = (unsigned char (*)[TREE_DIGEST_LEN])HcfMalloc((size_t)leafNum * TREE_DIGEST_LEN, 0);
+    if (task.digests == NULL) {
+        LOGE("Failed to allocate leaf digests memory!");
+        return HCF_ERR_MALLOC;
+    }
+    uint32_t threadNum = leafNum / TREE_MIN_LEAVES_PER_THREAD;
+    threadNum = (threadNum < impl->threadNum) ? threadNum : impl->threadNum;
+    HcfResult ret = HcfParallelRun(leafNum, (threadNum > 1) ? threadNum : 1, RunTreeLeaves, &task);
+    if (ret != HCF_SUCCESS) {
+        LOGE("Failed to hash leaves!");
+    }
+    for (uint32_t i = 0; (i < leafNum) && (ret == HCF_SUCCESS); i++) {
+        ret = PushLeafDigest(impl, task.digests[i]);
+    }
+    HcfFree(task.digests);
+    return ret;
+}
+
+static HcfResult OpensslEngineUpdateTreeMd(HcfMdSpi *self, HcfBlob *input)
+{
+    OpensslTreeMdSpiImpl *impl = OpensslGetTreeMd(self);
+    if (impl == NULL) {
+        return HCF_INVALID_PARAMS;
+    }
+    if ((input->len / HCF_TREE_MD_LEAF_LEN >= UINT32_MAX) ||
+        (impl->leafCount + input->len / HCF_TREE_MD_LEAF_LEN + 1 >= ((uint64_t)1 << (TREE_MAX_DEPTH - 1)))) {
+        LOGE("The input is too long!");
+        return HCF_INVALID_PARAMS;
+    }
+    const unsigned char *data = input->data;
+    size_t len = input->len;
+    if (impl->leafLen > 0) {
+        size_t fillLen = HCF_TREE_MD_LEAF_LEN - impl->leafLen;
+        fillLen = (len < fillLen) ? len : fillLen;
+        (void)memcpy_s(impl->leaf + impl->leafLen, HCF_TREE_MD_LEAF_LEN - impl->leafLen, data, fillLen);
+        impl->leafLen += (uint32_t)fillLen;
+        data += fillLen;
+        len -= fillLen;
+        if (impl->leafLen < HCF_TREE_MD_LEAF_LEN) {
+            return HCF_SUCCESS;
+        }
+        unsigned char digest[TREE_DIGEST_LEN];
+        HcfResult ret = HashLeaf(impl->ctx, impl->leaf, HCF_TREE_MD_LEAF_LEN, digest);
+        if (ret == HCF_SUCCESS) {
+            ret = PushLeafDigest(impl, digest);
+        }
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+        impl->leafLen = 0;
+    }
+    uint32_t leafNum = (uint32_t)(len / HCF_TREE_MD_LEAF_LEN);
+    HcfResult ret = HashWholeLeaves(impl, data, leafNum);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    size_t tailLen = len - leafNum * HCF_TREE_MD_LEAF_LEN;
+    if (tailLen > 0) {
+        (void)memcpy_s(impl->leaf, HCF_TREE_MD_LEAF_LEN, data + leafNum * HCF_TREE_MD_LEAF_LEN, tailLen);
+        impl->leafLen = (uint32_t)tailLen;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult OpensslEngineDoFinalTreeMd(HcfMdSpi *self, HcfBlob *output)
+{
+    OpensslTreeMdSpiImpl *impl = OpensslGetTreeMd(self);
+    if (impl == NULL) {
+        return HCF_INVALID_PARAMS;
+    }
+    unsigned char root[TREE_DIGEST_LEN];
+    HcfResult ret = HCF_SUCCESS;
+    if ((impl->leafCount == 0) && (impl->leafLen == 0)) {
+        /* RFC 6962 defines the hash of an empty tree as the hash of the empty string */
+        if (EVP_Digest(NULL, 0, root, NULL, EVP_sha256(), NULL) != HCF_OPENSSL_SUCCESS) {
+            LOGE("EVP_Digest return error!");
+            HcfPrintOpensslError();
+            return HCF_ERR_CRYPTO_OPERATION;
+        }
+    } else {
+        if (impl->leafLen > 0) {
+            ret = HashLeaf(impl->ctx, impl->leaf, impl->leafLen, root);
+            if (ret == HCF_SUCCESS) {
+                ret = PushLeafDigest(impl, root);
+            }
+            if (ret != HCF_SUCCESS) {
+                return ret;
+            }
+            impl->leafLen = 0;
+        }
+        /* the incomplete right edge, smaller subtrees are right children of the larger ones */
+        (void)memcpy_s(root, sizeof(root), impl->stack[impl->stackLen - 1], TREE_DIGEST_LEN);
+        for (uint32_t i = impl->stackLen - 1; (i > 0) && (ret == HCF_SUCCESS); i--) {
+            ret = HashNode(impl->ctx, impl->stack[i - 1], root, root);
+        }
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    output->data = (uint8_t *)HcfMalloc(TREE_DIGEST_LEN, 0);
+    if (output->data == NULL) {
+        LOGE("Failed to allocate output->data memory!");
+        return HCF_ERR_MALLOC;
+    }
+    (void)memcpy_s(output->data, TREE_DIGEST_LEN, root, sizeof(root));
+    output->len = TREE_DIGEST_LEN;
+    return HCF_SUCCESS;
+}
+
+static uint32_t OpensslEngineGetTreeMdLength(HcfMdSpi *self)
+{
+    return (OpensslGetTreeMd(self) == NULL) ? 0 : TREE_DIGEST_LEN;
+}
+
+static HcfResult OpensslEngineResetTreeMd(HcfMdSpi *self)
+{
+    OpensslTreeMdSpiImpl *impl = OpensslGetTreeMd(self);
+    if (impl == NULL) {
+        return HCF_INVALID_PARAMS;
+    }
+    impl->leafLen = 0;
+    impl->leafCount = 0;
+    impl->stackLen = 0;
+    return HCF_SUCCESS;
+}
+
+static void OpensslDestroyTreeMd(HcfObjectBase *self)
+{
+    if (self == NULL) {
+        LOGE("Self ptr is NULL!");
+        return;
+    }
+    if (!IsClassMatch(self, OpensslGetTreeMdClass())) {
+        LOGE("Class is not match.");
+        return;
+    }
+    OpensslTreeMdSpiImpl *impl = (OpensslTreeMdSpiImpl *)self;
+    EVP_MD_CTX_free(impl->ctx);
+    HcfFree(impl->leaf);
+    HcfFree(impl);
+}
+
+HcfResult OpensslTreeMdSpiCreate(const char *opensslAlgoName, HcfMdSpi **spiObj)
+{
+    if ((opensslAlgoName == NULL) || (spiObj == NULL)) {
+        LOGE("Invalid input parameter.");
+        return HCF_INVALID_PARAMS;
+    }
+    OpensslTreeMdSpiImpl *returnSpiImpl = (OpensslTreeMdSpiImpl *)HcfMalloc(sizeof(OpensslTreeMdSpiImpl), 0);
+    if (returnSpiImpl == NULL) {
+        LOGE("Failed to allocate returnImpl memory!");
+        return HCF_ERR_MALLOC;
+    }
+    returnSpiImpl->threadNum = HcfGetDefaultThreadNum();
+    returnSpiImpl->leaf = (unsigned char *)HcfMalloc(HCF_TREE_MD_LEAF_LEN, 0);
+    returnSpiImpl->ctx = EVP_MD_CTX_new();
+    if ((returnSpiImpl->leaf == NULL) || (returnSpiImpl->ctx == NULL)) {
+        LOGE("Failed to allocate tree buffers!");
+        EVP_MD_CTX_free(returnSpiImpl->ctx);
+        HcfFree(returnSpiImpl->leaf);
+        HcfFree(returnSpiImpl);
+        return HCF_ERR_MALLOC;
+    }
+    returnSpiImpl->base.base.getClass = OpensslGetTreeMdClass;
+    returnSpiImpl->base.base.destroy = OpensslDestroyTreeMd;
+    returnSpiImpl->base.engineUpdateMd = OpensslEngineUpdateTreeMd;
+    returnSpiImpl->base.engineDoFinalMd = OpensslEngineDoFinalTreeMd;
+    returnSpiImpl->base.engineGetMdLength = OpensslEngineGetTreeMdLength;
+    returnSpiImpl->base.engineResetMd = OpensslEngineResetTreeMd;
+    *spiObj = (HcfMdSpi *)returnSpiImpl;
+    return HCF_SUCCESS;
+}
@@ -268,6 +268,51 @@ static HcfResult EngineDoFinal(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input,
     return HCF_SUCCESS;
 }
 
+static HcfResult EngineDoFinalToBuffer(OH_HCF_CipherGeneratorSpi *self, HcfBlob *input, HcfBlob *output)
+{
+    if (self == NULL || input == NULL || input->data == NULL || output == NULL || output->data == NULL) {
+        LOGE("Param is invalid.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, EngineGetClass())) {
+        LOGE("Class not match");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherRsaGeneratorSpiImpl *impl = (HcfCipherRsaGeneratorSpiImpl *)self;
+    if (impl->initFlag != INITIALIZED) {
+        LOGE("RSACipher has not been init");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfResult ret = DoRsaCrypt(impl->ctx, input, output, impl->attr.mode);
+    if (ret != HCF_SUCCESS) {
+        LOGE("DoRsaCrypt fail.");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineGetOutputSize(OH_HCF_CipherGeneratorSpi *self, uint32_t inputLen, bool isFinal,
+    uint32_t *outputLen)
+{
+    (void)inputLen;
+    if (self == NULL || outputLen == NULL) {
+        LOGE("Param is invalid.");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, EngineGetClass())) {
+        LOGE("Class not match");
+        return HCF_INVALID_PARAMS;
+    }
+    HcfCipherRsaGeneratorSpiImpl *impl = (HcfCipherRsaGeneratorSpiImpl *)self;
+    if (impl->initFlag != INITIALIZED) {
+        LOGE("RSACipher has not been init");
+        return HCF_INVALID_PARAMS;
+    }
+    /* rsa cipher only outputs in doFinal, at most one modulus long */
+    *outputLen = isFinal ? (uint32_t)EVP_PKEY_size(EVP_PKEY_CTX_get0_pkey(impl->ctx)) : 0;
+    return HCF_SUCCESS;
+}
+
 static void EngineDestroySpiImpl(HcfObjectBase *generator)
 {
     if (generator == NULL) {
@@ -344,6 +389,8 @@ HcfResult HcfCipherRsaCipherSpiCreate(CipherAttr *params, OH_HCF_CipherGenerator
     returnImpl->super.init = EngineInit;
     returnImpl->super.update = EngineUpdata;
     returnImpl->super.doFinal = EngineDoFinal;
+    returnImpl->super.getOutputSize = EngineGetOutputSize;
+    returnImpl->super.doFinalToBuffer = EngineDoFinalToBuffer;
     returnImpl->super.base.destroy = EngineDestroySpiImpl;
     returnImpl->super.base.getClass = EngineGetClass;
     returnImpl->initFlag = UNINITIALIZED;
@@ -94,6 +94,21 @@ static void DestroyEcdsaSign(HcfObjectBase *self)
     HcfFree(impl);
 }
 
+static void EngineSignClear(HcfSignSpi *self)
+{
+    if (self == NULL) {
+        return;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, GetEcdsaSignClass())) {
+        return;
+    }
+    HcfSignSpiEcdsaOpensslImpl *impl = (HcfSignSpiEcdsaOpensslImpl *)self;
+    if (EVP_MD_CTX_reset(impl->ctx) != HCF_OPENSSL_SUCCESS) {
+        LOGE("EVP_MD_CTX_reset failed.");
+    }
+    impl->status = UNINITIALIZED;
+}
+
 static void DestroyEcdsaVerify(HcfObjectBase *self)
 {
     if (self == NULL) {
@@ -102,7 +117,7 @@ static void DestroyEcdsaVerify(HcfObjectBase *self)
     if (!IsClassMatch(self, GetEcdsaVerifyClass())) {
         return;
     }
-    HcfSignSpiEcdsaOpensslImpl *impl = (HcfSignSpiEcdsaOpensslImpl *)self;
+    HcfVerifySpiEcdsaOpensslImpl *impl = (HcfVerifySpiEcdsaOpensslImpl *)self;
     EVP_MD_CTX_destroy(impl->ctx);
     impl->ctx = NULL;
     HcfFree(impl);
@@ -370,6 +385,7 @@ HcfResult HcfSignSpiEcdsaCreate(HcfSignatureParams *params, HcfSignSpi **returnO
     returnImpl->base.engineInit = EngineSignInit;
     returnImpl->base.engineUpdate = EngineSignUpdate;
     returnImpl->base.engineSign = EngineSignDoFinal;
+    returnImpl->base.engineClear = EngineSignClear;
     returnImpl->curveId = curveId;
     returnImpl->digestAlg = opensslAlg;
     returnImpl->status = UNINITIALIZED;
@@ -81,6 +81,24 @@ static void DestroyRsaSign(HcfObjectBase *self)
     LOGI("DestroyRsaSign success.");
 }
 
+static void EngineSignClear(HcfSignSpi *self)
+{
+    if (self == NULL) {
+        LOGE("Class is null");
+        return;
+    }
+    if (!IsClassMatch((HcfObjectBase *)self, OPENSSL_RSA_SIGN_CLASS)) {
+        LOGE("Class not match.");
+        return;
+    }
+    HcfSignSpiRsaOpensslImpl *impl = (HcfSignSpiRsaOpensslImpl *)self;
+    // drops the pkey ctx and with it the reference to the private key
+    if (EVP_MD_CTX_reset(impl->mdctx) != HCF_OPENSSL_SUCCESS) {
+        LOGE("EVP_MD_CTX_reset failed.");
+    }
+    impl->initFlag = UNINITIALIZED;
+}
+
 static void DestroyRsaVerify(HcfObjectBase *self)
 {
     if (self == NULL) {
@@ -435,6 +453,7 @@ HcfResult HcfSignSpiRsaCreate(HcfSignatureParams *params, HcfSignSpi **returnObj
     returnImpl->base.engineInit = EngineSignInit;
     returnImpl->base.engineUpdate = EngineSignUpdate;
     returnImpl->base.engineSign = EngineSign;
+    returnImpl->base.engineClear = EngineSignClear;
 
     returnImpl->md = params->md;
     returnImpl->padding = params->padding;
@@ -16,6 +16,8 @@
 #ifndef HCF_SYM_COMMON_DEFINES_H
 #define HCF_SYM_COMMON_DEFINES_H
 
+#include <pthread.h>
+#include <openssl/evp.h>
 #include "sym_key_factory_spi.h"
 #include "sym_key.h"
 #include "params_parser.h"
@@ -23,12 +25,27 @@
 typedef struct {
     HCF_ALG_VALUE algo;
     int keySize;
+    /* HCF_ALG_MODE_XTS: keySize covers the data key and the tweak key */
+    HCF_ALG_PARA_VALUE mode;
+    /* HCF_ALG_MAC_DIGEST value of an encrypt-then-mac key: keySize covers the mac key and the aes key */
+    HCF_ALG_PARA_VALUE macMd;
 } SymKeyAttr;
 
+#define SYM_KEY_CTX_TEMPLATE_NUM 4
+
+typedef struct {
+    const EVP_CIPHER *cipher;
+    int enc;
+    EVP_CIPHER_CTX *ctx;
+} SymKeyCtxTemplate;
+
 typedef struct {
     HcfSymKey key;
     char *algoName;
     HcfBlob keyMaterial;
+    /* contexts holding the expanded key, built on first use and never changed until the key is cleared */
+    pthread_mutex_t templateLock;
+    SymKeyCtxTemplate templates[SYM_KEY_CTX_TEMPLATE_NUM];
 } SymKeyImpl;
 
 #ifdef __cplusplus
@@ -37,6 +54,9 @@ extern "C" {
 
 HcfResult HcfSymKeyGeneratorSpiCreate(SymKeyAttr *attr, OH_HCF_SymKeyGeneratorSpi **genertor);
 
+/* init ctx for cipher with the key set and no iv, the key schedule is copied from the template of the key */
+HcfResult HcfSymKeyInitCipherCtx(SymKeyImpl *key, const EVP_CIPHER *cipher, int enc, EVP_CIPHER_CTX *ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <string.h>
+#include <openssl/evp.h>
 #include <openssl/rand.h>
 #include "log.h"
 #include "memory.h"
@@ -22,11 +24,23 @@
 #include "sym_common_defines.h"
 #include "openssl_common.h"
 
-#define MAX_KEY_STR_SIZE 12
+#define MAX_KEY_STR_SIZE 20
 #define MAX_KEY_LEN 4096
 #define KEY_BIT 8
 #define AES_ALG_NAME "AES"
 #define DES_ALG_NAME "3DES"
+/* chacha20 has a single key size, so its name carries no size suffix */
+#define CHACHA20_ALG_NAME "ChaCha20"
+/* an xts key is named after its cipher, "AES256|XTS" holds two 256 bit keys */
+#define XTS_MODE_SUFFIX "|XTS"
+#define XTS_KEY_NUM 2
+/* an encrypt-then-mac key is named after its hmac, "AES256|HMAC-SHA256" holds a 256 bit mac key and aes key */
+#define ETM_KEY_NUM 2
+#define KEY_WRAP_BLOCK_SIZE 8
+#define KEY_WRAP_MIN_KEY_LEN 16
+#define KEK_LEN_128 16
+#define KEK_LEN_192 24
+#define KEK_LEN_256 32
 
 typedef struct {
     OH_HCF_SymKeyGeneratorSpi base;
@@ -58,6 +72,17 @@ static HcfResult GetEncoded(HcfKey *self, HcfBlob *key)
     return HCF_SUCCESS;
 }
 
+static void FreeCtxTemplates(SymKeyImpl *impl)
+{
+    (void)pthread_mutex_lock(&(impl->templateLock));
+    for (uint32_t i = 0; i < SYM_KEY_CTX_TEMPLATE_NUM; i++) {
+        EVP_CIPHER_CTX_free(impl->templates[i].ctx);
+        impl->templates[i].ctx = NULL;
+        impl->templates[i].cipher = NULL;
+    }
+    (void)pthread_mutex_unlock(&(impl->templateLock));
+}
+
 static void ClearMem(HcfSymKey *self)
 {
     if (self == NULL) {
@@ -69,11 +94,90 @@ static void ClearMem(HcfSymKey *self)
         return;
     }
     SymKeyImpl *impl = (SymKeyImpl *)self;
+    FreeCtxTemplates(impl);
     if ((impl->keyMaterial.data != NULL) && (impl->keyMaterial.len > 0)) {
         (void)memset_s(impl->keyMaterial.data, impl->keyMaterial.len, 0, impl->keyMaterial.len);
     }
 }
 
+static void InitCtxTemplates(SymKeyImpl *impl)
+{
+    (void)pthread_mutex_init(&(impl->templateLock), NULL);
+}
+
+static EVP_CIPHER_CTX *NewCtxTemplate(SymKeyImpl *key, const EVP_CIPHER *cipher, int enc)
+{
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return NULL;
+    }
+    if (EVP_CipherInit_ex(ctx, cipher, NULL, key->keyMaterial.data, NULL, enc) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("init template ctx failed!");
+        EVP_CIPHER_CTX_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+/*
+ * copy the template of cipher and enc into ctx, building it in a free slot first. The copy is done under the lock,
+ * clearMem may free the templates at any time. HCF_NOT_SUPPORT when all slots are taken.
+ */
+static HcfResult CopyCtxTemplate(SymKeyImpl *key, const EVP_CIPHER *cipher, int enc, EVP_CIPHER_CTX *ctx)
+{
+    EVP_CIPHER_CTX *template = NULL;
+    (void)pthread_mutex_lock(&(key->templateLock));
+    for (uint32_t i = 0; i < SYM_KEY_CTX_TEMPLATE_NUM; i++) {
+        SymKeyCtxTemplate *item = &(key->templates[i]);
+        if (item->ctx == NULL) {
+            item->ctx = NewCtxTemplate(key, cipher, enc);
+            item->cipher = cipher;
+            item->enc = enc;
+            template = item->ctx;
+            break;
+        }
+        if ((item->cipher == cipher) && (item->enc == enc)) {
+            template = item->ctx;
+            break;
+        }
+    }
+    HcfResult ret = HCF_NOT_SUPPORT;
+    if (template != NULL) {
+        ret = HCF_SUCCESS;
+        if (EVP_CIPHER_CTX_copy(ctx, template) != HCF_OPENSSL_SUCCESS) {
+            HcfPrintOpensslError();
+            LOGE("copy template ctx failed!");
+            ret = HCF_ERR_CRYPTO_OPERATION;
+        }
+    }
+    (void)pthread_mutex_unlock(&(key->templateLock));
+    return ret;
+}
+
+HcfResult HcfSymKeyInitCipherCtx(SymKeyImpl *key, const EVP_CIPHER *cipher, int enc, EVP_CIPHER_CTX *ctx)
+{
+    if ((key == NULL) || (cipher == NULL) || (ctx == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (key->keyMaterial.len != (size_t)EVP_CIPHER_key_length(cipher)) {
+        LOGE("key length %zu does not match the cipher!", key->keyMaterial.len);
+        return HCF_INVALID_PARAMS;
+    }
+    if (CopyCtxTemplate(key, cipher, enc, ctx) == HCF_SUCCESS) {
+        return HCF_SUCCESS;
+    }
+    /* no free template slot or a failed copy, schedule the key on ctx itself */
+    if (EVP_CipherInit_ex(ctx, cipher, NULL, key->keyMaterial.data, NULL, enc) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("EVP_CipherInit_ex failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
 static const char *GetFormat(HcfKey *self)
 {
     if (self == NULL) {
@@ -169,6 +273,8 @@ static void DestroySymKeySpi(HcfObjectBase *base)
         return;
     }
     SymKeyImpl *impl = (SymKeyImpl *)base;
+    FreeCtxTemplates(impl);
+    (void)pthread_mutex_destroy(&(impl->templateLock));
     if (impl->algoName != NULL) {
         HcfFree(impl->algoName);
         impl->algoName = NULL;
@@ -182,10 +288,40 @@ static void DestroySymKeySpi(HcfObjectBase *base)
     HcfFree(impl);
 }
 
+static const char *GetMacSuffix(HCF_ALG_PARA_VALUE macMd)
+{
+    switch (macMd) {
+        case HCF_OPENSSL_DIGEST_SHA1:
+            return "|HMAC-SHA1";
+        case HCF_OPENSSL_DIGEST_SHA256:
+            return "|HMAC-SHA256";
+        case HCF_OPENSSL_DIGEST_SHA384:
+            return "|HMAC-SHA384";
+        case HCF_OPENSSL_DIGEST_SHA512:
+            return "|HMAC-SHA512";
+        default:
+            return NULL;
+    }
+}
+
+static int32_t PrintKeySize(const SymKeyAttr *attr, char *keySizeChar)
+{
+    if (attr->mode == HCF_ALG_MODE_XTS) {
+        return sprintf_s(keySizeChar, MAX_KEY_STR_SIZE, "%d%s", attr->keySize / XTS_KEY_NUM, XTS_MODE_SUFFIX);
+    }
+    if (attr->macMd != 0) {
+        const char *suffix = GetMacSuffix(attr->macMd);
+        return (suffix == NULL) ? -1 :
+            sprintf_s(keySizeChar, MAX_KEY_STR_SIZE, "%d%s", attr->keySize / ETM_KEY_NUM, suffix);
+    }
+    return sprintf_s(keySizeChar, MAX_KEY_STR_SIZE, "%d", attr->keySize);
+}
+
 static char *GetAlgoName(HcfSymKeyGeneratorSpiOpensslImpl *impl)
 {
     char keySizeChar[MAX_KEY_STR_SIZE] = { 0 };
-    if (sprintf_s(keySizeChar, MAX_KEY_STR_SIZE, "%d", impl->attr.keySize) < 0) {
+    int32_t printRet = PrintKeySize(&(impl->attr), keySizeChar);
+    if (printRet < 0) {
         LOGE("Invalid input parameter!");
         return NULL;
     }
@@ -216,6 +352,11 @@ static char *GetAlgoName(HcfSymKeyGeneratorSpiOpensslImpl *impl)
             LOGE("des algoName size strcpy_s failed!");
             goto clearup;
         }
+    } else if (type == HCF_ALG_CHACHA20) {
+        if (strcpy_s(algoName, MAX_KEY_STR_SIZE, CHACHA20_ALG_NAME) != EOK) {
+            LOGE("chacha20 algoName strcpy_s failed!");
+            goto clearup;
+        }
     } else {
         LOGE("unsupport algo!");
         goto clearup;
@@ -265,6 +406,7 @@ static HcfResult GenerateSymmKey(OH_HCF_SymKeyGeneratorSpi *self, HcfSymKey **sy
         return res;
     }
     returnSymmKey->algoName = GetAlgoName(impl);
+    InitCtxTemplates(returnSymmKey);
     returnSymmKey->key.clearMem = ClearMem;
     returnSymmKey->key.key.getEncoded = GetEncoded;
     returnSymmKey->key.key.getFormat = GetFormat;
@@ -303,6 +445,7 @@ static HcfResult ConvertSymmKey(OH_HCF_SymKeyGeneratorSpi *self, const HcfBlob *
         return res;
     }
     returnSymmKey->algoName = GetAlgoName(impl);
+    InitCtxTemplates(returnSymmKey);
     returnSymmKey->key.clearMem = ClearMem;
     returnSymmKey->key.key.getEncoded = GetEncoded;
     returnSymmKey->key.key.getFormat = GetFormat;
@@ -313,6 +456,195 @@ static HcfResult ConvertSymmKey(OH_HCF_SymKeyGeneratorSpi *self, const HcfBlob *
     return HCF_SUCCESS;
 }
 
+static const EVP_CIPHER *GetWrapCipher(HcfKeyWrapMode mode, size_t kekLen)
+{
+    bool pad = (mode == HCF_KEY_WRAP_AES_PAD);
+    switch (kekLen) {
+        case KEK_LEN_128:
+            return pad ? EVP_aes_128_wrap_pad() : EVP_aes_128_wrap();
+        case KEK_LEN_192:
+            return pad ? EVP_aes_192_wrap_pad() : EVP_aes_192_wrap();
+        case KEK_LEN_256:
+            return pad ? EVP_aes_256_wrap_pad() : EVP_aes_256_wrap();
+        default:
+            return NULL;
+    }
+}
+
+/* the kek is a plain AES key, the key schedule is computed once for all keys wrapped by ctx */
+static HcfResult InitWrapCtx(HcfKeyWrapMode mode, HcfSymKey *kek, int enc, EVP_CIPHER_CTX **ctx)
+{
+    if ((mode != HCF_KEY_WRAP_AES) && (mode != HCF_KEY_WRAP_AES_PAD)) {
+        LOGE("Invalid key wrap mode %d!", mode);
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)kek, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    SymKeyImpl *kekImpl = (SymKeyImpl *)kek;
+    const EVP_CIPHER *cipher = GetWrapCipher(mode, kekImpl->keyMaterial.len);
+    if ((cipher == NULL) || (kekImpl->algoName == NULL) ||
+        (strncmp(kekImpl->algoName, AES_ALG_NAME, strlen(AES_ALG_NAME)) != 0) ||
+        (strchr(kekImpl->algoName, '|') != NULL)) {
+        LOGE("kek must be an AES128, AES192 or AES256 key!");
+        return HCF_INVALID_PARAMS;
+    }
+    *ctx = EVP_CIPHER_CTX_new();
+    if (*ctx == NULL) {
+        LOGE("Failed to allocate ctx memroy!");
+        return HCF_ERR_MALLOC;
+    }
+    EVP_CIPHER_CTX_set_flags(*ctx, EVP_CIPHER_CTX_FLAG_WRAP_ALLOW);
+    if (EVP_CipherInit_ex(*ctx, cipher, NULL, kekImpl->keyMaterial.data, NULL, enc) != HCF_OPENSSL_SUCCESS) {
+        HcfPrintOpensslError();
+        LOGE("init kek failed!");
+        EVP_CIPHER_CTX_free(*ctx);
+        *ctx = NULL;
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+/* one whole wrap or unwrap, the ctx is rewound to its default iv and keeps the expanded kek */
+static HcfResult WrapUpdate(EVP_CIPHER_CTX *ctx, const HcfBlob *input, uint8_t *output, int32_t *outLen)
+{
+    if ((EVP_CipherInit_ex(ctx, NULL, NULL, NULL, NULL, -1) != HCF_OPENSSL_SUCCESS) ||
+        (EVP_CipherUpdate(ctx, output, outLen, input->data, (int32_t)input->len) != HCF_OPENSSL_SUCCESS) ||
+        (*outLen <= 0)) {
+        HcfPrintOpensslError();
+        LOGE("key wrap operation failed!");
+        return HCF_ERR_CRYPTO_OPERATION;
+    }
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineWrapSymmKey(OH_HCF_SymKeyGeneratorSpi *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+    HcfSymKey *key, HcfBlob *wrapped)
+{
+    if ((self == NULL) || (kek == NULL) || (key == NULL) || (wrapped == NULL)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetSymKeyGeneratorClass()) ||
+        !IsClassMatch((const HcfObjectBase *)key, OPENSSL_SYM_KEY_CLASS)) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    const HcfBlob *keyMaterial = &(((SymKeyImpl *)key)->keyMaterial);
+    if (!IsBlobValid(keyMaterial) || (keyMaterial->len > INT32_MAX - 2 * KEY_WRAP_BLOCK_SIZE) ||
+        ((mode == HCF_KEY_WRAP_AES) &&
+        ((keyMaterial->len < KEY_WRAP_MIN_KEY_LEN) || (keyMaterial->len % KEY_WRAP_BLOCK_SIZE != 0)))) {
+        LOGE("key length does not fit the key wrap mode!");
+        return HCF_INVALID_PARAMS;
+    }
+    EVP_CIPHER_CTX *ctx = NULL;
+    HcfResult ret = InitWrapCtx(mode, kek, 1, &ctx);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    /* the integrity block plus the key padded to whole blocks */
+    size_t maxLen = (keyMaterial->len + KEY_WRAP_BLOCK_SIZE - 1) / KEY_WRAP_BLOCK_SIZE * KEY_WRAP_BLOCK_SIZE +
+        KEY_WRAP_BLOCK_SIZE;
+    wrapped->data = (uint8_t *)HcfMalloc(maxLen, 0);
+    if (wrapped->data == NULL) {
+        LOGE("malloc wrapped key failed!");
+        EVP_CIPHER_CTX_free(ctx);
+        return HCF_ERR_MALLOC;
+    }
+    int32_t outLen = 0;
+    ret = WrapUpdate(ctx, keyMaterial, wrapped->data, &outLen);
+    EVP_CIPHER_CTX_free(ctx);
+    if (ret != HCF_SUCCESS) {
+        HcfFree(wrapped->data);
+        wrapped->data = NULL;
+        return ret;
+    }
+    wrapped->len = (size_t)outLen;
+    return HCF_SUCCESS;
+}
+
+static HcfResult UnwrapOneKey(HcfSymKeyGeneratorSpiOpensslImpl *impl, EVP_CIPHER_CTX *ctx,
+    const HcfBlob *wrapped, HcfSymKey **symmKey)
+{
+    *symmKey = NULL;
+    if (!IsBlobValid(wrapped) || (wrapped->len > INT32_MAX) || (wrapped->len < 2 * KEY_WRAP_BLOCK_SIZE) ||
+        (wrapped->len % KEY_WRAP_BLOCK_SIZE != 0)) {
+        LOGE("Invalid wrapped key!");
+        return HCF_INVALID_PARAMS;
+    }
+    SymKeyImpl *returnSymmKey = (SymKeyImpl *)HcfMalloc(sizeof(SymKeyImpl), 0);
+    if (returnSymmKey == NULL) {
+        LOGE("Failed to allocate returnSymmKey memory!");
+        return HCF_ERR_MALLOC;
+    }
+    /* openssl cleanses the whole input length of the output when the integrity check fails */
+    uint32_t bufLen = wrapped->len;
+    returnSymmKey->keyMaterial.data = (uint8_t *)HcfMalloc(bufLen, 0);
+    if (returnSymmKey->keyMaterial.data == NULL) {
+        LOGE("keyMaterial malloc failed!");
+        HcfFree(returnSymmKey);
+        return HCF_ERR_MALLOC;
+    }
+    int32_t outLen = 0;
+    HcfResult ret = WrapUpdate(ctx, wrapped, returnSymmKey->keyMaterial.data, &outLen);
+    if ((ret == HCF_SUCCESS) && ((impl->attr.keySize / KEY_BIT) != outLen)) {
+        LOGE("unwrapped key length does not match the generator!");
+        ret = HCF_INVALID_PARAMS;
+    }
+    if (ret == HCF_SUCCESS) {
+        returnSymmKey->algoName = GetAlgoName(impl);
+        ret = (returnSymmKey->algoName == NULL) ? HCF_ERR_MALLOC : HCF_SUCCESS;
+    }
+    if (ret != HCF_SUCCESS) {
+        (void)memset_s(returnSymmKey->keyMaterial.data, bufLen, 0, bufLen);
+        HcfFree(returnSymmKey->keyMaterial.data);
+        HcfFree(returnSymmKey);
+        return ret;
+    }
+    returnSymmKey->keyMaterial.len = (size_t)outLen;
+    InitCtxTemplates(returnSymmKey);
+    returnSymmKey->key.clearMem = ClearMem;
+    returnSymmKey->key.key.getEncoded = GetEncoded;
+    returnSymmKey->key.key.getFormat = GetFormat;
+    returnSymmKey->key.key.getAlgorithm = GetAlgorithm;
+    returnSymmKey->key.key.base.destroy = DestroySymKeySpi;
+    returnSymmKey->key.key.base.getClass = GetSymKeyClass;
+    *symmKey = (HcfSymKey *)returnSymmKey;
+    return HCF_SUCCESS;
+}
+
+static HcfResult EngineUnwrapSymmKey(OH_HCF_SymKeyGeneratorSpi *self, HcfKeyWrapMode mode, HcfSymKey *kek,
+    const HcfBlob *wrapped, HcfSymKey **symmKeys, uint32_t count)
+{
+    if ((self == NULL) || (kek == NULL) || (wrapped == NULL) || (symmKeys == NULL) || (count == 0)) {
+        LOGE("Invalid input parameter!");
+        return HCF_INVALID_PARAMS;
+    }
+    if (!IsClassMatch((const HcfObjectBase *)self, GetSymKeyGeneratorClass())) {
+        LOGE("Class is not match.");
+        return HCF_INVALID_PARAMS;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        symmKeys[i] = NULL;
+    }
+    EVP_CIPHER_CTX *ctx = NULL;
+    HcfResult ret = InitWrapCtx(mode, kek, 0, &ctx);
+    if (ret != HCF_SUCCESS) {
+        return ret;
+    }
+    HcfSymKeyGeneratorSpiOpensslImpl *impl = (HcfSymKeyGeneratorSpiOpensslImpl *)self;
+    for (uint32_t i = 0; i < count; i++) {
+        HcfResult res = UnwrapOneKey(impl, ctx, &wrapped[i], &symmKeys[i]);
+        if ((res != HCF_SUCCESS) && (ret == HCF_SUCCESS)) {
+            LOGE("unwrap key %u failed!", i);
+            ret = res;
+        }
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
 HcfResult HcfSymKeyGeneratorSpiCreate(SymKeyAttr *attr, OH_HCF_SymKeyGeneratorSpi **generator)
 {
     if ((attr == NULL) || (generator == NULL)) {
@@ -328,6 +660,8 @@ HcfResult HcfSymKeyGeneratorSpiCreate(SymKeyAttr *attr, OH_HCF_SymKeyGeneratorSp
     (void)memcpy_s(&returnGenerator->attr, sizeof(SymKeyAttr), attr, sizeof(SymKeyAttr));
     returnGenerator->base.engineGenerateSymmKey = GenerateSymmKey;
     returnGenerator->base.engineConvertSymmKey = ConvertSymmKey;
+    returnGenerator->base.engineWrapSymmKey = EngineWrapSymmKey;
+    returnGenerator->base.engineUnwrapSymmKey = EngineUnwrapSymmKey;
     returnGenerator->base.base.destroy = DestroySymKeyGeneratorSpi;
     returnGenerator->base.base.getClass = GetSymKeyGeneratorClass;
     *generator = (OH_HCF_SymKeyGeneratorSpi *)returnGenerator;
@@ -0,0 +1,1379 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+#include "securec.h"
+
+#include "sym_key_generator.h"
+#include "asy_key_generator.h"
+#include "cipher.h"
+#include "cipher_container.h"
+#include "hcf_object_pool.h"
+#include "hcf_parallel.h"
+#include "mac.h"
+#include "md.h"
+#include "signature.h"
+#include "log.h"
+#include "memory.h"
+#include "detailed_gcm_params.h"
+#include "detailed_iv_params.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t BENCH_ROUNDS = 2000;
+constexpr uint32_t BENCH_MAX_PAYLOAD = 1500;
+constexpr uint32_t GCM_TAG_LEN = 16;
+constexpr uint32_t GCM_IV_LEN = 12;
+constexpr uint32_t GCM_AAD_LEN = 16;
+/* getOutputSize reserves one block besides the tag */
+constexpr uint32_t BENCH_MAX_OUTPUT = BENCH_MAX_PAYLOAD + 16 + GCM_TAG_LEN;
+const uint32_t BENCH_PAYLOAD_LENS[] = { 64, 256, 576, 1024, 1500 };
+
+class CryptoCipherBenchmarkTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void CryptoCipherBenchmarkTest::SetUpTestCase() {}
+void CryptoCipherBenchmarkTest::TearDownTestCase() {}
+
+void CryptoCipherBenchmarkTest::SetUp() // add init here, this will be called before test.
+{
+}
+
+void CryptoCipherBenchmarkTest::TearDown() // add destroy here, this will be called when test case done.
+{
+}
+
+static HcfSymKey *GenerateBenchKey(const char *algoName)
+{
+    HcfSymKeyGenerator *generator = nullptr;
+    HcfSymKey *key = nullptr;
+    if (HcfSymKeyGeneratorCreate(algoName, &generator) != HCF_SUCCESS) {
+        LOGE("HcfSymKeyGeneratorCreate failed!");
+        return nullptr;
+    }
+    if (generator->generateSymKey(generator, &key) != HCF_SUCCESS) {
+        LOGE("generateSymKey failed!");
+    }
+    OH_HCF_OBJ_DESTROY(generator);
+    return key;
+}
+
+static double NanoSecondsPerMessage(chrono::steady_clock::time_point start, uint32_t rounds)
+{
+    chrono::duration<double, nano> cost = chrono::steady_clock::now() - start;
+    return cost.count() / rounds;
+}
+
+/* one gcm message per round: the iv counter changes for every message like a packet sequence number */
+static void SetMessageIv(HcfGcmParamsSpec *spec, uint32_t seq)
+{
+    (void)memcpy_s(spec->iv.data, spec->iv.len, &seq, sizeof(seq));
+}
+
+static HcfResult SealWithInit(HcfCipher *cipher, HcfSymKey *key, HcfGcmParamsSpec *spec,
+    HcfBlob *input, HcfBlob *output)
+{
+    HcfResult res = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)spec);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    return cipher->doFinalToBuffer(cipher, input, output);
+}
+
+static HcfResult SealWithReset(HcfCipher *cipher, HcfGcmParamsSpec *spec, HcfBlob *input, HcfBlob *output)
+{
+    HcfResult res = cipher->reset(cipher, (HcfParamsSpec *)spec);
+    if (res != HCF_SUCCESS) {
+        return res;
+    }
+    return cipher->doFinalToBuffer(cipher, input, output);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest001
+ * @tc.desc: Per-message cost of AES-GCM seal, init for every message versus reset with a new iv.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest001, TestSize.Level1)
+{
+    uint8_t plainText[BENCH_MAX_PAYLOAD] = {0};
+    uint8_t initOut[BENCH_MAX_OUTPUT] = {0};
+    uint8_t resetOut[BENCH_MAX_OUTPUT] = {0};
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t aad[GCM_AAD_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    HcfSymKey *key = GenerateBenchKey("AES128");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES128|GCM|NoPadding", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+
+    printf("%-10s %16s %16s\n", "payload", "init ns/msg", "reset ns/msg");
+    for (uint32_t len : BENCH_PAYLOAD_LENS) {
+        HcfBlob input = { .data = plainText, .len = len };
+        HcfBlob output = { .data = initOut, .len = sizeof(initOut) };
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            SetMessageIv(&spec, i);
+            output.len = sizeof(initOut);
+            ASSERT_EQ(SealWithInit(cipher, key, &spec, &input, &output), HCF_SUCCESS);
+        }
+        double initCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+
+        HcfBlob resetOutput = { .data = resetOut, .len = sizeof(resetOut) };
+        start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            SetMessageIv(&spec, i);
+            resetOutput.len = sizeof(resetOut);
+            ASSERT_EQ(SealWithReset(cipher, &spec, &input, &resetOutput), HCF_SUCCESS);
+        }
+        double resetCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+        printf("%-10u %16.0f %16.0f\n", len, initCost, resetCost);
+
+        /* both loops end with the same iv, so the last messages must match */
+        ASSERT_EQ(output.len, len + GCM_TAG_LEN);
+        ASSERT_EQ(resetOutput.len, output.len);
+        EXPECT_EQ(memcmp(initOut, resetOut, output.len), 0);
+    }
+
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest002
+ * @tc.desc: Per-message cost of AES-GCM seal through the batch api, on the calling thread and on workers.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest002, TestSize.Level1)
+{
+    constexpr uint32_t batchCount = 256;
+    const uint32_t threadNums[] = { 1, 4 };
+    vector<uint8_t> plainText(BENCH_MAX_PAYLOAD, 0);
+    vector<uint8_t> cipherText(batchCount * (BENCH_MAX_PAYLOAD + GCM_TAG_LEN), 0);
+    vector<uint8_t> ivs(batchCount * GCM_IV_LEN, 0);
+    uint8_t aad[GCM_AAD_LEN] = {0};
+    vector<HcfCipherBatchItem> items(batchCount);
+
+    HcfSymKey *key = GenerateBenchKey("AES128");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES128|GCM|NoPadding", &cipher), HCF_SUCCESS);
+
+    printf("%-10s %8s %16s\n", "payload", "threads", "batch ns/msg");
+    for (uint32_t len : BENCH_PAYLOAD_LENS) {
+        for (uint32_t i = 0; i < batchCount; i++) {
+            (void)memcpy_s(&ivs[i * GCM_IV_LEN], GCM_IV_LEN, &i, sizeof(i));
+            items[i].iv = { .data = &ivs[i * GCM_IV_LEN], .len = GCM_IV_LEN };
+            items[i].aad = { .data = aad, .len = sizeof(aad) };
+            items[i].input = { .data = plainText.data(), .len = len };
+        }
+        for (uint32_t threadNum : threadNums) {
+            HcfCipherBatchParams params = { .tagLen = GCM_TAG_LEN, .threadNum = threadNum };
+            for (uint32_t i = 0; i < batchCount; i++) {
+                items[i].output = { .data = &cipherText[i * (BENCH_MAX_PAYLOAD + GCM_TAG_LEN)],
+                    .len = BENCH_MAX_PAYLOAD + GCM_TAG_LEN };
+            }
+            auto start = chrono::steady_clock::now();
+            ASSERT_EQ(HcfCipherSealBatch(cipher, (HcfKey *)key, &params, items.data(), batchCount), HCF_SUCCESS);
+            printf("%-10u %8u %16.0f\n", len, threadNum, NanoSecondsPerMessage(start, batchCount));
+            EXPECT_EQ(items[batchCount - 1].output.len, len + GCM_TAG_LEN);
+        }
+    }
+
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+static double MegaBytesPerSecond(chrono::steady_clock::time_point start, uint64_t bytes)
+{
+    chrono::duration<double> cost = chrono::steady_clock::now() - start;
+    return (double)bytes / cost.count() / (1024 * 1024);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest003
+ * @tc.desc: Throughput of large one shot AES-CTR and AES-GCM encryption with and without the parallel engine.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest003, TestSize.Level1)
+{
+    constexpr uint32_t bigLen = 8 * 1024 * 1024;
+    const char *algoNames[] = { "AES128|CTR|NoPadding", "AES128|GCM|NoPadding" };
+    const uint32_t threadNums[] = { 1, 4 };
+    vector<uint8_t> plainText(bigLen, 0);
+    vector<uint8_t> cipherText(bigLen + 2 * GCM_TAG_LEN, 0);
+    uint8_t iv[GCM_TAG_LEN] = {0};
+    uint8_t aad[GCM_AAD_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = GCM_IV_LEN;
+    gcmSpec.aad.data = aad;
+    gcmSpec.aad.len = sizeof(aad);
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    HcfParamsSpec *params[] = { (HcfParamsSpec *)&ivSpec, (HcfParamsSpec *)&gcmSpec };
+
+    HcfSymKey *key = GenerateBenchKey("AES128");
+    ASSERT_NE(key, nullptr);
+    printf("%-24s %8s %12s\n", "algorithm", "threads", "MB/s");
+    for (uint32_t i = 0; i < sizeof(algoNames) / sizeof(algoNames[0]); i++) {
+        for (uint32_t threadNum : threadNums) {
+            HcfCipher *cipher = nullptr;
+            ASSERT_EQ(HcfCipherCreate(algoNames[i], &cipher), HCF_SUCCESS);
+            EXPECT_EQ(cipher->setCipherSpecUint(cipher, CIPHER_PARALLEL_THREAD_NUM, threadNum), HCF_SUCCESS);
+            EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, params[i]), HCF_SUCCESS);
+            HcfBlob input = { .data = plainText.data(), .len = bigLen };
+            HcfBlob output = { .data = cipherText.data(), .len = cipherText.size() };
+            auto start = chrono::steady_clock::now();
+            EXPECT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+            printf("%-24s %8u %12.1f\n", algoNames[i], threadNum, MegaBytesPerSecond(start, bigLen));
+            OH_HCF_OBJ_DESTROY(cipher);
+        }
+    }
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+static double ResetSealNanoSeconds(HcfCipher *cipher, HcfGcmParamsSpec *spec, uint8_t *plainText, uint32_t len,
+    uint8_t *out, uint32_t outLen)
+{
+    HcfBlob input = { .data = plainText, .len = len };
+    HcfBlob output = { .data = out, .len = outLen };
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        SetMessageIv(spec, i);
+        output.len = outLen;
+        EXPECT_EQ(SealWithReset(cipher, spec, &input, &output), HCF_SUCCESS);
+    }
+    double cost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+    EXPECT_EQ(output.len, len + GCM_TAG_LEN);
+    return cost;
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest004
+ * @tc.desc: Per-message cost of ChaCha20-Poly1305 seal next to AES-256-GCM on the same payloads.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest004, TestSize.Level1)
+{
+    uint8_t plainText[BENCH_MAX_PAYLOAD] = {0};
+    uint8_t out[BENCH_MAX_OUTPUT] = {0};
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t aad[GCM_AAD_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    HcfSymKey *aesKey = GenerateBenchKey("AES256");
+    ASSERT_NE(aesKey, nullptr);
+    HcfSymKey *chachaKey = GenerateBenchKey("ChaCha20");
+    ASSERT_NE(chachaKey, nullptr);
+    HcfCipher *aesCipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &aesCipher), HCF_SUCCESS);
+    ASSERT_EQ(aesCipher->init(aesCipher, ENCRYPT_MODE, (HcfKey *)aesKey, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    HcfCipher *chachaCipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("ChaCha20|Poly1305", &chachaCipher), HCF_SUCCESS);
+    ASSERT_EQ(chachaCipher->init(chachaCipher, ENCRYPT_MODE, (HcfKey *)chachaKey, (HcfParamsSpec *)&spec),
+        HCF_SUCCESS);
+
+    printf("%-10s %16s %16s\n", "payload", "aes-gcm ns/msg", "chacha ns/msg");
+    for (uint32_t len : BENCH_PAYLOAD_LENS) {
+        double aesCost = ResetSealNanoSeconds(aesCipher, &spec, plainText, len, out, sizeof(out));
+        double chachaCost = ResetSealNanoSeconds(chachaCipher, &spec, plainText, len, out, sizeof(out));
+        printf("%-10u %16.1f %16.1f\n", len, aesCost, chachaCost);
+    }
+
+    OH_HCF_OBJ_DESTROY(aesCipher);
+    OH_HCF_OBJ_DESTROY(chachaCipher);
+    OH_HCF_OBJ_DESTROY(aesKey);
+    OH_HCF_OBJ_DESTROY(chachaKey);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest005
+ * @tc.desc: Per-message cost of AES-GCM-SIV seal with reset, which derives new keys for every nonce, next to AES-GCM.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest005, TestSize.Level1)
+{
+    uint8_t plainText[BENCH_MAX_PAYLOAD] = {0};
+    uint8_t out[BENCH_MAX_OUTPUT] = {0};
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t aad[GCM_AAD_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    HcfSymKey *key = GenerateBenchKey("AES128");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *gcmCipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES128|GCM|NoPadding", &gcmCipher), HCF_SUCCESS);
+    ASSERT_EQ(gcmCipher->init(gcmCipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    HcfCipher *sivCipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES128|GCMSIV|NoPadding", &sivCipher), HCF_SUCCESS);
+    ASSERT_EQ(sivCipher->init(sivCipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+
+    printf("%-10s %16s %16s\n", "payload", "gcm ns/msg", "gcm-siv ns/msg");
+    for (uint32_t len : BENCH_PAYLOAD_LENS) {
+        double gcmCost = ResetSealNanoSeconds(gcmCipher, &spec, plainText, len, out, sizeof(out));
+        double sivCost = ResetSealNanoSeconds(sivCipher, &spec, plainText, len, out, sizeof(out));
+        printf("%-10u %16.1f %16.1f\n", len, gcmCost, sivCost);
+    }
+
+    OH_HCF_OBJ_DESTROY(gcmCipher);
+    OH_HCF_OBJ_DESTROY(sivCipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest006
+ * @tc.desc: 4 KiB sectors by init per sector with AES-CBC versus one AES-XTS sector batch.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest006, TestSize.Level1)
+{
+    const uint32_t sectorSize = 4096;
+    const uint32_t sectorNum = 1024;
+    vector<uint8_t> image(sectorSize * sectorNum, 0);
+    vector<uint8_t> out(image.size() + 16, 0);
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+
+    HcfSymKey *cbcKey = GenerateBenchKey("AES256");
+    ASSERT_NE(cbcKey, nullptr);
+    HcfSymKey *xtsKey = GenerateBenchKey("AES256|XTS");
+    ASSERT_NE(xtsKey, nullptr);
+    HcfCipher *cbcCipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|CBC|NoPadding", &cbcCipher), HCF_SUCCESS);
+    HcfCipher *xtsCipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|XTS|NoPadding", &xtsCipher), HCF_SUCCESS);
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < sectorNum; i++) {
+        (void)memcpy_s(iv, sizeof(iv), &i, sizeof(i));
+        HcfBlob input = { .data = &image[i * sectorSize], .len = sectorSize };
+        HcfBlob output = { .data = &out[i * sectorSize], .len = out.size() - i * sectorSize };
+        EXPECT_EQ(cbcCipher->init(cbcCipher, ENCRYPT_MODE, (HcfKey *)cbcKey, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+        EXPECT_EQ(cbcCipher->doFinalToBuffer(cbcCipher, &input, &output), HCF_SUCCESS);
+    }
+    double cbcSpeed = MegaBytesPerSecond(start, image.size());
+
+    ASSERT_EQ(xtsCipher->init(xtsCipher, ENCRYPT_MODE, (HcfKey *)xtsKey, nullptr), HCF_SUCCESS);
+    HcfCipherSectorParams params = { .startSector = 0, .sectorSize = sectorSize };
+    HcfBlob input = { .data = image.data(), .len = image.size() };
+    HcfBlob output = { .data = out.data(), .len = out.size() };
+    start = chrono::steady_clock::now();
+    EXPECT_EQ(HcfCipherCryptSectors(xtsCipher, &params, &input, &output), HCF_SUCCESS);
+    double xtsSpeed = MegaBytesPerSecond(start, image.size());
+    printf("%-24s %12s\n", "sectors of 4 KiB", "MB/s");
+    printf("%-24s %12.1f\n", "cbc init per sector", cbcSpeed);
+    printf("%-24s %12.1f\n", "xts sector batch", xtsSpeed);
+
+    OH_HCF_OBJ_DESTROY(cbcCipher);
+    OH_HCF_OBJ_DESTROY(xtsCipher);
+    OH_HCF_OBJ_DESTROY(cbcKey);
+    OH_HCF_OBJ_DESTROY(xtsKey);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest007
+ * @tc.desc: AES256 data keys opened by an ECB cipher lifecycle per key, by key unwrap per key and in one batch.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest007, TestSize.Level1)
+{
+    const uint32_t keyNum = 1024;
+    const uint32_t keyLen = 32;
+    HcfSymKeyGenerator *generator = nullptr;
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES256", &generator), HCF_SUCCESS);
+    HcfSymKey *kek = GenerateBenchKey("AES256");
+    ASSERT_NE(kek, nullptr);
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfBlob encoded = { .data = nullptr, .len = 0 };
+    ASSERT_EQ(key->key.getEncoded((HcfKey *)key, &encoded), HCF_SUCCESS);
+    HcfBlob wrappedKey = { .data = nullptr, .len = 0 };
+    ASSERT_EQ(generator->wrapSymKey(generator, HCF_KEY_WRAP_AES, kek, key, &wrappedKey), HCF_SUCCESS);
+    vector<HcfBlob> wrapped(keyNum, wrappedKey);
+    vector<HcfSymKey *> keys(keyNum, nullptr);
+    const uint32_t blockSize = 16;
+    uint8_t plainKey[keyLen + blockSize] = {0};
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < keyNum; i++) {
+        HcfCipher *cipher = nullptr;
+        HcfBlob output = { .data = plainKey, .len = sizeof(plainKey) };
+        EXPECT_EQ(HcfCipherCreate("AES256|ECB|NoPadding", &cipher), HCF_SUCCESS);
+        EXPECT_EQ(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)kek, nullptr), HCF_SUCCESS);
+        EXPECT_EQ(cipher->doFinalToBuffer(cipher, &encoded, &output), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(cipher);
+        output.len = keyLen;
+        EXPECT_EQ(generator->convertSymKey(generator, &output, &keys[i]), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(keys[i]);
+    }
+    double ecbCost = NanoSecondsPerMessage(start, keyNum);
+
+    start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < keyNum; i++) {
+        EXPECT_EQ(generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES, kek, &wrappedKey, &keys[i]), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(keys[i]);
+    }
+    double unwrapCost = NanoSecondsPerMessage(start, keyNum);
+
+    start = chrono::steady_clock::now();
+    EXPECT_EQ(generator->unwrapSymKeyBatch(generator, HCF_KEY_WRAP_AES, kek, wrapped.data(), keys.data(), keyNum),
+        HCF_SUCCESS);
+    double batchCost = NanoSecondsPerMessage(start, keyNum);
+    printf("%-24s %12s\n", "AES256 data keys", "ns/key");
+    printf("%-24s %12.1f\n", "ecb cipher per key", ecbCost);
+    printf("%-24s %12.1f\n", "key unwrap per key", unwrapCost);
+    printf("%-24s %12.1f\n", "key unwrap batch", batchCost);
+
+    for (uint32_t i = 0; i < keyNum; i++) {
+        OH_HCF_OBJ_DESTROY(keys[i]);
+    }
+    (void)memset_s(plainKey, sizeof(plainKey), 0, sizeof(plainKey));
+    HcfBlobDataFree(&encoded);
+    HcfBlobDataFree(&wrappedKey);
+    OH_HCF_OBJ_DESTROY(kek);
+    OH_HCF_OBJ_DESTROY(key);
+    OH_HCF_OBJ_DESTROY(generator);
+}
+
+static double InitNanoSeconds(HcfCipher *cipher, HcfSymKey **keys, uint32_t keyNum, HcfParamsSpec *params)
+{
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)keys[i % keyNum], params), HCF_SUCCESS);
+    }
+    return NanoSecondsPerMessage(start, BENCH_ROUNDS);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest008
+ * @tc.desc: Cipher init latency on the first use of a key, which expands the key, versus a key used before.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest008, TestSize.Level1)
+{
+    const char *cipherNames[] = { "AES256|GCM|NoPadding", "AES256|CBC|PKCS7" };
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t cbcIv[16] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = sizeof(iv);
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = cbcIv;
+    ivSpec.iv.len = sizeof(cbcIv);
+    HcfParamsSpec *params[] = { (HcfParamsSpec *)&gcmSpec, (HcfParamsSpec *)&ivSpec };
+
+    HcfSymKeyGenerator *generator = nullptr;
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES256", &generator), HCF_SUCCESS);
+    uint8_t keyData[32] = {0};
+    HcfBlob keyBlob = { .data = keyData, .len = sizeof(keyData) };
+    printf("%-24s %16s %16s\n", "init", "first use ns", "cached ns");
+    for (uint32_t n = 0; n < sizeof(cipherNames) / sizeof(cipherNames[0]); n++) {
+        vector<HcfSymKey *> keys(BENCH_ROUNDS, nullptr);
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            ASSERT_EQ(generator->convertSymKey(generator, &keyBlob, &keys[i]), HCF_SUCCESS);
+        }
+        HcfCipher *cipher = nullptr;
+        ASSERT_EQ(HcfCipherCreate(cipherNames[n], &cipher), HCF_SUCCESS);
+        double firstCost = InitNanoSeconds(cipher, keys.data(), BENCH_ROUNDS, params[n]);
+        double cachedCost = InitNanoSeconds(cipher, keys.data(), 1, params[n]);
+        printf("%-24s %16.1f %16.1f\n", cipherNames[n], firstCost, cachedCost);
+        OH_HCF_OBJ_DESTROY(cipher);
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            OH_HCF_OBJ_DESTROY(keys[i]);
+        }
+    }
+    OH_HCF_OBJ_DESTROY(generator);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest009
+ * @tc.desc: Create and destroy cost of objects named by a transformation string.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest009, TestSize.Level1)
+{
+    HcfCipher *cipher = nullptr;
+    HcfSign *sign = nullptr;
+    HcfAsyKeyGenerator *generator = nullptr;
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(cipher);
+    }
+    double cipherCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+
+    start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        ASSERT_EQ(HcfSignCreate("RSA2048|PSS|SHA256|MGF1_SHA256", &sign), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(sign);
+    }
+    double signCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+
+    start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        ASSERT_EQ(HcfAsyKeyGeneratorCreate("RSA2048|PRIMES_2", &generator), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(generator);
+    }
+    double generatorCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+    printf("%-32s %12s\n", "create and destroy", "ns/object");
+    printf("%-32s %12.1f\n", "AES256|GCM|NoPadding", cipherCost);
+    printf("%-32s %12.1f\n", "RSA2048|PSS|SHA256|MGF1_SHA256", signCost);
+    printf("%-32s %12.1f\n", "RSA2048|PRIMES_2", generatorCost);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest010
+ * @tc.desc: Per-message cost of a short lived object, created and destroyed versus taken from the object pool.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest010, TestSize.Level1)
+{
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    HcfMd *md = nullptr;
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    vector<uint8_t> plainText(BENCH_PAYLOAD_LENS[1], 0x5a);
+    vector<uint8_t> cipherText(BENCH_MAX_OUTPUT, 0);
+    HcfBlob input = { .data = plainText.data(), .len = plainText.size() };
+    HcfBlob output = { .data = cipherText.data(), .len = cipherText.size() };
+    HcfBlob digest = { .data = nullptr, .len = 0 };
+
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        SetMessageIv(&spec, i);
+        output.len = cipherText.size();
+        ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+        ASSERT_EQ(SealWithInit(cipher, key, &spec, &input, &output), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY(cipher);
+    }
+    double cipherCreateCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+
+    start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        SetMessageIv(&spec, i);
+        output.len = cipherText.size();
+        ASSERT_EQ(HcfCipherPoolAcquire("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+        ASSERT_EQ(SealWithInit(cipher, key, &spec, &input, &output), HCF_SUCCESS);
+        HcfCipherPoolRelease(cipher);
+    }
+    double cipherPoolCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+
+    start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        ASSERT_EQ(HcfMdCreate("SHA256", &md), HCF_SUCCESS);
+        ASSERT_EQ(md->update(md, &input), HCF_SUCCESS);
+        ASSERT_EQ(md->doFinal(md, &digest), HCF_SUCCESS);
+        HcfBlobDataFree(&digest);
+        OH_HCF_OBJ_DESTROY(md);
+    }
+    double mdCreateCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+
+    start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+        ASSERT_EQ(HcfMdPoolAcquire("SHA256", &md), HCF_SUCCESS);
+        ASSERT_EQ(md->update(md, &input), HCF_SUCCESS);
+        ASSERT_EQ(md->doFinal(md, &digest), HCF_SUCCESS);
+        HcfBlobDataFree(&digest);
+        HcfMdPoolRelease(md);
+    }
+    double mdPoolCost = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+    printf("%-24s %12s %12s\n", "256 byte message", "create ns", "pool ns");
+    printf("%-24s %12.1f %12.1f\n", "AES256|GCM|NoPadding", cipherCreateCost, cipherPoolCost);
+    printf("%-24s %12.1f %12.1f\n", "SHA256", mdCreateCost, mdPoolCost);
+    HcfObjectPoolClear();
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+static const uint32_t VEC_SEGMENT_LENS[] = { 20, 1400, 16 };
+static const uint32_t VEC_SEGMENT_NUM = sizeof(VEC_SEGMENT_LENS) / sizeof(VEC_SEGMENT_LENS[0]);
+
+/* header, body and trailer of one message are joined before a single update */
+static HcfResult UpdateJoined(HcfCipher *cipher, HcfBlob *segments, vector<uint8_t> &joined, HcfBlob *output)
+{
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < VEC_SEGMENT_NUM; i++) {
+        (void)memcpy_s(joined.data() + offset, joined.size() - offset, segments[i].data, segments[i].len);
+        offset += segments[i].len;
+    }
+    HcfBlob input = { .data = joined.data(), .len = offset };
+    return cipher->update(cipher, &input, output);
+}
+
+/* the ciphertext goes back to the places the segments take in a packet buffer, the trailer gets the tag room */
+static void ResetOutSegments(HcfBlob *outSegments, vector<uint8_t> &cipherText)
+{
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < VEC_SEGMENT_NUM; i++) {
+        outSegments[i].data = cipherText.data() + offset;
+        outSegments[i].len = (i == VEC_SEGMENT_NUM - 1) ? (cipherText.size() - offset) : VEC_SEGMENT_LENS[i];
+        offset += VEC_SEGMENT_LENS[i];
+    }
+}
+
+static HcfResult UpdateEach(HcfCipher *cipher, HcfBlob *segments)
+{
+    for (uint32_t i = 0; i < VEC_SEGMENT_NUM; i++) {
+        HcfBlob output = {};
+        HcfResult ret = cipher->update(cipher, &segments[i], &output);
+        HcfBlobDataFree(&output);
+        if (ret != HCF_SUCCESS) {
+            return ret;
+        }
+    }
+    return HCF_SUCCESS;
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest011
+ * @tc.desc: Per-message cost of AES-GCM update over a three segment message, joined, one update per segment,
+ * vectored with one allocated output and vectored into caller segments.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest011, TestSize.Level1)
+{
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    vector<uint8_t> plainText(BENCH_MAX_PAYLOAD, 0x5a);
+    vector<uint8_t> joined(BENCH_MAX_PAYLOAD, 0);
+    vector<uint8_t> cipherText(BENCH_MAX_OUTPUT, 0);
+    HcfBlob segments[VEC_SEGMENT_NUM] = {};
+    HcfBlob outSegments[VEC_SEGMENT_NUM] = {};
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < VEC_SEGMENT_NUM; i++) {
+        segments[i].data = plainText.data() + offset;
+        segments[i].len = VEC_SEGMENT_LENS[i];
+        offset += VEC_SEGMENT_LENS[i];
+    }
+    ResetOutSegments(outSegments, cipherText);
+    HcfBlob output = {};
+    double cost[4] = {0};
+
+    for (uint32_t way = 0; way < 4; way++) {
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            SetMessageIv(&spec, i);
+            ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+            if (way == 0) {
+                ASSERT_EQ(UpdateJoined(cipher, segments, joined, &output), HCF_SUCCESS);
+                HcfBlobDataFree(&output);
+            } else if (way == 1) {
+                ASSERT_EQ(UpdateEach(cipher, segments), HCF_SUCCESS);
+            } else if (way == 2) {
+                ASSERT_EQ(HcfCipherUpdateVec(cipher, segments, VEC_SEGMENT_NUM, &output), HCF_SUCCESS);
+                HcfBlobDataFree(&output);
+            } else {
+                ASSERT_EQ(HcfCipherUpdateVecToBuffers(cipher, segments, VEC_SEGMENT_NUM, outSegments,
+                    VEC_SEGMENT_NUM), HCF_SUCCESS);
+                ResetOutSegments(outSegments, cipherText);
+            }
+        }
+        cost[way] = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+    }
+    printf("%-24s %12s\n", "1436 byte message", "ns/message");
+    printf("%-24s %12.1f\n", "joined update", cost[0]);
+    printf("%-24s %12.1f\n", "update per segment", cost[1]);
+    printf("%-24s %12.1f\n", "HcfCipherUpdateVec", cost[2]);
+    printf("%-24s %12.1f\n", "...VecToBuffers", cost[3]);
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest012
+ * @tc.desc: Per-packet cost of AES-GCM seal of a 1400 byte packet, doFinal and a copy back into the packet
+ * against seal in place.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest012, TestSize.Level1)
+{
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    const uint32_t headroom = 20;
+    const uint32_t payloadLen = 1400;
+    vector<uint8_t> packetBuf(headroom + payloadLen + GCM_TAG_LEN, 0x5a);
+    double cost[2] = {0};
+
+    for (uint32_t way = 0; way < 2; way++) {
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            SetMessageIv(&spec, i);
+            ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+            if (way == 0) {
+                HcfBlob input = { .data = packetBuf.data() + headroom, .len = payloadLen };
+                HcfBlob output = {};
+                ASSERT_EQ(cipher->doFinal(cipher, &input, &output), HCF_SUCCESS);
+                (void)memcpy_s(input.data, packetBuf.size() - headroom, output.data, output.len);
+                HcfBlobDataFree(&output);
+            } else {
+                HcfCipherPacket packet = { .data = packetBuf.data(), .capacity = (uint32_t)packetBuf.size(),
+                    .offset = headroom, .len = payloadLen };
+                ASSERT_EQ(HcfCipherSealInPlace(cipher, &packet), HCF_SUCCESS);
+            }
+        }
+        cost[way] = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+    }
+    printf("%-24s %12s\n", "1400 byte packet", "ns/packet");
+    printf("%-24s %12.1f\n", "doFinal and copy", cost[0]);
+    printf("%-24s %12.1f\n", "HcfCipherSealInPlace", cost[1]);
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest013
+ * @tc.desc: Cost of an AES-CTR range read of 4 KiB at offset 1 MiB + 5, decrypting up to the range against
+ * seeking to it.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest013, TestSize.Level1)
+{
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|CTR|NoPadding", &cipher), HCF_SUCCESS);
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    const uint32_t offset = 1024 * 1024 + 5;
+    const uint32_t rangeLen = 4096;
+    const uint32_t rounds = 50;
+    vector<uint8_t> object(offset + rangeLen, 0x5a);
+    vector<uint8_t> out(object.size(), 0);
+    double cost[2] = {0};
+
+    for (uint32_t way = 0; way < 2; way++) {
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            ASSERT_EQ(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+            HcfBlob input = { .data = object.data(), .len = offset + rangeLen };
+            if (way == 1) {
+                ASSERT_EQ(HcfCipherSeek(cipher, offset), HCF_SUCCESS);
+                input.data += offset;
+                input.len = rangeLen;
+            }
+            HcfBlob output = { .data = out.data(), .len = (uint32_t)out.size() };
+            ASSERT_EQ(cipher->updateToBuffer(cipher, &input, &output), HCF_SUCCESS);
+        }
+        cost[way] = NanoSecondsPerMessage(start, rounds);
+    }
+    printf("%-24s %12s\n", "4 KiB at 1 MiB + 5", "ns/read");
+    printf("%-24s %12.1f\n", "decrypt from start", cost[0]);
+    printf("%-24s %12.1f\n", "HcfCipherSeek", cost[1]);
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+static double SealContainerMiBPerSecond(HcfSymKey *key, uint32_t threadNum, vector<uint8_t> &file,
+    vector<uint8_t> &out, uint32_t batchLen)
+{
+    HcfCipherContainer *container = nullptr;
+    HcfCipherContainerParams params = { .chunkSize = 64 * 1024, .threadNum = threadNum };
+    if (HcfCipherContainerCreate(key, &params, &container) != HCF_SUCCESS) {
+        return 0;
+    }
+    auto start = chrono::steady_clock::now();
+    for (uint32_t offset = 0; offset < file.size(); offset += batchLen) {
+        HcfBlob input = { .data = file.data() + offset, .len = batchLen };
+        HcfBlob output = { .data = out.data(), .len = (uint32_t)out.size() };
+        bool isLast = (offset + batchLen == file.size());
+        if (container->sealChunks(container, offset / params.chunkSize, isLast, &input, &output) != HCF_SUCCESS) {
+            OH_HCF_OBJ_DESTROY(container);
+            return 0;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    OH_HCF_OBJ_DESTROY(container);
+    return file.size() / (1024.0 * 1024.0) / seconds;
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest014
+ * @tc.desc: Throughput of sealing a 16 MiB file, one GCM message against a chunked container with 64 KiB
+ * chunks, sealed 1 MiB at a time on one and four threads.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest014, TestSize.Level1)
+{
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *cipher = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    const uint32_t fileLen = 16 * 1024 * 1024;
+    const uint32_t batchLen = 1024 * 1024;
+    vector<uint8_t> file(fileLen, 0x5a);
+    vector<uint8_t> out(fileLen + 16 + GCM_TAG_LEN, 0);
+
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    auto start = chrono::steady_clock::now();
+    HcfBlob input = { .data = file.data(), .len = fileLen };
+    HcfBlob output = { .data = out.data(), .len = (uint32_t)out.size() };
+    ASSERT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    double single = fileLen / (1024.0 * 1024.0) / chrono::duration<double>(chrono::steady_clock::now() -
+        start).count();
+    printf("%-24s %12s\n", "16 MiB file", "MiB/s");
+    printf("%-24s %12.1f\n", "one gcm message", single);
+    printf("%-24s %12.1f\n", "container, 1 thread", SealContainerMiBPerSecond(key, 1, file, out, batchLen));
+    printf("%-24s %12.1f\n", "container, 4 threads", SealContainerMiBPerSecond(key, 4, file, out, batchLen));
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+static HcfResult RekeyTwoPass(HcfCipher *decryptor, HcfCipher *encryptor, vector<uint8_t> &message,
+    vector<uint8_t> &out)
+{
+    /* the whole plaintext sits in a heap buffer between the passes */
+    vector<uint8_t> plain(message.size() + 16, 0);
+    HcfBlob input = { .data = message.data(), .len = message.size() };
+    HcfBlob plainBlob = { .data = plain.data(), .len = plain.size() };
+    HcfResult ret = decryptor->doFinalToBuffer(decryptor, &input, &plainBlob);
+    if (ret == HCF_SUCCESS) {
+        HcfBlob output = { .data = out.data(), .len = out.size() };
+        ret = encryptor->doFinalToBuffer(encryptor, &plainBlob, &output);
+    }
+    (void)memset_s(plain.data(), plain.size(), 0, plain.size());
+    return ret;
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest015
+ * @tc.desc: Throughput of moving a 4 MiB message from AES-128-CBC to AES-256-GCM, decrypting to a buffer and
+ * encrypting it against the fused HcfCipherRekey.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest015, TestSize.Level1)
+{
+    HcfSymKey *oldKey = GenerateBenchKey("AES128");
+    HcfSymKey *newKey = GenerateBenchKey("AES256");
+    ASSERT_NE(oldKey, nullptr);
+    ASSERT_NE(newKey, nullptr);
+    HcfCipher *decryptor = nullptr;
+    HcfCipher *encryptor = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES128|CBC|PKCS7", &decryptor), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &encryptor), HCF_SUCCESS);
+    uint8_t iv[16] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = GCM_IV_LEN;
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    const uint32_t messageLen = 4 * 1024 * 1024;
+    const uint32_t rounds = 8;
+    vector<uint8_t> plain(messageLen, 0x5a);
+    vector<uint8_t> message(messageLen + 16, 0);
+    vector<uint8_t> out(messageLen + 32 + GCM_TAG_LEN, 0);
+    ASSERT_EQ(decryptor->init(decryptor, ENCRYPT_MODE, (HcfKey *)oldKey, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    HcfBlob plainBlob = { .data = plain.data(), .len = plain.size() };
+    HcfBlob messageBlob = { .data = message.data(), .len = message.size() };
+    ASSERT_EQ(decryptor->doFinalToBuffer(decryptor, &plainBlob, &messageBlob), HCF_SUCCESS);
+    message.resize(messageBlob.len);
+    double speed[2] = {0};
+
+    for (uint32_t way = 0; way < 2; way++) {
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            ASSERT_EQ(decryptor->init(decryptor, DECRYPT_MODE, (HcfKey *)oldKey, (HcfParamsSpec *)&ivSpec),
+                HCF_SUCCESS);
+            ASSERT_EQ(encryptor->init(encryptor, ENCRYPT_MODE, (HcfKey *)newKey, (HcfParamsSpec *)&gcmSpec),
+                HCF_SUCCESS);
+            if (way == 0) {
+                ASSERT_EQ(RekeyTwoPass(decryptor, encryptor, message, out), HCF_SUCCESS);
+                continue;
+            }
+            HcfBlob input = { .data = message.data(), .len = message.size() };
+            HcfBlob output = { .data = out.data(), .len = out.size() };
+            ASSERT_EQ(HcfCipherRekey(decryptor, encryptor, &input, &output), HCF_SUCCESS);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        speed[way] = (double)messageLen * rounds / (1024.0 * 1024.0) / seconds;
+    }
+    printf("%-24s %12s\n", "4 MiB cbc to gcm", "MiB/s");
+    printf("%-24s %12.1f\n", "decrypt, then encrypt", speed[0]);
+    printf("%-24s %12.1f\n", "HcfCipherRekey", speed[1]);
+    OH_HCF_OBJ_DESTROY(decryptor);
+    OH_HCF_OBJ_DESTROY(encryptor);
+    OH_HCF_OBJ_DESTROY(oldKey);
+    OH_HCF_OBJ_DESTROY(newKey);
+}
+
+/* aes-cbc and then hmac of iv || ciphertext, joined into out the way callers do it today; the mac has no reset */
+static HcfResult SealTwoPass(HcfCipher *cipher, HcfMac *mac, HcfSymKey *macKey, HcfIvParamsSpec *spec,
+    HcfBlob *input, vector<uint8_t> &out)
+{
+    HcfBlob cipherText = { .data = nullptr, .len = 0 };
+    HcfBlob tag = { .data = nullptr, .len = 0 };
+    HcfBlob iv = { .data = spec->iv.data, .len = spec->iv.len };
+    HcfResult ret = cipher->reset(cipher, (HcfParamsSpec *)spec);
+    if (ret == HCF_SUCCESS) {
+        ret = cipher->doFinal(cipher, input, &cipherText);
+    }
+    if (ret == HCF_SUCCESS) {
+        ret = mac->init(mac, macKey);
+    }
+    if (ret == HCF_SUCCESS) {
+        ret = mac->update(mac, &iv);
+    }
+    if (ret == HCF_SUCCESS) {
+        ret = mac->update(mac, &cipherText);
+    }
+    if (ret == HCF_SUCCESS) {
+        ret = mac->doFinal(mac, &tag);
+    }
+    if (ret == HCF_SUCCESS) {
+        (void)memcpy_s(out.data(), out.size(), cipherText.data, cipherText.len);
+        (void)memcpy_s(out.data() + cipherText.len, out.size() - cipherText.len, tag.data, tag.len);
+    }
+    HcfBlobDataFree(&cipherText);
+    HcfBlobDataFree(&tag);
+    return ret;
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest016
+ * @tc.desc: Throughput of sealing with AES-256-CBC and HMAC-SHA256, a cipher pass and a mac pass against the
+ * fused "AES256|CBC|PKCS7|HMAC-SHA256" cipher, for 4 KiB and 1 MiB messages.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest016, TestSize.Level1)
+{
+    HcfSymKey *aesKey = GenerateBenchKey("AES256");
+    HcfSymKey *macKey = GenerateBenchKey("AES256");
+    HcfSymKey *etmKey = GenerateBenchKey("AES256|HMAC-SHA256");
+    ASSERT_NE(aesKey, nullptr);
+    ASSERT_NE(macKey, nullptr);
+    ASSERT_NE(etmKey, nullptr);
+    HcfCipher *cipher = nullptr;
+    HcfCipher *etm = nullptr;
+    HcfMac *mac = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|CBC|PKCS7", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("AES256|CBC|PKCS7|HMAC-SHA256", &etm), HCF_SUCCESS);
+    ASSERT_EQ(HcfMacCreate("SHA256", &mac), HCF_SUCCESS);
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    const uint32_t messageLens[] = { 4096, 1024 * 1024 };
+    const uint32_t bytesPerLen = 64 * 1024 * 1024;
+    vector<uint8_t> message(messageLens[1], 0x5a);
+    vector<uint8_t> out(messageLens[1] + 16 + 32, 0);
+    /* both key once, every message only takes a new iv */
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)aesKey, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    ASSERT_EQ(etm->init(etm, ENCRYPT_MODE, (HcfKey *)etmKey, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+
+    printf("%-12s %16s %16s\n", "message", "two pass MiB/s", "fused MiB/s");
+    for (uint32_t len : messageLens) {
+        uint32_t rounds = bytesPerLen / len;
+        HcfBlob input = { .data = message.data(), .len = len };
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            ASSERT_EQ(SealTwoPass(cipher, mac, macKey, &spec, &input, out), HCF_SUCCESS);
+        }
+        double twoPass = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            ASSERT_EQ(etm->reset(etm, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+            HcfBlob output = { .data = out.data(), .len = out.size() };
+            ASSERT_EQ(etm->doFinalToBuffer(etm, &input, &output), HCF_SUCCESS);
+        }
+        double fused = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double mib = (double)bytesPerLen / (1024.0 * 1024.0);
+        printf("%-12u %16.1f %16.1f\n", len, mib / twoPass, mib / fused);
+    }
+    OH_HCF_OBJ_DESTROY(mac);
+    OH_HCF_OBJ_DESTROY(etm);
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(etmKey);
+    OH_HCF_OBJ_DESTROY(macKey);
+    OH_HCF_OBJ_DESTROY(aesKey);
+}
+
+/* ns per gcm open of one message, each round resets to the same iv and tag */
+static double OpenNanoSeconds(HcfCipher *cipher, HcfGcmParamsSpec *spec, HcfBlob *input, vector<uint8_t> &out,
+    HcfResult expect)
+{
+    const uint32_t bytesPerRun = 32 * 1024 * 1024;
+    uint32_t rounds = bytesPerRun / input->len;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; i++) {
+        if (cipher->reset(cipher, (HcfParamsSpec *)spec) != HCF_SUCCESS) {
+            return -1;
+        }
+        HcfBlob output = { .data = out.data(), .len = out.size() };
+        if (cipher->doFinalToBuffer(cipher, input, &output) != expect) {
+            return -1;
+        }
+    }
+    return NanoSecondsPerMessage(start, rounds);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest017
+ * @tc.desc: Cost of opening valid and forged AES-256-GCM messages of 1500 bytes and 64 KiB, the default doFinal
+ * against CIPHER_GCM_VERIFY_FIRST which checks the tag before it decrypts.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest017, TestSize.Level1)
+{
+    HcfSymKey *key = GenerateBenchKey("AES256");
+    ASSERT_NE(key, nullptr);
+    HcfCipher *defaultOpen = nullptr;
+    HcfCipher *verifyFirst = nullptr;
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &defaultOpen), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &verifyFirst), HCF_SUCCESS);
+    /* one thread each, this compares the work per message */
+    ASSERT_EQ(defaultOpen->setCipherSpecUint(defaultOpen, CIPHER_PARALLEL_THREAD_NUM, 1), HCF_SUCCESS);
+    ASSERT_EQ(verifyFirst->setCipherSpecUint(verifyFirst, CIPHER_PARALLEL_THREAD_NUM, 1), HCF_SUCCESS);
+    ASSERT_EQ(verifyFirst->setCipherSpecUint(verifyFirst, CIPHER_GCM_VERIFY_FIRST, 1), HCF_SUCCESS);
+    uint8_t iv[GCM_IV_LEN] = {0};
+    uint8_t aad[GCM_AAD_LEN] = {0};
+    uint8_t tag[GCM_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    const uint32_t messageLens[] = { BENCH_MAX_PAYLOAD, 64 * 1024 };
+    vector<uint8_t> message(messageLens[1], 0x5a);
+    vector<uint8_t> out(messageLens[1] + 16 + GCM_TAG_LEN, 0);
+
+    printf("%-10s %-8s %16s %16s\n", "message", "tag", "default ns", "verify first ns");
+    for (uint32_t len : messageLens) {
+        HcfBlob plain = { .data = message.data(), .len = len };
+        HcfBlob sealed = { .data = out.data(), .len = out.size() };
+        ASSERT_EQ(defaultOpen->init(defaultOpen, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+        ASSERT_EQ(defaultOpen->doFinalToBuffer(defaultOpen, &plain, &sealed), HCF_SUCCESS);
+        vector<uint8_t> cipherText(out.begin(), out.begin() + len);
+        (void)memcpy_s(tag, sizeof(tag), out.data() + len, sizeof(tag));
+        HcfBlob input = { .data = cipherText.data(), .len = len };
+        ASSERT_EQ(defaultOpen->init(defaultOpen, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+        ASSERT_EQ(verifyFirst->init(verifyFirst, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+        double validDefault = OpenNanoSeconds(defaultOpen, &spec, &input, out, HCF_SUCCESS);
+        double validFirst = OpenNanoSeconds(verifyFirst, &spec, &input, out, HCF_SUCCESS);
+        tag[0] ^= 1;
+        double forgedDefault = OpenNanoSeconds(defaultOpen, &spec, &input, out, HCF_ERR_CRYPTO_OPERATION);
+        double forgedFirst = OpenNanoSeconds(verifyFirst, &spec, &input, out, HCF_ERR_CRYPTO_OPERATION);
+        EXPECT_GT(validDefault, 0);
+        EXPECT_GT(validFirst, 0);
+        EXPECT_GT(forgedDefault, 0);
+        EXPECT_GT(forgedFirst, 0);
+        printf("%-10u %-8s %16.0f %16.0f\n", len, "valid", validDefault, validFirst);
+        printf("%-10u %-8s %16.0f %16.0f\n", len, "forged", forgedDefault, forgedFirst);
+    }
+    OH_HCF_OBJ_DESTROY(verifyFirst);
+    OH_HCF_OBJ_DESTROY(defaultOpen);
+    OH_HCF_OBJ_DESTROY(key);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest018
+ * @tc.desc: Per-message cost of SHA256 over a stream of short messages, a md created and destroyed for every
+ * message against one md reused, which doFinal leaves ready for the next message.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest018, TestSize.Level1)
+{
+    const uint32_t rounds = BENCH_ROUNDS * 10;
+    vector<uint8_t> message(BENCH_MAX_PAYLOAD, 0x5a);
+    HcfBlob digest = { .data = nullptr, .len = 0 };
+    HcfMd *md = nullptr;
+    printf("%-10s %12s %12s\n", "message", "create ns", "reuse ns");
+    for (uint32_t len : BENCH_PAYLOAD_LENS) {
+        HcfBlob input = { .data = message.data(), .len = len };
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            ASSERT_EQ(HcfMdCreate("SHA256", &md), HCF_SUCCESS);
+            ASSERT_EQ(md->update(md, &input), HCF_SUCCESS);
+            ASSERT_EQ(md->doFinal(md, &digest), HCF_SUCCESS);
+            HcfBlobDataFree(&digest);
+            OH_HCF_OBJ_DESTROY(md);
+        }
+        double createCost = NanoSecondsPerMessage(start, rounds);
+
+        ASSERT_EQ(HcfMdCreate("SHA256", &md), HCF_SUCCESS);
+        start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            ASSERT_EQ(md->update(md, &input), HCF_SUCCESS);
+            ASSERT_EQ(md->doFinal(md, &digest), HCF_SUCCESS);
+            HcfBlobDataFree(&digest);
+        }
+        double reuseCost = NanoSecondsPerMessage(start, rounds);
+        OH_HCF_OBJ_DESTROY(md);
+        printf("%-10u %12.1f %12.1f\n", len, createCost, reuseCost);
+    }
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest019
+ * @tc.desc: Per-record cost of SHA256 and SHA512 over 100000 independent records of 32 and 256 bytes, one reused
+ * md object per record against a single HcfMdDigestMany call.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest019, TestSize.Level1)
+{
+    const uint32_t recordNum = 100000;
+    const uint32_t recordLens[] = { 32, 256 };
+    const char *algoNames[] = { "SHA256", "SHA512" };
+    const uint32_t maxMdLen = 64;
+    vector<uint8_t> records(recordNum * recordLens[1]);
+    for (uint32_t i = 0; i < records.size(); i++) {
+        records[i] = (uint8_t)(i * 31);
+    }
+    vector<uint8_t> digests(recordNum * maxMdLen);
+    vector<HcfBlob> inputs(recordNum);
+    vector<HcfBlob> outputs(recordNum);
+    printf("%-8s %-8s %14s %14s\n", "algo", "record", "md loop ns", "batch ns");
+    for (const char *algoName : algoNames) {
+        for (uint32_t len : recordLens) {
+            for (uint32_t i = 0; i < recordNum; i++) {
+                inputs[i] = { .data = records.data() + i * len, .len = len };
+                outputs[i] = { .data = digests.data() + i * maxMdLen, .len = maxMdLen };
+            }
+            HcfMd *md = nullptr;
+            HcfBlob digest = { .data = nullptr, .len = 0 };
+            ASSERT_EQ(HcfMdCreate(algoName, &md), HCF_SUCCESS);
+            auto start = chrono::steady_clock::now();
+            for (uint32_t i = 0; i < recordNum; i++) {
+                ASSERT_EQ(md->update(md, &inputs[i]), HCF_SUCCESS);
+                ASSERT_EQ(md->doFinal(md, &digest), HCF_SUCCESS);
+                (void)memcpy_s(outputs[i].data, outputs[i].len, digest.data, digest.len);
+                HcfBlobDataFree(&digest);
+            }
+            double loopCost = NanoSecondsPerMessage(start, recordNum);
+            OH_HCF_OBJ_DESTROY(md);
+            vector<uint8_t> expect(digests);
+
+            start = chrono::steady_clock::now();
+            ASSERT_EQ(HcfMdDigestMany(algoName, inputs.data(), outputs.data(), recordNum), HCF_SUCCESS);
+            double batchCost = NanoSecondsPerMessage(start, recordNum);
+            EXPECT_EQ(digests, expect);
+            printf("%-8s %-8u %14.1f %14.1f\n", algoName, len, loopCost, batchCost);
+        }
+    }
+}
+
+static double HashMiBPerSecond(const char *algoName, vector<uint8_t> &chunk, uint32_t chunkNum)
+{
+    HcfMd *md = nullptr;
+    HcfBlob digest = { .data = nullptr, .len = 0 };
+    if (HcfMdCreate(algoName, &md) != HCF_SUCCESS) {
+        return -1;
+    }
+    HcfBlob input = { .data = chunk.data(), .len = chunk.size() };
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        chunk[0] = (uint8_t)i;
+        (void)md->update(md, &input);
+    }
+    HcfResult ret = md->doFinal(md, &digest);
+    double cost = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    HcfBlobDataFree(&digest);
+    OH_HCF_OBJ_DESTROY(md);
+    return (ret == HCF_SUCCESS) ? (double)chunk.size() * chunkNum / (1024.0 * 1024.0) / cost : -1;
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest020
+ * @tc.desc: Throughput of hashing 512 MiB in 4 MiB updates, SHA256 on one core against the SHA256-TREE merkle hash
+ * whose leaves are hashed on all cores.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest020, TestSize.Level1)
+{
+    const uint32_t chunkNum = 128;
+    vector<uint8_t> chunk(4 * 1024 * 1024, 0x5a);
+    double sha = HashMiBPerSecond("SHA256", chunk, chunkNum);
+    double tree = HashMiBPerSecond("SHA256-TREE", chunk, chunkNum);
+    EXPECT_GT(sha, 0);
+    EXPECT_GT(tree, 0);
+    printf("%-8s %14s %14s\n", "threads", "SHA256 MiB/s", "tree MiB/s");
+    printf("%-8u %14.1f %14.1f\n", HcfGetDefaultThreadNum(), sha, tree);
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest021
+ * @tc.desc: Single core throughput of hashing 256 MiB in 64 KiB updates with SHA-2, SHA-3, SHAKE and BLAKE2.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest021, TestSize.Level1)
+{
+    const char *algoNames[] = {
+        "SHA256", "SHA512", "SHA3-256", "SHA3-512", "SHAKE128", "SHAKE256", "BLAKE2b512", "BLAKE2s256"
+    };
+    const uint32_t chunkNum = 4096;
+    vector<uint8_t> chunk(64 * 1024, 0x5a);
+    printf("%-12s %10s\n", "algo", "MiB/s");
+    for (const char *algoName : algoNames) {
+        double speed = HashMiBPerSecond(algoName, chunk, chunkNum);
+        EXPECT_GT(speed, 0);
+        printf("%-12s %10.1f\n", algoName, speed);
+    }
+}
+
+/**
+ * @tc.name: CryptoCipherBenchmarkTest.CryptoCipherBenchmarkTest022
+ * @tc.desc: Per-message cost of SHA256 and HMAC-SHA256 over messages that share a 1 KiB or 16 KiB prefix and end
+ * in 64 distinct bytes, the prefix hashed again for every message against a clone of the state after the prefix.
+ * @tc.type: PERF
+ */
+HWTEST_F(CryptoCipherBenchmarkTest, CryptoCipherBenchmarkTest022, TestSize.Level1)
+{
+    const uint32_t prefixLens[] = { 1024, 16 * 1024 };
+    vector<uint8_t> message(16 * 1024 + 64, 0x5a);
+    HcfBlob digest = { .data = nullptr, .len = 0 };
+    HcfSymKeyGenerator *generator = nullptr;
+    HcfSymKey *key = nullptr;
+    HcfMd *md = nullptr;
+    HcfMac *mac = nullptr;
+    HcfMd *mdFork = nullptr;
+    HcfMac *macFork = nullptr;
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES256", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->generateSymKey(generator, &key), HCF_SUCCESS);
+    ASSERT_EQ(HcfMdCreate("SHA256", &md), HCF_SUCCESS);
+    ASSERT_EQ(HcfMacCreate("SHA256", &mac), HCF_SUCCESS);
+
+    printf("%-8s %-8s %12s %12s\n", "algo", "prefix", "rehash ns", "clone ns");
+    for (uint32_t prefixLen : prefixLens) {
+        HcfBlob prefix = { .data = message.data(), .len = prefixLen };
+        HcfBlob suffix = { .data = message.data() + prefixLen, .len = 64 };
+        auto start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            ASSERT_EQ(md->update(md, &prefix), HCF_SUCCESS);
+            ASSERT_EQ(md->update(md, &suffix), HCF_SUCCESS);
+            ASSERT_EQ(md->doFinal(md, &digest), HCF_SUCCESS);
+            HcfBlobDataFree(&digest);
+        }
+        double mdRehash = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+        ASSERT_EQ(md->update(md, &prefix), HCF_SUCCESS);
+        start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            ASSERT_EQ(md->clone(md, &mdFork), HCF_SUCCESS);
+            ASSERT_EQ(mdFork->update(mdFork, &suffix), HCF_SUCCESS);
+            ASSERT_EQ(mdFork->doFinal(mdFork, &digest), HCF_SUCCESS);
+            HcfBlobDataFree(&digest);
+            OH_HCF_OBJ_DESTROY(mdFork);
+        }
+        double mdClone = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+        ASSERT_EQ(md->reset(md), HCF_SUCCESS);
+
+        start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            ASSERT_EQ(mac->init(mac, key), HCF_SUCCESS);
+            ASSERT_EQ(mac->update(mac, &prefix), HCF_SUCCESS);
+            ASSERT_EQ(mac->update(mac, &suffix), HCF_SUCCESS);
+            ASSERT_EQ(mac->doFinal(mac, &digest), HCF_SUCCESS);
+            HcfBlobDataFree(&digest);
+        }
+        double macRehash = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+        ASSERT_EQ(mac->init(mac, key), HCF_SUCCESS);
+        ASSERT_EQ(mac->update(mac, &prefix), HCF_SUCCESS);
+        start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+            ASSERT_EQ(mac->clone(mac, &macFork), HCF_SUCCESS);
+            ASSERT_EQ(macFork->update(macFork, &suffix), HCF_SUCCESS);
+            ASSERT_EQ(macFork->doFinal(macFork, &digest), HCF_SUCCESS);
+            HcfBlobDataFree(&digest);
+            OH_HCF_OBJ_DESTROY(macFork);
+        }
+        double macClone = NanoSecondsPerMessage(start, BENCH_ROUNDS);
+        printf("%-8s %-8u %12.1f %12.1f\n", "SHA256", prefixLen, mdRehash, mdClone);
+        printf("%-8s %-8u %12.1f %12.1f\n", "HMAC", prefixLen, macRehash, macClone);
+    }
+    OH_HCF_OBJ_DESTROY(mac);
+    OH_HCF_OBJ_DESTROY(md);
+    OH_HCF_OBJ_DESTROY(key);
+    OH_HCF_OBJ_DESTROY(generator);
+}
+}
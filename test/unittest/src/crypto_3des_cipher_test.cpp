@@ -1405,4 +1405,219 @@ clearup:
     OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
     EXPECT_EQ(ret, 0);
 }
-}
\ No newline at end of file
+
+HWTEST_F(Crypto3DesCipherTest, Crypto3DesCipherTest025, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t plainText[] = "this is test!";
+    uint8_t cipherText[128] = {0};
+    uint8_t buffer[128] = {0};
+    uint32_t outLen = 0;
+
+    HcfSymKeyGenerator *generator = NULL;
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+    uint8_t iv[8] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 8;
+    HcfBlob input = {.data = plainText, .len = 13};
+    HcfBlob output = {.data = cipherText, .len = sizeof(cipherText)};
+
+    ret = HcfSymKeyGeneratorCreate("3DES192", &generator);
+    if (ret != 0) {
+        LOGE("HcfSymKeyGeneratorCreate failed!");
+        goto clearup;
+    }
+    ret = generator->generateSymKey(generator, &key);
+    if (ret != 0) {
+        LOGE("generateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("3DES192|CBC|PKCS7", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->getOutputSize(cipher, input.len, true, &outLen);
+    if ((ret != 0) || (outLen > sizeof(cipherText))) {
+        LOGE("getOutputSize failed!");
+        goto clearup;
+    }
+    ret = cipher->doFinalToBuffer(cipher, &input, &output);
+    if (ret != 0) {
+        LOGE("doFinalToBuffer failed! %d", ret);
+        goto clearup;
+    }
+
+    ret = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    input.data = cipherText;
+    input.len = output.len;
+    output.data = buffer;
+    output.len = sizeof(buffer);
+    ret = cipher->doFinalToBuffer(cipher, &input, &output);
+    if (ret != 0) {
+        LOGE("doFinalToBuffer failed! %d", ret);
+        goto clearup;
+    }
+    ret = ((output.len == sizeof(plainText) - 1) && (memcmp(buffer, plainText, output.len) == 0)) ? 0 : 1;
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(Crypto3DesCipherTest, Crypto3DesCipherTest026, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t plainText[] = "this is test!";
+    HcfSymKeyGenerator *generator = NULL;
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+    uint8_t iv[8] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 8;
+    HcfBlob input = {.data = plainText, .len = 13};
+    HcfBlob first = {.data = NULL, .len = 0};
+    HcfBlob second = {.data = NULL, .len = 0};
+
+    ret = HcfSymKeyGeneratorCreate("3DES192", &generator);
+    if (ret != 0) {
+        LOGE("HcfSymKeyGeneratorCreate failed!");
+        goto clearup;
+    }
+    ret = generator->generateSymKey(generator, &key);
+    if (ret != 0) {
+        LOGE("generateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("3DES192|CBC|PKCS7", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->doFinal(cipher, &input, &first);
+    if (ret != 0) {
+        LOGE("doFinal failed!");
+        goto clearup;
+    }
+    /* same iv after reset must give the same ciphertext */
+    ret = cipher->reset(cipher, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        LOGE("reset failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->doFinal(cipher, &input, &second);
+    if (ret != 0) {
+        LOGE("doFinal failed!");
+        goto clearup;
+    }
+    ret = ((first.len == second.len) && (memcmp(first.data, second.data, first.len) == 0)) ? 0 : 1;
+
+clearup:
+    HcfBlobDataFree(&first);
+    HcfBlobDataFree(&second);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(Crypto3DesCipherTest, Crypto3DesCipherTest027, TestSize.Level0)
+{
+    HcfSymKeyGenerator *generator = NULL;
+    HcfCipher *sealer = NULL;
+    HcfCipher *opener = NULL;
+    HcfSymKey *key = NULL;
+    uint8_t iv[8] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 8;
+    /* the last byte 0 is never a valid PKCS7 pad, so the decrypt below fails its padding check */
+    uint8_t plainText[16] = "AAAAAAAAAAAAAAA";
+    uint8_t cipherText[24] = {0};
+    uint8_t buffer[24] = {0};
+    uint8_t zeros[24] = {0};
+    HcfBlob input = {.data = plainText, .len = sizeof(plainText)};
+    HcfBlob output = {.data = cipherText, .len = sizeof(cipherText)};
+
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("3DES192", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->generateSymKey(generator, &key), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("3DES192|CBC|NoPadding", &sealer), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("3DES192|CBC|PKCS7", &opener), HCF_SUCCESS);
+    EXPECT_EQ(sealer->init(sealer, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    EXPECT_EQ(sealer->doFinalToBuffer(sealer, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, sizeof(plainText));
+    input.data = cipherText;
+    output.data = buffer;
+    output.len = sizeof(buffer);
+    EXPECT_EQ(opener->init(opener, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    EXPECT_NE(opener->doFinalToBuffer(opener, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 0);
+    EXPECT_EQ(memcmp(buffer, zeros, sizeof(buffer)), 0);
+
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)sealer);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)opener);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+}
+
+HWTEST_F(Crypto3DesCipherTest, Crypto3DesCipherTest028, TestSize.Level0)
+{
+    HcfSymKeyGenerator *generator = NULL;
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+    uint8_t iv[8] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 8;
+    uint8_t plainText[8] = "testing";
+    uint8_t buffer[32] = {0};
+    uint8_t guard[32] = {0};
+    uint32_t outLen = 0;
+
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("3DES192", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->generateSymKey(generator, &key), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("3DES192|CBC|PKCS7", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    /* the 7 bytes of the update stay in the cipher, the final flushes them with the padding block */
+    HcfBlob input = {.data = plainText, .len = 7};
+    HcfBlob output = {.data = buffer, .len = sizeof(buffer)};
+    EXPECT_EQ(cipher->updateToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 0);
+    EXPECT_EQ(cipher->getOutputSize(cipher, 1, true, &outLen), HCF_SUCCESS);
+    EXPECT_GE(outLen, 16);
+    ASSERT_LE(outLen, sizeof(buffer));
+    (void)memset_s(buffer, sizeof(buffer), 0xa5, sizeof(buffer));
+    (void)memset_s(guard, sizeof(guard), 0xa5, sizeof(guard));
+    input.data = plainText + 7;
+    input.len = 1;
+    output.data = buffer;
+    output.len = outLen;
+    EXPECT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 16);
+    EXPECT_EQ(memcmp(buffer + outLen, guard, sizeof(buffer) - outLen), 0);
+
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+}
+}
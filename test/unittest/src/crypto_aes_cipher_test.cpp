@@ -16,6 +16,8 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include "securec.h"
 
 #include "sym_key_generator.h"
@@ -25,6 +27,8 @@
 #include "detailed_iv_params.h"
 #include "detailed_gcm_params.h"
 #include "detailed_ccm_params.h"
+#include "hcf_object_pool.h"
+#include "mac.h"
 
 
 using namespace std;
@@ -3833,4 +3837,3109 @@ clearup:
     OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
     EXPECT_EQ(ret, 0);
 }
-}
\ No newline at end of file
+
+static int32_t AesBufferEncrypt(HcfCipher *cipher, HcfSymKey *key, HcfParamsSpec *params,
+    uint8_t *cipherText, int *cipherTextLen)
+{
+    uint8_t plainText[] = "this is test!";
+    HcfBlob input = {.data = (uint8_t *)plainText, .len = 13};
+    uint32_t outLen = 0;
+    int32_t ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, params);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        return ret;
+    }
+    ret = cipher->getOutputSize(cipher, input.len, false, &outLen);
+    if ((ret != 0) || (outLen > (uint32_t)*cipherTextLen)) {
+        LOGE("getOutputSize failed!");
+        return -1;
+    }
+    HcfBlob output = {.data = cipherText, .len = outLen};
+    ret = cipher->updateToBuffer(cipher, &input, &output);
+    if (ret != 0) {
+        LOGE("updateToBuffer failed!");
+        return ret;
+    }
+    uint32_t len = output.len;
+    ret = cipher->getOutputSize(cipher, 0, true, &outLen);
+    if ((ret != 0) || (len + outLen > (uint32_t)*cipherTextLen)) {
+        LOGE("getOutputSize failed!");
+        return -1;
+    }
+    output.data = cipherText + len;
+    output.len = outLen;
+    ret = cipher->doFinalToBuffer(cipher, NULL, &output);
+    if (ret != 0) {
+        LOGE("doFinalToBuffer failed!");
+        return ret;
+    }
+    *cipherTextLen = len + output.len;
+    PrintfHex("ciphertext", cipherText, *cipherTextLen);
+    return 0;
+}
+
+static int32_t AesBufferDecrypt(HcfCipher *cipher, HcfSymKey *key, HcfParamsSpec *params,
+    uint8_t *cipherText, int cipherTextLen)
+{
+    uint8_t plainText[] = "this is test!";
+    uint8_t buffer[128] = {0};
+    HcfBlob input = {.data = (uint8_t *)cipherText, .len = cipherTextLen};
+    HcfBlob output = {.data = buffer, .len = sizeof(buffer)};
+    int32_t ret = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, params);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        return ret;
+    }
+    ret = cipher->doFinalToBuffer(cipher, &input, &output);
+    if (ret != 0) {
+        LOGE("doFinalToBuffer failed!");
+        return ret;
+    }
+    PrintfHex("planText", buffer, output.len);
+    if ((output.len != sizeof(plainText) - 1) || (memcmp(buffer, plainText, output.len) != 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest068, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[16] = {0};
+    uint8_t cipherText[128] = {0};
+    int cipherTextLen = 128;
+
+    HcfIvParamsSpec ivSpec = {};
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 16;
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+
+    ret = HcfCipherCreate("AES128|CBC|PKCS5", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+
+    ret = AesBufferEncrypt(cipher, key, (HcfParamsSpec *)&ivSpec, cipherText, &cipherTextLen);
+    if (ret != 0) {
+        LOGE("AesBufferEncrypt failed! %d", ret);
+        goto clearup;
+    }
+
+    ret = AesBufferDecrypt(cipher, key, (HcfParamsSpec *)&ivSpec, cipherText, cipherTextLen);
+    if (ret != 0) {
+        LOGE("AesBufferDecrypt failed! %d", ret);
+        goto clearup;
+    }
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest069, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t aad[8] = {0};
+    uint8_t tag[16] = {0};
+    uint8_t iv[12] = {0};
+    uint8_t cipherText[128] = {0};
+    int cipherTextLen = 128;
+
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+
+    HcfGcmParamsSpec spec = {};
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+
+    ret = HcfCipherCreate("AES128|GCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+
+    ret = AesBufferEncrypt(cipher, key, (HcfParamsSpec *)&spec, cipherText, &cipherTextLen);
+    if (ret != 0) {
+        LOGE("AesBufferEncrypt failed, ret:%d!", ret);
+        goto clearup;
+    }
+
+    (void)memcpy_s(spec.tag.data, 16, cipherText + cipherTextLen - 16, 16);
+    PrintfHex("gcm tag", spec.tag.data, spec.tag.len);
+    cipherTextLen -= 16;
+
+    ret = AesBufferDecrypt(cipher, key, (HcfParamsSpec *)&spec, cipherText, cipherTextLen);
+    if (ret != 0) {
+        LOGE("AesBufferDecrypt failed, ret:%d!", ret);
+        goto clearup;
+    }
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest070, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t plainText[] = "this is test!";
+    uint8_t buffer[16] = {0};
+    uint32_t outLen = 0;
+    HcfBlob input = {.data = plainText, .len = 13};
+    HcfBlob output = {.data = buffer, .len = sizeof(buffer)};
+
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+
+    ret = HcfCipherCreate("AES128|ECB|PKCS5", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, NULL);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->getOutputSize(cipher, input.len, true, &outLen);
+    if (ret != 0) {
+        LOGE("getOutputSize failed!");
+        goto clearup;
+    }
+    EXPECT_GT(outLen, sizeof(buffer));
+    /* the buffer is smaller than getOutputSize, the cipher must reject it and stay usable */
+    ret = cipher->doFinalToBuffer(cipher, &input, &output);
+    EXPECT_NE(ret, 0);
+    output.len = 0;
+    ret = cipher->doFinal(cipher, &input, &output);
+    EXPECT_EQ(output.len, 16);
+    HcfBlobDataFree(&output);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest071, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t plainText[] = "this is test!";
+    uint8_t aad[8] = {0};
+    uint8_t tag[16] = {0};
+    uint8_t iv[12] = {0};
+    HcfBlob input = {.data = plainText, .len = 13};
+    HcfBlob first = {.data = NULL, .len = 0};
+    HcfBlob second = {.data = NULL, .len = 0};
+    HcfBlob expect = {.data = NULL, .len = 0};
+
+    HcfCipher *cipher = NULL;
+    HcfCipher *other = NULL;
+    HcfSymKey *key = NULL;
+
+    HcfGcmParamsSpec spec = {};
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|GCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    /* reset is only allowed after init */
+    EXPECT_NE(cipher->reset(cipher, (HcfParamsSpec *)&spec), 0);
+
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->doFinal(cipher, &input, &first);
+    if (ret != 0) {
+        LOGE("doFinal failed!");
+        goto clearup;
+    }
+
+    /* new message with another iv and aad, the key is kept from init */
+    iv[0] = 1;
+    aad[0] = 1;
+    ret = cipher->reset(cipher, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        LOGE("reset failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->doFinal(cipher, &input, &second);
+    if (ret != 0) {
+        LOGE("doFinal failed!");
+        goto clearup;
+    }
+
+    ret = HcfCipherCreate("AES128|GCM|NoPadding", &other);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = other->init(other, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    ret = other->doFinal(other, &input, &expect);
+    if (ret != 0) {
+        LOGE("doFinal failed!");
+        goto clearup;
+    }
+    EXPECT_EQ(second.len, expect.len);
+    EXPECT_EQ(memcmp(second.data, expect.data, expect.len), 0);
+    EXPECT_NE(memcmp(first.data, second.data, second.len), 0);
+
+clearup:
+    HcfBlobDataFree(&first);
+    HcfBlobDataFree(&second);
+    HcfBlobDataFree(&expect);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)other);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest072, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[16] = {0};
+    uint8_t cipherText[128] = {0};
+    int cipherTextLen = 128;
+    uint8_t plainText[] = "this is test!";
+    HcfBlob input = {.data = plainText, .len = 13};
+    HcfBlob output = {.data = NULL, .len = 0};
+
+    HcfIvParamsSpec ivSpec = {};
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 16;
+
+    ret = GenerateSymKey("AES256", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES256|CBC|PKCS5", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = AesBufferEncrypt(cipher, key, (HcfParamsSpec *)&ivSpec, cipherText, &cipherTextLen);
+    if (ret != 0) {
+        LOGE("AesBufferEncrypt failed! %d", ret);
+        goto clearup;
+    }
+
+    /* an unfinished message is dropped by reset */
+    ret = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        goto clearup;
+    }
+    ret = cipher->update(cipher, &input, &output);
+    HcfBlobDataFree(&output);
+    if (ret != 0) {
+        LOGE("update failed!");
+        goto clearup;
+    }
+    ret = cipher->reset(cipher, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        LOGE("reset failed! %d", ret);
+        goto clearup;
+    }
+    input.data = cipherText;
+    input.len = cipherTextLen;
+    ret = cipher->doFinal(cipher, &input, &output);
+    if (ret != 0) {
+        LOGE("doFinal failed!");
+        goto clearup;
+    }
+    EXPECT_EQ(output.len, sizeof(plainText) - 1);
+    EXPECT_EQ(memcmp(output.data, plainText, output.len), 0);
+
+clearup:
+    HcfBlobDataFree(&output);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t BATCH_COUNT = 8;
+static const uint32_t BATCH_TAG_LEN = 16;
+static const uint32_t BATCH_MAX_TEXT_LEN = 64;
+
+typedef struct {
+    uint8_t iv[12];
+    uint8_t aad[8];
+    uint8_t plainText[BATCH_MAX_TEXT_LEN];
+    uint8_t cipherText[BATCH_MAX_TEXT_LEN + BATCH_TAG_LEN];
+    uint8_t decrypted[BATCH_MAX_TEXT_LEN];
+} AesBatchMessage;
+
+static void InitBatchMessages(AesBatchMessage *msgs, HcfCipherBatchItem *items, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        (void)memset_s(&msgs[i], sizeof(AesBatchMessage), (int)i, sizeof(AesBatchMessage));
+        items[i].iv.data = msgs[i].iv;
+        items[i].iv.len = sizeof(msgs[i].iv);
+        items[i].aad.data = msgs[i].aad;
+        items[i].aad.len = sizeof(msgs[i].aad);
+        items[i].input.data = msgs[i].plainText;
+        items[i].input.len = i * (BATCH_MAX_TEXT_LEN / count);
+        items[i].output.data = msgs[i].cipherText;
+        items[i].output.len = sizeof(msgs[i].cipherText);
+        items[i].result = HCF_INVALID_PARAMS;
+    }
+}
+
+static void SetOpenBatchItems(AesBatchMessage *msgs, HcfCipherBatchItem *items, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        items[i].input.data = msgs[i].cipherText;
+        items[i].input.len = items[i].output.len;
+        items[i].output.data = msgs[i].decrypted;
+        items[i].output.len = sizeof(msgs[i].decrypted);
+    }
+}
+
+static int32_t GcmEncryptOne(HcfCipher *cipher, HcfSymKey *key, HcfCipherBatchItem *item, HcfBlob *output)
+{
+    uint8_t tag[BATCH_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    spec.iv = item->iv;
+    spec.aad = item->aad;
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    int32_t ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        return ret;
+    }
+    return cipher->doFinal(cipher, &item->input, output);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest073, TestSize.Level0)
+{
+    int ret = 0;
+    AesBatchMessage msgs[BATCH_COUNT];
+    HcfCipherBatchItem items[BATCH_COUNT];
+    HcfCipherBatchParams params = { .tagLen = BATCH_TAG_LEN, .threadNum = 3 };
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+
+    InitBatchMessages(msgs, items, BATCH_COUNT);
+    ret = GenerateSymKey("AES256", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES256|GCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = HcfCipherSealBatch(cipher, (HcfKey *)key, &params, items, BATCH_COUNT);
+    if (ret != 0) {
+        LOGE("HcfCipherSealBatch failed! %d", ret);
+        goto clearup;
+    }
+    /* every message must match the single message api */
+    for (uint32_t i = 0; i < BATCH_COUNT; i++) {
+        HcfBlob expect = {.data = NULL, .len = 0};
+        ret = GcmEncryptOne(cipher, key, &items[i], &expect);
+        EXPECT_EQ(ret, 0);
+        EXPECT_EQ(items[i].result, HCF_SUCCESS);
+        EXPECT_EQ(items[i].output.len, expect.len);
+        EXPECT_EQ(memcmp(items[i].output.data, expect.data, expect.len), 0);
+        HcfBlobDataFree(&expect);
+    }
+
+    SetOpenBatchItems(msgs, items, BATCH_COUNT);
+    ret = HcfCipherOpenBatch(cipher, (HcfKey *)key, &params, items, BATCH_COUNT);
+    if (ret != 0) {
+        LOGE("HcfCipherOpenBatch failed! %d", ret);
+        goto clearup;
+    }
+    for (uint32_t i = 0; i < BATCH_COUNT; i++) {
+        EXPECT_EQ(items[i].output.len, i * (BATCH_MAX_TEXT_LEN / BATCH_COUNT));
+        EXPECT_EQ(memcmp(msgs[i].decrypted, msgs[i].plainText, items[i].output.len), 0);
+    }
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest074, TestSize.Level0)
+{
+    int ret = 0;
+    AesBatchMessage msgs[BATCH_COUNT];
+    HcfCipherBatchItem items[BATCH_COUNT];
+    HcfCipherBatchParams params = { .tagLen = BATCH_TAG_LEN, .threadNum = 2 };
+    HcfCipher *cipher = NULL;
+    HcfCipher *cbc = NULL;
+    HcfSymKey *key = NULL;
+
+    InitBatchMessages(msgs, items, BATCH_COUNT);
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|CBC|PKCS5", &cbc);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    EXPECT_EQ(HcfCipherSealBatch(cbc, (HcfKey *)key, &params, items, BATCH_COUNT), HCF_NOT_SUPPORT);
+
+    ret = HcfCipherCreate("AES128|GCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = HcfCipherSealBatch(cipher, (HcfKey *)key, &params, items, BATCH_COUNT);
+    if (ret != 0) {
+        LOGE("HcfCipherSealBatch failed! %d", ret);
+        goto clearup;
+    }
+
+    /* a broken tag only fails its own message */
+    SetOpenBatchItems(msgs, items, BATCH_COUNT);
+    msgs[BATCH_COUNT - 1].cipherText[items[BATCH_COUNT - 1].input.len - 1] ^= 1;
+    EXPECT_NE(HcfCipherOpenBatch(cipher, (HcfKey *)key, &params, items, BATCH_COUNT), HCF_SUCCESS);
+    for (uint32_t i = 0; i < BATCH_COUNT - 1; i++) {
+        EXPECT_EQ(items[i].result, HCF_SUCCESS);
+    }
+    EXPECT_NE(items[BATCH_COUNT - 1].result, HCF_SUCCESS);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cbc);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t PARALLEL_TEXT_LEN = 4099;
+static const uint32_t PARALLEL_THRESHOLD = 64;
+static const uint32_t PARALLEL_THREAD_NUM = 4;
+
+/* chunkLen 0 passes the whole input to doFinal */
+static int32_t AesCryptInChunks(HcfCipher *cipher, enum HcfCryptoMode mode, HcfSymKey *key, HcfParamsSpec *params,
+    const vector<uint8_t> &input, uint32_t chunkLen, vector<uint8_t> &output)
+{
+    output.clear();
+    int32_t ret = cipher->init(cipher, mode, (HcfKey *)key, params);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        return ret;
+    }
+    uint32_t offset = 0;
+    while ((chunkLen != 0) && (offset < input.size())) {
+        uint32_t len = min<uint32_t>(chunkLen, input.size() - offset);
+        HcfBlob in = {.data = const_cast<uint8_t *>(input.data()) + offset, .len = len};
+        HcfBlob out = {.data = NULL, .len = 0};
+        ret = cipher->update(cipher, &in, &out);
+        if (ret != 0) {
+            LOGE("update failed! %d", ret);
+            return ret;
+        }
+        output.insert(output.end(), out.data, out.data + out.len);
+        HcfBlobDataFree(&out);
+        offset += len;
+    }
+    HcfBlob in = {.data = const_cast<uint8_t *>(input.data()) + offset, .len = input.size() - offset};
+    HcfBlob out = {.data = NULL, .len = 0};
+    ret = cipher->doFinal(cipher, &in, &out);
+    if (ret != 0) {
+        LOGE("doFinal failed! %d", ret);
+        return ret;
+    }
+    output.insert(output.end(), out.data, out.data + out.len);
+    HcfBlobDataFree(&out);
+    return 0;
+}
+
+static int32_t CreateCipherWithThreads(const char *algoName, uint32_t threadNum, HcfCipher **cipher)
+{
+    int32_t ret = HcfCipherCreate(algoName, cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        return ret;
+    }
+    ret = (*cipher)->setCipherSpecUint(*cipher, CIPHER_PARALLEL_THRESHOLD, PARALLEL_THRESHOLD);
+    if (ret != 0) {
+        return ret;
+    }
+    return (*cipher)->setCipherSpecUint(*cipher, CIPHER_PARALLEL_THREAD_NUM, threadNum);
+}
+
+/* the parallel engine must give the same output as one thread, for any update split */
+static int32_t CheckParallelMatchesSerial(const char *algoName, HcfSymKey *key, HcfParamsSpec *params)
+{
+    const uint32_t chunkLens[] = { 0, 1024, 1000 };
+    vector<uint8_t> plainText(PARALLEL_TEXT_LEN);
+    for (uint32_t i = 0; i < PARALLEL_TEXT_LEN; i++) {
+        plainText[i] = (uint8_t)(i * 7 + 3);
+    }
+    HcfCipher *serial = NULL;
+    HcfCipher *parallel = NULL;
+    vector<uint8_t> expect;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    int32_t ret = CreateCipherWithThreads(algoName, 1, &serial);
+    if (ret == 0) {
+        ret = CreateCipherWithThreads(algoName, PARALLEL_THREAD_NUM, &parallel);
+    }
+    if (ret == 0) {
+        ret = AesCryptInChunks(serial, ENCRYPT_MODE, key, params, plainText, 0, expect);
+    }
+    for (uint32_t i = 0; (ret == 0) && (i < sizeof(chunkLens) / sizeof(chunkLens[0])); i++) {
+        ret = AesCryptInChunks(parallel, ENCRYPT_MODE, key, params, plainText, chunkLens[i], cipherText);
+        if ((ret == 0) && (cipherText != expect)) {
+            LOGE("%s encrypt differs with chunk %u", algoName, chunkLens[i]);
+            ret = -1;
+        }
+        if (ret == 0) {
+            ret = AesCryptInChunks(parallel, DECRYPT_MODE, key, params, cipherText, chunkLens[i], decrypted);
+        }
+        if ((ret == 0) && (decrypted != plainText)) {
+            LOGE("%s decrypt differs with chunk %u", algoName, chunkLens[i]);
+            ret = -1;
+        }
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)serial);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)parallel);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest075, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[16] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 };
+    HcfIvParamsSpec ivSpec = {};
+    HcfSymKey *key = NULL;
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = 16;
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = CheckParallelMatchesSerial("AES128|ECB|PKCS5", key, NULL);
+    EXPECT_EQ(ret, 0);
+    ret = CheckParallelMatchesSerial("AES128|CBC|PKCS5", key, (HcfParamsSpec *)&ivSpec);
+    EXPECT_EQ(ret, 0);
+    ret = CheckParallelMatchesSerial("AES128|CBC|NoPadding", key, (HcfParamsSpec *)&ivSpec);
+    EXPECT_NE(ret, 0); /* the text is not block aligned */
+    /* the counter of this iv carries over 64 bits inside the message */
+    ret = CheckParallelMatchesSerial("AES128|CTR|NoPadding", key, (HcfParamsSpec *)&ivSpec);
+    EXPECT_EQ(ret, 0);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest076, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t aad[20] = {0};
+    uint8_t tag[16] = {0};
+    uint8_t iv[12] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *serial = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> plainText(PARALLEL_TEXT_LEN, 0x5A);
+    vector<uint8_t> expect;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+
+    HcfGcmParamsSpec spec = {};
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES256", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = CreateCipherWithThreads("AES256|GCM|NoPadding", 1, &serial);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CreateCipherWithThreads("AES256|GCM|NoPadding", PARALLEL_THREAD_NUM, &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* ciphertext and tag must match one thread */
+    ret = AesCryptInChunks(serial, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, expect);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, cipherText);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(cipherText == expect);
+
+    (void)memcpy_s(tag, sizeof(tag), cipherText.data() + PARALLEL_TEXT_LEN, sizeof(tag));
+    cipherText.resize(PARALLEL_TEXT_LEN);
+    cipherText[PARALLEL_TEXT_LEN / 2] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 0, decrypted), 0);
+    cipherText[PARALLEL_TEXT_LEN / 2] ^= 1;
+    ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 0, decrypted);
+    EXPECT_TRUE(decrypted == plainText);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)serial);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest077, TestSize.Level0)
+{
+    HcfCipher *cipher = NULL;
+    HcfCipher *des = NULL;
+    int ret = HcfCipherCreate("AES128|CTR|NoPadding", &cipher);
+    ASSERT_EQ(ret, 0);
+    EXPECT_EQ(cipher->setCipherSpecUint(cipher, (CipherSpecItem)100, 1), HCF_INVALID_PARAMS);
+    EXPECT_EQ(cipher->setCipherSpecUint(cipher, CIPHER_PARALLEL_THREAD_NUM, 0), HCF_SUCCESS);
+    ret = HcfCipherCreate("3DES192|ECB|PKCS7", &des);
+    ASSERT_EQ(ret, 0);
+    EXPECT_EQ(des->setCipherSpecUint(des, CIPHER_PARALLEL_THREAD_NUM, 2), HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)des);
+}
+
+static const uint32_t STREAM_AAD_LEN = 5000;
+static const uint32_t STREAM_AAD_PREFIX_LEN = 1000;
+static const uint32_t STREAM_AAD_CHUNK_LEN = 1500;
+
+static vector<uint8_t> MakeStreamAad(void)
+{
+    vector<uint8_t> aad(STREAM_AAD_LEN);
+    for (uint32_t i = 0; i < aad.size(); i++) {
+        aad[i] = (uint8_t)(i * 7);
+    }
+    return aad;
+}
+
+/* init with the aad of params, then stream the rest of the aad in chunkLen pieces and finish in one shot */
+static int32_t AeadCryptWithAadChunks(HcfCipher *cipher, enum HcfCryptoMode mode, HcfSymKey *key,
+    HcfParamsSpec *params, const vector<uint8_t> &aad, const vector<uint8_t> &input, vector<uint8_t> &output)
+{
+    output.clear();
+    int32_t ret = cipher->init(cipher, mode, (HcfKey *)key, params);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        return ret;
+    }
+    HcfBlob empty = {.data = NULL, .len = 0};
+    ret = cipher->updateAad(cipher, &empty);
+    for (uint32_t offset = 0; (ret == 0) && (offset < aad.size()); offset += STREAM_AAD_CHUNK_LEN) {
+        HcfBlob chunk = {.data = const_cast<uint8_t *>(aad.data()) + offset,
+            .len = min<uint32_t>(STREAM_AAD_CHUNK_LEN, aad.size() - offset)};
+        ret = cipher->updateAad(cipher, &chunk);
+    }
+    if (ret != 0) {
+        LOGE("updateAad failed! %d", ret);
+        return ret;
+    }
+    HcfBlob in = {.data = const_cast<uint8_t *>(input.data()), .len = input.size()};
+    HcfBlob out = {.data = NULL, .len = 0};
+    ret = cipher->doFinal(cipher, &in, &out);
+    if (ret != 0) {
+        LOGE("doFinal failed! %d", ret);
+        return ret;
+    }
+    output.assign(out.data, out.data + out.len);
+    HcfBlobDataFree(&out);
+    return 0;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest078, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t tag[16] = {0};
+    uint8_t iv[12] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> aad = MakeStreamAad();
+    vector<uint8_t> rest(aad.begin() + STREAM_AAD_PREFIX_LEN, aad.end());
+    vector<uint8_t> plainText(100, 0x3C);
+    vector<uint8_t> expect;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    uint8_t data[16] = {0};
+    HcfBlob in = {.data = data, .len = sizeof(data)};
+    HcfBlob out = {.data = NULL, .len = 0};
+
+    HcfGcmParamsSpec spec = {};
+    spec.aad.data = aad.data();
+    spec.aad.len = aad.size();
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|GCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    /* aad longer than the former 2048 byte cap, given whole or streamed, gives the same tag */
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, expect);
+    if (ret != 0) {
+        goto clearup;
+    }
+    spec.aad.len = STREAM_AAD_PREFIX_LEN;
+    ret = AeadCryptWithAadChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, rest, plainText, cipherText);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(cipherText == expect);
+
+    (void)memcpy_s(tag, sizeof(tag), cipherText.data() + plainText.size(), sizeof(tag));
+    cipherText.resize(plainText.size());
+    ret = AeadCryptWithAadChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, rest, cipherText, decrypted);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(decrypted == plainText);
+
+    /* aad can no longer be added once message data went in */
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cipher->update(cipher, &in, &out);
+    HcfBlobDataFree(&out);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(cipher->updateAad(cipher, &in), HCF_INVALID_PARAMS);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest079, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t tag[12] = {0};
+    uint8_t iv[7] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    HcfCipher *cbc = NULL;
+    vector<uint8_t> aad = MakeStreamAad();
+    vector<uint8_t> rest(aad.begin() + STREAM_AAD_PREFIX_LEN, aad.end());
+    vector<uint8_t> noAad;
+    vector<uint8_t> plainText(100, 0x3C);
+    vector<uint8_t> expect;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    HcfBlob empty = {.data = NULL, .len = 0};
+
+    HcfCcmParamsSpec spec = {};
+    spec.aad.data = aad.data();
+    spec.aad.len = aad.size();
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|CCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    /* ccm buffers the streamed aad, the tag matches the aad given whole */
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, expect);
+    if (ret != 0) {
+        goto clearup;
+    }
+    spec.aad.len = STREAM_AAD_PREFIX_LEN;
+    ret = AeadCryptWithAadChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, rest, plainText, cipherText);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(cipherText == expect);
+
+    /* no aad at all */
+    spec.aad.data = NULL;
+    spec.aad.len = 0;
+    ret = AeadCryptWithAadChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, noAad, plainText, cipherText);
+    if (ret != 0) {
+        goto clearup;
+    }
+    (void)memcpy_s(tag, sizeof(tag), cipherText.data() + plainText.size(), sizeof(tag));
+    cipherText.resize(plainText.size());
+    ret = AeadCryptWithAadChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, noAad, cipherText, decrypted);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(decrypted == plainText);
+
+    ret = HcfCipherCreate("AES128|CBC|PKCS5", &cbc);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cbc->init(cbc, ENCRYPT_MODE, (HcfKey *)key, NULL);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(cbc->updateAad(cbc, &empty), HCF_NOT_SUPPORT);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cbc);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest080, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t tag[16] = {0};
+    uint8_t iv[12] = {1};
+    HcfSymKey *key = NULL;
+    HcfCipher *serial = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> aad = MakeStreamAad();
+    vector<uint8_t> rest(aad.begin() + STREAM_AAD_PREFIX_LEN, aad.end());
+    vector<uint8_t> plainText(PARALLEL_TEXT_LEN, 0x5A);
+    vector<uint8_t> expect;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+
+    HcfGcmParamsSpec spec = {};
+    spec.aad.data = aad.data();
+    spec.aad.len = aad.size();
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES256", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = CreateCipherWithThreads("AES256|GCM|NoPadding", 1, &serial);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CreateCipherWithThreads("AES256|GCM|NoPadding", PARALLEL_THREAD_NUM, &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* the parallel engine recovers the ghash of aad it never saw whole */
+    ret = AesCryptInChunks(serial, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, expect);
+    if (ret != 0) {
+        goto clearup;
+    }
+    spec.aad.len = STREAM_AAD_PREFIX_LEN;
+    ret = AeadCryptWithAadChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, rest, plainText, cipherText);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(cipherText == expect);
+
+    (void)memcpy_s(tag, sizeof(tag), cipherText.data() + PARALLEL_TEXT_LEN, sizeof(tag));
+    cipherText.resize(PARALLEL_TEXT_LEN);
+    ret = AeadCryptWithAadChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, rest, cipherText, decrypted);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(decrypted == plainText);
+    aad[0] ^= 1;
+    rest.assign(aad.begin() + STREAM_AAD_PREFIX_LEN, aad.end());
+    EXPECT_TRUE(AeadCryptWithAadChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, rest, cipherText,
+        decrypted) != 0);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)serial);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t CCM_STREAM_BIG_LEN = 3 * 1024 * 1024;
+static const uint32_t CCM_STREAM_CHUNK_LEN = 64 * 1024;
+
+/* a ccm message with a declared length, split over many updates, matches the single call ccm */
+static int32_t CheckCcmStreamMatchesOneShot(HcfCipher *cipher, HcfSymKey *key, HcfCcmParamsSpec *spec,
+    const vector<uint8_t> &plainText, uint32_t chunkLen)
+{
+    vector<uint8_t> expect;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    spec->isDataLenSet = false;
+    int32_t ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)spec, plainText, 0, expect);
+    if (ret != 0) {
+        return ret;
+    }
+    spec->isDataLenSet = true;
+    spec->dataLen = plainText.size();
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)spec, plainText, chunkLen, cipherText);
+    if (ret != 0) {
+        return ret;
+    }
+    if (cipherText != expect) {
+        LOGE("ccm stream does not match one shot!");
+        return -1;
+    }
+    (void)memcpy_s(spec->tag.data, spec->tag.len, cipherText.data() + plainText.size(), spec->tag.len);
+    cipherText.resize(plainText.size());
+    ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)spec, cipherText, chunkLen + 1, decrypted);
+    if (ret != 0) {
+        return ret;
+    }
+    return (decrypted == plainText) ? 0 : -1;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest081, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t aad[8] = {0};
+    uint8_t tag[12] = {0};
+    uint8_t iv[7] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> plainText(100, 0x3C);
+    vector<uint8_t> longText(plainText.size() + 1, 0x3C);
+    vector<uint8_t> shortText(plainText.size() - 1, 0x3C);
+    vector<uint8_t> output;
+
+    HcfCcmParamsSpec spec = {};
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|CCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = CheckCcmStreamMatchesOneShot(cipher, key, &spec, plainText, 7);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* a wrong tag fails */
+    tag[0] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 16, output), 0);
+    /* the data must match the declared length */
+    EXPECT_NE(AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, longText, 16, output), 0);
+    EXPECT_NE(AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, shortText, 16, output), 0);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest082, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t tag[12] = {0};
+    uint8_t iv[11] = {0}; /* 4 length bytes */
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    /* long enough for the 0xFFFE aad length encoding */
+    vector<uint8_t> aad(70000, 0x11);
+    vector<uint8_t> plainText(CCM_STREAM_BIG_LEN);
+    vector<uint8_t> empty;
+    vector<uint8_t> output;
+    for (uint32_t i = 0; i < plainText.size(); i++) {
+        plainText[i] = (uint8_t)(i * 31);
+    }
+
+    HcfCcmParamsSpec spec = {};
+    spec.aad.data = aad.data();
+    spec.aad.len = aad.size();
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES256", &key);
+    if (ret != 0) {
+        LOGE("GenerateSymKey failed!");
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES256|CCM|NoPadding", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = CheckCcmStreamMatchesOneShot(cipher, key, &spec, plainText, CCM_STREAM_CHUNK_LEN);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* an empty message without aad, which a single call ccm cannot produce */
+    spec.aad.data = NULL;
+    spec.aad.len = 0;
+    spec.dataLen = 0;
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, empty, 0, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(output.size(), sizeof(tag));
+    (void)memcpy_s(tag, sizeof(tag), output.data(), output.size());
+    ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, empty, 0, output);
+    EXPECT_TRUE(output.empty());
+    tag[0] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, empty, 0, output), 0);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t GCM_SIV_NONCE_LEN = 12;
+static const uint32_t GCM_SIV_TAG_LEN = 16;
+
+typedef struct {
+    const char *algoName;
+    const char *key;
+    const char *aad;
+    const char *plainText;
+    const char *result;
+} GcmSivVector;
+
+/* RFC 8452 appendix C, result is the ciphertext followed by the tag */
+static const GcmSivVector GCM_SIV_VECTORS[] = {
+    { "AES128", "01000000000000000000000000000000", "", "", "dc20e2d83f25705bb49e439eca56de25" },
+    { "AES128", "01000000000000000000000000000000", "", "0100000000000000",
+        "b5d839330ac7b786578782fff6013b815b287c22493a364c" },
+    { "AES128", "01000000000000000000000000000000", "", "010000000000000000000000",
+        "7323ea61d05932260047d942a4978db357391a0bc4fdec8b0d106639" },
+    { "AES128", "01000000000000000000000000000000", "01", "0200000000000000",
+        "1e6daba35669f4273b0a1a2560969cdf790d99759abd1508" },
+    { "AES256", "0100000000000000000000000000000000000000000000000000000000000000", "", "",
+        "07f5f4169bbf55a8400cd47ea6fd400f" },
+    { "AES256", "0100000000000000000000000000000000000000000000000000000000000000", "", "0100000000000000",
+        "c2ef328e5c71c83b843122130f7364b761e0b97427e3df28" },
+};
+
+static vector<uint8_t> HexToBytes(const char *hex)
+{
+    vector<uint8_t> bytes;
+    for (size_t i = 0; hex[i] != '\0' && hex[i + 1] != '\0'; i += 2) {
+        char byte[3] = { hex[i], hex[i + 1], '\0' };
+        bytes.push_back((uint8_t)strtoul(byte, NULL, 16));
+    }
+    return bytes;
+}
+
+static int32_t ConvertSymKeyData(const char *algoName, const vector<uint8_t> &keyData, HcfSymKey **key)
+{
+    HcfSymKeyGenerator *generator = NULL;
+    int32_t ret = HcfSymKeyGeneratorCreate(algoName, &generator);
+    if (ret != 0) {
+        LOGE("HcfSymKeyGeneratorCreate failed!%d", ret);
+        return ret;
+    }
+    HcfBlob keyBlob = {.data = const_cast<uint8_t *>(keyData.data()), .len = keyData.size()};
+    ret = generator->convertSymKey(generator, &keyBlob, key);
+    if (ret != 0) {
+        LOGE("convertSymKey failed!");
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    return ret;
+}
+
+static int32_t CheckGcmSivVector(const GcmSivVector *vector)
+{
+    uint8_t nonce[GCM_SIV_NONCE_LEN] = { 0x03 };
+    uint8_t tag[GCM_SIV_TAG_LEN] = {0};
+    std::vector<uint8_t> aad = HexToBytes(vector->aad);
+    std::vector<uint8_t> plainText = HexToBytes(vector->plainText);
+    std::vector<uint8_t> expect = HexToBytes(vector->result);
+    std::vector<uint8_t> output;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    char cipherName[32] = {0};
+    (void)sprintf_s(cipherName, sizeof(cipherName), "%s|GCMSIV|NoPadding", vector->algoName);
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = nonce;
+    spec.iv.len = sizeof(nonce);
+    spec.aad.data = aad.empty() ? NULL : aad.data();
+    spec.aad.len = aad.size();
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    int32_t ret = ConvertSymKeyData(vector->algoName, HexToBytes(vector->key), &key);
+    if (ret == 0) {
+        ret = HcfCipherCreate(cipherName, &cipher);
+    }
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, output);
+    }
+    if ((ret == 0) && (output != expect)) {
+        LOGE("gcm-siv result does not match!");
+        ret = -1;
+    }
+    if (ret == 0) {
+        (void)memcpy_s(tag, sizeof(tag), expect.data() + plainText.size(), sizeof(tag));
+        expect.resize(plainText.size());
+        ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, expect, 0, output);
+    }
+    if ((ret == 0) && (output != plainText)) {
+        LOGE("gcm-siv decrypt does not match!");
+        ret = -1;
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest083, TestSize.Level0)
+{
+    for (const GcmSivVector &vector : GCM_SIV_VECTORS) {
+        EXPECT_EQ(CheckGcmSivVector(&vector), 0);
+    }
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest084, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t nonce[GCM_SIV_NONCE_LEN] = {0};
+    uint8_t tag[GCM_SIV_TAG_LEN] = {0};
+    vector<uint8_t> keyData(32);
+    vector<uint8_t> aad(37);
+    vector<uint8_t> plainText(1500);
+    vector<uint8_t> cipherText;
+    vector<uint8_t> output;
+    const vector<uint8_t> expectTag = HexToBytes("90ee1f130f929096c3664c0305d59bc1");
+    const vector<uint8_t> expectFirst = HexToBytes("8f436d28b39bdfafe58461a327c3d707");
+    const vector<uint8_t> expectAt1024 = HexToBytes("3311beaba110a74e8eb724697e07faea");
+    HcfBlob aadHead = {.data = aad.data(), .len = 20};
+    HcfBlob aadTail = {.data = aad.data() + 20, .len = aad.size() - 20};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    for (uint32_t i = 0; i < keyData.size(); i++) {
+        keyData[i] = (uint8_t)i;
+    }
+    for (uint32_t i = 0; i < sizeof(nonce); i++) {
+        nonce[i] = (uint8_t)(0x40 + i);
+    }
+    for (uint32_t i = 0; i < aad.size(); i++) {
+        aad[i] = (uint8_t)(i * 5);
+    }
+    for (uint32_t i = 0; i < plainText.size(); i++) {
+        plainText[i] = (uint8_t)(i * 7 + 3);
+    }
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = nonce;
+    spec.iv.len = sizeof(nonce);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    ret = ConvertSymKeyData("AES256", keyData, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES256|GCMSIV|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* the aad streamed in two parts and the data over several updates, which return nothing */
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(cipher->updateAad(cipher, &aadHead), HCF_SUCCESS);
+    EXPECT_EQ(cipher->updateAad(cipher, &aadTail), HCF_SUCCESS);
+    for (uint32_t offset = 0; offset < 1000; offset += 100) {
+        HcfBlob in = {.data = plainText.data() + offset, .len = 100};
+        HcfBlob out = {.data = NULL, .len = 0};
+        ret = cipher->update(cipher, &in, &out);
+        if (ret != 0) {
+            goto clearup;
+        }
+        EXPECT_EQ(out.len, 0);
+        HcfBlobDataFree(&out);
+    }
+    EXPECT_EQ(cipher->updateAad(cipher, &aadTail), HCF_INVALID_PARAMS);
+    {
+        HcfBlob in = {.data = plainText.data() + 1000, .len = 500};
+        HcfBlob out = {.data = NULL, .len = 0};
+        ret = cipher->doFinal(cipher, &in, &out);
+        if (ret != 0) {
+            goto clearup;
+        }
+        cipherText.assign(out.data, out.data + out.len);
+        HcfBlobDataFree(&out);
+    }
+    ASSERT_EQ(cipherText.size(), plainText.size() + GCM_SIV_TAG_LEN);
+    EXPECT_EQ(memcmp(cipherText.data(), expectFirst.data(), expectFirst.size()), 0);
+    EXPECT_EQ(memcmp(cipherText.data() + 1024, expectAt1024.data(), expectAt1024.size()), 0);
+    EXPECT_EQ(memcmp(cipherText.data() + plainText.size(), expectTag.data(), expectTag.size()), 0);
+
+    /* decrypt with the aad in params; a changed ciphertext or aad fails and returns nothing */
+    spec.aad.data = aad.data();
+    spec.aad.len = aad.size();
+    (void)memcpy_s(tag, sizeof(tag), expectTag.data(), sizeof(tag));
+    cipherText.resize(plainText.size());
+    ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 333, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(output == plainText);
+    cipherText[700] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 333, output), 0);
+    EXPECT_TRUE(output.empty());
+    cipherText[700] ^= 1;
+    aad[0] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 0, output), 0);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest085, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t nonce[GCM_SIV_NONCE_LEN] = {0};
+    uint8_t tag[GCM_SIV_TAG_LEN] = {0};
+    uint8_t buffer[256 + GCM_SIV_TAG_LEN] = {0};
+    uint32_t outLen = 0;
+    vector<uint8_t> plainText(256, 0x5A);
+    vector<uint8_t> otherText(256, 0x5B);
+    vector<uint8_t> first;
+    vector<uint8_t> second;
+    HcfBlob input = {.data = plainText.data(), .len = plainText.size()};
+    HcfBlob output = {.data = buffer, .len = sizeof(buffer)};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = nonce;
+    spec.iv.len = sizeof(nonce);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|GCMSIV|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* with a fixed nonce the same message gives the same result, whether by init or by reset */
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, first);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cipher->reset(cipher, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(cipher->getOutputSize(cipher, plainText.size(), false, &outLen), HCF_SUCCESS);
+    EXPECT_EQ(outLen, 0);
+    EXPECT_EQ(cipher->getOutputSize(cipher, plainText.size(), true, &outLen), HCF_SUCCESS);
+    EXPECT_EQ(outLen, sizeof(buffer));
+    ret = cipher->doFinalToBuffer(cipher, &input, &output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(output.len, first.size());
+    EXPECT_EQ(memcmp(buffer, first.data(), first.size()), 0);
+    /* a different message under the same nonce shares nothing with the first */
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, otherText, 64, second);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_NE(memcmp(second.data(), first.data(), plainText.size()), 0);
+    EXPECT_NE(memcmp(second.data() + plainText.size(), first.data() + plainText.size(), GCM_SIV_TAG_LEN), 0);
+    nonce[0] = 1;
+    ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, second);
+    EXPECT_FALSE(second == first);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest086, TestSize.Level0)
+{
+    uint8_t nonce[GCM_SIV_NONCE_LEN] = {0};
+    uint8_t tag[GCM_SIV_TAG_LEN] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    HcfGcmParamsSpec spec = {};
+    spec.iv.data = nonce;
+    spec.iv.len = sizeof(nonce);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+
+    EXPECT_NE(HcfCipherCreate("AES192|GCMSIV|NoPadding", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("AES256|GCMSIV|NoPadding", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+    /* the key must match the cipher, the nonce is 12 bytes and the tag 16 bytes */
+    EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_INVALID_PARAMS);
+    EXPECT_EQ(cipher->reset(cipher, (HcfParamsSpec *)&spec), HCF_INVALID_PARAMS);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    ASSERT_EQ(HcfCipherCreate("AES128|GCMSIV|NoPadding", &cipher), HCF_SUCCESS);
+    spec.iv.len = GCM_SIV_NONCE_LEN - 1;
+    EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_INVALID_PARAMS);
+    spec.iv.len = GCM_SIV_NONCE_LEN;
+    spec.tag.len = GCM_SIV_TAG_LEN - 4;
+    EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_INVALID_PARAMS);
+    spec.tag.len = GCM_SIV_TAG_LEN;
+    EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_EQ(cipher->setCipherSpecUint(cipher, CIPHER_PARALLEL_THREAD_NUM, 2), HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+}
+
+static const uint32_t XTS_SECTOR_SIZE = 512;
+
+static int32_t XtsCrypt(HcfCipher *cipher, enum HcfCryptoMode mode, HcfSymKey *key, uint64_t sector,
+    const vector<uint8_t> &input, uint32_t chunkLen, vector<uint8_t> &output)
+{
+    uint8_t tweak[16] = {0};
+    for (uint32_t i = 0; i < sizeof(uint64_t); i++) {
+        tweak[i] = (uint8_t)(sector >> (i * 8));
+    }
+    HcfIvParamsSpec spec = {};
+    spec.iv.data = tweak;
+    spec.iv.len = sizeof(tweak);
+    return AesCryptInChunks(cipher, mode, key, (HcfParamsSpec *)&spec, input, chunkLen, output);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest087, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    HcfSymKey *genKey = NULL;
+    HcfSymKeyGenerator *generator = NULL;
+    HcfBlob encoded = {.data = NULL, .len = 0};
+    /* IEEE 1619 vector 2 */
+    vector<uint8_t> keyData = HexToBytes("1111111111111111111111111111111122222222222222222222222222222222");
+    vector<uint8_t> plainText(32, 0x44);
+    vector<uint8_t> expect = HexToBytes("c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0");
+    vector<uint8_t> output;
+
+    ret = ConvertSymKeyData("AES128|XTS", keyData, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_STREQ(key->key.getAlgorithm((HcfKey *)key), "AES128|XTS");
+    ret = HcfCipherCreate("AES128|XTS|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = XtsCrypt(cipher, ENCRYPT_MODE, key, 0x3333333333ULL, plainText, 0, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(output == expect);
+    /* a data unit collected by update gives the same result */
+    ret = XtsCrypt(cipher, DECRYPT_MODE, key, 0x3333333333ULL, expect, 7, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(output == plainText);
+
+    /* the generator makes keys of both halves */
+    ret = HcfSymKeyGeneratorCreate("AES256|XTS", &generator);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = generator->generateSymKey(generator, &genKey);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = genKey->key.getEncoded((HcfKey *)genKey, &encoded);
+    EXPECT_EQ(encoded.len, 64);
+    EXPECT_STREQ(genKey->key.getAlgorithm((HcfKey *)genKey), "AES256|XTS");
+    EXPECT_NE(HcfSymKeyGeneratorCreate("AES192|XTS", &generator), HCF_SUCCESS);
+    EXPECT_NE(HcfSymKeyGeneratorCreate("AES256|CBC", &generator), HCF_SUCCESS);
+
+clearup:
+    HcfBlobDataFree(&encoded);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)genKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest088, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    /* IEEE 1619 vectors 4 and 5: two 512 byte sectors from sector 0 */
+    vector<uint8_t> keyData = HexToBytes("2718281828459045235360287471352631415926535897932384626433832795");
+    vector<uint8_t> expectSector0 = HexToBytes("27a7479befa1d476489f308cd4cfa6e2a96e4bbe3208ff25287dd3819616e89c");
+    vector<uint8_t> expectSector1 = HexToBytes("264d3ca8512194fec312c8c9891f279fefdd608d0c027b60483a3fa811d65ee5");
+    vector<uint8_t> plainText(2 * XTS_SECTOR_SIZE);
+    vector<uint8_t> cipherText(plainText.size());
+    vector<uint8_t> sector;
+    vector<uint8_t> output;
+    for (uint32_t i = 0; i < plainText.size(); i++) {
+        plainText[i] = (uint8_t)i;
+    }
+    HcfCipherSectorParams params = { .startSector = 0, .sectorSize = XTS_SECTOR_SIZE };
+    HcfBlob input = {.data = plainText.data(), .len = plainText.size()};
+    HcfBlob out = {.data = cipherText.data(), .len = cipherText.size()};
+
+    ret = ConvertSymKeyData("AES128|XTS", keyData, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|XTS|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(HcfCipherCryptSectors(cipher, &params, &input, &out), HCF_INVALID_PARAMS);
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, NULL);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCryptSectors(cipher, &params, &input, &out);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(out.len, plainText.size());
+    EXPECT_EQ(memcmp(cipherText.data(), expectSector0.data(), expectSector0.size()), 0);
+    /* vector 5 is the ciphertext of vector 4 encrypted again as sector 1 */
+    params.startSector = 1;
+    input.data = cipherText.data();
+    input.len = XTS_SECTOR_SIZE;
+    output.resize(XTS_SECTOR_SIZE);
+    out.data = output.data();
+    out.len = output.size();
+    ret = HcfCipherCryptSectors(cipher, &params, &input, &out);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(memcmp(output.data(), expectSector1.data(), expectSector1.size()), 0);
+    params.startSector = 0;
+    input.len = plainText.size();
+    out.data = cipherText.data();
+    out.len = cipherText.size();
+
+    /* a sector of the batch matches the same sector by doFinal */
+    sector.assign(plainText.begin() + XTS_SECTOR_SIZE, plainText.end());
+    ret = XtsCrypt(cipher, ENCRYPT_MODE, key, 1, sector, 0, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(memcmp(output.data(), cipherText.data() + XTS_SECTOR_SIZE, XTS_SECTOR_SIZE), 0);
+
+    /* decrypt in place, and a batch that does not start at 0 */
+    ret = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, NULL);
+    if (ret != 0) {
+        goto clearup;
+    }
+    input.data = cipherText.data();
+    ret = HcfCipherCryptSectors(cipher, &params, &input, &out);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(cipherText == plainText);
+    /* sector 1 alone, encrypted by doFinal above, decrypts as a batch starting at 1 */
+    params.startSector = 1;
+    input.data = output.data();
+    input.len = XTS_SECTOR_SIZE;
+    out.len = XTS_SECTOR_SIZE;
+    ret = HcfCipherCryptSectors(cipher, &params, &input, &out);
+    EXPECT_EQ(memcmp(cipherText.data(), sector.data(), XTS_SECTOR_SIZE), 0);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest089, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfSymKey *sameHalves = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> keyData(64, 0x01);
+    vector<uint8_t> data(XTS_SECTOR_SIZE + 16);
+    vector<uint8_t> output;
+    HcfCipherSectorParams params = { .startSector = UINT64_MAX, .sectorSize = XTS_SECTOR_SIZE };
+    HcfBlob input = {.data = data.data(), .len = data.size()};
+    HcfBlob out = {.data = data.data(), .len = data.size()};
+
+    EXPECT_NE(HcfCipherCreate("AES192|XTS|NoPadding", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(ConvertSymKeyData("AES256|XTS", keyData, &sameHalves), 0);
+    keyData[63] = 0x02;
+    ASSERT_EQ(ConvertSymKeyData("AES256|XTS", keyData, &key), 0);
+    ASSERT_EQ(HcfCipherCreate("AES256|XTS|NoPadding", &cipher), HCF_SUCCESS);
+    /* the data key and the tweak key must differ */
+    EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)sameHalves, NULL), HCF_INVALID_PARAMS);
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, NULL), HCF_SUCCESS);
+    /* whole sectors only, and the sector number must not wrap */
+    EXPECT_EQ(HcfCipherCryptSectors(cipher, &params, &input, &out), HCF_INVALID_PARAMS);
+    input.len = 2 * XTS_SECTOR_SIZE;
+    EXPECT_EQ(HcfCipherCryptSectors(cipher, &params, &input, &out), HCF_INVALID_PARAMS);
+    input.len = XTS_SECTOR_SIZE;
+    EXPECT_EQ(HcfCipherCryptSectors(cipher, &params, &input, &out), HCF_SUCCESS);
+    /* a data unit is at least one block, the output of a partial last block is still its length */
+    EXPECT_NE(XtsCrypt(cipher, ENCRYPT_MODE, key, 0, vector<uint8_t>(15), 0, output), 0);
+    EXPECT_EQ(XtsCrypt(cipher, ENCRYPT_MODE, key, 0, vector<uint8_t>(17), 0, output), 0);
+    EXPECT_EQ(output.size(), 17);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    /* other ciphers have no sector batch */
+    ASSERT_EQ(HcfCipherCreate("AES256|CTR|NoPadding", &cipher), HCF_SUCCESS);
+    EXPECT_EQ(HcfCipherCryptSectors(cipher, &params, &input, &out), HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)sameHalves);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest090, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *kek = NULL;
+    HcfSymKey *key = NULL;
+    HcfSymKey *unwrapped = NULL;
+    HcfSymKeyGenerator *generator = NULL;
+    HcfBlob wrapped = {.data = NULL, .len = 0};
+    HcfBlob encoded = {.data = NULL, .len = 0};
+    /* RFC 3394 4.1: wrap 128 bits of key data with a 128-bit kek */
+    vector<uint8_t> expect = HexToBytes("1fa68b0a8112b447aef34bd8fb5a7b829d3e862371d2cfe5");
+    vector<uint8_t> keyData = HexToBytes("00112233445566778899aabbccddeeff");
+
+    ret = ConvertSymKeyData("AES128", HexToBytes("000102030405060708090a0b0c0d0e0f"), &kek);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = ConvertSymKeyData("AES128", keyData, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfSymKeyGeneratorCreate("AES128", &generator);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = generator->wrapSymKey(generator, HCF_KEY_WRAP_AES, kek, key, &wrapped);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(vector<uint8_t>(wrapped.data, wrapped.data + wrapped.len) == expect);
+    ret = generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES, kek, &wrapped, &unwrapped);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_STREQ(unwrapped->key.getAlgorithm((HcfKey *)unwrapped), "AES128");
+    ret = unwrapped->key.getEncoded((HcfKey *)unwrapped, &encoded);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(vector<uint8_t>(encoded.data, encoded.data + encoded.len) == keyData);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)unwrapped);
+    unwrapped = NULL;
+
+    /* a flipped bit fails the integrity check */
+    wrapped.data[wrapped.len - 1] ^= 0x01;
+    EXPECT_EQ(generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES, kek, &wrapped, &unwrapped),
+        HCF_ERR_CRYPTO_OPERATION);
+    EXPECT_EQ(unwrapped, nullptr);
+
+clearup:
+    HcfBlobDataFree(&wrapped);
+    HcfBlobDataFree(&encoded);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)unwrapped);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)kek);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest091, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *kek = NULL;
+    HcfSymKey *key = NULL;
+    HcfSymKey *unwrapped = NULL;
+    HcfSymKeyGenerator *generator = NULL;
+    HcfBlob wrapped = {.data = NULL, .len = 0};
+    HcfBlob encoded = {.data = NULL, .len = 0};
+    HcfBlob keyBlob = {.data = NULL, .len = 0};
+    /* RFC 5649 6: 20 octets of key data wrapped with a 192-bit kek */
+    vector<uint8_t> kekData = HexToBytes("5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8");
+    vector<uint8_t> rfcWrapped = HexToBytes("138bdeaa9b8fa7fc61f97742e72248ee5ae6ae5360d1ae6a5f54f373fa543b6a");
+    HcfBlob rfcBlob = {.data = rfcWrapped.data(), .len = rfcWrapped.size()};
+
+    ret = ConvertSymKeyData("AES192", kekData, &kek);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfSymKeyGeneratorCreate("3DES192", &generator);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* the vector passes the integrity check but 20 octets is no 3DES192 key */
+    EXPECT_EQ(generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES_PAD, kek, &rfcBlob, &unwrapped),
+        HCF_INVALID_PARAMS);
+    rfcWrapped[0] ^= 0x01;
+    EXPECT_EQ(generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES_PAD, kek, &rfcBlob, &unwrapped),
+        HCF_ERR_CRYPTO_OPERATION);
+
+    ret = generator->generateSymKey(generator, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = generator->wrapSymKey(generator, HCF_KEY_WRAP_AES_PAD, kek, key, &wrapped);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(wrapped.len, 32);
+    ret = generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES_PAD, kek, &wrapped, &unwrapped);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_STREQ(unwrapped->key.getAlgorithm((HcfKey *)unwrapped), "3DES192");
+    ret = unwrapped->key.getEncoded((HcfKey *)unwrapped, &encoded);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = key->key.getEncoded((HcfKey *)key, &keyBlob);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(encoded.len, keyBlob.len);
+    EXPECT_EQ(memcmp(encoded.data, keyBlob.data, keyBlob.len), 0);
+    /* a padded wrap does not unwrap as a plain one */
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)unwrapped);
+    unwrapped = NULL;
+    EXPECT_NE(generator->unwrapSymKey(generator, HCF_KEY_WRAP_AES, kek, &wrapped, &unwrapped), HCF_SUCCESS);
+    /* the kek must be a plain AES key */
+    EXPECT_EQ(generator->wrapSymKey(generator, HCF_KEY_WRAP_AES_PAD, key, key, &encoded), HCF_INVALID_PARAMS);
+
+clearup:
+    HcfBlobDataFree(&wrapped);
+    HcfBlobDataFree(&encoded);
+    HcfBlobDataFree(&keyBlob);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)unwrapped);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)kek);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest092, TestSize.Level0)
+{
+    int ret = 0;
+    const uint32_t keyNum = 4;
+    HcfSymKey *kek = NULL;
+    HcfSymKeyGenerator *generator = NULL;
+    HcfSymKey *keys[keyNum] = { NULL };
+    HcfSymKey *unwrapped[keyNum] = { NULL };
+    HcfBlob wrapped[keyNum] = {{.data = NULL, .len = 0}};
+    HcfBlob encoded = {.data = NULL, .len = 0};
+    HcfBlob expect = {.data = NULL, .len = 0};
+
+    ret = HcfSymKeyGeneratorCreate("AES256", &generator);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = generator->generateSymKey(generator, &kek);
+    if (ret != 0) {
+        goto clearup;
+    }
+    for (uint32_t i = 0; i < keyNum; i++) {
+        ret = generator->generateSymKey(generator, &keys[i]);
+        if (ret != 0) {
+            goto clearup;
+        }
+        ret = generator->wrapSymKey(generator, HCF_KEY_WRAP_AES, kek, keys[i], &wrapped[i]);
+        if (ret != 0) {
+            goto clearup;
+        }
+        EXPECT_EQ(wrapped[i].len, 40);
+    }
+    /* one bad item is reported without losing the rest of the batch */
+    wrapped[1].data[0] ^= 0x80;
+    EXPECT_EQ(generator->unwrapSymKeyBatch(generator, HCF_KEY_WRAP_AES, kek, wrapped, unwrapped, keyNum),
+        HCF_ERR_CRYPTO_OPERATION);
+    EXPECT_EQ(unwrapped[1], nullptr);
+    for (uint32_t i = 0; i < keyNum; i++) {
+        if (i == 1) {
+            continue;
+        }
+        ASSERT_NE(unwrapped[i], nullptr);
+        ret = unwrapped[i]->key.getEncoded((HcfKey *)unwrapped[i], &encoded);
+        if (ret != 0) {
+            goto clearup;
+        }
+        ret = keys[i]->key.getEncoded((HcfKey *)keys[i], &expect);
+        if (ret != 0) {
+            goto clearup;
+        }
+        EXPECT_EQ(encoded.len, expect.len);
+        EXPECT_EQ(memcmp(encoded.data, expect.data, expect.len), 0);
+        HcfBlobDataFree(&encoded);
+        HcfBlobDataFree(&expect);
+    }
+    EXPECT_EQ(generator->unwrapSymKeyBatch(generator, HCF_KEY_WRAP_AES, kek, wrapped, unwrapped, 0),
+        HCF_INVALID_PARAMS);
+
+clearup:
+    HcfBlobDataFree(&encoded);
+    HcfBlobDataFree(&expect);
+    for (uint32_t i = 0; i < keyNum; i++) {
+        HcfBlobDataFree(&wrapped[i]);
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)keys[i]);
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)unwrapped[i]);
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)kek);
+    EXPECT_EQ(ret, 0);
+}
+
+static int32_t CheckSameCipherText(const char *cipherName, HcfSymKey *usedKey, HcfSymKey *freshKey,
+    HcfParamsSpec *params)
+{
+    uint8_t cipherText[128] = {0};
+    uint8_t expect[128] = {0};
+    int cipherTextLen = sizeof(cipherText);
+    int expectLen = sizeof(expect);
+    HcfCipher *cipher = NULL;
+    int32_t ret = HcfCipherCreate(cipherName, &cipher);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = AesEncrypt(cipher, freshKey, params, expect, &expectLen);
+    if (ret == 0) {
+        ret = AesEncrypt(cipher, usedKey, params, cipherText, &cipherTextLen);
+    }
+    if ((ret == 0) && ((cipherTextLen != expectLen) || (memcmp(cipherText, expect, expectLen) != 0))) {
+        LOGE("%s ciphertext differs!", cipherName);
+        ret = -1;
+    }
+    if ((ret == 0) && (strstr(cipherName, "GCM") == NULL)) {
+        ret = AesDecrypt(cipher, usedKey, params, cipherText, cipherTextLen);
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest093, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfSymKey *zeroKey = NULL;
+    uint8_t iv[16] = {0};
+    uint8_t tag[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = 12;
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    /* more cipher types than the key keeps templates for, the rest init from the key material */
+    const char *cipherNames[] = { "AES128|CBC|PKCS7", "AES128|ECB|PKCS7", "AES128|CTR|NoPadding",
+        "AES128|GCM|NoPadding", "AES128|OFB|NoPadding", "AES128|CBC|PKCS7" };
+    HcfParamsSpec *params[] = { (HcfParamsSpec *)&ivSpec, NULL, (HcfParamsSpec *)&ivSpec,
+        (HcfParamsSpec *)&gcmSpec, (HcfParamsSpec *)&ivSpec, (HcfParamsSpec *)&ivSpec };
+    vector<uint8_t> keyData = HexToBytes("000102030405060708090a0b0c0d0e0f");
+
+    ret = ConvertSymKeyData("AES128", keyData, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    for (uint32_t i = 0; i < sizeof(cipherNames) / sizeof(cipherNames[0]); i++) {
+        HcfSymKey *freshKey = NULL;
+        ret = ConvertSymKeyData("AES128", keyData, &freshKey);
+        if (ret != 0) {
+            goto clearup;
+        }
+        ret = CheckSameCipherText(cipherNames[i], key, freshKey, params[i]);
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)freshKey);
+        if (ret != 0) {
+            goto clearup;
+        }
+    }
+    /* a cleared key drops the expanded key along with the key material */
+    key->clearMem(key);
+    ret = ConvertSymKeyData("AES128", vector<uint8_t>(keyData.size(), 0), &zeroKey);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckSameCipherText("AES128|CBC|PKCS7", key, zeroKey, (HcfParamsSpec *)&ivSpec);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)zeroKey);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest094, TestSize.Level0)
+{
+    HcfCipher *cipher = NULL;
+    HcfSymKeyGenerator *generator = NULL;
+    const char *badNames[] = { "AES128|CBC|PKCS7|", "AES128||PKCS7", "AES128|CBC|PKCS", "AES128|CBC|PKCS7X",
+        "|AES128|CBC|PKCS7", "AES128|CBC|PKCS7|NoSuchMode" };
+
+    /* the second create of a transformation is served from the parse cache */
+    for (uint32_t i = 0; i < 2; i++) {
+        ASSERT_EQ(HcfCipherCreate("AES128|CBC|PKCS7", &cipher), HCF_SUCCESS);
+        EXPECT_STREQ(cipher->getAlgorithm(cipher), "AES128|CBC|PKCS7");
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+        cipher = NULL;
+        ASSERT_EQ(HcfSymKeyGeneratorCreate("AES256|XTS", &generator), HCF_SUCCESS);
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+        generator = NULL;
+    }
+    for (uint32_t n = 0; n < sizeof(badNames) / sizeof(badNames[0]); n++) {
+        for (uint32_t i = 0; i < 2; i++) {
+            EXPECT_NE(HcfCipherCreate(badNames[n], &cipher), HCF_SUCCESS);
+            EXPECT_EQ(cipher, nullptr);
+        }
+    }
+    /* the same string parsed by another create keeps its own result */
+    EXPECT_NE(HcfSymKeyGeneratorCreate("AES128|CBC|PKCS7", &generator), HCF_SUCCESS);
+    EXPECT_EQ(generator, nullptr);
+}
+
+static int32_t PoolEncrypt(HcfCipher *cipher, HcfSymKey *key, HcfParamsSpec *params, vector<uint8_t> &cipherText)
+{
+    uint8_t buf[128] = {0};
+    int bufLen = sizeof(buf);
+    int32_t ret = AesEncrypt(cipher, key, params, buf, &bufLen);
+    if (ret != 0) {
+        return ret;
+    }
+    cipherText.assign(buf, buf + bufLen);
+    return 0;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest095, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    HcfCipher *pooled = NULL;
+    HcfCipher *other = NULL;
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    uint8_t plainText[] = "this is test!";
+    HcfBlob input = {.data = plainText, .len = sizeof(plainText) - 1};
+    HcfBlob output = {};
+    vector<uint8_t> first;
+    vector<uint8_t> second;
+
+    ret = ConvertSymKeyData("AES128", HexToBytes("000102030405060708090a0b0c0d0e0f"), &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherPoolAcquire("AES128|CBC|PKCS7", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = PoolEncrypt(cipher, key, (HcfParamsSpec *)&ivSpec, first);
+    if (ret != 0) {
+        goto clearup;
+    }
+    HcfCipherPoolRelease(cipher);
+
+    /* the released cipher comes back without its key and must be initialized again */
+    ret = HcfCipherPoolAcquire("AES128|CBC|PKCS7", &pooled);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(pooled, cipher);
+    cipher = NULL;
+    EXPECT_NE(pooled->update(pooled, &input, &output), HCF_SUCCESS);
+    EXPECT_NE(pooled->reset(pooled, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    ret = PoolEncrypt(pooled, key, (HcfParamsSpec *)&ivSpec, second);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(first, second);
+
+    /* another transformation, or the same one while the pooled object is taken, gets a new object */
+    ret = HcfCipherPoolAcquire("AES128|ECB|PKCS7", &other);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_NE(other, pooled);
+    EXPECT_STREQ(other->getAlgorithm(other), "AES128|ECB|PKCS7");
+    HcfCipherPoolRelease(other);
+    ret = HcfCipherPoolAcquire("AES128|CBC|PKCS7", &other);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_NE(other, pooled);
+    HcfCipherPoolRelease(other);
+    other = NULL;
+
+    /* ciphers that can not be wiped in place are destroyed on release */
+    ret = HcfCipherPoolAcquire("RSA1024|PKCS1", &other);
+    if (ret != 0) {
+        goto clearup;
+    }
+    HcfCipherPoolRelease(other);
+    other = NULL;
+    EXPECT_NE(HcfCipherPoolAcquire("AES128|CBC|NoSuchPadding", &other), HCF_SUCCESS);
+    EXPECT_EQ(other, nullptr);
+
+clearup:
+    HcfCipherPoolRelease(pooled);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    HcfObjectPoolClear();
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest096, TestSize.Level0)
+{
+    HcfCipher *released = NULL;
+    HcfCipher *cipher = NULL;
+
+    /* objects pooled by a thread that exits move to the shared overflow */
+    std::thread worker([&released]() {
+        HcfCipher *obj = NULL;
+        if (HcfCipherPoolAcquire("AES256|GCM|NoPadding", &obj) == HCF_SUCCESS) {
+            released = obj;
+            HcfCipherPoolRelease(obj);
+        }
+    });
+    worker.join();
+    ASSERT_NE(released, nullptr);
+    ASSERT_EQ(HcfCipherPoolAcquire("AES256|GCM|NoPadding", &cipher), HCF_SUCCESS);
+    EXPECT_EQ(cipher, released);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    HcfObjectPoolClear();
+}
+
+/* short segments are gathered into one update, the long ones are written in place, outputs fill outBuf exactly */
+static const uint32_t VEC_TEXT_LEN = 5181;
+static const uint32_t VEC_SEGMENT_LENS[] = { 5, 0, 37, 128, 3000, 11, 2000 };
+static const uint32_t VEC_OUTPUT_LENS[] = { 7, 3, 0, 20, 2500, 17, 2650 };
+static const uint32_t VEC_ROUNDS = 3;
+
+static void AppendBlob(vector<uint8_t> &out, HcfBlob *blob)
+{
+    if ((blob->data != NULL) && (blob->len > 0)) {
+        out.insert(out.end(), blob->data, blob->data + blob->len);
+    }
+    HcfBlobDataFree(blob);
+}
+
+static HcfResult UpdateToSegments(HcfCipher *cipher, HcfBlob *inputs, uint32_t inputCount, vector<uint8_t> &out)
+{
+    uint8_t outBuf[VEC_TEXT_LEN + 16] = {0};
+    const uint32_t outputCount = sizeof(VEC_OUTPUT_LENS) / sizeof(VEC_OUTPUT_LENS[0]);
+    HcfBlob outputs[outputCount] = {};
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < outputCount; i++) {
+        outputs[i].data = outBuf + offset;
+        outputs[i].len = VEC_OUTPUT_LENS[i];
+        offset += VEC_OUTPUT_LENS[i];
+    }
+    HcfResult ret = HcfCipherUpdateVecToBuffers(cipher, inputs, inputCount, outputs, outputCount);
+    for (uint32_t i = 0; (ret == HCF_SUCCESS) && (i < outputCount); i++) {
+        out.insert(out.end(), outputs[i].data, outputs[i].data + outputs[i].len);
+    }
+    return ret;
+}
+
+/* the same text as one update, as segments into one output and as segments into output segments */
+static int32_t CheckUpdateVec(const char *cipherName, HcfSymKey *key, HcfParamsSpec *params)
+{
+    vector<uint8_t> text(VEC_TEXT_LEN);
+    for (uint32_t i = 0; i < VEC_TEXT_LEN; i++) {
+        text[i] = (uint8_t)(i * 7 + 1);
+    }
+    const uint32_t inputCount = sizeof(VEC_SEGMENT_LENS) / sizeof(VEC_SEGMENT_LENS[0]);
+    HcfBlob inputs[inputCount] = {};
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < inputCount; i++) {
+        inputs[i].data = (VEC_SEGMENT_LENS[i] > 0) ? text.data() + offset : NULL;
+        inputs[i].len = VEC_SEGMENT_LENS[i];
+        offset += VEC_SEGMENT_LENS[i];
+    }
+    vector<uint8_t> result[VEC_ROUNDS];
+    HcfCipher *cipher = NULL;
+    int32_t ret = HcfCipherCreate(cipherName, &cipher);
+    for (uint32_t round = 0; (ret == 0) && (round < VEC_ROUNDS); round++) {
+        HcfBlob whole = { .data = text.data(), .len = text.size() };
+        HcfBlob output = {};
+        ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, params);
+        if (ret != 0) {
+            break;
+        }
+        if (round == 0) {
+            ret = cipher->update(cipher, &whole, &output);
+            AppendBlob(result[round], &output);
+        } else if (round == 1) {
+            ret = HcfCipherUpdateVec(cipher, inputs, inputCount, &output);
+            AppendBlob(result[round], &output);
+        } else {
+            ret = UpdateToSegments(cipher, inputs, inputCount, result[round]);
+        }
+        if (ret != 0) {
+            break;
+        }
+        ret = cipher->doFinal(cipher, NULL, &output);
+        AppendBlob(result[round], &output);
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    if (ret != 0) {
+        LOGE("%s vec update failed!", cipherName);
+        return ret;
+    }
+    return ((result[0] == result[1]) && (result[0] == result[2])) ? 0 : -1;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest097, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    uint8_t iv[16] = {0};
+    uint8_t tag[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = 12;
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    uint8_t data[16] = {0};
+    HcfBlob badInputs[] = { { .data = data, .len = sizeof(data) }, { .data = NULL, .len = 1 } };
+    HcfBlob small = { .data = data, .len = 8 };
+    HcfBlob output = {};
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckUpdateVec("AES128|CBC|PKCS7", key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckUpdateVec("AES128|CTR|NoPadding", key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckUpdateVec("AES128|GCM|NoPadding", key, (HcfParamsSpec *)&gcmSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|CTR|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_NE(HcfCipherUpdateVec(cipher, badInputs, 2, &output), HCF_SUCCESS);
+    EXPECT_NE(HcfCipherUpdateVec(cipher, badInputs, 0, &output), HCF_SUCCESS);
+    EXPECT_NE(HcfCipherUpdateVec(cipher, NULL, 1, &output), HCF_SUCCESS);
+    /* the output segments are smaller than the output */
+    EXPECT_NE(HcfCipherUpdateVecToBuffers(cipher, badInputs, 1, &small, 1), HCF_SUCCESS);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t PACKET_HEADROOM = 8;
+static const uint32_t PACKET_TEXT_LEN = 100;
+static const uint32_t PACKET_CAPACITY = 128;
+static const uint8_t PACKET_HEADER_BYTE = 0xa5;
+
+static bool IsHeadroomKept(const uint8_t *buf)
+{
+    for (uint32_t i = 0; i < PACKET_HEADROOM; i++) {
+        if (buf[i] != PACKET_HEADER_BYTE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int32_t InitCipher(HcfCipher *cipher, enum HcfCryptoMode mode, HcfSymKey *key, HcfParamsSpec *params)
+{
+    return cipher->init(cipher, mode, (HcfKey *)key, params);
+}
+
+// seal and open in place must match doFinal, keep the headroom and clear a payload that fails to verify
+static int32_t CheckAeadInPlace(const char *cipherName, HcfSymKey *key, HcfParamsSpec *params)
+{
+    HcfCipher *cipher = NULL;
+    uint8_t plainText[PACKET_TEXT_LEN] = {0};
+    uint8_t buf[PACKET_CAPACITY] = {0};
+    uint8_t *payload = buf + PACKET_HEADROOM;
+    for (uint32_t i = 0; i < PACKET_TEXT_LEN; i++) {
+        plainText[i] = (uint8_t)i;
+    }
+    (void)memset_s(buf, PACKET_HEADROOM, PACKET_HEADER_BYTE, PACKET_HEADROOM);
+    (void)memcpy_s(payload, PACKET_CAPACITY - PACKET_HEADROOM, plainText, PACKET_TEXT_LEN);
+    HcfBlob input = { .data = plainText, .len = PACKET_TEXT_LEN };
+    HcfBlob expect = {};
+    HcfCipherPacket packet = { .data = buf, .capacity = PACKET_CAPACITY, .offset = PACKET_HEADROOM,
+        .len = PACKET_TEXT_LEN };
+    int32_t ret = HcfCipherCreate(cipherName, &cipher);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = InitCipher(cipher, ENCRYPT_MODE, key, params);
+    if (ret == 0) {
+        ret = cipher->doFinal(cipher, &input, &expect);
+    }
+    if (ret == 0) {
+        ret = InitCipher(cipher, ENCRYPT_MODE, key, params);
+    }
+    if (ret == 0) {
+        ret = HcfCipherSealInPlace(cipher, &packet);
+    }
+    if (ret != 0) {
+        goto clearup;
+    }
+    if ((packet.len != expect.len) || (memcmp(payload, expect.data, expect.len) != 0) || !IsHeadroomKept(buf)) {
+        ret = -1;
+        goto clearup;
+    }
+    ret = InitCipher(cipher, DECRYPT_MODE, key, params);
+    if (ret == 0) {
+        ret = HcfCipherOpenInPlace(cipher, &packet);
+    }
+    if (ret != 0) {
+        goto clearup;
+    }
+    if ((packet.len != PACKET_TEXT_LEN) || (memcmp(payload, plainText, PACKET_TEXT_LEN) != 0)) {
+        ret = -1;
+        goto clearup;
+    }
+    (void)memcpy_s(payload, PACKET_CAPACITY - PACKET_HEADROOM, expect.data, expect.len);
+    payload[expect.len - 1] ^= 1;
+    packet.len = expect.len;
+    ret = InitCipher(cipher, DECRYPT_MODE, key, params);
+    if ((ret != 0) || (HcfCipherOpenInPlace(cipher, &packet) == HCF_SUCCESS)) {
+        ret = -1;
+        goto clearup;
+    }
+    for (uint32_t i = 0; i < PACKET_TEXT_LEN; i++) {
+        ret |= payload[i];
+    }
+clearup:
+    HcfBlobDataFree(&expect);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest098, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    uint8_t iv[12] = {0};
+    uint8_t aad[8] = {0};
+    uint8_t tag[16] = {0};
+    uint8_t buf[PACKET_CAPACITY] = {0};
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = sizeof(iv);
+    gcmSpec.aad.data = aad;
+    gcmSpec.aad.len = sizeof(aad);
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    HcfCcmParamsSpec ccmSpec = {};
+    ccmSpec.iv.data = iv;
+    ccmSpec.iv.len = 7;
+    ccmSpec.aad.data = aad;
+    ccmSpec.aad.len = sizeof(aad);
+    ccmSpec.tag.data = tag;
+    ccmSpec.tag.len = 12;
+    HcfCipherPacket packet = { .data = buf, .capacity = PACKET_CAPACITY, .offset = PACKET_HEADROOM,
+        .len = PACKET_CAPACITY - PACKET_HEADROOM - 8 };
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckAeadInPlace("AES128|GCM|NoPadding", key, (HcfParamsSpec *)&gcmSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckAeadInPlace("AES128|CCM|NoPadding", key, (HcfParamsSpec *)&ccmSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ccmSpec.isDataLenSet = true;
+    ccmSpec.dataLen = PACKET_TEXT_LEN;
+    ret = CheckAeadInPlace("AES128|CCM|NoPadding", key, (HcfParamsSpec *)&ccmSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|GCM|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&gcmSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* the tailroom can not hold the tag, and the cipher is not initialized to open */
+    EXPECT_EQ(HcfCipherSealInPlace(cipher, &packet), HCF_INVALID_PARAMS);
+    EXPECT_EQ(HcfCipherOpenInPlace(cipher, &packet), HCF_INVALID_PARAMS);
+    packet.offset = PACKET_CAPACITY + 1;
+    EXPECT_EQ(HcfCipherSealInPlace(cipher, &packet), HCF_INVALID_PARAMS);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t SEEK_TEXT_LEN = 1000;
+static const uint32_t SEEK_READ_LEN = 300;
+/* out of order, so that the cipher also seeks backwards */
+static const uint64_t SEEK_OFFSETS[] = { 500, 1, 999, 16, 0, 17, 15, 1000, 128 };
+
+static int32_t CheckSeekRanges(HcfCipher *cipher, HcfSymKey *key, HcfParamsSpec *params,
+    const vector<uint8_t> &plainText, vector<uint8_t> &cipherText)
+{
+    int32_t ret = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, params);
+    if (ret != 0) {
+        return ret;
+    }
+    for (uint32_t i = 0; i < sizeof(SEEK_OFFSETS) / sizeof(SEEK_OFFSETS[0]); i++) {
+        uint32_t offset = (uint32_t)SEEK_OFFSETS[i];
+        uint32_t len = (SEEK_TEXT_LEN - offset < SEEK_READ_LEN) ? (SEEK_TEXT_LEN - offset) : SEEK_READ_LEN;
+        ret = HcfCipherSeek(cipher, offset);
+        if ((ret != 0) || (len == 0)) {
+            continue;
+        }
+        HcfBlob input = { .data = cipherText.data() + offset, .len = len };
+        HcfBlob output = {};
+        ret = cipher->update(cipher, &input, &output);
+        if ((ret == 0) && ((output.len != len) || (memcmp(output.data, plainText.data() + offset, len) != 0))) {
+            LOGE("range at %u does not match!", offset);
+            ret = -1;
+        }
+        HcfBlobDataFree(&output);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return ret;
+}
+
+static int32_t CheckSeek(HcfSymKey *key, uint32_t threadNum, HcfIvParamsSpec *ivSpec)
+{
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> plainText(SEEK_TEXT_LEN);
+    vector<uint8_t> cipherText;
+    for (uint32_t i = 0; i < SEEK_TEXT_LEN; i++) {
+        plainText[i] = (uint8_t)(i * 7);
+    }
+    int32_t ret = CreateCipherWithThreads("AES128|CTR|NoPadding", threadNum, &cipher);
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)ivSpec, plainText, 0, cipherText);
+    }
+    if (ret == 0) {
+        ret = CheckSeekRanges(cipher, key, (HcfParamsSpec *)ivSpec, plainText, cipherText);
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest099, TestSize.Level0)
+{
+    int ret = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+
+    ret = GenerateSymKey("AES128", &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckSeek(key, 1, &ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = CheckSeek(key, 4, &ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* the counter wraps around inside the message */
+    (void)memset_s(iv, sizeof(iv), 0xff, sizeof(iv));
+    iv[sizeof(iv) - 1] = 0xf0;
+    ret = CheckSeek(key, 1, &ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("AES128|CBC|NoPadding", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(HcfCipherSeek(cipher, 16), HCF_NOT_SUPPORT);
+    EXPECT_EQ(HcfCipherSeek(NULL, 16), HCF_INVALID_PARAMS);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    EXPECT_EQ(ret, 0);
+}
+
+static const uint32_t REKEY_TEXT_LEN = 50000;
+static const uint32_t REKEY_PAIR_NUM = 3;
+
+static int32_t RekeyMessage(const char *decName, HcfSymKey *oldKey, HcfParamsSpec *decParams, const char *encName,
+    HcfSymKey *newKey, HcfParamsSpec *encParams, vector<uint8_t> &input, vector<uint8_t> &output)
+{
+    HcfCipher *decryptor = NULL;
+    HcfCipher *encryptor = NULL;
+    output.assign(input.size() + 64, 0xff);
+    int32_t ret = HcfCipherCreate(decName, &decryptor);
+    if (ret == 0) {
+        ret = HcfCipherCreate(encName, &encryptor);
+    }
+    if (ret == 0) {
+        ret = decryptor->init(decryptor, DECRYPT_MODE, (HcfKey *)oldKey, decParams);
+    }
+    if (ret == 0) {
+        ret = encryptor->init(encryptor, ENCRYPT_MODE, (HcfKey *)newKey, encParams);
+    }
+    if (ret == 0) {
+        HcfBlob in = { .data = input.data(), .len = (uint32_t)input.size() };
+        HcfBlob out = { .data = output.data(), .len = (uint32_t)output.size() };
+        ret = HcfCipherRekey(decryptor, encryptor, &in, &out);
+        if (ret == 0) {
+            output.resize(out.len);
+        }
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)decryptor);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)encryptor);
+    return ret;
+}
+
+static int32_t RekeyInStripes(const char *cipherName, HcfSymKey *oldKey, HcfSymKey *newKey, HcfParamsSpec *params,
+    vector<uint8_t> &input, vector<uint8_t> &output)
+{
+    HcfCipher *decryptors[REKEY_PAIR_NUM] = { NULL };
+    HcfCipher *encryptors[REKEY_PAIR_NUM] = { NULL };
+    int32_t ret = 0;
+    for (uint32_t i = 0; (i < REKEY_PAIR_NUM) && (ret == 0); i++) {
+        ret = HcfCipherCreate(cipherName, &decryptors[i]);
+        if (ret == 0) {
+            ret = HcfCipherCreate(cipherName, &encryptors[i]);
+        }
+        if (ret == 0) {
+            ret = decryptors[i]->init(decryptors[i], DECRYPT_MODE, (HcfKey *)oldKey, params);
+        }
+        if (ret == 0) {
+            ret = encryptors[i]->init(encryptors[i], ENCRYPT_MODE, (HcfKey *)newKey, params);
+        }
+    }
+    if (ret == 0) {
+        output.assign(input.size(), 0);
+        HcfBlob in = { .data = input.data(), .len = (uint32_t)input.size() };
+        HcfBlob out = { .data = output.data(), .len = (uint32_t)output.size() };
+        ret = HcfCipherRekeyParallel(decryptors, encryptors, REKEY_PAIR_NUM, &in, &out);
+    }
+    for (uint32_t i = 0; i < REKEY_PAIR_NUM; i++) {
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)decryptors[i]);
+        OH_HCF_OBJ_DESTROY((HcfObjectBase *)encryptors[i]);
+    }
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest100, TestSize.Level0)
+{
+    HcfSymKey *oldKey = NULL;
+    HcfSymKey *newKey = NULL;
+    HcfCipher *cipher = NULL;
+    uint8_t iv[16] = {0};
+    uint8_t tag[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = 12;
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    vector<uint8_t> plainText(REKEY_TEXT_LEN);
+    for (uint32_t i = 0; i < REKEY_TEXT_LEN; i++) {
+        plainText[i] = (uint8_t)(i * 31);
+    }
+    vector<uint8_t> cbcText;
+    vector<uint8_t> gcmText;
+    vector<uint8_t> rekeyed;
+    ASSERT_EQ(GenerateSymKey("AES128", &oldKey), 0);
+    ASSERT_EQ(GenerateSymKey("AES256", &newKey), 0);
+    ASSERT_EQ(HcfCipherCreate("AES128|CBC|PKCS7", &cipher), 0);
+    ASSERT_EQ(AesCryptInChunks(cipher, ENCRYPT_MODE, oldKey, (HcfParamsSpec *)&ivSpec, plainText, 0, cbcText), 0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &cipher), 0);
+    ASSERT_EQ(AesCryptInChunks(cipher, ENCRYPT_MODE, newKey, (HcfParamsSpec *)&gcmSpec, plainText, 0, gcmText), 0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    cipher = NULL;
+
+    EXPECT_EQ(RekeyMessage("AES128|CBC|PKCS7", oldKey, (HcfParamsSpec *)&ivSpec, "AES256|GCM|NoPadding", newKey,
+        (HcfParamsSpec *)&gcmSpec, cbcText, rekeyed), 0);
+    EXPECT_EQ(rekeyed, gcmText);
+    /* the gcm decryptor takes the tag from its params */
+    (void)memcpy_s(tag, sizeof(tag), gcmText.data() + REKEY_TEXT_LEN, sizeof(tag));
+    gcmText.resize(REKEY_TEXT_LEN);
+    EXPECT_EQ(RekeyMessage("AES256|GCM|NoPadding", newKey, (HcfParamsSpec *)&gcmSpec, "AES128|CBC|PKCS7", oldKey,
+        (HcfParamsSpec *)&ivSpec, gcmText, rekeyed), 0);
+    EXPECT_EQ(rekeyed, cbcText);
+    /* the tag fails at the end, the re-encrypted plaintext written before is cleared */
+    gcmText[100] ^= 1;
+    EXPECT_NE(RekeyMessage("AES256|GCM|NoPadding", newKey, (HcfParamsSpec *)&gcmSpec, "AES128|CBC|PKCS7", oldKey,
+        (HcfParamsSpec *)&ivSpec, gcmText, rekeyed), 0);
+    EXPECT_EQ(vector<uint8_t>(rekeyed.begin(), rekeyed.begin() + REKEY_TEXT_LEN - 16),
+        vector<uint8_t>(REKEY_TEXT_LEN - 16, 0));
+
+    vector<uint8_t> ctrText;
+    vector<uint8_t> expect;
+    ASSERT_EQ(HcfCipherCreate("AES256|CTR|NoPadding", &cipher), 0);
+    ASSERT_EQ(AesCryptInChunks(cipher, ENCRYPT_MODE, newKey, (HcfParamsSpec *)&ivSpec, plainText, 0, ctrText), 0);
+    HcfSymKey *ctrKey = NULL;
+    ASSERT_EQ(GenerateSymKey("AES256", &ctrKey), 0);
+    ASSERT_EQ(AesCryptInChunks(cipher, ENCRYPT_MODE, ctrKey, (HcfParamsSpec *)&ivSpec, plainText, 0, expect), 0);
+    EXPECT_EQ(RekeyInStripes("AES256|CTR|NoPadding", newKey, ctrKey, (HcfParamsSpec *)&ivSpec, ctrText, rekeyed), 0);
+    EXPECT_EQ(rekeyed, expect);
+    /* cbc can not seek to a stripe */
+    EXPECT_EQ(RekeyInStripes("AES128|CBC|PKCS7", oldKey, oldKey, (HcfParamsSpec *)&ivSpec, cbcText, rekeyed),
+        HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)ctrKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)oldKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)newKey);
+}
+
+static const uint32_t ETM_TEXT_LEN = 40000;
+static const uint32_t ETM_AES256_KEY_LEN = 32;
+
+/* the reference of encrypt-then-mac: aes-cbc with the second key half, hmac of iv || ciphertext with the first */
+static int32_t EtmReference(const vector<uint8_t> &keyData, HcfIvParamsSpec *spec, const vector<uint8_t> &plainText,
+    vector<uint8_t> &output)
+{
+    HcfSymKey *macKey = NULL;
+    HcfSymKey *aesKey = NULL;
+    HcfCipher *cipher = NULL;
+    HcfMac *mac = NULL;
+    int32_t ret = ConvertSymKeyData("AES256", vector<uint8_t>(keyData.begin(), keyData.begin() + ETM_AES256_KEY_LEN),
+        &macKey);
+    if (ret == 0) {
+        ret = ConvertSymKeyData("AES256", vector<uint8_t>(keyData.begin() + ETM_AES256_KEY_LEN, keyData.end()),
+            &aesKey);
+    }
+    if (ret == 0) {
+        ret = HcfCipherCreate("AES256|CBC|PKCS7", &cipher);
+    }
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, ENCRYPT_MODE, aesKey, (HcfParamsSpec *)spec, plainText, 0, output);
+    }
+    if (ret == 0) {
+        ret = HcfMacCreate("SHA256", &mac);
+    }
+    if (ret == 0) {
+        ret = mac->init(mac, macKey);
+    }
+    HcfBlob tag = { .data = NULL, .len = 0 };
+    if (ret == 0) {
+        HcfBlob iv = { .data = spec->iv.data, .len = spec->iv.len };
+        HcfBlob cipherText = { .data = output.data(), .len = output.size() };
+        ret = mac->update(mac, &iv);
+        if (ret == 0) {
+            ret = mac->update(mac, &cipherText);
+        }
+    }
+    if (ret == 0) {
+        ret = mac->doFinal(mac, &tag);
+    }
+    if (ret == 0) {
+        output.insert(output.end(), tag.data, tag.data + tag.len);
+    }
+    HcfBlobDataFree(&tag);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)mac);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)macKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)aesKey);
+    return ret;
+}
+
+static int32_t EtmRoundTrip(const char *cipherName, HcfSymKey *key, HcfIvParamsSpec *spec,
+    const vector<uint8_t> &plainText, uint32_t chunkLen, vector<uint8_t> &cipherText)
+{
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> decrypted;
+    int32_t ret = HcfCipherCreate(cipherName, &cipher);
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)spec, plainText, chunkLen, cipherText);
+    }
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)spec, cipherText, chunkLen, decrypted);
+    }
+    if ((ret == 0) && (decrypted != plainText)) {
+        ret = -1;
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest101, TestSize.Level0)
+{
+    uint8_t iv[16] = { 0x5c };
+    HcfIvParamsSpec spec = {};
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    vector<uint8_t> keyData(ETM_AES256_KEY_LEN * 2);
+    for (uint32_t i = 0; i < keyData.size(); i++) {
+        keyData[i] = (uint8_t)(i * 7 + 1);
+    }
+    vector<uint8_t> plainText(ETM_TEXT_LEN);
+    for (uint32_t i = 0; i < ETM_TEXT_LEN; i++) {
+        plainText[i] = (uint8_t)(i * 13);
+    }
+    HcfSymKey *key = NULL;
+    ASSERT_EQ(ConvertSymKeyData("AES256|HMAC-SHA256", keyData, &key), 0);
+    EXPECT_STREQ(key->key.getAlgorithm((HcfKey *)key), "AES256|HMAC-SHA256");
+    vector<uint8_t> expect;
+    ASSERT_EQ(EtmReference(keyData, &spec, plainText, expect), 0);
+
+    /* one shot and in uneven updates, ciphertext || tag equals the two separate passes */
+    vector<uint8_t> cipherText;
+    EXPECT_EQ(EtmRoundTrip("AES256|CBC|PKCS7|HMAC-SHA256", key, &spec, plainText, 0, cipherText), 0);
+    EXPECT_EQ(cipherText, expect);
+    EXPECT_EQ(EtmRoundTrip("AES256|CBC|PKCS7|HMAC-SHA256", key, &spec, plainText, 1000, cipherText), 0);
+    EXPECT_EQ(cipherText, expect);
+    EXPECT_EQ(EtmRoundTrip("AES256|CTR|NoPadding|HMAC-SHA256", key, &spec, plainText, 777, cipherText), 0);
+    EXPECT_EQ(cipherText.size(), ETM_TEXT_LEN + 32);
+    EXPECT_EQ(EtmRoundTrip("AES256|CBC|PKCS7|HMAC-SHA256", key, &spec, vector<uint8_t>(), 0, cipherText), 0);
+
+    /* a flipped bit in the iv, the ciphertext or the tag fails before any plaintext is returned */
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> decrypted;
+    ASSERT_EQ(HcfCipherCreate("AES256|CBC|PKCS7|HMAC-SHA256", &cipher), 0);
+    expect[100] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, expect, 0, decrypted), 0);
+    expect[100] ^= 1;
+    expect[expect.size() - 1] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, expect, 4096, decrypted), 0);
+    EXPECT_TRUE(decrypted.empty());
+    expect[expect.size() - 1] ^= 1;
+    iv[0] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, expect, 0, decrypted), 0);
+    iv[0] ^= 1;
+    EXPECT_NE(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, vector<uint8_t>(16), 0,
+        decrypted), 0);
+    EXPECT_EQ(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, expect, 0, decrypted), 0);
+    EXPECT_EQ(decrypted, plainText);
+
+    /* a plain aes key, a missing iv and modes other than cbc and ctr are rejected */
+    HcfSymKey *aesKey = NULL;
+    ASSERT_EQ(GenerateSymKey("AES256", &aesKey), 0);
+    EXPECT_NE(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)aesKey, (HcfParamsSpec *)&spec), 0);
+    EXPECT_NE(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, NULL), 0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    cipher = NULL;
+    EXPECT_NE(HcfCipherCreate("AES256|GCM|NoPadding|HMAC-SHA256", &cipher), 0);
+    EXPECT_NE(HcfCipherCreate("3DES192|CBC|PKCS7|HMAC-SHA256", &cipher), 0);
+    HcfSymKeyGenerator *generator = NULL;
+    EXPECT_NE(HcfSymKeyGeneratorCreate("AES256|XTS|HMAC-SHA256", &generator), 0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)aesKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+/* a verify first gcm decrypt of every ciphertext length returns what the default path returns */
+static int32_t CheckGcmVerifyFirst(HcfSymKey *key, HcfGcmParamsSpec *spec, uint32_t threadNum, uint32_t textLen)
+{
+    vector<uint8_t> plainText(textLen);
+    for (uint32_t i = 0; i < textLen; i++) {
+        plainText[i] = (uint8_t)(i * 11 + 5);
+    }
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    int32_t ret = CreateCipherWithThreads("AES256|GCM|NoPadding", threadNum, &cipher);
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)spec, plainText, 0, cipherText);
+    }
+    if (ret == 0) {
+        (void)memcpy_s(spec->tag.data, spec->tag.len, cipherText.data() + textLen, spec->tag.len);
+        cipherText.resize(textLen);
+        ret = cipher->setCipherSpecUint(cipher, CIPHER_GCM_VERIFY_FIRST, 1);
+    }
+    if (ret == 0) {
+        ret = AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)spec, cipherText, 0, decrypted);
+    }
+    if ((ret == 0) && (decrypted != plainText)) {
+        LOGE("verify first decrypt of %u bytes differs", textLen);
+        ret = -1;
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest102, TestSize.Level0)
+{
+    uint8_t aad[13] = { 0x3c };
+    uint8_t tag[16] = { 0 };
+    uint8_t iv[12] = { 0x7e };
+    HcfGcmParamsSpec spec = {};
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    spec.tag.data = tag;
+    spec.tag.len = sizeof(tag);
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    HcfSymKey *key = NULL;
+    ASSERT_EQ(GenerateSymKey("AES256", &key), 0);
+
+    EXPECT_EQ(CheckGcmVerifyFirst(key, &spec, 1, PARALLEL_TEXT_LEN), 0);
+    EXPECT_EQ(CheckGcmVerifyFirst(key, &spec, PARALLEL_THREAD_NUM, PARALLEL_TEXT_LEN), 0);
+    EXPECT_EQ(CheckGcmVerifyFirst(key, &spec, PARALLEL_THREAD_NUM, 17), 0);
+    EXPECT_EQ(CheckGcmVerifyFirst(key, &spec, 1, 0), 0);
+    spec.aad.len = 0;
+    EXPECT_EQ(CheckGcmVerifyFirst(key, &spec, PARALLEL_THREAD_NUM, PARALLEL_TEXT_LEN), 0);
+    spec.aad.len = sizeof(aad);
+
+    /* a forged message fails before any byte of the caller buffer is written, none is allocated */
+    HcfCipher *cipher = NULL;
+    ASSERT_EQ(CreateCipherWithThreads("AES256|GCM|NoPadding", PARALLEL_THREAD_NUM, &cipher), 0);
+    vector<uint8_t> plainText(PARALLEL_TEXT_LEN, 0x21);
+    vector<uint8_t> cipherText;
+    ASSERT_EQ(AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, cipherText), 0);
+    (void)memcpy_s(tag, sizeof(tag), cipherText.data() + PARALLEL_TEXT_LEN, sizeof(tag));
+    cipherText.resize(PARALLEL_TEXT_LEN);
+    EXPECT_EQ(cipher->setCipherSpecUint(cipher, CIPHER_GCM_VERIFY_FIRST, 1), HCF_SUCCESS);
+    vector<uint8_t> buffer(PARALLEL_TEXT_LEN, 0xAA);
+    HcfBlob input = { .data = cipherText.data(), .len = PARALLEL_TEXT_LEN };
+    HcfBlob output = { .data = buffer.data(), .len = PARALLEL_TEXT_LEN };
+    tag[0] ^= 1;
+    EXPECT_EQ(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_NE(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(buffer, vector<uint8_t>(PARALLEL_TEXT_LEN, 0xAA));
+    tag[0] ^= 1;
+    cipherText[PARALLEL_TEXT_LEN - 1] ^= 1;
+    HcfBlob allocated = { .data = NULL, .len = 0 };
+    EXPECT_EQ(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_NE(cipher->doFinal(cipher, &input, &allocated), HCF_SUCCESS);
+    EXPECT_EQ(allocated.data, nullptr);
+    cipherText[PARALLEL_TEXT_LEN - 1] ^= 1;
+    /* the genuine message after a reset, in place over the ciphertext */
+    EXPECT_EQ(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_EQ(cipher->reset(cipher, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    cipherText.resize(PARALLEL_TEXT_LEN + sizeof(tag) * 2);
+    input.data = cipherText.data();
+    output.data = cipherText.data();
+    output.len = cipherText.size();
+    EXPECT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, PARALLEL_TEXT_LEN);
+    cipherText.resize(PARALLEL_TEXT_LEN);
+    EXPECT_EQ(cipherText, plainText);
+
+    /* updates before doFinal fall back to the default path, and the option is off unless set */
+    vector<uint8_t> decrypted;
+    ASSERT_EQ(AesCryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, cipherText), 0);
+    (void)memcpy_s(tag, sizeof(tag), cipherText.data() + PARALLEL_TEXT_LEN, sizeof(tag));
+    cipherText.resize(PARALLEL_TEXT_LEN);
+    EXPECT_EQ(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 1000, decrypted), 0);
+    EXPECT_EQ(decrypted, plainText);
+    EXPECT_EQ(cipher->setCipherSpecUint(cipher, CIPHER_GCM_VERIFY_FIRST, 0), HCF_SUCCESS);
+    EXPECT_EQ(AesCryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 0, decrypted), 0);
+    EXPECT_EQ(decrypted, plainText);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+/* seal plainText with a NoPadding or GCM cipher and open it into a caller buffer that fails, the buffer is wiped */
+static int32_t CheckFailedOpenWipes(const char *sealAlgo, const char *openAlgo, HcfSymKey *key, HcfParamsSpec *spec,
+    uint8_t *tag)
+{
+    HcfCipher *sealer = NULL;
+    HcfCipher *opener = NULL;
+    vector<uint8_t> plainText(64, 'A');
+    plainText.back() = 0; /* never a valid PKCS7 pad */
+    vector<uint8_t> sealed(plainText.size() + 32, 0);
+    vector<uint8_t> buffer(plainText.size() + 32, 0);
+    HcfBlob input = { .data = plainText.data(), .len = plainText.size() };
+    HcfBlob output = { .data = sealed.data(), .len = sealed.size() };
+    int32_t ret = -1;
+    if ((HcfCipherCreate(sealAlgo, &sealer) != HCF_SUCCESS) || (HcfCipherCreate(openAlgo, &opener) != HCF_SUCCESS) ||
+        (sealer->init(sealer, ENCRYPT_MODE, (HcfKey *)key, spec) != HCF_SUCCESS) ||
+        (sealer->doFinalToBuffer(sealer, &input, &output) != HCF_SUCCESS)) {
+        goto clearup;
+    }
+    if (tag != NULL) {
+        /* a forged tag */
+        (void)memcpy_s(tag, 16, sealed.data() + plainText.size(), 16);
+        tag[0] ^= 1;
+    }
+    input.data = sealed.data();
+    input.len = plainText.size();
+    output.data = buffer.data();
+    output.len = buffer.size();
+    if ((opener->init(opener, DECRYPT_MODE, (HcfKey *)key, spec) != HCF_SUCCESS) ||
+        (opener->doFinalToBuffer(opener, &input, &output) == HCF_SUCCESS)) {
+        goto clearup;
+    }
+    ret = ((output.len == 0) && (buffer == vector<uint8_t>(buffer.size(), 0))) ? 0 : -1;
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)sealer);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)opener);
+    return ret;
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest103, TestSize.Level0)
+{
+    uint8_t tag[16] = { 0 };
+    uint8_t iv[16] = { 0x7e };
+    HcfGcmParamsSpec gcmSpec = {};
+    gcmSpec.tag.data = tag;
+    gcmSpec.tag.len = sizeof(tag);
+    gcmSpec.iv.data = iv;
+    gcmSpec.iv.len = 12;
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    HcfSymKey *key = NULL;
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+
+    EXPECT_EQ(CheckFailedOpenWipes("AES128|GCM|NoPadding", "AES128|GCM|NoPadding", key, (HcfParamsSpec *)&gcmSpec,
+        tag), 0);
+    EXPECT_EQ(CheckFailedOpenWipes("AES128|CBC|NoPadding", "AES128|CBC|PKCS7", key, (HcfParamsSpec *)&ivSpec, NULL),
+        0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest104, TestSize.Level0)
+{
+    uint8_t tag[17] = { 0 };
+    uint8_t iv[12] = { 0x11 };
+    HcfGcmParamsSpec spec = {};
+    spec.tag.data = tag;
+    spec.tag.len = 16;
+    spec.iv.data = iv;
+    spec.iv.len = sizeof(iv);
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+    ASSERT_EQ(HcfCipherCreate("AES128|GCM|NoPadding", &cipher), HCF_SUCCESS);
+
+    /* every reset takes the iv and the tag of its own message */
+    vector<uint8_t> plainText(100, 0x42);
+    vector<vector<uint8_t>> sealed;
+    for (uint8_t i = 0; i < 3; i++) {
+        iv[0] = i;
+        vector<uint8_t> out(plainText.size() + 16 + 16, 0);
+        HcfBlob input = { .data = plainText.data(), .len = plainText.size() };
+        HcfBlob output = { .data = out.data(), .len = out.size() };
+        HcfResult ret = (i == 0) ? cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec) :
+            cipher->reset(cipher, (HcfParamsSpec *)&spec);
+        ASSERT_EQ(ret, HCF_SUCCESS);
+        ASSERT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+        out.resize(output.len);
+        sealed.push_back(out);
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        iv[0] = i;
+        (void)memcpy_s(tag, sizeof(tag), sealed[i].data() + plainText.size(), 16);
+        vector<uint8_t> out(plainText.size() + 16, 0);
+        HcfBlob input = { .data = sealed[i].data(), .len = plainText.size() };
+        HcfBlob output = { .data = out.data(), .len = out.size() };
+        HcfResult ret = (i == 0) ? cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec) :
+            cipher->reset(cipher, (HcfParamsSpec *)&spec);
+        ASSERT_EQ(ret, HCF_SUCCESS);
+        EXPECT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+        out.resize(output.len);
+        EXPECT_EQ(out, plainText);
+    }
+    /* the tag is kept inline, longer ones are rejected up front */
+    spec.tag.len = sizeof(tag);
+    EXPECT_NE(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest105, TestSize.Level0)
+{
+    AesBatchMessage msgs[BATCH_COUNT];
+    HcfCipherBatchItem items[BATCH_COUNT];
+    HcfCipherBatchParams params = { .tagLen = BATCH_TAG_LEN, .threadNum = 1 };
+    uint8_t iv[12] = { 0 };
+    uint8_t tag[16] = { 0 };
+    HcfCcmParamsSpec ccmSpec = {};
+    ccmSpec.iv.data = iv;
+    ccmSpec.iv.len = sizeof(iv);
+    ccmSpec.tag.data = tag;
+    ccmSpec.tag.len = sizeof(tag);
+    HcfSymKey *key = NULL;
+    HcfCipher *gcm = NULL;
+    HcfCipher *ccm = NULL;
+
+    /* a 128 bit key must not be expanded as a 256 bit one */
+    InitBatchMessages(msgs, items, BATCH_COUNT);
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+    ASSERT_EQ(HcfCipherCreate("AES256|GCM|NoPadding", &gcm), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("AES256|CCM|NoPadding", &ccm), HCF_SUCCESS);
+    EXPECT_EQ(HcfCipherSealBatch(gcm, (HcfKey *)key, &params, items, BATCH_COUNT), HCF_INVALID_PARAMS);
+    EXPECT_EQ(GcmEncryptOne(gcm, key, &items[1], &items[1].output), HCF_INVALID_PARAMS);
+    EXPECT_EQ(ccm->init(ccm, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ccmSpec), HCF_INVALID_PARAMS);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)gcm);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)ccm);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+/* SP 800-38C example 3: a 12 byte nonce, an 8 byte tag */
+static const char *CCM_COMPAT_KEY = "404142434445464748494a4b4c4d4e4f";
+static const char *CCM_COMPAT_NONCE = "101112131415161718191a1b";
+static const char *CCM_COMPAT_AAD = "000102030405060708090a0b0c0d0e0f10111213";
+static const char *CCM_COMPAT_PLAIN = "202122232425262728292a2b2c2d2e2f3031323334353637";
+static const uint32_t CCM_DEFAULT_NONCE_LEN = 7;
+
+static int32_t CcmCryptOneShot(HcfCipher *cipher, enum HcfCryptoMode mode, HcfSymKey *key,
+    const vector<uint8_t> &nonce, vector<uint8_t> &tag, const vector<uint8_t> &input, vector<uint8_t> &output)
+{
+    vector<uint8_t> aad = HexToBytes(CCM_COMPAT_AAD);
+    HcfCcmParamsSpec spec = {};
+    spec.iv.data = const_cast<uint8_t *>(nonce.data());
+    spec.iv.len = nonce.size();
+    spec.aad.data = aad.data();
+    spec.aad.len = aad.size();
+    spec.tag.data = tag.data();
+    spec.tag.len = tag.size();
+    return AesCryptInChunks(cipher, mode, key, (HcfParamsSpec *)&spec, input, 0, output);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest106, TestSize.Level0)
+{
+    vector<uint8_t> nonce = HexToBytes(CCM_COMPAT_NONCE);
+    vector<uint8_t> shortNonce(nonce.begin(), nonce.begin() + CCM_DEFAULT_NONCE_LEN);
+    vector<uint8_t> plainText = HexToBytes(CCM_COMPAT_PLAIN);
+    /* the single call ccm used to cut the nonce to its first 7 bytes and always made a 12 byte tag */
+    vector<uint8_t> oldOutput = HexToBytes("7162015bc051951e5918aeaf3c11f3d4ac363f8d5b6af3d34f32927dac49ab4146126adc");
+    /* now it uses the whole nonce and the tag length of the params */
+    vector<uint8_t> newOutput = HexToBytes("e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5b760fef45e76adf825ccd12c");
+    vector<uint8_t> nistOutput = HexToBytes("e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5484392fbc1b09951");
+    vector<uint8_t> tag(12, 0);
+    vector<uint8_t> shortTag(8, 0);
+    vector<uint8_t> output;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    ASSERT_EQ(ConvertSymKeyData("AES128", HexToBytes(CCM_COMPAT_KEY), &key), 0);
+    ASSERT_EQ(HcfCipherCreate("AES128|CCM|NoPadding", &cipher), HCF_SUCCESS);
+
+    EXPECT_EQ(CcmCryptOneShot(cipher, ENCRYPT_MODE, key, nonce, tag, plainText, output), 0);
+    EXPECT_EQ(output, newOutput);
+    EXPECT_EQ(CcmCryptOneShot(cipher, ENCRYPT_MODE, key, nonce, shortTag, plainText, output), 0);
+    EXPECT_EQ(output, nistOutput);
+    /* reset keeps the key but still takes the nonce and tag lengths of its params */
+    vector<uint8_t> aad = HexToBytes(CCM_COMPAT_AAD);
+    HcfCcmParamsSpec spec = {};
+    spec.iv = { .data = nonce.data(), .len = nonce.size() };
+    spec.aad = { .data = aad.data(), .len = aad.size() };
+    spec.tag = { .data = tag.data(), .len = tag.size() };
+    HcfBlob input = { .data = plainText.data(), .len = plainText.size() };
+    HcfBlob sealed = { .data = NULL, .len = 0 };
+    EXPECT_EQ(cipher->reset(cipher, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_EQ(cipher->doFinal(cipher, &input, &sealed), HCF_SUCCESS);
+    EXPECT_EQ(vector<uint8_t>(sealed.data, sealed.data + sealed.len), newOutput);
+    HcfBlobDataFree(&sealed);
+    /* the old output is still what the 7 byte prefix of the nonce gives */
+    EXPECT_EQ(CcmCryptOneShot(cipher, ENCRYPT_MODE, key, shortNonce, tag, plainText, output), 0);
+    EXPECT_EQ(output, oldOutput);
+
+    /* so data sealed before opens with the prefix, but no longer with the whole nonce */
+    vector<uint8_t> cipherText(oldOutput.begin(), oldOutput.begin() + plainText.size());
+    (void)memcpy_s(tag.data(), tag.size(), oldOutput.data() + plainText.size(), tag.size());
+    EXPECT_EQ(CcmCryptOneShot(cipher, DECRYPT_MODE, key, shortNonce, tag, cipherText, output), 0);
+    EXPECT_EQ(output, plainText);
+    EXPECT_NE(CcmCryptOneShot(cipher, DECRYPT_MODE, key, nonce, tag, cipherText, output), 0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest107, TestSize.Level0)
+{
+    uint8_t plainText[16] = "this is a test!";
+    uint8_t buffer[64] = {0};
+    uint8_t guard[64] = {0};
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    uint32_t outLen = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+    ASSERT_EQ(HcfCipherCreate("AES128|CBC|PKCS7", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+
+    /* the 15 bytes of the update stay in the cipher, the final flushes them with the padding block */
+    HcfBlob input = { .data = plainText, .len = 15 };
+    HcfBlob output = { .data = buffer, .len = sizeof(buffer) };
+    EXPECT_EQ(cipher->updateToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 0);
+    EXPECT_EQ(cipher->getOutputSize(cipher, 1, true, &outLen), HCF_SUCCESS);
+    EXPECT_GE(outLen, 32);
+    ASSERT_LE(outLen, sizeof(buffer));
+    (void)memset_s(buffer, sizeof(buffer), 0xa5, sizeof(buffer));
+    (void)memset_s(guard, sizeof(guard), 0xa5, sizeof(guard));
+    input = { .data = plainText + 15, .len = 1 };
+    output = { .data = buffer, .len = outLen };
+    EXPECT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 32);
+    EXPECT_EQ(memcmp(buffer + outLen, guard, sizeof(buffer) - outLen), 0);
+
+    /* the allocating final is sized the same way */
+    HcfBlob first = { .data = NULL, .len = 0 };
+    HcfBlob last = { .data = NULL, .len = 0 };
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    input = { .data = plainText, .len = 15 };
+    EXPECT_EQ(cipher->update(cipher, &input, &first), HCF_SUCCESS);
+    input = { .data = plainText + 15, .len = 1 };
+    EXPECT_EQ(cipher->doFinal(cipher, &input, &last), HCF_SUCCESS);
+    EXPECT_EQ(first.len + last.len, 32);
+    EXPECT_EQ(memcmp(last.data, buffer, last.len), 0);
+    HcfBlobDataFree(&first);
+    HcfBlobDataFree(&last);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+HWTEST_F(CryptoAesCipherTest, CryptoAesCipherTest108, TestSize.Level0)
+{
+    uint8_t plainText[16] = "this is a test!";
+    uint8_t buffer[96] = {0};
+    uint8_t guard[96] = {0};
+    uint8_t iv[16] = {0};
+    HcfIvParamsSpec ivSpec = {};
+    ivSpec.iv.data = iv;
+    ivSpec.iv.len = sizeof(iv);
+    uint32_t outLen = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    ASSERT_EQ(ConvertSymKeyData("AES128|HMAC-SHA256", vector<uint8_t>(32, 0x3c), &key), 0);
+    ASSERT_EQ(HcfCipherCreate("AES128|CBC|PKCS7|HMAC-SHA256", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+
+    /* the 15 bytes of the update stay in the cipher, the final flushes them with the padding block and the tag */
+    HcfBlob input = { .data = plainText, .len = 15 };
+    HcfBlob output = { .data = buffer, .len = sizeof(buffer) };
+    EXPECT_EQ(cipher->updateToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 0);
+    EXPECT_EQ(cipher->getOutputSize(cipher, 1, true, &outLen), HCF_SUCCESS);
+    EXPECT_GE(outLen, 64);
+    ASSERT_LE(outLen, sizeof(buffer));
+    (void)memset_s(buffer, sizeof(buffer), 0xa5, sizeof(buffer));
+    (void)memset_s(guard, sizeof(guard), 0xa5, sizeof(guard));
+    input = { .data = plainText + 15, .len = 1 };
+    output = { .data = buffer, .len = outLen };
+    EXPECT_EQ(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 64);
+    EXPECT_EQ(memcmp(buffer + outLen, guard, sizeof(buffer) - outLen), 0);
+
+    /* the allocating final is sized the same way */
+    HcfBlob first = { .data = NULL, .len = 0 };
+    HcfBlob last = { .data = NULL, .len = 0 };
+    ASSERT_EQ(cipher->reset(cipher, (HcfParamsSpec *)&ivSpec), HCF_SUCCESS);
+    input = { .data = plainText, .len = 15 };
+    EXPECT_EQ(cipher->update(cipher, &input, &first), HCF_SUCCESS);
+    input = { .data = plainText + 15, .len = 1 };
+    EXPECT_EQ(cipher->doFinal(cipher, &input, &last), HCF_SUCCESS);
+    EXPECT_EQ(first.len + last.len, 64);
+    EXPECT_EQ(memcmp(last.data, buffer, last.len), 0);
+    HcfBlobDataFree(&first);
+    HcfBlobDataFree(&last);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+}
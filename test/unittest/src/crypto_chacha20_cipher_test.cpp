@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "securec.h"
+
+#include "sym_key_generator.h"
+#include "cipher.h"
+#include "log.h"
+#include "memory.h"
+#include "detailed_gcm_params.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t CHACHA20_KEY_LEN = 32;
+constexpr uint32_t CHACHA20_IV_LEN = 12;
+constexpr uint32_t POLY1305_TAG_LEN = 16;
+
+/* RFC 8439 section 2.8.2 */
+const uint8_t RFC_KEY[CHACHA20_KEY_LEN] = {
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+const uint8_t RFC_IV[CHACHA20_IV_LEN] = {
+    0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+};
+const uint8_t RFC_AAD[] = { 0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7 };
+const char RFC_PLAIN_TEXT[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for "
+    "the future, sunscreen would be it.";
+const uint8_t RFC_CIPHER_TEXT[] = {
+    0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+    0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+    0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+    0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+    0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+    0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+    0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+    0x61, 0x16,
+    /* tag */
+    0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+};
+
+class CryptoChaCha20CipherTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void CryptoChaCha20CipherTest::SetUpTestCase() {}
+void CryptoChaCha20CipherTest::TearDownTestCase() {}
+
+void CryptoChaCha20CipherTest::SetUp() // add init here, this will be called before test.
+{
+}
+
+void CryptoChaCha20CipherTest::TearDown() // add destroy here, this will be called when test case done.
+{
+}
+
+static int32_t ConvertChaCha20Key(const uint8_t *keyData, HcfSymKey **key)
+{
+    HcfSymKeyGenerator *generator = NULL;
+    int32_t ret = HcfSymKeyGeneratorCreate("ChaCha20", &generator);
+    if (ret != 0) {
+        LOGE("HcfSymKeyGeneratorCreate failed!");
+        return ret;
+    }
+    HcfBlob keyBlob = {.data = const_cast<uint8_t *>(keyData), .len = CHACHA20_KEY_LEN};
+    ret = generator->convertSymKey(generator, &keyBlob, key);
+    if (ret != 0) {
+        LOGE("convertSymKey failed!");
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    return ret;
+}
+
+static void InitSpec(HcfGcmParamsSpec *spec, uint8_t *iv, uint8_t *aad, uint32_t aadLen, uint8_t *tag)
+{
+    spec->iv.data = iv;
+    spec->iv.len = CHACHA20_IV_LEN;
+    spec->aad.data = aad;
+    spec->aad.len = aadLen;
+    spec->tag.data = tag;
+    spec->tag.len = POLY1305_TAG_LEN;
+}
+
+/* feed input in chunkLen updates, chunkLen 0 passes the whole input to doFinal */
+static int32_t ChaCha20CryptInChunks(HcfCipher *cipher, enum HcfCryptoMode mode, HcfSymKey *key,
+    HcfParamsSpec *params, const vector<uint8_t> &input, uint32_t chunkLen, vector<uint8_t> &output)
+{
+    output.clear();
+    int32_t ret = (key == NULL) ? cipher->reset(cipher, params) : cipher->init(cipher, mode, (HcfKey *)key, params);
+    if (ret != 0) {
+        LOGE("init failed! %d", ret);
+        return ret;
+    }
+    uint32_t offset = 0;
+    while ((chunkLen != 0) && (offset < input.size())) {
+        uint32_t len = min<uint32_t>(chunkLen, input.size() - offset);
+        HcfBlob in = {.data = const_cast<uint8_t *>(input.data()) + offset, .len = len};
+        HcfBlob out = {.data = NULL, .len = 0};
+        ret = cipher->update(cipher, &in, &out);
+        if (ret != 0) {
+            LOGE("update failed! %d", ret);
+            return ret;
+        }
+        output.insert(output.end(), out.data, out.data + out.len);
+        HcfBlobDataFree(&out);
+        offset += len;
+    }
+    HcfBlob in = {.data = const_cast<uint8_t *>(input.data()) + offset, .len = input.size() - offset};
+    HcfBlob out = {.data = NULL, .len = 0};
+    ret = cipher->doFinal(cipher, &in, &out);
+    if (ret != 0) {
+        LOGE("doFinal failed! %d", ret);
+        return ret;
+    }
+    output.insert(output.end(), out.data, out.data + out.len);
+    HcfBlobDataFree(&out);
+    return 0;
+}
+
+HWTEST_F(CryptoChaCha20CipherTest, CryptoChaCha20CipherTest001, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[CHACHA20_IV_LEN] = {0};
+    uint8_t aad[sizeof(RFC_AAD)] = {0};
+    uint8_t tag[POLY1305_TAG_LEN] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> plainText(RFC_PLAIN_TEXT, RFC_PLAIN_TEXT + sizeof(RFC_PLAIN_TEXT) - 1);
+    vector<uint8_t> expect(RFC_CIPHER_TEXT, RFC_CIPHER_TEXT + sizeof(RFC_CIPHER_TEXT));
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    HcfGcmParamsSpec spec = {};
+    (void)memcpy_s(iv, sizeof(iv), RFC_IV, sizeof(RFC_IV));
+    (void)memcpy_s(aad, sizeof(aad), RFC_AAD, sizeof(RFC_AAD));
+    InitSpec(&spec, iv, aad, sizeof(aad), tag);
+
+    ret = ConvertChaCha20Key(RFC_KEY, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_STREQ(key->key.getAlgorithm((HcfKey *)key), "ChaCha20");
+    ret = HcfCipherCreate("ChaCha20|Poly1305", &cipher);
+    if (ret != 0) {
+        LOGE("HcfCipherCreate failed!");
+        goto clearup;
+    }
+    ret = ChaCha20CryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, cipherText);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(cipherText == expect);
+
+    (void)memcpy_s(tag, sizeof(tag), RFC_CIPHER_TEXT + plainText.size(), sizeof(tag));
+    expect.resize(plainText.size());
+    ret = ChaCha20CryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, expect, 0, decrypted);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(decrypted == plainText);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoChaCha20CipherTest, CryptoChaCha20CipherTest002, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[CHACHA20_IV_LEN] = {0};
+    uint8_t aad[sizeof(RFC_AAD)] = {0};
+    uint8_t tag[POLY1305_TAG_LEN] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> plainText(RFC_PLAIN_TEXT, RFC_PLAIN_TEXT + sizeof(RFC_PLAIN_TEXT) - 1);
+    vector<uint8_t> cipherText;
+    vector<uint8_t> decrypted;
+    HcfBlob aadHead = {.data = aad, .len = 5};
+    HcfBlob aadTail = {.data = aad + 5, .len = sizeof(aad) - 5};
+    HcfGcmParamsSpec spec = {};
+    (void)memcpy_s(iv, sizeof(iv), RFC_IV, sizeof(RFC_IV));
+    (void)memcpy_s(aad, sizeof(aad), RFC_AAD, sizeof(RFC_AAD));
+    InitSpec(&spec, iv, NULL, 0, tag);
+
+    ret = ConvertChaCha20Key(RFC_KEY, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("ChaCha20|Poly1305", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* aad streamed with updateAad and the text split over updates gives the rfc result */
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(cipher->updateAad(cipher, &aadHead), HCF_SUCCESS);
+    EXPECT_EQ(cipher->updateAad(cipher, &aadTail), HCF_SUCCESS);
+    for (uint32_t offset = 0; offset < plainText.size(); offset += 7) {
+        HcfBlob in = {.data = plainText.data() + offset, .len = min<uint32_t>(7, plainText.size() - offset)};
+        HcfBlob out = {.data = NULL, .len = 0};
+        ret = cipher->update(cipher, &in, &out);
+        if (ret != 0) {
+            goto clearup;
+        }
+        cipherText.insert(cipherText.end(), out.data, out.data + out.len);
+        HcfBlobDataFree(&out);
+    }
+    EXPECT_EQ(cipher->updateAad(cipher, &aadTail), HCF_INVALID_PARAMS);
+    {
+        HcfBlob out = {.data = NULL, .len = 0};
+        ret = cipher->doFinal(cipher, NULL, &out);
+        if (ret != 0) {
+            goto clearup;
+        }
+        cipherText.insert(cipherText.end(), out.data, out.data + out.len);
+        HcfBlobDataFree(&out);
+    }
+    EXPECT_EQ(cipherText.size(), sizeof(RFC_CIPHER_TEXT));
+    EXPECT_EQ(memcmp(cipherText.data(), RFC_CIPHER_TEXT, sizeof(RFC_CIPHER_TEXT)), 0);
+
+    /* a tampered ciphertext fails */
+    spec.aad.data = aad;
+    spec.aad.len = sizeof(aad);
+    (void)memcpy_s(tag, sizeof(tag), RFC_CIPHER_TEXT + plainText.size(), sizeof(tag));
+    cipherText.resize(plainText.size());
+    cipherText[0] ^= 1;
+    EXPECT_NE(ChaCha20CryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 16, decrypted), 0);
+    cipherText[0] ^= 1;
+    ret = ChaCha20CryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, cipherText, 16, decrypted);
+    EXPECT_TRUE(decrypted == plainText);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoChaCha20CipherTest, CryptoChaCha20CipherTest003, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[CHACHA20_IV_LEN] = {0};
+    uint8_t tag[POLY1305_TAG_LEN] = {0};
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    vector<uint8_t> plainText(1000, 0x42);
+    vector<uint8_t> empty;
+    vector<uint8_t> expect;
+    vector<uint8_t> output;
+    HcfGcmParamsSpec spec = {};
+    InitSpec(&spec, iv, NULL, 0, tag);
+
+    ret = ConvertChaCha20Key(RFC_KEY, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("ChaCha20|Poly1305", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = ChaCha20CryptInChunks(cipher, ENCRYPT_MODE, key, (HcfParamsSpec *)&spec, plainText, 0, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    /* reset with another nonce, then back: the keyed ctx gives the same result as init */
+    iv[0] = 1;
+    ret = ChaCha20CryptInChunks(cipher, ENCRYPT_MODE, NULL, (HcfParamsSpec *)&spec, plainText, 100, expect);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_FALSE(expect == output);
+    iv[0] = 0;
+    ret = ChaCha20CryptInChunks(cipher, ENCRYPT_MODE, NULL, (HcfParamsSpec *)&spec, plainText, 100, expect);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_TRUE(expect == output);
+
+    /* an empty message only carries the tag */
+    ret = ChaCha20CryptInChunks(cipher, ENCRYPT_MODE, NULL, (HcfParamsSpec *)&spec, empty, 0, output);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(output.size(), POLY1305_TAG_LEN);
+    (void)memcpy_s(tag, sizeof(tag), output.data(), POLY1305_TAG_LEN);
+    ret = ChaCha20CryptInChunks(cipher, DECRYPT_MODE, key, (HcfParamsSpec *)&spec, empty, 0, output);
+    EXPECT_TRUE(output.empty());
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoChaCha20CipherTest, CryptoChaCha20CipherTest004, TestSize.Level0)
+{
+    int ret = 0;
+    uint8_t iv[CHACHA20_IV_LEN] = {0};
+    uint8_t tag[POLY1305_TAG_LEN] = {0};
+    uint8_t plainText[100] = {0};
+    uint8_t cipherText[sizeof(plainText) + POLY1305_TAG_LEN] = {0};
+    uint32_t outLen = 0;
+    HcfSymKey *key = NULL;
+    HcfCipher *cipher = NULL;
+    HcfBlob input = {.data = plainText, .len = sizeof(plainText)};
+    HcfBlob output = {.data = cipherText, .len = sizeof(cipherText)};
+    HcfGcmParamsSpec spec = {};
+    InitSpec(&spec, iv, NULL, 0, tag);
+
+    ret = ConvertChaCha20Key(RFC_KEY, &key);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = HcfCipherCreate("ChaCha20|Poly1305", &cipher);
+    if (ret != 0) {
+        goto clearup;
+    }
+    ret = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec);
+    if (ret != 0) {
+        goto clearup;
+    }
+    EXPECT_EQ(cipher->getOutputSize(cipher, sizeof(plainText), false, &outLen), HCF_SUCCESS);
+    EXPECT_EQ(outLen, sizeof(plainText));
+    EXPECT_EQ(cipher->getOutputSize(cipher, sizeof(plainText), true, &outLen), HCF_SUCCESS);
+    EXPECT_EQ(outLen, sizeof(cipherText));
+    ret = cipher->doFinalToBuffer(cipher, &input, &output);
+    EXPECT_EQ(output.len, sizeof(cipherText));
+
+    /* a nonce other than 12 bytes, a tag over 16 bytes and the aes modes are rejected */
+    spec.iv.len = CHACHA20_IV_LEN - 1;
+    EXPECT_NE(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    spec.iv.len = CHACHA20_IV_LEN;
+    spec.tag.len = POLY1305_TAG_LEN + 1;
+    EXPECT_NE(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_NE(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)key, NULL), HCF_SUCCESS);
+
+clearup:
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+    EXPECT_EQ(ret, 0);
+}
+
+HWTEST_F(CryptoChaCha20CipherTest, CryptoChaCha20CipherTest005, TestSize.Level0)
+{
+    HcfCipher *cipher = NULL;
+    HcfSymKeyGenerator *generator = NULL;
+    HcfSymKey *aesKey = NULL;
+    uint8_t iv[CHACHA20_IV_LEN] = {0};
+    uint8_t tag[POLY1305_TAG_LEN] = {0};
+    HcfGcmParamsSpec spec = {};
+    InitSpec(&spec, iv, NULL, 0, tag);
+
+    EXPECT_NE(HcfCipherCreate("ChaCha20|GCM", &cipher), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherCreate("ChaCha20|Poly1305", &cipher), HCF_SUCCESS);
+    /* a 128 bit aes key is not a chacha20 key */
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES128", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->generateSymKey(generator, &aesKey), HCF_SUCCESS);
+    EXPECT_EQ(cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)aesKey, (HcfParamsSpec *)&spec), HCF_INVALID_PARAMS);
+    EXPECT_EQ(cipher->setCipherSpecUint(cipher, CIPHER_PARALLEL_THREAD_NUM, 2), HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)aesKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+}
+
+HWTEST_F(CryptoChaCha20CipherTest, CryptoChaCha20CipherTest006, TestSize.Level0)
+{
+    HcfCipher *cipher = NULL;
+    HcfSymKey *key = NULL;
+    uint8_t iv[CHACHA20_IV_LEN] = {0};
+    uint8_t tag[POLY1305_TAG_LEN] = {0};
+    (void)memcpy_s(iv, sizeof(iv), RFC_IV, sizeof(RFC_IV));
+    uint32_t textLen = sizeof(RFC_CIPHER_TEXT) - POLY1305_TAG_LEN;
+    (void)memcpy_s(tag, sizeof(tag), RFC_CIPHER_TEXT + textLen, POLY1305_TAG_LEN);
+    tag[0] ^= 1;
+    HcfGcmParamsSpec spec = {};
+    InitSpec(&spec, iv, const_cast<uint8_t *>(RFC_AAD), sizeof(RFC_AAD), tag);
+    ASSERT_EQ(ConvertChaCha20Key(RFC_KEY, &key), 0);
+    ASSERT_EQ(HcfCipherCreate("ChaCha20|Poly1305", &cipher), HCF_SUCCESS);
+
+    /* a forged tag leaves nothing of the plaintext in the caller's buffer */
+    vector<uint8_t> buffer(textLen, 0xA5);
+    HcfBlob input = {.data = const_cast<uint8_t *>(RFC_CIPHER_TEXT), .len = textLen};
+    HcfBlob output = {.data = buffer.data(), .len = buffer.size()};
+    ASSERT_EQ(cipher->init(cipher, DECRYPT_MODE, (HcfKey *)key, (HcfParamsSpec *)&spec), HCF_SUCCESS);
+    EXPECT_NE(cipher->doFinalToBuffer(cipher, &input, &output), HCF_SUCCESS);
+    EXPECT_EQ(output.len, 0);
+    EXPECT_EQ(buffer, vector<uint8_t>(textLen, 0));
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)cipher);
+}
+}
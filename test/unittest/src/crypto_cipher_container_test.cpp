@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "securec.h"
+
+#include "sym_key_generator.h"
+#include "cipher_container.h"
+#include "log.h"
+#include "memory.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace {
+constexpr uint32_t CHUNK_SIZE = 1000;
+constexpr uint32_t SEALED_CHUNK_LEN = CHUNK_SIZE + HCF_CONTAINER_CHUNK_OVERHEAD;
+/* empty, shorter than a chunk, around one chunk and more chunks than one batch call takes */
+constexpr uint32_t FILE_LENS[] = { 0, 1, 999, 1000, 1001, 5000, 64 * CHUNK_SIZE + 7, 130 * CHUNK_SIZE };
+
+class CryptoCipherContainerTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void CryptoCipherContainerTest::SetUpTestCase() {}
+void CryptoCipherContainerTest::TearDownTestCase() {}
+
+void CryptoCipherContainerTest::SetUp() // add init here, this will be called before test.
+{
+}
+
+void CryptoCipherContainerTest::TearDown() // add destroy here, this will be called when test case done.
+{
+}
+
+static int32_t GenerateSymKey(const char *algoName, HcfSymKey **key)
+{
+    HcfSymKeyGenerator *generator = NULL;
+    int32_t ret = HcfSymKeyGeneratorCreate(algoName, &generator);
+    if (ret != 0) {
+        LOGE("HcfSymKeyGeneratorCreate failed!");
+        return ret;
+    }
+    ret = generator->generateSymKey(generator, key);
+    if (ret != 0) {
+        LOGE("generateSymKey failed!");
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)generator);
+    return ret;
+}
+
+static vector<uint8_t> MakePlainText(uint32_t len)
+{
+    vector<uint8_t> plainText(len);
+    for (uint32_t i = 0; i < len; i++) {
+        plainText[i] = (uint8_t)(i * 13 + i / CHUNK_SIZE);
+    }
+    return plainText;
+}
+
+/* header || sealed chunks, sealed batchChunks chunks per call, 0 seals the whole file in one call */
+static int32_t SealFile(HcfCipherContainer *container, const vector<uint8_t> &plainText, uint32_t batchChunks,
+    vector<uint8_t> &sealed)
+{
+    sealed.assign(HCF_CONTAINER_HEADER_LEN, 0);
+    HcfBlob header = { .data = sealed.data(), .len = HCF_CONTAINER_HEADER_LEN };
+    int32_t ret = container->getHeader(container, &header);
+    uint32_t batchLen = (batchChunks == 0) ? (uint32_t)plainText.size() : (batchChunks * CHUNK_SIZE);
+    uint32_t offset = 0;
+    uint32_t chunk = 0;
+    while (ret == 0) {
+        uint32_t len = ((uint32_t)plainText.size() - offset > batchLen) ? batchLen :
+            ((uint32_t)plainText.size() - offset);
+        bool isLast = (offset + len == plainText.size());
+        vector<uint8_t> out(len + (len / CHUNK_SIZE + 1) * HCF_CONTAINER_CHUNK_OVERHEAD);
+        HcfBlob input = { .data = const_cast<uint8_t *>(plainText.data()) + offset, .len = len };
+        HcfBlob output = { .data = out.data(), .len = (uint32_t)out.size() };
+        ret = container->sealChunks(container, chunk, isLast, &input, &output);
+        if (ret != 0) {
+            break;
+        }
+        sealed.insert(sealed.end(), out.data(), out.data() + output.len);
+        offset += len;
+        chunk += len / CHUNK_SIZE;
+        if (isLast) {
+            break;
+        }
+    }
+    return ret;
+}
+
+/* load the container from the sealed file and open chunks [first, first + count) */
+static int32_t OpenRange(HcfSymKey *key, vector<uint8_t> &sealed, uint32_t first, uint32_t count,
+    vector<uint8_t> &plainText)
+{
+    HcfCipherContainer *container = NULL;
+    HcfBlob header = { .data = sealed.data(), .len = HCF_CONTAINER_HEADER_LEN };
+    uint32_t chunkCount = 0;
+    int32_t ret = HcfCipherContainerLoad(key, &header, 4, &container);
+    if (ret == 0) {
+        ret = container->getChunkCount(container, sealed.size(), &chunkCount);
+    }
+    if ((ret == 0) && (first + count > chunkCount)) {
+        ret = -1;
+    }
+    if (ret == 0) {
+        uint64_t begin = container->getChunkOffset(container, first);
+        uint64_t end = (first + count == chunkCount) ? sealed.size() : container->getChunkOffset(container,
+            first + count);
+        plainText.assign(count * CHUNK_SIZE, 0);
+        HcfBlob input = { .data = sealed.data() + begin, .len = (uint32_t)(end - begin) };
+        HcfBlob output = { .data = plainText.data(), .len = (uint32_t)plainText.size() };
+        ret = container->openChunks(container, first, first + count == chunkCount, &input, &output);
+        plainText.resize(output.len);
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    return ret;
+}
+
+HWTEST_F(CryptoCipherContainerTest, CryptoCipherContainerTest001, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfCipherContainer *container = NULL;
+    HcfCipherContainerParams params = { .chunkSize = CHUNK_SIZE, .threadNum = 4 };
+    ASSERT_EQ(GenerateSymKey("AES256", &key), 0);
+    ASSERT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_SUCCESS);
+    EXPECT_EQ(container->getChunkSize(container), CHUNK_SIZE);
+
+    for (uint32_t i = 0; i < sizeof(FILE_LENS) / sizeof(FILE_LENS[0]); i++) {
+        vector<uint8_t> plainText = MakePlainText(FILE_LENS[i]);
+        vector<uint8_t> sealed;
+        vector<uint8_t> opened;
+        uint32_t chunkCount = 0;
+        ASSERT_EQ(SealFile(container, plainText, 0, sealed), 0);
+        uint32_t expectChunks = (FILE_LENS[i] == 0) ? 1 : ((FILE_LENS[i] + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        EXPECT_EQ(sealed.size(), HCF_CONTAINER_HEADER_LEN + FILE_LENS[i] +
+            expectChunks * HCF_CONTAINER_CHUNK_OVERHEAD);
+        EXPECT_EQ(container->getChunkCount(container, sealed.size(), &chunkCount), HCF_SUCCESS);
+        EXPECT_EQ(chunkCount, expectChunks);
+        ASSERT_EQ(OpenRange(key, sealed, 0, chunkCount, opened), 0);
+        EXPECT_EQ(opened, plainText);
+    }
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+/* sealing in batches of chunks, with any number of threads, opens to the same file as one call */
+HWTEST_F(CryptoCipherContainerTest, CryptoCipherContainerTest002, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfCipherContainer *container = NULL;
+    HcfCipherContainer *serial = NULL;
+    HcfCipherContainerParams params = { .chunkSize = CHUNK_SIZE, .threadNum = 4 };
+    uint8_t headerData[HCF_CONTAINER_HEADER_LEN] = { 0 };
+    HcfBlob header = { .data = headerData, .len = sizeof(headerData) };
+    vector<uint8_t> plainText = MakePlainText(130 * CHUNK_SIZE + 77);
+    vector<uint8_t> whole;
+    vector<uint8_t> batched;
+    vector<uint8_t> serialSealed;
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+    ASSERT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_SUCCESS);
+    ASSERT_EQ(container->getHeader(container, &header), HCF_SUCCESS);
+    ASSERT_EQ(HcfCipherContainerLoad(key, &header, 1, &serial), HCF_SUCCESS);
+
+    vector<uint8_t> opened;
+    EXPECT_EQ(SealFile(container, plainText, 0, whole), 0);
+    EXPECT_EQ(SealFile(container, plainText, 3, batched), 0);
+    EXPECT_EQ(SealFile(serial, plainText, 7, serialSealed), 0);
+    EXPECT_EQ(whole.size(), batched.size());
+    EXPECT_EQ(whole.size(), serialSealed.size());
+    /* every seal draws new nonces */
+    EXPECT_NE(whole, batched);
+    ASSERT_EQ(OpenRange(key, batched, 0, 131, opened), 0);
+    EXPECT_EQ(opened, plainText);
+    ASSERT_EQ(OpenRange(key, serialSealed, 0, 131, opened), 0);
+    EXPECT_EQ(opened, plainText);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)serial);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+/* any chunk can be opened on its own */
+HWTEST_F(CryptoCipherContainerTest, CryptoCipherContainerTest003, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfCipherContainer *container = NULL;
+    HcfCipherContainerParams params = { .chunkSize = CHUNK_SIZE, .threadNum = 2 };
+    vector<uint8_t> plainText = MakePlainText(10 * CHUNK_SIZE + 300);
+    vector<uint8_t> sealed;
+    vector<uint8_t> opened;
+    ASSERT_EQ(GenerateSymKey("AES192", &key), 0);
+    ASSERT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_SUCCESS);
+    ASSERT_EQ(SealFile(container, plainText, 4, sealed), 0);
+
+    const uint32_t chunks[] = { 0, 5, 9, 10 };
+    for (uint32_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        uint32_t begin = chunks[i] * CHUNK_SIZE;
+        uint32_t len = (begin + CHUNK_SIZE > plainText.size()) ? ((uint32_t)plainText.size() - begin) : CHUNK_SIZE;
+        ASSERT_EQ(OpenRange(key, sealed, chunks[i], 1, opened), 0);
+        EXPECT_EQ(opened, vector<uint8_t>(plainText.begin() + begin, plainText.begin() + begin + len));
+    }
+    ASSERT_EQ(OpenRange(key, sealed, 3, 4, opened), 0);
+    EXPECT_EQ(opened, vector<uint8_t>(plainText.begin() + 3 * CHUNK_SIZE, plainText.begin() + 7 * CHUNK_SIZE));
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+/* changed, reordered and truncated containers do not open, and a failed open returns no plaintext */
+HWTEST_F(CryptoCipherContainerTest, CryptoCipherContainerTest004, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfCipherContainer *container = NULL;
+    HcfCipherContainerParams params = { .chunkSize = CHUNK_SIZE, .threadNum = 1 };
+    vector<uint8_t> plainText = MakePlainText(4 * CHUNK_SIZE + 10);
+    vector<uint8_t> sealed;
+    vector<uint8_t> opened;
+    ASSERT_EQ(GenerateSymKey("AES256", &key), 0);
+    ASSERT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_SUCCESS);
+    ASSERT_EQ(SealFile(container, plainText, 0, sealed), 0);
+
+    vector<uint8_t> changed = sealed;
+    changed[HCF_CONTAINER_HEADER_LEN + 2 * SEALED_CHUNK_LEN + 5] ^= 1;
+    EXPECT_NE(OpenRange(key, changed, 0, 5, opened), 0);
+    EXPECT_EQ(opened, vector<uint8_t>(opened.size(), 0));
+    /* the container id in the header */
+    changed = sealed;
+    changed[6] ^= 1;
+    EXPECT_NE(OpenRange(key, changed, 0, 1, opened), 0);
+    /* chunks 1 and 2 swapped */
+    changed = sealed;
+    (void)memcpy_s(changed.data() + HCF_CONTAINER_HEADER_LEN + SEALED_CHUNK_LEN, SEALED_CHUNK_LEN,
+        sealed.data() + HCF_CONTAINER_HEADER_LEN + 2 * SEALED_CHUNK_LEN, SEALED_CHUNK_LEN);
+    EXPECT_NE(OpenRange(key, changed, 1, 1, opened), 0);
+    /* the last chunk dropped, chunk 3 is not sealed as the last one */
+    changed.assign(sealed.begin(), sealed.begin() + HCF_CONTAINER_HEADER_LEN + 4 * SEALED_CHUNK_LEN);
+    EXPECT_NE(OpenRange(key, changed, 3, 1, opened), 0);
+    EXPECT_EQ(OpenRange(key, sealed, 3, 1, opened), 0);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+HWTEST_F(CryptoCipherContainerTest, CryptoCipherContainerTest005, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfSymKey *desKey = NULL;
+    HcfCipherContainer *container = NULL;
+    HcfCipherContainerParams params = { .chunkSize = 0, .threadNum = 1 };
+    uint8_t headerData[HCF_CONTAINER_HEADER_LEN] = { 0 };
+    HcfBlob header = { .data = headerData, .len = sizeof(headerData) };
+    uint8_t data[2 * SEALED_CHUNK_LEN] = { 0 };
+    HcfBlob input = { .data = data, .len = CHUNK_SIZE + 1 };
+    HcfBlob output = { .data = data, .len = sizeof(data) };
+    uint32_t count = 0;
+    ASSERT_EQ(GenerateSymKey("AES128", &key), 0);
+    ASSERT_EQ(GenerateSymKey("3DES192", &desKey), 0);
+
+    EXPECT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_INVALID_PARAMS);
+    params.chunkSize = HCF_CONTAINER_MAX_CHUNK_SIZE + 1;
+    EXPECT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_INVALID_PARAMS);
+    params.chunkSize = CHUNK_SIZE;
+    EXPECT_EQ(HcfCipherContainerCreate(desKey, &params, &container), HCF_NOT_SUPPORT);
+    EXPECT_EQ(HcfCipherContainerLoad(key, &header, 1, &container), HCF_INVALID_PARAMS);
+    ASSERT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_SUCCESS);
+
+    /* only the last call may end in a partial chunk */
+    EXPECT_EQ(container->sealChunks(container, 0, false, &input, &output), HCF_INVALID_PARAMS);
+    input.len = CHUNK_SIZE;
+    output.len = SEALED_CHUNK_LEN - 1;
+    EXPECT_EQ(container->sealChunks(container, 0, false, &input, &output), HCF_INVALID_PARAMS);
+    output.len = sizeof(data);
+    EXPECT_EQ(container->sealChunks(container, UINT32_MAX, true, &input, &output), HCF_SUCCESS);
+    input.len = 2 * CHUNK_SIZE;
+    EXPECT_EQ(container->sealChunks(container, UINT32_MAX, true, &input, &output), HCF_INVALID_PARAMS);
+    /* a sealed chunk is at least a nonce and a tag */
+    input.len = HCF_CONTAINER_CHUNK_OVERHEAD - 1;
+    EXPECT_EQ(container->openChunks(container, 0, true, &input, &output), HCF_INVALID_PARAMS);
+    EXPECT_EQ(container->getChunkCount(container, HCF_CONTAINER_HEADER_LEN + SEALED_CHUNK_LEN + 1, &count),
+        HCF_INVALID_PARAMS);
+    EXPECT_EQ(container->getChunkOffset(container, 2), HCF_CONTAINER_HEADER_LEN + 2 * SEALED_CHUNK_LEN);
+
+    ASSERT_EQ(container->getHeader(container, &header), HCF_SUCCESS);
+    headerData[4]++;
+    EXPECT_EQ(HcfCipherContainerLoad(key, &header, 1, &container), HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)desKey);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+
+static vector<uint8_t> ChunkNonce(HcfCipherContainer *container, const vector<uint8_t> &sealed, uint32_t chunk)
+{
+    uint64_t offset = container->getChunkOffset(container, chunk);
+    return vector<uint8_t>(sealed.begin() + offset, sealed.begin() + offset + HCF_CONTAINER_NONCE_LEN);
+}
+
+/* an append seals the short last chunk again, under a new nonce */
+HWTEST_F(CryptoCipherContainerTest, CryptoCipherContainerTest006, TestSize.Level0)
+{
+    HcfSymKey *key = NULL;
+    HcfCipherContainer *container = NULL;
+    HcfCipherContainer *appender = NULL;
+    HcfCipherContainerParams params = { .chunkSize = CHUNK_SIZE, .threadNum = 1 };
+    vector<uint8_t> plainText = MakePlainText(3 * CHUNK_SIZE + 500);
+    vector<uint8_t> first(plainText.begin(), plainText.begin() + 2 * CHUNK_SIZE + 100);
+    vector<uint8_t> sealed;
+    vector<uint8_t> opened;
+    ASSERT_EQ(GenerateSymKey("AES256", &key), 0);
+    ASSERT_EQ(HcfCipherContainerCreate(key, &params, &container), HCF_SUCCESS);
+    ASSERT_EQ(SealFile(container, first, 0, sealed), 0);
+    vector<uint8_t> oldNonce = ChunkNonce(container, sealed, 2);
+
+    /* load the file and seal everything from the short chunk 2 on again */
+    HcfBlob header = { .data = sealed.data(), .len = HCF_CONTAINER_HEADER_LEN };
+    ASSERT_EQ(HcfCipherContainerLoad(key, &header, 1, &appender), HCF_SUCCESS);
+    vector<uint8_t> tail(2 * SEALED_CHUNK_LEN);
+    HcfBlob input = { .data = plainText.data() + 2 * CHUNK_SIZE, .len = (uint32_t)plainText.size() - 2 * CHUNK_SIZE };
+    HcfBlob output = { .data = tail.data(), .len = (uint32_t)tail.size() };
+    ASSERT_EQ(appender->sealChunks(appender, 2, true, &input, &output), HCF_SUCCESS);
+    sealed.resize(container->getChunkOffset(container, 2));
+    sealed.insert(sealed.end(), tail.begin(), tail.begin() + output.len);
+    EXPECT_NE(ChunkNonce(container, sealed, 2), oldNonce);
+    EXPECT_NE(ChunkNonce(container, sealed, 2), ChunkNonce(container, sealed, 3));
+    ASSERT_EQ(OpenRange(key, sealed, 0, 4, opened), 0);
+    EXPECT_EQ(opened, plainText);
+
+    /* the same chunk sealed twice with the same data still gets two nonces */
+    vector<uint8_t> again(2 * SEALED_CHUNK_LEN);
+    output = { .data = again.data(), .len = (uint32_t)again.size() };
+    ASSERT_EQ(appender->sealChunks(appender, 2, true, &input, &output), HCF_SUCCESS);
+    EXPECT_NE(vector<uint8_t>(again.begin(), again.begin() + HCF_CONTAINER_NONCE_LEN),
+        vector<uint8_t>(tail.begin(), tail.begin() + HCF_CONTAINER_NONCE_LEN));
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)appender);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)container);
+    OH_HCF_OBJ_DESTROY((HcfObjectBase *)key);
+}
+}
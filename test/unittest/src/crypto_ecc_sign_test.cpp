@@ -18,6 +18,7 @@
 
 #include "asy_key_generator.h"
 #include "blob.h"
+#include "hcf_object_pool.h"
 #include "memory.h"
 #include "securec.h"
 #include "signature.h"
@@ -2813,4 +2814,84 @@ HWTEST_F(CryptoEccSignTest, CryptoEccSignTest928, TestSize.Level0)
     free(out.data);
     OH_HCF_OBJ_DESTROY(sign);
 }
+
+static bool SignAndVerify(HcfSign *sign, HcfKeyPair *keyPair)
+{
+    HcfBlob out = { .data = NULL, .len = 0 };
+    HcfVerify *verify = NULL;
+    bool ret = false;
+    if (sign->init(sign, NULL, keyPair->priKey) != HCF_SUCCESS) {
+        return false;
+    }
+    if (sign->sign(sign, &mockInput, &out) != HCF_SUCCESS) {
+        return false;
+    }
+    if (HcfVerifyCreate("ECC256|SHA256", &verify) == HCF_SUCCESS) {
+        ret = (verify->init(verify, NULL, keyPair->pubKey) == HCF_SUCCESS) &&
+            verify->verify(verify, &mockInput, &out);
+        OH_HCF_OBJ_DESTROY(verify);
+    }
+    HcfFree(out.data);
+    return ret;
+}
+
+HWTEST_F(CryptoEccSignTest, CryptoEccSignTest929, TestSize.Level0)
+{
+    HcfSign *sign = NULL;
+    HcfSign *pooled = NULL;
+    HcfBlob out = { .data = NULL, .len = 0 };
+
+    ASSERT_EQ(HcfSignPoolAcquire("ECC256|SHA256", &sign), HCF_SUCCESS);
+    EXPECT_TRUE(SignAndVerify(sign, ecc256KeyPair_));
+    HcfSignPoolRelease(sign);
+
+    // the pooled sign holds no private key until it is initialized again
+    ASSERT_EQ(HcfSignPoolAcquire("ECC256|SHA256", &pooled), HCF_SUCCESS);
+    EXPECT_EQ(pooled, sign);
+    EXPECT_STREQ(pooled->getAlgoName(pooled), "ECC256|SHA256");
+    EXPECT_NE(pooled->sign(pooled, &mockInput, &out), HCF_SUCCESS);
+    EXPECT_EQ(out.data, nullptr);
+    EXPECT_TRUE(SignAndVerify(pooled, ecc256KeyPair_));
+
+    HcfSignPoolRelease(pooled);
+    HcfObjectPoolClear();
+}
+
+HWTEST_F(CryptoEccSignTest, CryptoEccSignTest930, TestSize.Level0)
+{
+    uint8_t message[] = "header|body of the message|trailer";
+    HcfBlob signSegments[] = {
+        { .data = message, .len = 7 }, { .data = message + 7, .len = sizeof(message) - 8 }
+    };
+    HcfBlob verifySegments[] = {
+        { .data = message, .len = 3 }, { .data = NULL, .len = 0 }, { .data = message + 3, .len = 24 },
+        { .data = message + 27, .len = sizeof(message) - 28 }
+    };
+    HcfBlob whole = { .data = message, .len = sizeof(message) - 1 };
+    HcfBlob out = { .data = NULL, .len = 0 };
+    HcfSign *sign = NULL;
+    HcfVerify *verify = NULL;
+
+    ASSERT_EQ(HcfSignCreate("ECC256|SHA256", &sign), HCF_SUCCESS);
+    ASSERT_EQ(sign->init(sign, NULL, ecc256KeyPair_->priKey), HCF_SUCCESS);
+    ASSERT_EQ(HcfSignUpdateVec(sign, signSegments, 2), HCF_SUCCESS);
+    ASSERT_EQ(sign->sign(sign, NULL, &out), HCF_SUCCESS);
+
+    // signed as segments, verified as other segments and as one blob
+    ASSERT_EQ(HcfVerifyCreate("ECC256|SHA256", &verify), HCF_SUCCESS);
+    ASSERT_EQ(verify->init(verify, NULL, ecc256KeyPair_->pubKey), HCF_SUCCESS);
+    ASSERT_EQ(HcfVerifyUpdateVec(verify, verifySegments, sizeof(verifySegments) / sizeof(verifySegments[0])),
+        HCF_SUCCESS);
+    EXPECT_TRUE(verify->verify(verify, NULL, &out));
+    OH_HCF_OBJ_DESTROY(verify);
+    ASSERT_EQ(HcfVerifyCreate("ECC256|SHA256", &verify), HCF_SUCCESS);
+    ASSERT_EQ(verify->init(verify, NULL, ecc256KeyPair_->pubKey), HCF_SUCCESS);
+    EXPECT_TRUE(verify->verify(verify, &whole, &out));
+    EXPECT_NE(HcfSignUpdateVec(sign, signSegments, 0), HCF_SUCCESS);
+    EXPECT_NE(HcfVerifyUpdateVec((HcfVerify *)sign, signSegments, 2), HCF_SUCCESS);
+
+    HcfFree(out.data);
+    OH_HCF_OBJ_DESTROY(verify);
+    OH_HCF_OBJ_DESTROY(sign);
+}
 }
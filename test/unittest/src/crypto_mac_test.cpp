@@ -21,6 +21,7 @@
 #include "sym_key_generator.h"
 
 #include "log.h"
+#include "hcf_object_pool.h"
 #include "memory.h"
 
 using namespace std;
@@ -610,4 +611,188 @@ HWTEST_F(CryptoMacTest, CryptoFrameworkHmacAlgoTest005, TestSize.Level0)
     OH_HCF_OBJ_DESTROY(key);
     OH_HCF_OBJ_DESTROY(generator);
 }
-}
\ No newline at end of file
+
+HWTEST_F(CryptoMacTest, CryptoFrameworkHmacPoolTest001, TestSize.Level0)
+{
+    HcfMac *macObj = nullptr;
+    HcfMac *pooledObj = nullptr;
+    HcfSymKeyGenerator *generator = nullptr;
+    HcfSymKey *key = nullptr;
+    uint8_t testKey[] = "abcdefghijklmnop";
+    HcfBlob keyMaterialBlob = {.data = (uint8_t *)testKey, .len = 16};
+    uint8_t testData[] = "My test data";
+    HcfBlob inBlob = {.data = (uint8_t *)testData, .len = 12};
+    HcfBlob firstBlob = {.data = nullptr, .len = 0};
+    HcfBlob secondBlob = {.data = nullptr, .len = 0};
+
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES128", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->convertSymKey(generator, &keyMaterialBlob, &key), HCF_SUCCESS);
+    ASSERT_EQ(HcfMacPoolAcquire("SHA256", &macObj), HCF_SUCCESS);
+    EXPECT_EQ(macObj->init(macObj, key), HCF_SUCCESS);
+    EXPECT_EQ(macObj->update(macObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(macObj->doFinal(macObj, &firstBlob), HCF_SUCCESS);
+    HcfMacPoolRelease(macObj);
+    // the pooled mac has no key until it is initialized again
+    ASSERT_EQ(HcfMacPoolAcquire("SHA256", &pooledObj), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj, macObj);
+    EXPECT_NE(pooledObj->update(pooledObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->init(pooledObj, key), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->update(pooledObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->doFinal(pooledObj, &secondBlob), HCF_SUCCESS);
+    ASSERT_EQ(firstBlob.len, secondBlob.len);
+    EXPECT_EQ(memcmp(firstBlob.data, secondBlob.data, firstBlob.len), 0);
+
+    HcfBlobDataClearAndFree(&firstBlob);
+    HcfBlobDataClearAndFree(&secondBlob);
+    HcfMacPoolRelease(pooledObj);
+    HcfObjectPoolClear();
+    OH_HCF_OBJ_DESTROY(key);
+    OH_HCF_OBJ_DESTROY(generator);
+}
+
+HWTEST_F(CryptoMacTest, CryptoFrameworkHmacVecTest001, TestSize.Level0)
+{
+    HcfMac *macObj = nullptr;
+    HcfSymKeyGenerator *generator = nullptr;
+    HcfSymKey *key = nullptr;
+    uint8_t testKey[] = "abcdefghijklmnop";
+    HcfBlob keyMaterialBlob = {.data = (uint8_t *)testKey, .len = 16};
+    uint8_t testData[] = "header|body of the message|trailer";
+    HcfBlob wholeBlob = {.data = (uint8_t *)testData, .len = sizeof(testData) - 1};
+    HcfBlob segments[] = {
+        {.data = testData, .len = 7}, {.data = testData + 7, .len = 20}, {.data = nullptr, .len = 0},
+        {.data = testData + 27, .len = sizeof(testData) - 28}
+    };
+    HcfBlob wholeOut = {.data = nullptr, .len = 0};
+    HcfBlob vecOut = {.data = nullptr, .len = 0};
+
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES128", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->convertSymKey(generator, &keyMaterialBlob, &key), HCF_SUCCESS);
+    ASSERT_EQ(HcfMacCreate("SHA384", &macObj), HCF_SUCCESS);
+    EXPECT_EQ(macObj->init(macObj, key), HCF_SUCCESS);
+    EXPECT_EQ(macObj->update(macObj, &wholeBlob), HCF_SUCCESS);
+    EXPECT_EQ(macObj->doFinal(macObj, &wholeOut), HCF_SUCCESS);
+    EXPECT_EQ(macObj->init(macObj, key), HCF_SUCCESS);
+    EXPECT_EQ(HcfMacUpdateVec(macObj, segments, sizeof(segments) / sizeof(segments[0])), HCF_SUCCESS);
+    EXPECT_EQ(macObj->doFinal(macObj, &vecOut), HCF_SUCCESS);
+    ASSERT_EQ(wholeOut.len, vecOut.len);
+    EXPECT_EQ(memcmp(wholeOut.data, vecOut.data, wholeOut.len), 0);
+    EXPECT_NE(HcfMacUpdateVec(macObj, nullptr, 1), HCF_SUCCESS);
+
+    HcfBlobDataClearAndFree(&wholeOut);
+    HcfBlobDataClearAndFree(&vecOut);
+    OH_HCF_OBJ_DESTROY(macObj);
+    OH_HCF_OBJ_DESTROY(key);
+    OH_HCF_OBJ_DESTROY(generator);
+}
+
+HWTEST_F(CryptoMacTest, CryptoFrameworkHmacSha3Blake2Test001, TestSize.Level0)
+{
+    const struct {
+        const char *algoName;
+        const char *macHex;
+    } vectors[] = {
+        { "SHA3-256", "681b40063f08b0097ec1aa17de4e2cd4f106b84e5305a953282a4c4f3ddb938c" },
+        { "SHA3-512", "ad5eca11c4fcf8924b5136b8e9ade04db5bc3c28cf34cf0edee1e690a34ecd04"
+            "e9c356cf6b727d81f444d141d19048d237819f1722e034cf0a2f5b9edfac3fae" },
+        { "BLAKE2b512", "77d6060d395c5293d164d5f0494f3233568477eca8b217866beb713899d0c651"
+            "ee66fc622eb3ae66ddd808e878ba2dae7a7af7c1f1de82f7add138ca3315bef1" },
+        { "BLAKE2s256", "e234f0fde52531cf17b144339352a34d740de894fda001892d71b07d56975deb" },
+    };
+    HcfSymKeyGenerator *generator = nullptr;
+    HcfSymKey *key = nullptr;
+    uint8_t testKey[] = "abcdefghijklmnop";
+    HcfBlob keyMaterialBlob = {.data = (uint8_t *)testKey, .len = 16};
+    uint8_t testData[] = "My test data";
+    HcfBlob inBlob = {.data = (uint8_t *)testData, .len = 12};
+
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES128", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->convertSymKey(generator, &keyMaterialBlob, &key), HCF_SUCCESS);
+    for (const auto &item : vectors) {
+        HcfMac *macObj = nullptr;
+        HcfBlob outBlob = {.data = nullptr, .len = 0};
+        ASSERT_EQ(HcfMacCreate(item.algoName, &macObj), HCF_SUCCESS);
+        EXPECT_EQ(macObj->init(macObj, key), HCF_SUCCESS);
+        EXPECT_EQ(macObj->update(macObj, &inBlob), HCF_SUCCESS);
+        EXPECT_EQ(macObj->doFinal(macObj, &outBlob), HCF_SUCCESS);
+        EXPECT_EQ(macObj->getMacLength(macObj), strlen(item.macHex) / 2);
+        string macHex;
+        char byteHex[3] = { 0 };
+        for (uint32_t i = 0; i < outBlob.len; i++) {
+            (void)sprintf_s(byteHex, sizeof(byteHex), "%02x", outBlob.data[i]);
+            macHex += byteHex;
+        }
+        EXPECT_EQ(macHex, item.macHex) << item.algoName;
+        HcfBlobDataClearAndFree(&outBlob);
+        OH_HCF_OBJ_DESTROY(macObj);
+    }
+    // hmac is not defined over an extendable output function
+    HcfMac *shakeObj = nullptr;
+    EXPECT_EQ(HcfMacCreate("SHAKE128", &shakeObj), HCF_NOT_SUPPORT);
+
+    OH_HCF_OBJ_DESTROY(key);
+    OH_HCF_OBJ_DESTROY(generator);
+}
+
+HWTEST_F(CryptoMacTest, CryptoFrameworkHmacCloneTest001, TestSize.Level0)
+{
+    HcfMac *prefixObj = nullptr;
+    HcfMac *cloneObj = nullptr;
+    HcfMac *wholeObj = nullptr;
+    HcfSymKeyGenerator *generator = nullptr;
+    HcfSymKey *key = nullptr;
+    uint8_t testKey[] = "abcdefghijklmnop";
+    HcfBlob keyMaterialBlob = {.data = (uint8_t *)testKey, .len = 16};
+    uint8_t testData[] = "canonical header|body";
+    HcfBlob headerBlob = {.data = testData, .len = 17};
+    HcfBlob bodyBlob = {.data = testData + 17, .len = 4};
+    HcfBlob wholeBlob = {.data = testData, .len = 21};
+    HcfBlob cloneOut = {.data = nullptr, .len = 0};
+    HcfBlob wholeOut = {.data = nullptr, .len = 0};
+
+    ASSERT_EQ(HcfSymKeyGeneratorCreate("AES128", &generator), HCF_SUCCESS);
+    ASSERT_EQ(generator->convertSymKey(generator, &keyMaterialBlob, &key), HCF_SUCCESS);
+    ASSERT_EQ(HcfMacCreate("SHA256", &wholeObj), HCF_SUCCESS);
+    EXPECT_EQ(wholeObj->init(wholeObj, key), HCF_SUCCESS);
+    EXPECT_EQ(wholeObj->update(wholeObj, &wholeBlob), HCF_SUCCESS);
+    EXPECT_EQ(wholeObj->doFinal(wholeObj, &wholeOut), HCF_SUCCESS);
+
+    // the clone carries the key and the header, the original is untouched by the clone's updates
+    ASSERT_EQ(HcfMacCreate("SHA256", &prefixObj), HCF_SUCCESS);
+    EXPECT_EQ(prefixObj->init(prefixObj, key), HCF_SUCCESS);
+    EXPECT_EQ(prefixObj->update(prefixObj, &headerBlob), HCF_SUCCESS);
+    ASSERT_EQ(prefixObj->clone(prefixObj, &cloneObj), HCF_SUCCESS);
+    EXPECT_EQ(cloneObj->update(cloneObj, &bodyBlob), HCF_SUCCESS);
+    EXPECT_EQ(cloneObj->update(cloneObj, &bodyBlob), HCF_SUCCESS);
+    EXPECT_EQ(prefixObj->update(prefixObj, &bodyBlob), HCF_SUCCESS);
+    EXPECT_EQ(prefixObj->doFinal(prefixObj, &cloneOut), HCF_SUCCESS);
+    ASSERT_EQ(cloneOut.len, wholeOut.len);
+    EXPECT_EQ(memcmp(cloneOut.data, wholeOut.data, wholeOut.len), 0);
+    HcfBlobDataClearAndFree(&cloneOut);
+    EXPECT_EQ(cloneObj->doFinal(cloneObj, &cloneOut), HCF_SUCCESS);
+    ASSERT_EQ(cloneOut.len, wholeOut.len);
+    EXPECT_NE(memcmp(cloneOut.data, wholeOut.data, wholeOut.len), 0);
+    HcfBlobDataClearAndFree(&cloneOut);
+    OH_HCF_OBJ_DESTROY(cloneObj);
+    OH_HCF_OBJ_DESTROY(prefixObj);
+
+    // a clone of a mac without a key needs its own init
+    ASSERT_EQ(HcfMacCreate("SHA256", &prefixObj), HCF_SUCCESS);
+    ASSERT_EQ(prefixObj->clone(prefixObj, &cloneObj), HCF_SUCCESS);
+    EXPECT_NE(cloneObj->update(cloneObj, &wholeBlob), HCF_SUCCESS);
+    EXPECT_EQ(cloneObj->init(cloneObj, key), HCF_SUCCESS);
+    EXPECT_EQ(cloneObj->update(cloneObj, &wholeBlob), HCF_SUCCESS);
+    EXPECT_EQ(cloneObj->doFinal(cloneObj, &cloneOut), HCF_SUCCESS);
+    ASSERT_EQ(cloneOut.len, wholeOut.len);
+    EXPECT_EQ(memcmp(cloneOut.data, wholeOut.data, wholeOut.len), 0);
+    EXPECT_NE(prefixObj->clone(prefixObj, nullptr), HCF_SUCCESS);
+
+    HcfBlobDataClearAndFree(&cloneOut);
+    HcfBlobDataClearAndFree(&wholeOut);
+    OH_HCF_OBJ_DESTROY(cloneObj);
+    OH_HCF_OBJ_DESTROY(prefixObj);
+    OH_HCF_OBJ_DESTROY(wholeObj);
+    OH_HCF_OBJ_DESTROY(key);
+    OH_HCF_OBJ_DESTROY(generator);
+}
+}
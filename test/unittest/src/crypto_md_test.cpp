@@ -14,11 +14,15 @@
  */
 
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 #include "securec.h"
 
 #include "md.h"
 
+#include "config.h"
 #include "log.h"
+#include "hcf_object_pool.h"
 #include "memory.h"
 
 using namespace std;
@@ -411,4 +415,417 @@ HWTEST_F(CryptoMdTest, CryptoFrameworkMdAlgoTest006, TestSize.Level0)
     HcfBlobDataClearAndFree(&outBlob);
     OH_HCF_OBJ_DESTROY(mdObj);
 }
-}
\ No newline at end of file
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdPoolTest001, TestSize.Level0)
+{
+    HcfMd *mdObj = nullptr;
+    HcfMd *pooledObj = nullptr;
+    uint8_t testData[] = "My test data";
+    uint8_t otherData[] = "unfinished";
+    HcfBlob inBlob = {.data = (uint8_t *)testData, .len = 12};
+    HcfBlob otherBlob = {.data = (uint8_t *)otherData, .len = 10};
+    HcfBlob firstBlob = {.data = nullptr, .len = 0};
+    HcfBlob secondBlob = {.data = nullptr, .len = 0};
+
+    ASSERT_EQ(HcfMdPoolAcquire("SHA256", &mdObj), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->update(mdObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->doFinal(mdObj, &firstBlob), HCF_SUCCESS);
+    // released in the middle of a message, the pooled md starts over
+    EXPECT_EQ(mdObj->update(mdObj, &otherBlob), HCF_SUCCESS);
+    HcfMdPoolRelease(mdObj);
+    ASSERT_EQ(HcfMdPoolAcquire("SHA256", &pooledObj), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj, mdObj);
+    EXPECT_STREQ(pooledObj->getAlgoName(pooledObj), "SHA256");
+    EXPECT_EQ(pooledObj->update(pooledObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->doFinal(pooledObj, &secondBlob), HCF_SUCCESS);
+    ASSERT_EQ(firstBlob.len, secondBlob.len);
+    EXPECT_EQ(memcmp(firstBlob.data, secondBlob.data, firstBlob.len), 0);
+
+    HcfBlobDataClearAndFree(&firstBlob);
+    HcfBlobDataClearAndFree(&secondBlob);
+    HcfMdPoolRelease(pooledObj);
+    EXPECT_NE(HcfMdPoolAcquire("SHA0", &mdObj), HCF_SUCCESS);
+    HcfObjectPoolClear();
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdVecTest001, TestSize.Level0)
+{
+    HcfMd *mdObj = nullptr;
+    uint8_t testData[] = "header|body of the message|trailer";
+    HcfBlob wholeBlob = {.data = (uint8_t *)testData, .len = sizeof(testData) - 1};
+    HcfBlob segments[] = {
+        {.data = testData, .len = 7}, {.data = nullptr, .len = 0}, {.data = testData + 7, .len = 20},
+        {.data = testData + 27, .len = sizeof(testData) - 28}
+    };
+    HcfBlob badSegments[] = { {.data = testData, .len = 7}, {.data = nullptr, .len = 3} };
+    HcfBlob wholeOut = {.data = nullptr, .len = 0};
+    HcfBlob vecOut = {.data = nullptr, .len = 0};
+
+    ASSERT_EQ(HcfMdCreate("SHA256", &mdObj), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->update(mdObj, &wholeBlob), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->doFinal(mdObj, &wholeOut), HCF_SUCCESS);
+    OH_HCF_OBJ_DESTROY(mdObj);
+    ASSERT_EQ(HcfMdCreate("SHA256", &mdObj), HCF_SUCCESS);
+    EXPECT_EQ(HcfMdUpdateVec(mdObj, segments, sizeof(segments) / sizeof(segments[0])), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->doFinal(mdObj, &vecOut), HCF_SUCCESS);
+    ASSERT_EQ(wholeOut.len, vecOut.len);
+    EXPECT_EQ(memcmp(wholeOut.data, vecOut.data, wholeOut.len), 0);
+    EXPECT_NE(HcfMdUpdateVec(mdObj, badSegments, 2), HCF_SUCCESS);
+    EXPECT_NE(HcfMdUpdateVec(mdObj, segments, 0), HCF_SUCCESS);
+    EXPECT_NE(HcfMdUpdateVec(nullptr, segments, 1), HCF_SUCCESS);
+
+    HcfBlobDataClearAndFree(&wholeOut);
+    HcfBlobDataClearAndFree(&vecOut);
+    OH_HCF_OBJ_DESTROY(mdObj);
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdResetTest001, TestSize.Level0)
+{
+    HcfMd *mdObj = nullptr;
+    HcfMd *freshObj = nullptr;
+    uint8_t testData[] = "My test data";
+    uint8_t otherData[] = "abandoned";
+    HcfBlob inBlob = {.data = (uint8_t *)testData, .len = 12};
+    HcfBlob otherBlob = {.data = (uint8_t *)otherData, .len = 9};
+    HcfBlob expectBlob = {.data = nullptr, .len = 0};
+    HcfBlob outBlob = {.data = nullptr, .len = 0};
+
+    ASSERT_EQ(HcfMdCreate("SHA512", &freshObj), HCF_SUCCESS);
+    EXPECT_EQ(freshObj->update(freshObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(freshObj->doFinal(freshObj, &expectBlob), HCF_SUCCESS);
+    OH_HCF_OBJ_DESTROY(freshObj);
+
+    // every doFinal starts the next message, one md hashes any number of them
+    ASSERT_EQ(HcfMdCreate("SHA512", &mdObj), HCF_SUCCESS);
+    for (uint32_t i = 0; i < 3; i++) {
+        EXPECT_EQ(mdObj->update(mdObj, &inBlob), HCF_SUCCESS);
+        EXPECT_EQ(mdObj->doFinal(mdObj, &outBlob), HCF_SUCCESS);
+        ASSERT_EQ(outBlob.len, expectBlob.len);
+        EXPECT_EQ(memcmp(outBlob.data, expectBlob.data, expectBlob.len), 0);
+        HcfBlobDataClearAndFree(&outBlob);
+    }
+    // reset drops a message in the middle
+    EXPECT_EQ(mdObj->update(mdObj, &otherBlob), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->reset(mdObj), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->update(mdObj, &inBlob), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->doFinal(mdObj, &outBlob), HCF_SUCCESS);
+    ASSERT_EQ(outBlob.len, expectBlob.len);
+    EXPECT_EQ(memcmp(outBlob.data, expectBlob.data, expectBlob.len), 0);
+    HcfBlobDataClearAndFree(&outBlob);
+    EXPECT_EQ(mdObj->reset(mdObj), HCF_SUCCESS);
+    EXPECT_NE(mdObj->reset(nullptr), HCF_SUCCESS);
+
+    HcfBlobDataClearAndFree(&expectBlob);
+    OH_HCF_OBJ_DESTROY(mdObj);
+}
+
+static const uint32_t DIGEST_MANY_NUM = 5;
+
+// every message of a batch hashes to what a md object gives for it alone
+static int32_t CheckDigestMany(const char *algoName)
+{
+    const uint32_t lens[DIGEST_MANY_NUM] = { 0, 1, 55, 64, 1000 };
+    uint8_t outBuf[DIGEST_MANY_NUM][64] = { { 0 } };
+    HcfBlob inputs[DIGEST_MANY_NUM];
+    HcfBlob outputs[DIGEST_MANY_NUM];
+    for (uint32_t i = 0; i < DIGEST_MANY_NUM; i++) {
+        inputs[i].data = (lens[i] == 0) ? nullptr : (uint8_t *)g_testBigData + i;
+        inputs[i].len = lens[i];
+        outputs[i].data = outBuf[i];
+        outputs[i].len = sizeof(outBuf[i]);
+    }
+    if (HcfMdDigestMany(algoName, inputs, outputs, DIGEST_MANY_NUM) != HCF_SUCCESS) {
+        return -1;
+    }
+    HcfMd *mdObj = nullptr;
+    if (HcfMdCreate(algoName, &mdObj) != HCF_SUCCESS) {
+        return -1;
+    }
+    int32_t ret = 0;
+    for (uint32_t i = 0; (ret == 0) && (i < DIGEST_MANY_NUM); i++) {
+        HcfBlob expect = {.data = nullptr, .len = 0};
+        if ((lens[i] > 0) && (mdObj->update(mdObj, &inputs[i]) != HCF_SUCCESS)) {
+            ret = -1;
+        }
+        if ((ret == 0) && (mdObj->doFinal(mdObj, &expect) != HCF_SUCCESS)) {
+            ret = -1;
+        }
+        if ((ret == 0) && ((outputs[i].len != expect.len) || (memcmp(outputs[i].data, expect.data, expect.len) != 0))) {
+            LOGE("%s message %u differs", algoName, i);
+            ret = -1;
+        }
+        HcfBlobDataClearAndFree(&expect);
+    }
+    OH_HCF_OBJ_DESTROY(mdObj);
+    return ret;
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdDigestManyTest001, TestSize.Level0)
+{
+    // SHA-2 runs in the plugin batch, the others on one md per batch
+    EXPECT_EQ(CheckDigestMany("SHA224"), 0);
+    EXPECT_EQ(CheckDigestMany("SHA256"), 0);
+    EXPECT_EQ(CheckDigestMany("SHA384"), 0);
+    EXPECT_EQ(CheckDigestMany("SHA512"), 0);
+    EXPECT_EQ(CheckDigestMany("SHA1"), 0);
+    EXPECT_EQ(CheckDigestMany("MD5"), 0);
+
+    uint8_t testData[] = "My test data";
+    uint8_t outBuf[2][32] = { { 0 } };
+    HcfBlob inputs[2] = { {.data = testData, .len = 12}, {.data = testData, .len = 12} };
+    HcfBlob outputs[2] = { {.data = outBuf[0], .len = 32}, {.data = outBuf[1], .len = 31} };
+    EXPECT_EQ(HcfMdDigestMany("SHA256", inputs, outputs, 2), HCF_INVALID_PARAMS);
+    EXPECT_EQ(HcfMdDigestMany("SHA512", inputs, outputs, 1), HCF_INVALID_PARAMS);
+    EXPECT_EQ(HcfMdDigestMany("MD5", inputs, outputs, 2), HCF_SUCCESS);
+    EXPECT_EQ(HcfMdDigestMany("SHA3", inputs, outputs, 2), HCF_NOT_SUPPORT);
+    EXPECT_EQ(HcfMdDigestMany("SHA256", inputs, outputs, 0), HCF_INVALID_PARAMS);
+    EXPECT_EQ(HcfMdDigestMany("SHA256", inputs, nullptr, 1), HCF_INVALID_PARAMS);
+    inputs[1].data = nullptr;
+    EXPECT_EQ(HcfMdDigestMany("SHA256", inputs, outputs, 2), HCF_INVALID_PARAMS);
+}
+
+// sha256(prefix || a || b) with a plain SHA256 md
+static vector<uint8_t> PrefixedSha256(HcfMd *sha, uint8_t prefix, const uint8_t *a, size_t aLen, const uint8_t *b,
+    size_t bLen)
+{
+    HcfBlob parts[] = { {.data = &prefix, .len = 1}, {.data = (uint8_t *)a, .len = aLen},
+        {.data = (uint8_t *)b, .len = bLen} };
+    HcfBlob out = {.data = nullptr, .len = 0};
+    vector<uint8_t> digest;
+    if ((HcfMdUpdateVec(sha, parts, 3) == HCF_SUCCESS) && (sha->doFinal(sha, &out) == HCF_SUCCESS)) {
+        digest.assign(out.data, out.data + out.len);
+    }
+    HcfBlobDataFree(&out);
+    return digest;
+}
+
+// MTH of RFC 6962 section 2.1 over leafNum leaves of data, written the way the rfc defines it
+static vector<uint8_t> ReferenceTreeHash(HcfMd *sha, const uint8_t *data, size_t len)
+{
+    size_t leafNum = (len + HCF_TREE_MD_LEAF_LEN - 1) / HCF_TREE_MD_LEAF_LEN;
+    if (leafNum <= 1) {
+        return PrefixedSha256(sha, 0, data, len, nullptr, 0);
+    }
+    size_t k = 1;
+    while (k * 2 < leafNum) {
+        k *= 2;
+    }
+    size_t leftLen = k * HCF_TREE_MD_LEAF_LEN;
+    vector<uint8_t> left = ReferenceTreeHash(sha, data, leftLen);
+    vector<uint8_t> right = ReferenceTreeHash(sha, data + leftLen, len - leftLen);
+    return PrefixedSha256(sha, 1, left.data(), left.size(), right.data(), right.size());
+}
+
+static vector<uint8_t> TreeHashInChunks(HcfMd *tree, const vector<uint8_t> &data, size_t chunkLen)
+{
+    for (size_t offset = 0; offset < data.size(); offset += chunkLen) {
+        size_t len = (data.size() - offset < chunkLen) ? (data.size() - offset) : chunkLen;
+        HcfBlob input = {.data = (uint8_t *)data.data() + offset, .len = len};
+        if (tree->update(tree, &input) != HCF_SUCCESS) {
+            return vector<uint8_t>();
+        }
+    }
+    HcfBlob out = {.data = nullptr, .len = 0};
+    vector<uint8_t> digest;
+    if (tree->doFinal(tree, &out) == HCF_SUCCESS) {
+        digest.assign(out.data, out.data + out.len);
+    }
+    HcfBlobDataFree(&out);
+    return digest;
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdTreeTest001, TestSize.Level0)
+{
+    HcfMd *tree = nullptr;
+    HcfMd *sha = nullptr;
+    ASSERT_EQ(HcfMdCreate("SHA256-TREE", &tree), HCF_SUCCESS);
+    ASSERT_EQ(HcfMdCreate("SHA256", &sha), HCF_SUCCESS);
+    EXPECT_EQ(tree->getMdLength(tree), 32);
+    EXPECT_STREQ(tree->getAlgoName(tree), "SHA256-TREE");
+
+    // the empty tree is sha256 of the empty string
+    const uint8_t emptyTree[] = { 0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14 };
+    vector<uint8_t> digest = TreeHashInChunks(tree, vector<uint8_t>(), 1);
+    ASSERT_EQ(digest.size(), 32);
+    EXPECT_EQ(memcmp(digest.data(), emptyTree, sizeof(emptyTree)), 0);
+
+    // edges of the leaves and of the parallel batches, in any update split
+    const size_t leaf = HCF_TREE_MD_LEAF_LEN;
+    const size_t lens[] = { 1, leaf - 1, leaf, leaf + 1, 2 * leaf, 3 * leaf, 5 * leaf + 7, 33 * leaf + 100 };
+    const size_t chunkLens[] = { SIZE_MAX, 1000, leaf + leaf / 2 };
+    for (size_t len : lens) {
+        vector<uint8_t> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = (uint8_t)(i * 7 + i / leaf);
+        }
+        vector<uint8_t> expect = ReferenceTreeHash(sha, data.data(), len);
+        for (size_t chunkLen : chunkLens) {
+            EXPECT_EQ(TreeHashInChunks(tree, data, chunkLen), expect) << len << " in chunks of " << chunkLen;
+        }
+    }
+
+    // reset drops the buffered leaf and the finished subtrees
+    vector<uint8_t> data(3 * leaf + 5, 0x42);
+    HcfBlob input = {.data = data.data(), .len = data.size()};
+    EXPECT_EQ(tree->update(tree, &input), HCF_SUCCESS);
+    EXPECT_EQ(tree->reset(tree), HCF_SUCCESS);
+    EXPECT_EQ(TreeHashInChunks(tree, data, data.size()), ReferenceTreeHash(sha, data.data(), data.size()));
+    OH_HCF_OBJ_DESTROY(sha);
+    OH_HCF_OBJ_DESTROY(tree);
+}
+
+// hash input with md and compare the digest with the expected lower case hex string
+static bool DigestMatchesHex(HcfMd *md, HcfBlob *input, const char *expectHex)
+{
+    HcfBlob out = {.data = nullptr, .len = 0};
+    if ((md->update(md, input) != HCF_SUCCESS) || (md->doFinal(md, &out) != HCF_SUCCESS)) {
+        return false;
+    }
+    string hex;
+    char byteHex[3] = { 0 };
+    for (uint32_t i = 0; i < out.len; i++) {
+        (void)sprintf_s(byteHex, sizeof(byteHex), "%02x", out.data[i]);
+        hex += byteHex;
+    }
+    HcfBlobDataFree(&out);
+    return hex == expectHex;
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdSha3Blake2Test001, TestSize.Level0)
+{
+    const struct {
+        const char *algoName;
+        uint32_t mdLen;
+        const char *digestOfAbc;
+    } vectors[] = {
+        { "SHA3-224", 28, "e642824c3f8cf24ad09234ee7d3c766fc9a3a5168d0c94ad73b46fdf" },
+        { "SHA3-256", 32, "3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532" },
+        { "SHA3-384", 48, "ec01498288516fc926459f58e2c6ad8df9b473cb0fc08c2596da7cf0e49be4b2"
+            "98d88cea927ac7f539f1edf228376d25" },
+        { "SHA3-512", 64, "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+            "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0" },
+        { "BLAKE2b512", 64, "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+            "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923" },
+        { "BLAKE2s256", 32, "508c5e8c327c14e2e1a72ba34eeb452f37458b209ed63a294d999b4c86675982" },
+    };
+    uint8_t abc[] = "abc";
+    HcfBlob inBlob = {.data = abc, .len = 3};
+    for (const auto &item : vectors) {
+        HcfMd *mdObj = nullptr;
+        ASSERT_EQ(HcfMdCreate(item.algoName, &mdObj), HCF_SUCCESS);
+        EXPECT_EQ(mdObj->getMdLength(mdObj), item.mdLen);
+        EXPECT_TRUE(DigestMatchesHex(mdObj, &inBlob, item.digestOfAbc)) << item.algoName;
+        EXPECT_EQ(mdObj->setMdLength(mdObj, 16), HCF_NOT_SUPPORT);
+        OH_HCF_OBJ_DESTROY(mdObj);
+    }
+    EXPECT_EQ(CheckDigestMany("SHA3-256"), 0);
+    EXPECT_EQ(CheckDigestMany("BLAKE2b512"), 0);
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdShakeTest001, TestSize.Level0)
+{
+    uint8_t abc[] = "abc";
+    HcfBlob inBlob = {.data = abc, .len = 3};
+    HcfMd *mdObj = nullptr;
+    HcfMd *pooledObj = nullptr;
+    HcfMd *treeObj = nullptr;
+
+    ASSERT_EQ(HcfMdCreate("SHAKE256", &mdObj), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->getMdLength(mdObj), 32);
+    EXPECT_TRUE(DigestMatchesHex(mdObj, &inBlob, "483366601360a8771c6863080cc4114d8db44530f8f1e1ee4f94ea37e78b5739"));
+    OH_HCF_OBJ_DESTROY(mdObj);
+
+    // a longer output starts with the shorter one, the length outlives doFinal
+    ASSERT_EQ(HcfMdPoolAcquire("SHAKE128", &mdObj), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->getMdLength(mdObj), 16);
+    EXPECT_TRUE(DigestMatchesHex(mdObj, &inBlob, "5881092dd818bf5cf8a3ddb793fbcba7"));
+    EXPECT_EQ(mdObj->setMdLength(mdObj, 40), HCF_SUCCESS);
+    EXPECT_EQ(mdObj->getMdLength(mdObj), 40);
+    for (uint32_t i = 0; i < 2; i++) {
+        EXPECT_TRUE(DigestMatchesHex(mdObj, &inBlob,
+            "5881092dd818bf5cf8a3ddb793fbcba74097d5c526a6d35f97b83351940f2cc844c50af32acd3f2c"));
+    }
+    EXPECT_EQ(mdObj->setMdLength(mdObj, HCF_MAX_BUFFER_LEN + 1), HCF_INVALID_PARAMS);
+    EXPECT_EQ(mdObj->getMdLength(mdObj), 40);
+    // the next user of a pooled md gets the default length
+    HcfMdPoolRelease(mdObj);
+    ASSERT_EQ(HcfMdPoolAcquire("SHAKE128", &pooledObj), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->getMdLength(pooledObj), 16);
+    EXPECT_EQ(pooledObj->setMdLength(pooledObj, 40), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->setMdLength(pooledObj, 0), HCF_SUCCESS);
+    EXPECT_EQ(pooledObj->getMdLength(pooledObj), 16);
+    EXPECT_NE(pooledObj->setMdLength(nullptr, 16), HCF_SUCCESS);
+    HcfMdPoolRelease(pooledObj);
+    HcfObjectPoolClear();
+
+    ASSERT_EQ(HcfMdCreate("SHA256-TREE", &treeObj), HCF_SUCCESS);
+    EXPECT_EQ(treeObj->setMdLength(treeObj, 64), HCF_NOT_SUPPORT);
+    OH_HCF_OBJ_DESTROY(treeObj);
+}
+
+// digest of prefix || suffix with a new md of algoName
+static vector<uint8_t> DigestOfJoined(const char *algoName, HcfBlob *prefix, HcfBlob *suffix)
+{
+    HcfMd *mdObj = nullptr;
+    HcfBlob out = {.data = nullptr, .len = 0};
+    vector<uint8_t> digest;
+    if (HcfMdCreate(algoName, &mdObj) != HCF_SUCCESS) {
+        return digest;
+    }
+    if ((mdObj->update(mdObj, prefix) == HCF_SUCCESS) && (mdObj->update(mdObj, suffix) == HCF_SUCCESS) &&
+        (mdObj->doFinal(mdObj, &out) == HCF_SUCCESS)) {
+        digest.assign(out.data, out.data + out.len);
+    }
+    HcfBlobDataFree(&out);
+    OH_HCF_OBJ_DESTROY(mdObj);
+    return digest;
+}
+
+HWTEST_F(CryptoMdTest, CryptoFrameworkMdCloneTest001, TestSize.Level0)
+{
+    uint8_t firstData[] = "first message";
+    uint8_t secondData[] = "second";
+    HcfBlob prefix = {.data = (uint8_t *)g_testBigData, .len = 1000};
+    HcfBlob suffixes[] = { {.data = firstData, .len = 13}, {.data = secondData, .len = 6} };
+    HcfBlob out = {.data = nullptr, .len = 0};
+    HcfMd *prefixObj = nullptr;
+
+    // every clone of the prefix state continues on its own, the original as well
+    ASSERT_EQ(HcfMdCreate("SHA256", &prefixObj), HCF_SUCCESS);
+    EXPECT_EQ(prefixObj->update(prefixObj, &prefix), HCF_SUCCESS);
+    for (auto &suffix : suffixes) {
+        HcfMd *cloneObj = nullptr;
+        ASSERT_EQ(prefixObj->clone(prefixObj, &cloneObj), HCF_SUCCESS);
+        EXPECT_STREQ(cloneObj->getAlgoName(cloneObj), "SHA256");
+        EXPECT_EQ(cloneObj->update(cloneObj, &suffix), HCF_SUCCESS);
+        EXPECT_EQ(cloneObj->doFinal(cloneObj, &out), HCF_SUCCESS);
+        EXPECT_EQ(vector<uint8_t>(out.data, out.data + out.len), DigestOfJoined("SHA256", &prefix, &suffix));
+        HcfBlobDataFree(&out);
+        OH_HCF_OBJ_DESTROY(cloneObj);
+    }
+    EXPECT_EQ(prefixObj->update(prefixObj, &suffixes[1]), HCF_SUCCESS);
+    EXPECT_EQ(prefixObj->doFinal(prefixObj, &out), HCF_SUCCESS);
+    EXPECT_EQ(vector<uint8_t>(out.data, out.data + out.len), DigestOfJoined("SHA256", &prefix, &suffixes[1]));
+    HcfBlobDataFree(&out);
+    OH_HCF_OBJ_DESTROY(prefixObj);
+
+    // the output length of SHAKE goes with the clone
+    HcfMd *shakeObj = nullptr;
+    HcfMd *cloneObj = nullptr;
+    ASSERT_EQ(HcfMdCreate("SHAKE256", &shakeObj), HCF_SUCCESS);
+    EXPECT_EQ(shakeObj->setMdLength(shakeObj, 100), HCF_SUCCESS);
+    ASSERT_EQ(shakeObj->clone(shakeObj, &cloneObj), HCF_SUCCESS);
+    EXPECT_EQ(cloneObj->getMdLength(cloneObj), 100);
+    EXPECT_NE(shakeObj->clone(shakeObj, nullptr), HCF_SUCCESS);
+    EXPECT_NE(shakeObj->clone(nullptr, &cloneObj), HCF_SUCCESS);
+    OH_HCF_OBJ_DESTROY(cloneObj);
+    OH_HCF_OBJ_DESTROY(shakeObj);
+
+    HcfMd *treeObj = nullptr;
+    cloneObj = nullptr;
+    ASSERT_EQ(HcfMdCreate("SHA256-TREE", &treeObj), HCF_SUCCESS);
+    EXPECT_EQ(treeObj->clone(treeObj, &cloneObj), HCF_NOT_SUPPORT);
+    EXPECT_EQ(cloneObj, nullptr);
+    OH_HCF_OBJ_DESTROY(treeObj);
+}
+}
@@ -983,4 +983,50 @@ HWTEST_F(CryptoRsaCipherTest, CryptoRsaCipherTest880, TestSize.Level0)
     OH_HCF_OBJ_DESTROY(keyPair);
     OH_HCF_OBJ_DESTROY(generator);
 }
+
+// correct case: encrypt and decrypt into caller owned buffers sized by getOutputSize
+HWTEST_F(CryptoRsaCipherTest, CryptoRsaCipherTest890, TestSize.Level0)
+{
+    HcfResult res = HCF_SUCCESS;
+    uint8_t plan[] = "this is rsa cipher test!\0";
+    uint8_t encBuf[128] = {0};
+    uint8_t decBuf[128] = {0};
+    uint32_t outLen = 0;
+
+    HcfAsyKeyGenerator *generator = NULL;
+    res = HcfAsyKeyGeneratorCreate("RSA1024|PRIMES_2", &generator);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    HcfKeyPair *keyPair = NULL;
+    res = generator->generateKeyPair(generator, NULL, &keyPair);
+    EXPECT_EQ(res, HCF_SUCCESS);
+
+    HcfCipher *cipher = NULL;
+    res = HcfCipherCreate("RSA1024|PKCS1", &cipher);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    res = cipher->init(cipher, ENCRYPT_MODE, (HcfKey *)keyPair->pubKey, NULL);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    res = cipher->getOutputSize(cipher, strlen((char *)plan), true, &outLen);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    EXPECT_EQ(outLen, sizeof(encBuf));
+
+    HcfBlob input = {.data = (uint8_t *)plan, .len = strlen((char *)plan)};
+    HcfBlob encoutput = {.data = encBuf, .len = outLen};
+    res = cipher->doFinalToBuffer(cipher, &input, &encoutput);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    OH_HCF_OBJ_DESTROY(cipher);
+
+    res = HcfCipherCreate("RSA1024|PKCS1", &cipher);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    res = cipher->init(cipher, DECRYPT_MODE, (HcfKey *)keyPair->priKey, NULL);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    HcfBlob decoutput = {.data = decBuf, .len = sizeof(decBuf)};
+    res = cipher->doFinalToBuffer(cipher, &encoutput, &decoutput);
+    EXPECT_EQ(res, HCF_SUCCESS);
+    EXPECT_EQ(decoutput.len, input.len);
+    EXPECT_EQ(memcmp(decoutput.data, plan, decoutput.len), 0);
+
+    OH_HCF_OBJ_DESTROY(cipher);
+    OH_HCF_OBJ_DESTROY(keyPair);
+    OH_HCF_OBJ_DESTROY(generator);
+}
 }